@@ -9,6 +9,8 @@ import Foundation
     func tryAgain()
     func save()
     func listen()
+    var accuracy: Float { get }
+    var meanAbsCentsError: Float { get }
 }
 
 @objc public protocol ProjectControllerBridgeDelegate {
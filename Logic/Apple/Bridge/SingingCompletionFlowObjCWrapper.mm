@@ -29,4 +29,12 @@
     _cpp->listen();
 }
 
+- (float)accuracy {
+    return _cpp->getSingingScore().getAccuracy();
+}
+
+- (float)meanAbsCentsError {
+    return _cpp->getSingingScore().getMeanAbsCentsError();
+}
+
 @end
\ No newline at end of file
@@ -7,14 +7,11 @@
 
 #include "AudioAverageInputLevelMonitor.h"
 #include "Algorithms.h"
-#include "AudioUtils.h"
 
 constexpr double THRESHOLD = 60;
 
-void AudioAverageInputLevelMonitor::operator()(const int16_t *data, int size) const {
-    tempFloatBuffer.resize(size);
-    AudioUtils::Int16SamplesIntoFloatSamples(data, size, tempFloatBuffer.data());
-    double sum = CppUtils::AbsoluteAverage<double>(tempFloatBuffer.data(), (int)tempFloatBuffer.size());
+void AudioAverageInputLevelMonitor::operator()(const float *data, int size) const {
+    double sum = CppUtils::AbsoluteAverage<double>(data, size);
     double value = 20 * log10(sum) + THRESHOLD;
     double inputLevel = value < 0 ? 0 : value / THRESHOLD;
     callback(inputLevel);
@@ -22,5 +19,4 @@ void AudioAverageInputLevelMonitor::operator()(const int16_t *data, int size) co
 
 AudioAverageInputLevelMonitor::AudioAverageInputLevelMonitor(const Callback& callback)
 : callback(callback) {
-    tempFloatBuffer.reserve(2048);
 }
@@ -12,12 +12,12 @@ class AudioAverageInputLevelMonitor {
 public:
     typedef std::function<void(double)> Callback;
 private:
-    mutable std::vector<float> tempFloatBuffer;
     Callback callback;
 public:
 
     AudioAverageInputLevelMonitor(const Callback& callback);
-    void operator()(const int16_t* data, int size) const;
+    // Float samples of the input, e.g. AudioInputBuffer::getFloatData()
+    void operator()(const float* data, int size) const;
 };
 
 
@@ -0,0 +1,193 @@
+#include "AudioInputGraph.h"
+#include "MultiChannelPitchInputReader.h"
+#include "AudioUtils.h"
+#include <chrono>
+#include <algorithm>
+#include <cassert>
+
+using namespace CppUtils;
+
+typedef std::chrono::steady_clock Clock;
+
+static double SecondsSince(const Clock::time_point& begin) {
+    return std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+AudioInputBuffer::AudioInputBuffer(int channelsCount, int maximumBufferSize) :
+        channelsCount(channelsCount),
+        floatSamples((size_t) maximumBufferSize),
+        channels((size_t) channelsCount) {
+    assert(channelsCount > 0);
+    if (channelsCount > 1) {
+        channelsBuffers.assign((size_t) channelsCount,
+                std::vector<int16_t>((size_t) maximumBufferSize / channelsCount));
+        for (int channel = 0; channel < channelsCount; ++channel) {
+            channelsBuffersData.push_back(channelsBuffers[channel].data());
+            channels[channel] = channelsBuffers[channel].data();
+        }
+    }
+}
+
+void AudioInputBuffer::prepare(const int16_t* data, int size) {
+    assert(size <= floatSamples.size());
+    assert(size % channelsCount == 0);
+    this->data = data;
+    this->size = size;
+    AudioUtils::Int16SamplesIntoFloatSamples(data, size, floatSamples.data());
+    if (channelsCount == 1) {
+        channels[0] = data;
+    } else {
+        MultiChannelPitchInputReader::deinterleave(data, getFramesCount(), channelsCount,
+                channelsBuffersData.data());
+    }
+}
+
+const int16_t* AudioInputBuffer::getData() const {
+    return data;
+}
+
+int AudioInputBuffer::getSize() const {
+    return size;
+}
+
+int AudioInputBuffer::getChannelsCount() const {
+    return channelsCount;
+}
+
+int AudioInputBuffer::getFramesCount() const {
+    return size / channelsCount;
+}
+
+const float* AudioInputBuffer::getFloatData() const {
+    return floatSamples.data();
+}
+
+const int16_t* AudioInputBuffer::getChannel(int channel) const {
+    assert(channel >= 0 && channel < channelsCount);
+    return channels[channel];
+}
+
+const int16_t* const* AudioInputBuffer::getChannels() const {
+    return channels.data();
+}
+
+double AudioInputGraph::StageStatistics::getMeanSeconds() const {
+    return executionsCount > 0 ? totalSeconds / executionsCount : 0;
+}
+
+AudioInputGraph::Stage::Stage() : enabled(false), executionsCount(0), totalSeconds(0), maxSeconds(0) {
+}
+
+void AudioInputGraph::Stage::addExecution(double seconds) {
+    // A single writer, so the values don't need to be updated atomically as a whole
+    executionsCount.store(executionsCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    totalSeconds.store(totalSeconds.load(std::memory_order_relaxed) + seconds, std::memory_order_relaxed);
+    if (seconds > maxSeconds.load(std::memory_order_relaxed)) {
+        maxSeconds.store(seconds, std::memory_order_relaxed);
+    }
+}
+
+void AudioInputGraph::Stage::clearStatistics() {
+    executionsCount.store(0, std::memory_order_relaxed);
+    totalSeconds.store(0, std::memory_order_relaxed);
+    maxSeconds.store(0, std::memory_order_relaxed);
+}
+
+AudioInputGraph::AudioInputGraph(int channelsCount, int maximumBufferSize) :
+        buffer(channelsCount, maximumBufferSize),
+        nodesCount(0),
+        statisticsResetRequested(false) {
+    stages[0].name = PREPARATION_STAGE_NAME;
+}
+
+AudioInputGraph::AudioInputGraph(AudioInputReader* audioInputReader) :
+        AudioInputGraph(audioInputReader->getNumberOfChannels(), audioInputReader->getMaximumBufferSize()) {
+}
+
+AudioInputGraph::Stage& AudioInputGraph::getNodeStage(int nodeIndex) {
+    assert(nodeIndex >= 0 && nodeIndex < getNodesCount());
+    return stages[nodeIndex + 1];
+}
+
+const AudioInputGraph::Stage& AudioInputGraph::getNodeStage(int nodeIndex) const {
+    assert(nodeIndex >= 0 && nodeIndex < getNodesCount());
+    return stages[nodeIndex + 1];
+}
+
+int AudioInputGraph::addNode(const std::string& name, const Node& node, bool enabled) {
+    std::lock_guard<std::mutex> _(addNodeMutex);
+    int nodeIndex = nodesCount.load(std::memory_order_relaxed);
+    assert(nodeIndex < MAX_NODES_COUNT);
+    Stage& stage = stages[nodeIndex + 1];
+    stage.name = name;
+    stage.node = node;
+    stage.enabled.store(enabled, std::memory_order_relaxed);
+    // The audio thread sees the stage constructed
+    nodesCount.store(nodeIndex + 1, std::memory_order_release);
+    return nodeIndex;
+}
+
+void AudioInputGraph::setNodeEnabled(int nodeIndex, bool enabled) {
+    getNodeStage(nodeIndex).enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool AudioInputGraph::isNodeEnabled(int nodeIndex) const {
+    return getNodeStage(nodeIndex).enabled.load(std::memory_order_relaxed);
+}
+
+int AudioInputGraph::getNodesCount() const {
+    return nodesCount.load(std::memory_order_acquire);
+}
+
+void AudioInputGraph::operator()(const int16_t* data, int size) {
+    int nodesCount = getNodesCount();
+    if (statisticsResetRequested.load(std::memory_order_acquire)) {
+        for (int i = 0; i <= nodesCount; ++i) {
+            stages[i].clearStatistics();
+        }
+        statisticsResetRequested.store(false, std::memory_order_release);
+    }
+
+    bool hasEnabledNodes = std::any_of(stages.begin() + 1, stages.begin() + 1 + nodesCount, [] (const Stage& stage) {
+        return stage.enabled.load(std::memory_order_relaxed);
+    });
+    if (!hasEnabledNodes) {
+        return;
+    }
+
+    Clock::time_point begin = Clock::now();
+    buffer.prepare(data, size);
+    stages[0].addExecution(SecondsSince(begin));
+
+    for (int i = 1; i <= nodesCount; ++i) {
+        Stage& stage = stages[i];
+        if (!stage.enabled.load(std::memory_order_relaxed)) {
+            continue;
+        }
+
+        begin = Clock::now();
+        stage.node(buffer);
+        stage.addExecution(SecondsSince(begin));
+    }
+}
+
+std::vector<AudioInputGraph::StageStatistics> AudioInputGraph::getStatistics() const {
+    int nodesCount = getNodesCount();
+    bool cleared = statisticsResetRequested.load(std::memory_order_acquire);
+    std::vector<StageStatistics> result((size_t) nodesCount + 1);
+    for (int i = 0; i <= nodesCount; ++i) {
+        const Stage& stage = stages[i];
+        StageStatistics& statistics = result[i];
+        statistics.name = stage.name;
+        if (!cleared) {
+            statistics.executionsCount = stage.executionsCount.load(std::memory_order_relaxed);
+            statistics.totalSeconds = stage.totalSeconds.load(std::memory_order_relaxed);
+            statistics.maxSeconds = stage.maxSeconds.load(std::memory_order_relaxed);
+        }
+    }
+    return result;
+}
+
+void AudioInputGraph::resetStatistics() {
+    statisticsResetRequested.store(true, std::memory_order_release);
+}
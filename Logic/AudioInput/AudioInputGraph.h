@@ -0,0 +1,111 @@
+#ifndef VOCALTRAINER_AUDIOINPUTGRAPH_H
+#define VOCALTRAINER_AUDIOINPUTGRAPH_H
+
+#include "AudioInputReader.h"
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <array>
+#include <functional>
+#include <cstdint>
+
+// Views of an input callback buffer shared by the nodes of AudioInputGraph. The float samples and the channels
+// are prepared once per callback, before the nodes are executed.
+class AudioInputBuffer {
+    friend class AudioInputGraph;
+
+    const int16_t* data = nullptr;
+    int size = 0;
+    int channelsCount;
+    std::vector<float> floatSamples;
+    std::vector<std::vector<int16_t>> channelsBuffers;
+    std::vector<int16_t*> channelsBuffersData;
+    std::vector<const int16_t*> channels;
+
+    AudioInputBuffer(int channelsCount, int maximumBufferSize);
+    void prepare(const int16_t* data, int size);
+public:
+    // Interleaved samples of all the channels
+    const int16_t* getData() const;
+    // Number of samples of all the channels
+    int getSize() const;
+    int getChannelsCount() const;
+    int getFramesCount() const;
+    // getData() converted to floats in [-1, 1)
+    const float* getFloatData() const;
+    // getFramesCount() samples of the channel, the data of a mono input as is
+    const int16_t* getChannel(int channel) const;
+    const int16_t* const* getChannels() const;
+};
+
+// Processing of the audio input as an ordered list of nodes: the callback buffer is converted to floats and
+// deinterleaved once, then the enabled nodes are executed in the order they were added, each one receiving
+// the shared views. The execution time of the preparation stage and of every node is accounted.
+// The graph is executed on the audio input thread without locking: the stages have fixed places, a node is
+// published by the nodes count after it's constructed, the enabled flags and the statistics are atomic.
+// The nodes are added and enabled from any thread, but not from the nodes. The nodes own their synchronization:
+// the level and the pitches nodes don't lock, the recording node locks the recorded data briefly.
+class AudioInputGraph {
+public:
+    typedef std::function<void(const AudioInputBuffer&)> Node;
+
+    struct StageStatistics {
+        std::string name;
+        int64_t executionsCount = 0;
+        double totalSeconds = 0;
+        double maxSeconds = 0;
+
+        double getMeanSeconds() const;
+    };
+
+    static constexpr const char* PREPARATION_STAGE_NAME = "prepare";
+    static constexpr int MAX_NODES_COUNT = 16;
+
+private:
+    // The statistics are written by the audio thread only
+    struct Stage {
+        std::string name;
+        Node node;
+        std::atomic<bool> enabled;
+        std::atomic<int64_t> executionsCount;
+        std::atomic<double> totalSeconds;
+        std::atomic<double> maxSeconds;
+
+        Stage();
+        void addExecution(double seconds);
+        void clearStatistics();
+    };
+
+    AudioInputBuffer buffer;
+    // The preparation stage goes first
+    std::array<Stage, MAX_NODES_COUNT + 1> stages;
+    std::atomic<int> nodesCount;
+    // Applied by the audio thread, the statistics read before are reported as cleared
+    std::atomic<bool> statisticsResetRequested;
+    // Serializes addNode, never locked by the audio thread
+    std::mutex addNodeMutex;
+
+    Stage& getNodeStage(int nodeIndex);
+    const Stage& getNodeStage(int nodeIndex) const;
+public:
+    // maximumBufferSize is in samples of all the channels
+    AudioInputGraph(int channelsCount, int maximumBufferSize);
+    explicit AudioInputGraph(AudioInputReader* audioInputReader);
+
+    // Returns the index of the node, at most MAX_NODES_COUNT nodes are added
+    int addNode(const std::string& name, const Node& node, bool enabled = true);
+    void setNodeEnabled(int nodeIndex, bool enabled);
+    bool isNodeEnabled(int nodeIndex) const;
+    int getNodesCount() const;
+
+    // An AudioInputReader callback, nothing is done if no node is enabled
+    void operator()(const int16_t* data, int size);
+
+    // The preparation stage followed by the nodes
+    std::vector<StageStatistics> getStatistics() const;
+    void resetStatistics();
+};
+
+
+#endif //VOCALTRAINER_AUDIOINPUTGRAPH_H
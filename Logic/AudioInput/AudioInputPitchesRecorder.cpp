@@ -15,40 +15,63 @@ using namespace std;
 #define LOCK std::lock_guard<std::mutex> _(mutex)
 
 void AudioInputPitchesRecorder::init(AudioInputReader *audioInputReader, int smoothLevel,
-        PitchDetector* pitchDetector) {
-    pitchInputReader = new PitchInputReader(audioInputReader, pitchDetector, smoothLevel);
-
+        const MultiChannelPitchInputReader::PitchDetectorFactory& createPitchDetector, int decimationFactor) {
+    pitchInputReader = new MultiChannelPitchInputReader(audioInputReader, createPitchDetector, smoothLevel,
+            decimationFactor);
     pitchInputReader->setExecuteCallBackOnInvalidPitches(true);
-    pitchInputReader->setCallback([=](const Pitch& pitch) {
-        float frequency = pitch.getFrequency();
-        double seek = pitches.appendPitch(frequency);
-        pitchDetected(frequency, seek);
-    });
+    pitchInputReader->startDetectionThread();
+    for (int channel = 0; channel < pitchInputReader->getChannelsCount(); ++channel) {
+        channelsPitches.emplace_back(new SeekablePitchesList());
+        SeekablePitchesList* pitches = channelsPitches.back().get();
+        // Executed on the detection and the worker threads of the reader
+        pitchInputReader->getChannelReader(channel)->setCallback([=](const Pitch& pitch) {
+            float frequency = pitch.getFrequency();
+            double seek = pitches->appendPitch(frequency);
+            pitchDetected(channel, frequency, seek);
+        });
+    }
 }
 
-void AudioInputPitchesRecorder::operator()(const int16_t* data, int size) {
+void AudioInputPitchesRecorder::operator()(const AudioInputBuffer& buffer) {
     assert(pitchInputReader && "call init before");
-    pitchInputReader->operator()(data, size);
+    pitchInputReader->enqueueChannels(buffer.getChannels(), buffer.getFramesCount());
 }
 
 AudioInputPitchesRecorder::~AudioInputPitchesRecorder() {
     delete pitchInputReader;
 }
 
-void AudioInputPitchesRecorder::pitchDetected(float frequency, double time) {
+void AudioInputPitchesRecorder::pitchDetected(int channel, float frequency, double time) {
     executeOnMainThread([=] {
-        pitchDetectedListeners.executeAll(Pitch(frequency), time);
+        Pitch pitch(frequency);
+        if (channel == 0) {
+            pitchDetectedListeners.executeAll(pitch, time);
+        }
+        channelPitchDetectedListeners.executeAll(channel, pitch, time);
     });
 }
 
 void AudioInputPitchesRecorder::setSeek(double seek) {
-    pitches.setSeek(seek);
+    for (const auto& pitches : channelsPitches) {
+        pitches->setSeek(seek);
+    }
+}
+
+int AudioInputPitchesRecorder::getChannelsCount() const {
+    return int(channelsPitches.size());
 }
 
 const PitchesCollection* AudioInputPitchesRecorder::getPitches() const {
-    return &pitches;
+    return getPitches(0);
+}
+
+const PitchesCollection* AudioInputPitchesRecorder::getPitches(int channel) const {
+    assert(channel >= 0 && channel < channelsPitches.size());
+    return channelsPitches[channel].get();
 }
 
 void AudioInputPitchesRecorder::clearRecordedPitches() {
-    pitches.clearPitches();
+    for (const auto& pitches : channelsPitches) {
+        pitches->clearPitches();
+    }
 }
@@ -8,32 +8,43 @@
 
 #include <vector>
 #include "Pitch.h"
-#include "PitchInputReader.h"
+#include "MultiChannelPitchInputReader.h"
+#include "AudioInputGraph.h"
 #include "PitchesCollection.h"
 #include "SeekablePitchesList.h"
 #include "ListenersSet.h"
 #include "Executors.h"
 #include <functional>
 #include <mutex>
+#include <memory>
 
+// Records a pitch stream per input channel, channel 0 is the main one
 class AudioInputPitchesRecorder : private CppUtils::OnThreadExecutor {
-    PitchInputReader* pitchInputReader = nullptr;
-    SeekablePitchesList pitches;
+    MultiChannelPitchInputReader* pitchInputReader = nullptr;
+    std::vector<std::unique_ptr<SeekablePitchesList>> channelsPitches;
 public:
+    // Pitches of channel 0
     CppUtils::ListenersSet<const Pitch&, double> pitchDetectedListeners;
+    // Pitches of every channel
+    CppUtils::ListenersSet<int, const Pitch&, double> channelPitchDetectedListeners;
 
+    // A detector is created for every channel of the input
     void init(AudioInputReader* audioInputReader,
             int smoothLevel,
-            PitchDetector* pitchDetector);
+            const MultiChannelPitchInputReader::PitchDetectorFactory& createPitchDetector,
+            int decimationFactor = 1);
 
-    void operator()(const int16_t* data, int size);
+    // An AudioInputGraph node, the channels are queued for the pitch detection running on its own thread
+    void operator()(const AudioInputBuffer& buffer);
 
     ~AudioInputPitchesRecorder();
-    virtual void pitchDetected(float frequency, double time);
+    virtual void pitchDetected(int channel, float frequency, double time);
 
     void setSeek(double seek);
 
+    int getChannelsCount() const;
     const PitchesCollection* getPitches() const;
+    const PitchesCollection* getPitches(int channel) const;
 
     void clearRecordedPitches();
 };
@@ -31,10 +31,15 @@ public:
     virtual ~AudioInputReader() = default;
 };
 
+// Plays the input back to the singer
 class AudioInputReaderWithOutput : public AudioInputReader {
 public:
     virtual void setOutputVolume(float value) = 0;
     virtual float getOutputVolume() const = 0;
+    // Delay between the input and the output in seconds, 0 before the input is played back for the first time
+    virtual double getOutputLatency() const = 0;
+    // False if the input can't be played back, e.g. there is no output device
+    virtual bool isOutputAvailable() const = 0;
 };
 
 #endif //PITCHDETECTION_AUDOINPUTREADER_H
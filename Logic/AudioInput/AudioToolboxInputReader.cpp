@@ -8,6 +8,11 @@
 #include <AudioToolbox/AudioToolbox.h>
 #include "AudioStreamDescription.h"
 #include "AudioToolboxUtils.h"
+#include "AudioOperationFailedException.h"
+#include <iostream>
+
+// I/O buffer size requested for the monitoring, about 1.5ms at 44100Hz
+static const int MONITORING_BUFFER_FRAMES_COUNT = 64;
 
 void AudioToolboxInputReader::HandleInputBuffer(void *userData,
         AudioQueueRef audioQueueRef,
@@ -20,23 +25,67 @@ void AudioToolboxInputReader::HandleInputBuffer(void *userData,
     self->callbacks.executeAll((int16_t*)inBuffer->mAudioData, inBuffer->mAudioDataByteSize / sizeof(int16_t));
 }
 
-AudioToolboxInputReader::AudioToolboxInputReader(int maximumBufferSize) {
+void AudioToolboxInputReader::HandleMonitoringBuffer(void *userData, int16_t* data, int size) {
+    AudioToolboxInputReader* self = static_cast<AudioToolboxInputReader *>(userData);
+    // The input of the cycle is played back with the monitoring gain
+    self->monitor.process(data, data, size);
+}
+
+static AudioStreamDescription CreateFormat(int maximumBufferSize) {
     assert(maximumBufferSize > 0);
+    AudioStreamDescription format;
     format.sampleRate = 44100;
     format.numberOfChannels = 1;
     format.samplesPerBuffer = maximumBufferSize;
     format.bitsPerChannel = 16;
+    return format;
+}
+
+AudioToolboxInputReader::AudioToolboxInputReader(int maximumBufferSize) :
+        format(CreateFormat(maximumBufferSize)),
+        monitor(format.numberOfChannels) {
     queue.initAsInput(format, HandleInputBuffer, this);
+
+    monitor.setGain(0);
 }
 
 void AudioToolboxInputReader::start() {
     running = true;
     queue.start();
+    updateMonitoringRunning();
 }
 
 void AudioToolboxInputReader::stop() {
     running = false;
     queue.pause();
+    updateMonitoringRunning();
+}
+
+void AudioToolboxInputReader::updateMonitoringRunning() {
+    bool shouldRun = running && monitoringAvailable && monitor.getGain() > 0;
+    if (shouldRun == monitoringRunning) {
+        return;
+    }
+
+    try {
+        if (shouldRun) {
+            if (!monitoringUnit) {
+                std::unique_ptr<AudioToolboxDuplexUnit> unit(new AudioToolboxDuplexUnit());
+                AudioStreamDescription monitoringFormat(format, MONITORING_BUFFER_FRAMES_COUNT);
+                unit->init(monitoringFormat, HandleMonitoringBuffer, this);
+                monitoringUnit = std::move(unit);
+            }
+            monitoringUnit->start();
+        } else {
+            monitoringUnit->pause();
+        }
+        monitoringRunning = shouldRun;
+    } catch (AudioOperationFailedException& e) {
+        std::cerr << "Input monitoring is unavailable: " << e.what() << std::endl;
+        monitoringAvailable = false;
+        monitoringRunning = false;
+        monitoringUnit = nullptr;
+    }
 }
 
 bool AudioToolboxInputReader::isRunning() {
@@ -72,9 +121,21 @@ void AudioToolboxInputReader::setDeviceName(const char *deviceName) {
 }
 
 void AudioToolboxInputReader::setOutputVolume(float value) {
-    NOT_IMPLEMENTED_ASSERT;
+    monitor.setGain(value);
+    updateMonitoringRunning();
 }
 
 float AudioToolboxInputReader::getOutputVolume() const {
-    return 0;
+    return monitor.getGain();
+}
+
+double AudioToolboxInputReader::getOutputLatency() const {
+    if (!monitoringUnit) {
+        return 0;
+    }
+    return monitoringUnit->getLatency();
+}
+
+bool AudioToolboxInputReader::isOutputAvailable() const {
+    return monitoringAvailable;
 }
@@ -10,11 +10,22 @@
 #include <AudioToolbox/AudioToolbox.h>
 #include "AudioStreamDescription.h"
 #include "AudioToolboxQueue.h"
+#include "AudioToolboxDuplexUnit.h"
+#include "DirectMonitor.h"
+#include <memory>
 
 class AudioToolboxInputReader : public AudioInputReaderWithOutput {
     volatile bool running = false;
     AudioStreamDescription format;
     AudioToolboxQueue queue;
+    // The input is played back by a duplex unit with small I/O buffers, the pitch detection buffers are too long
+    // for a singer to hear themselves without a noticeable delay. The unit is created when the output volume
+    // rises above 0 for the first time and runs while it's above 0. If it fails, the monitoring is unavailable,
+    // the pitch detection and the recording keep working.
+    DirectMonitor monitor;
+    std::unique_ptr<AudioToolboxDuplexUnit> monitoringUnit;
+    bool monitoringRunning = false;
+    bool monitoringAvailable = true;
 
     static void HandleInputBuffer(void *userData,
             AudioQueueRef audioQueueRef,
@@ -22,6 +33,9 @@ class AudioToolboxInputReader : public AudioInputReaderWithOutput {
             const AudioTimeStamp *inStartTime,
             UInt32 inNumPackets,
             const AudioStreamPacketDescription *inPacketDesc);
+    static void HandleMonitoringBuffer(void *userData, int16_t* data, int size);
+
+    void updateMonitoringRunning();
 public:
     AudioToolboxInputReader(int maximumBufferSize);
 
@@ -38,6 +52,8 @@ public:
 
     void setOutputVolume(float value) override;
     float getOutputVolume() const override;
+    double getOutputLatency() const override;
+    bool isOutputAvailable() const override;
 };
 
 
@@ -0,0 +1,43 @@
+#include "DirectMonitor.h"
+#include <algorithm>
+#include <cassert>
+
+DirectMonitor::DirectMonitor(int channelsCount) :
+        channelsCount(channelsCount),
+        gain(1),
+        currentGain(1) {
+    assert(channelsCount > 0);
+}
+
+void DirectMonitor::process(const int16_t* input, int16_t* output, int size) {
+    assert(size % channelsCount == 0);
+    int framesCount = size / channelsCount;
+    if (framesCount == 0) {
+        return;
+    }
+
+    float targetGain = gain.load(std::memory_order_relaxed);
+    float gainStep = (targetGain - currentGain) / framesCount;
+    for (int frame = 0; frame < framesCount; ++frame) {
+        float frameGain = currentGain + gainStep * (frame + 1);
+        for (int channel = 0; channel < channelsCount; ++channel) {
+            int index = frame * channelsCount + channel;
+            float value = input[index] * frameGain;
+            output[index] = int16_t(std::max(-32768.0f, std::min(32767.0f, value)));
+        }
+    }
+    currentGain = targetGain;
+}
+
+void DirectMonitor::setGain(float gain) {
+    assert(gain >= 0);
+    this->gain.store(gain, std::memory_order_relaxed);
+}
+
+float DirectMonitor::getGain() const {
+    return gain.load(std::memory_order_relaxed);
+}
+
+int DirectMonitor::getChannelsCount() const {
+    return channelsCount;
+}
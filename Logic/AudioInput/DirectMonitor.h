@@ -0,0 +1,27 @@
+#ifndef VOCALTRAINER_DIRECTMONITOR_H
+#define VOCALTRAINER_DIRECTMONITOR_H
+
+#include <atomic>
+#include <cstdint>
+
+// Plays the input back to the singer inside a duplex callback, independently of the players and their mixers.
+// The gain is lock free, it's set from any thread and ramped over a block to avoid clicks.
+class DirectMonitor {
+    int channelsCount;
+    std::atomic<float> gain;
+    // Gain applied to the last processed block, owned by the audio thread
+    float currentGain;
+public:
+    explicit DirectMonitor(int channelsCount = 1);
+
+    // Duplex callback, input and output have size samples of all the channels, they may be the same buffer
+    void process(const int16_t* input, int16_t* output, int size);
+
+    // Linear gain of the monitored input
+    void setGain(float gain);
+    float getGain() const;
+    int getChannelsCount() const;
+};
+
+
+#endif //VOCALTRAINER_DIRECTMONITOR_H
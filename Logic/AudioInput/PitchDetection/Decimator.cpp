@@ -0,0 +1,117 @@
+#include "Decimator.h"
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DECIMATOR_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define DECIMATOR_NEON
+#endif
+
+// Taps per unit of the factor, gives the transition band of 0.2 of the output sample rate
+static constexpr int TAPS_PER_FACTOR = 28;
+
+// count is a multiple of 4
+static float DotProduct(const float* a, const float* b, int count) {
+#if defined(DECIMATOR_SSE2)
+    __m128 sum0 = _mm_setzero_ps();
+    __m128 sum1 = _mm_setzero_ps();
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    if (i < count) {
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    __m128 sum = _mm_add_ps(sum0, sum1);
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+#elif defined(DECIMATOR_NEON)
+    float32x4_t sum = vdupq_n_f32(0);
+    for (int i = 0; i < count; i += 4) {
+        sum = vfmaq_f32(sum, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+    return vaddvq_f32(sum);
+#else
+    float sum = 0;
+    for (int i = 0; i < count; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+#endif
+}
+
+Decimator::Decimator(int factor) : factor(factor) {
+    assert(factor >= 1);
+    if (factor == 1) {
+        return;
+    }
+
+    int tapsCount = TAPS_PER_FACTOR * factor;
+    taps.resize(static_cast<size_t>(tapsCount));
+    double center = (tapsCount - 1) / 2.0;
+    double cutoff = 0.5 / factor;
+    double sum = 0;
+    for (int i = 0; i < tapsCount; ++i) {
+        double x = i - center;
+        double sinc = fabs(x) < 1e-9 ? 2 * cutoff : sin(2 * M_PI * cutoff * x) / (M_PI * x);
+        double window = 0.42 - 0.5 * cos(2 * M_PI * (i + 0.5) / tapsCount)
+                + 0.08 * cos(4 * M_PI * (i + 0.5) / tapsCount);
+        taps[i] = float(sinc * window);
+        sum += taps[i];
+    }
+    // Unit gain at DC, the filter is symmetric, so it doesn't need to be reversed
+    for (float& tap : taps) {
+        tap = float(tap / sum);
+    }
+    reset();
+}
+
+int Decimator::process(const int16_t* input, int size, int16_t* output) {
+    if (factor == 1) {
+        std::copy(input, input + size, output);
+        return size;
+    }
+
+    int historySize = int(taps.size()) - 1;
+    samples.resize(static_cast<size_t>(historySize + size));
+    std::transform(input, input + size, samples.begin() + historySize, [] (int16_t sample) {
+        return float(sample);
+    });
+
+    int outputSize = 0;
+    int tapsCount = int(taps.size());
+    int index = skipCount;
+    for (; index < size; index += factor) {
+        // The filter ends at the input sample index
+        float value = DotProduct(samples.data() + index, taps.data(), tapsCount);
+        output[outputSize++] = static_cast<int16_t>(std::max(-32768.0f, std::min(32767.0f, roundf(value))));
+    }
+    skipCount = index - size;
+
+    std::copy(samples.end() - historySize, samples.end(), samples.begin());
+    samples.resize(static_cast<size_t>(historySize));
+    return outputSize;
+}
+
+int Decimator::getMaxOutputSize(int inputSize) const {
+    return (inputSize + factor - 1) / factor;
+}
+
+int Decimator::getFactor() const {
+    return factor;
+}
+
+int Decimator::getDelay() const {
+    return factor == 1 ? 0 : int(taps.size()) / 2;
+}
+
+void Decimator::reset() {
+    skipCount = 0;
+    samples.assign(taps.empty() ? 0 : taps.size() - 1, 0.0f);
+}
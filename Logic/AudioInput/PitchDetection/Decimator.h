@@ -0,0 +1,36 @@
+#ifndef VOCALTRAINER_DECIMATOR_H
+#define VOCALTRAINER_DECIMATOR_H
+
+#include <cstdint>
+#include <vector>
+
+// Anti-aliasing decimator of the input audio by an integer factor, so the pitch detection works at a reduced
+// sample rate. The low-pass filter is a Blackman windowed sinc cut at the output Nyquist frequency, its aliases
+// fall above 0.4 of the output sample rate, out of the sung range. It is polyphase in the sense that only every
+// factor-th output is computed. The state is kept between the pieces, so a stream can be given in pieces of any
+// size, the output pieces then differ by one sample at most.
+class Decimator {
+public:
+    // factor 1 copies the input
+    explicit Decimator(int factor);
+
+    // Returns the output samples count, at most getMaxOutputSize(size)
+    int process(const int16_t* input, int size, int16_t* output);
+    int getMaxOutputSize(int inputSize) const;
+    int getFactor() const;
+    // Group delay of the filter, in input samples
+    int getDelay() const;
+    void reset();
+
+private:
+    int factor;
+    // Reversed, the count is a multiple of 4
+    std::vector<float> taps;
+    // Last taps.size() - 1 input samples followed by the piece being processed
+    std::vector<float> samples;
+    // Input samples to skip before the next output
+    int skipCount = 0;
+};
+
+
+#endif //VOCALTRAINER_DECIMATOR_H
@@ -0,0 +1,195 @@
+#include "MpmPitchDetector.h"
+#include "AudioUtils.h"
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MPM_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define MPM_NEON
+#endif
+
+using namespace CppUtils;
+
+static int NextPowerOfTwo(int value) {
+    int result = 4;
+    while (result < value) {
+        result *= 2;
+    }
+    return result;
+}
+
+// Bits 0-3 are set for the positive local maxima of nsdf[i..i + 3], bits 4-7 for the positive values followed by
+// a non positive one, the ends of the lobes. nsdf[i - 1] and nsdf[i + 4] should be readable.
+static inline int GetPeakEvents(const float* nsdf, int i) {
+#if defined(MPM_SSE2)
+    __m128 previous = _mm_loadu_ps(nsdf + i - 1);
+    __m128 current = _mm_loadu_ps(nsdf + i);
+    __m128 next = _mm_loadu_ps(nsdf + i + 1);
+    __m128 zero = _mm_setzero_ps();
+    __m128 positive = _mm_cmpgt_ps(current, zero);
+    __m128 maxima = _mm_and_ps(_mm_and_ps(_mm_cmpgt_ps(current, previous), _mm_cmpge_ps(current, next)), positive);
+    __m128 ends = _mm_and_ps(positive, _mm_cmple_ps(next, zero));
+    return _mm_movemask_ps(maxima) | _mm_movemask_ps(ends) << 4;
+#elif defined(MPM_NEON)
+    float32x4_t previous = vld1q_f32(nsdf + i - 1);
+    float32x4_t current = vld1q_f32(nsdf + i);
+    float32x4_t next = vld1q_f32(nsdf + i + 1);
+    float32x4_t zero = vdupq_n_f32(0);
+    uint32x4_t positive = vcgtq_f32(current, zero);
+    uint32x4_t maxima = vandq_u32(vandq_u32(vcgtq_f32(current, previous), vcgeq_f32(current, next)), positive);
+    uint32x4_t ends = vandq_u32(positive, vcleq_f32(next, zero));
+    static const uint32_t bits[4] = {1, 2, 4, 8};
+    uint32x4_t bitsVector = vld1q_u32(bits);
+    return int(vaddvq_u32(vandq_u32(maxima, bitsVector)) | vaddvq_u32(vandq_u32(ends, bitsVector)) << 4);
+#else
+    int result = 0;
+    for (int k = 0; k < 4; ++k) {
+        float current = nsdf[i + k];
+        float next = nsdf[i + k + 1];
+        if (current > 0 && current > nsdf[i + k - 1] && current >= next) {
+            result |= 1 << k;
+        }
+        if (current > 0 && next <= 0) {
+            result |= 1 << (k + 4);
+        }
+    }
+    return result;
+#endif
+}
+
+void MpmPitchDetector::findKeyMaxima(const float* nsdf, int size, std::vector<int>* keyMaxima) {
+    keyMaxima->clear();
+    // The first lobe, around tau = 0, is skipped
+    bool firstLobeFinished = false;
+    int lobeMaximum = -1;
+    auto handleEvents = [&] (int i, int events) {
+        for (int k = 0; k < 4; ++k) {
+            if (events & (1 << k)) {
+                int position = i + k;
+                if (firstLobeFinished && (lobeMaximum < 0 || nsdf[position] > nsdf[lobeMaximum])) {
+                    lobeMaximum = position;
+                }
+            }
+            if (events & (1 << (k + 4))) {
+                if (lobeMaximum >= 0) {
+                    keyMaxima->push_back(lobeMaximum);
+                    lobeMaximum = -1;
+                }
+                firstLobeFinished = true;
+            }
+        }
+    };
+
+    int i = 1;
+    // The last block reads nsdf[i + 4]
+    for (; i + 4 < size; i += 4) {
+        int events = GetPeakEvents(nsdf, i);
+        if (events) {
+            handleEvents(i, events);
+        }
+    }
+    for (; i < size - 1; ++i) {
+        float current = nsdf[i];
+        float next = nsdf[i + 1];
+        int events = 0;
+        if (current > 0 && current > nsdf[i - 1] && current >= next) {
+            events |= 1;
+        }
+        if (current > 0 && next <= 0) {
+            events |= 1 << 4;
+        }
+        handleEvents(i, events);
+    }
+
+    if (lobeMaximum >= 0) {
+        keyMaxima->push_back(lobeMaximum);
+    }
+}
+
+MpmPitchDetector::MpmPitchDetector() : MpmPitchDetector(Settings()) {
+}
+
+MpmPitchDetector::MpmPitchDetector(const Settings& settings) : settings(settings) {
+}
+
+void MpmPitchDetector::init(int maxBufferSize, int sampleRate) {
+    assert(maxBufferSize >= 8 && sampleRate > 0);
+    assert(settings.minFrequency > 0 && settings.maxFrequency > settings.minFrequency);
+    bufferSize = maxBufferSize;
+    this->sampleRate = sampleRate;
+    // The lobe of the lowest period should be finished, so a half of the period is added. The NSDF of the long
+    // lags is computed from a few samples and is not reliable, so the half of the buffer is the limit.
+    maxTau = std::min(bufferSize / 2, int(ceil(1.5 * sampleRate / settings.minFrequency)) + 2);
+    minTau = std::max(1, int(sampleRate / settings.maxFrequency) - 1);
+
+    // Zero padded to twice the size, so the autocorrelation is not circular
+    fft.reset(new RealFFT(NextPowerOfTwo(bufferSize * 2)));
+    samples.assign(static_cast<size_t>(fft->getSize()), 0.0f);
+    spectrum.resize(static_cast<size_t>(fft->getSpectrumSize()));
+    autocorrelation.resize(static_cast<size_t>(fft->getSize()));
+    nsdf.resize(static_cast<size_t>(maxTau + 1));
+}
+
+float MpmPitchDetector::getFrequencyFromBuffer(const int16_t *buffer) {
+    AudioUtils::Int16SamplesIntoFloatSamples(buffer, bufferSize, samples.data());
+
+    fft->forward(samples.data(), spectrum.data());
+    for (std::complex<float>& value : spectrum) {
+        value = std::norm(value);
+    }
+    fft->inverse(spectrum.data(), autocorrelation.data());
+
+    // m(tau) = sum(x[j]^2 + x[j + tau]^2), j < size - tau, nsdf(tau) = 2 * r(tau) / m(tau)
+    double energy = 0;
+    for (int i = 0; i < bufferSize; ++i) {
+        energy += double(samples[i]) * samples[i];
+    }
+    if (energy <= 0) {
+        return -1;
+    }
+
+    float scale = 1.0f / fft->getSize();
+    double m = 2 * energy;
+    for (int tau = 0; tau <= maxTau; ++tau) {
+        if (tau > 0) {
+            m -= double(samples[tau - 1]) * samples[tau - 1] + double(samples[bufferSize - tau]) * samples[bufferSize - tau];
+        }
+        nsdf[tau] = m > 0 ? float(2 * autocorrelation[tau] * scale / m) : 0.0f;
+    }
+
+    findKeyMaxima(nsdf.data(), maxTau + 1, &keyMaxima);
+
+    float highest = 0;
+    for (int position : keyMaxima) {
+        highest = std::max(highest, nsdf[position]);
+    }
+    if (highest < settings.smallCutoff) {
+        return -1;
+    }
+
+    float threshold = settings.cutoff * highest;
+    for (int position : keyMaxima) {
+        if (position < minTau || nsdf[position] < threshold) {
+            continue;
+        }
+
+        // Parabolic interpolation of the maximum
+        float previous = nsdf[position - 1];
+        float current = nsdf[position];
+        float next = nsdf[position + 1];
+        float denominator = previous + next - 2 * current;
+        float period = position;
+        if (denominator != 0) {
+            period += std::max(-1.0f, std::min(1.0f, (previous - next) / (2 * denominator)));
+        }
+
+        float frequency = sampleRate / period;
+        return frequency >= settings.minFrequency ? frequency : -1;
+    }
+
+    return -1;
+}
@@ -0,0 +1,50 @@
+#ifndef VOCALTRAINER_MPMPITCHDETECTOR_H
+#define VOCALTRAINER_MPMPITCHDETECTOR_H
+
+#include "PitchDetector.h"
+#include "RealFFT.h"
+#include <vector>
+#include <memory>
+
+// McLeod pitch method. The normalized square difference function is the autocorrelation, computed by a single
+// real FFT of the zero padded buffer and its inverse, divided by the incrementally updated energy terms.
+// Key maxima of its positive lobes are picked by a SIMD scan, the first one close enough to the highest is
+// the period.
+class MpmPitchDetector : public PitchDetector {
+public:
+    struct Settings {
+        // Share of the highest key maximum the period maximum should reach
+        float cutoff = 0.93f;
+        // Key maxima below are ignored
+        float smallCutoff = 0.5f;
+        // Hz, limit the searched periods
+        float minFrequency = 60;
+        float maxFrequency = 1600;
+    };
+
+    MpmPitchDetector();
+    explicit MpmPitchDetector(const Settings& settings);
+
+    void init(int maxBufferSize, int sampleRate) override;
+    float getFrequencyFromBuffer(const int16_t *buffer) override;
+
+    // Positions in [1, size - 1) of the highest local maximum of every positive lobe after the first
+    // negative zero crossing, the last lobe may be unfinished
+    static void findKeyMaxima(const float* nsdf, int size, std::vector<int>* keyMaxima);
+
+private:
+    Settings settings;
+    int bufferSize = 0;
+    int sampleRate = 0;
+    int minTau = 0;
+    int maxTau = 0;
+    std::unique_ptr<RealFFT> fft;
+    std::vector<float> samples;
+    std::vector<std::complex<float>> spectrum;
+    std::vector<float> autocorrelation;
+    std::vector<float> nsdf;
+    std::vector<int> keyMaxima;
+};
+
+
+#endif //VOCALTRAINER_MPMPITCHDETECTOR_H
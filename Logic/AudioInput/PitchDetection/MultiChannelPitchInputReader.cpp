@@ -0,0 +1,205 @@
+#include "MultiChannelPitchInputReader.h"
+#include <algorithm>
+#include <chrono>
+#include <cassert>
+
+// The audio thread doesn't lock the mutex to notify the detection thread, so a notification sent between the queue
+// check and the wait is lost, the detection thread checks the queue again after this time
+static constexpr std::chrono::milliseconds MAX_DETECTION_WAIT_TIME(5);
+
+MultiChannelPitchInputReader::MultiChannelPitchInputReader(int sampleRate, int channelsCount, int maximumBufferSize,
+        const PitchDetectorFactory& createPitchDetector, int smoothLevel, int decimationFactor,
+        int workerThreadsCount) :
+        queuedBlocksCount(0),
+        processedBlocksCount(0),
+        droppedBlocksCount(0) {
+    assert(channelsCount > 0);
+    maximumChannelBufferSize = maximumBufferSize / channelsCount;
+    for (int channel = 0; channel < channelsCount; ++channel) {
+        readers.emplace_back(new PitchInputReader(sampleRate, maximumChannelBufferSize, createPitchDetector(),
+                smoothLevel, decimationFactor));
+    }
+
+    if (channelsCount > 1) {
+        channelsBuffers.assign((size_t) channelsCount, std::vector<int16_t>((size_t) maximumChannelBufferSize));
+        for (auto& buffer : channelsBuffers) {
+            channelsBuffersData.push_back(buffer.data());
+        }
+    }
+
+    if (workerThreadsCount < 0) {
+        int concurrency = std::max(int(std::thread::hardware_concurrency()), 1);
+        workerThreadsCount = std::min(channelsCount, concurrency) - 1;
+    }
+    workerPool.reset(new WorkerPool(workerThreadsCount));
+
+    processChannel = [this] (int channel) {
+        readers[channel]->operator()(channels[channel], framesCount);
+    };
+}
+
+MultiChannelPitchInputReader::MultiChannelPitchInputReader(AudioInputReader* audioInputReader,
+        const PitchDetectorFactory& createPitchDetector, int smoothLevel, int decimationFactor,
+        int workerThreadsCount) :
+        MultiChannelPitchInputReader(audioInputReader->getSampleRate(), audioInputReader->getNumberOfChannels(),
+                audioInputReader->getMaximumBufferSize(), createPitchDetector, smoothLevel, decimationFactor,
+                workerThreadsCount) {
+}
+
+void MultiChannelPitchInputReader::operator()(const int16_t* data, int size) {
+    int channelsCount = getChannelsCount();
+    if (channelsCount == 1) {
+        readers[0]->operator()(data, size);
+        return;
+    }
+
+    assert(size % channelsCount == 0);
+    int framesCount = size / channelsCount;
+    assert(framesCount <= channelsBuffers[0].size());
+    deinterleave(data, framesCount, channelsCount, channelsBuffersData.data());
+    processChannels(channelsBuffersData.data(), framesCount);
+}
+
+void MultiChannelPitchInputReader::processChannels(const int16_t* const* channels, int framesCount) {
+    int channelsCount = getChannelsCount();
+    if (channelsCount == 1) {
+        readers[0]->operator()(channels[0], framesCount);
+        return;
+    }
+
+    this->channels = channels;
+    this->framesCount = framesCount;
+    workerPool->run(channelsCount, processChannel);
+}
+
+void MultiChannelPitchInputReader::startDetectionThread(int queueCapacity) {
+    assert(queueCapacity > 0 && !detectionThread.joinable());
+    this->queueCapacity = queueCapacity;
+    queue.resize(size_t(queueCapacity) * getChannelsCount() * maximumChannelBufferSize);
+    queuedFramesCounts.resize(size_t(queueCapacity));
+    queuedChannels.resize(size_t(getChannelsCount()));
+    detectionThread = std::thread([this] {
+        detectionLoop();
+    });
+}
+
+int16_t* MultiChannelPitchInputReader::getQueueSlotChannel(uint64_t blockIndex, int channel) {
+    size_t slot = size_t(blockIndex % queueCapacity);
+    return queue.data() + (slot * getChannelsCount() + channel) * maximumChannelBufferSize;
+}
+
+void MultiChannelPitchInputReader::enqueueChannels(const int16_t* const* channels, int framesCount) {
+    assert(detectionThread.joinable() && "call startDetectionThread before");
+    assert(framesCount <= maximumChannelBufferSize);
+    uint64_t queued = queuedBlocksCount.load(std::memory_order_relaxed);
+    uint64_t processed = processedBlocksCount.load(std::memory_order_acquire);
+    if (queued - processed >= uint64_t(queueCapacity)) {
+        droppedBlocksCount++;
+        return;
+    }
+
+    for (int channel = 0; channel < getChannelsCount(); ++channel) {
+        std::copy(channels[channel], channels[channel] + framesCount, getQueueSlotChannel(queued, channel));
+    }
+    queuedFramesCounts[queued % queueCapacity] = framesCount;
+    queuedBlocksCount.store(queued + 1, std::memory_order_release);
+    blockQueued.notify_one();
+}
+
+void MultiChannelPitchInputReader::detectionLoop() {
+    uint64_t processed = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(detectionMutex);
+            blockQueued.wait_for(lock, MAX_DETECTION_WAIT_TIME, [&] {
+                return detectionStopped || queuedBlocksCount.load(std::memory_order_acquire) != processed;
+            });
+            if (detectionStopped) {
+                return;
+            }
+        }
+
+        uint64_t queued = queuedBlocksCount.load(std::memory_order_acquire);
+        for (; processed < queued; ++processed) {
+            for (int channel = 0; channel < getChannelsCount(); ++channel) {
+                queuedChannels[channel] = getQueueSlotChannel(processed, channel);
+            }
+            processChannels(queuedChannels.data(), queuedFramesCounts[processed % queueCapacity]);
+            processedBlocksCount.store(processed + 1, std::memory_order_release);
+        }
+        // Taking the mutex orders the notification after the check of a waiting thread
+        {
+            std::lock_guard<std::mutex> _(detectionMutex);
+        }
+        blockProcessed.notify_all();
+    }
+}
+
+void MultiChannelPitchInputReader::waitForQueuedBlocks() {
+    uint64_t queued = queuedBlocksCount.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(detectionMutex);
+    blockProcessed.wait(lock, [&] {
+        return processedBlocksCount.load(std::memory_order_acquire) >= queued;
+    });
+}
+
+int64_t MultiChannelPitchInputReader::getDroppedBlocksCount() const {
+    return droppedBlocksCount;
+}
+
+MultiChannelPitchInputReader::~MultiChannelPitchInputReader() {
+    if (detectionThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> _(detectionMutex);
+            detectionStopped = true;
+        }
+        blockQueued.notify_one();
+        detectionThread.join();
+    }
+}
+
+void MultiChannelPitchInputReader::deinterleave(const int16_t* data, int framesCount, int channelsCount,
+        int16_t* const* outputs) {
+    if (channelsCount == 2) {
+        int16_t* left = outputs[0];
+        int16_t* right = outputs[1];
+        for (int i = 0; i < framesCount; ++i) {
+            left[i] = data[2 * i];
+            right[i] = data[2 * i + 1];
+        }
+        return;
+    }
+
+    for (int channel = 0; channel < channelsCount; ++channel) {
+        int16_t* output = outputs[channel];
+        const int16_t* input = data + channel;
+        for (int i = 0; i < framesCount; ++i) {
+            output[i] = input[i * channelsCount];
+        }
+    }
+}
+
+int MultiChannelPitchInputReader::getChannelsCount() const {
+    return int(readers.size());
+}
+
+PitchInputReader* MultiChannelPitchInputReader::getChannelReader(int channel) const {
+    assert(channel >= 0 && channel < readers.size());
+    return readers[channel].get();
+}
+
+int MultiChannelPitchInputReader::getWorkerThreadsCount() const {
+    return workerPool->getThreadsCount();
+}
+
+void MultiChannelPitchInputReader::setExecuteCallBackOnInvalidPitches(bool executeCallBackOnInvalidPitches) {
+    for (const auto& reader : readers) {
+        reader->setExecuteCallBackOnInvalidPitches(executeCallBackOnInvalidPitches);
+    }
+}
+
+void MultiChannelPitchInputReader::setVoicingGateEnabled(bool voicingGateEnabled) {
+    for (const auto& reader : readers) {
+        reader->setVoicingGateEnabled(voicingGateEnabled);
+    }
+}
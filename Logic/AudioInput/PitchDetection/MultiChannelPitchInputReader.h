@@ -0,0 +1,89 @@
+#ifndef VOCALTRAINER_MULTICHANNELPITCHINPUTREADER_H
+#define VOCALTRAINER_MULTICHANNELPITCHINPUTREADER_H
+
+#include "PitchInputReader.h"
+#include "WorkerPool.h"
+#include <vector>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// Tracks the pitch of every channel of an interleaved input independently, e.g. for duets or a teacher and
+// a student singing into one interface. Every channel has its own PitchInputReader and detector, the channels of
+// a callback are processed in parallel on a WorkerPool, so the callback takes about the time of a single channel.
+// A mono input is passed to its reader as is.
+// The audio thread shouldn't wait for the detection, it calls enqueueChannels instead: the channels are copied into
+// a lock free single producer single consumer queue of blocks, the detection thread started by
+// startDetectionThread takes them from the queue and runs the readers and the WorkerPool.
+class MultiChannelPitchInputReader {
+public:
+    typedef std::function<PitchDetector*()> PitchDetectorFactory;
+
+private:
+    std::vector<std::unique_ptr<PitchInputReader>> readers;
+    std::vector<std::vector<int16_t>> channelsBuffers;
+    std::vector<int16_t*> channelsBuffersData;
+    std::unique_ptr<WorkerPool> workerPool;
+    int framesCount = 0;
+    const int16_t* const* channels = nullptr;
+    std::function<void(int)> processChannel;
+
+    // Queued blocks of maximumChannelBufferSize samples per channel, the slot is the block counter % capacity
+    int maximumChannelBufferSize = 0;
+    int queueCapacity = 0;
+    std::vector<int16_t> queue;
+    std::vector<int> queuedFramesCounts;
+    std::vector<const int16_t*> queuedChannels;
+    std::atomic<uint64_t> queuedBlocksCount;
+    std::atomic<uint64_t> processedBlocksCount;
+    std::atomic<int64_t> droppedBlocksCount;
+    std::thread detectionThread;
+    std::mutex detectionMutex;
+    std::condition_variable blockQueued;
+    std::condition_variable blockProcessed;
+    bool detectionStopped = false;
+
+    int16_t* getQueueSlotChannel(uint64_t blockIndex, int channel);
+    void detectionLoop();
+
+public:
+    // maximumBufferSize is in samples of all the channels. The worker pool has min(channelsCount,
+    // hardware concurrency) - 1 threads, if workerThreadsCount is negative.
+    MultiChannelPitchInputReader(int sampleRate, int channelsCount, int maximumBufferSize,
+            const PitchDetectorFactory& createPitchDetector, int smoothLevel, int decimationFactor = 1,
+            int workerThreadsCount = -1);
+    MultiChannelPitchInputReader(AudioInputReader* audioInputReader,
+            const PitchDetectorFactory& createPitchDetector, int smoothLevel, int decimationFactor = 1,
+            int workerThreadsCount = -1);
+
+    // size is the number of samples of all the channels
+    void operator()(const int16_t* data, int size);
+    // Already deinterleaved input, framesCount samples per channel
+    void processChannels(const int16_t* const* channels, int framesCount);
+
+    // Starts the thread processing the blocks of enqueueChannels, the queue keeps up to queueCapacity blocks
+    void startDetectionThread(int queueCapacity = 16);
+    // Doesn't lock or allocate, so it's called from the audio thread. The block is dropped if the queue is full.
+    void enqueueChannels(const int16_t* const* channels, int framesCount);
+    // Blocks until the detection thread has processed the queued blocks
+    void waitForQueuedBlocks();
+    int64_t getDroppedBlocksCount() const;
+
+    int getChannelsCount() const;
+    // Callbacks of the channel readers are executed on the worker threads and the detection thread
+    PitchInputReader* getChannelReader(int channel) const;
+    int getWorkerThreadsCount() const;
+
+    void setExecuteCallBackOnInvalidPitches(bool executeCallBackOnInvalidPitches);
+    void setVoicingGateEnabled(bool voicingGateEnabled);
+
+    static void deinterleave(const int16_t* data, int framesCount, int channelsCount, int16_t* const* outputs);
+
+    ~MultiChannelPitchInputReader();
+};
+
+
+#endif //VOCALTRAINER_MULTICHANNELPITCHINPUTREADER_H
@@ -12,6 +12,8 @@ class PitchDetector {
 public:
     virtual void init(int maxBufferSize, int sampleRate) = 0;
     virtual float getFrequencyFromBuffer(const int16_t *buffer) = 0;
+    // Forgets the state kept between the buffers, e.g. when the buffers stop being analyzed for a while
+    virtual void reset() {}
     virtual ~PitchDetector() = default;
 };
 
@@ -0,0 +1,210 @@
+#include "PitchDetectorFactory.h"
+#include "YinPitchDetector.h"
+#include "MpmPitchDetector.h"
+#include "ProbabilisticYinPitchDetector.h"
+#include <mutex>
+#include <stdexcept>
+#include <cstdlib>
+
+#if defined(__APPLE__) && !defined(NO_SEVAGH_PITCH_DETECTOR)
+#define SEVAGH_PITCH_DETECTOR
+#include "SevaghPitchDetector.h"
+#endif
+
+#define LOCK std::lock_guard<std::mutex> _(registry.mutex)
+
+namespace {
+    struct Registry {
+        std::mutex mutex;
+        std::map<std::string, PitchDetectorFactory::Engine> engines;
+    };
+}
+
+// NaN settings fail all the checks
+static void CheckTunable(bool valid, const std::string& engineName, const std::string& range) {
+    if (!valid) {
+        throw std::invalid_argument("Pitch detector engine " + engineName + " requires " + range);
+    }
+}
+
+static void CheckFrequencies(const std::string& engineName, float minFrequency, float maxFrequency) {
+    CheckTunable(minFrequency > 0, engineName, "minFrequency > 0");
+    CheckTunable(maxFrequency > minFrequency, engineName, "maxFrequency > minFrequency");
+}
+
+static void RegisterBuiltInEngines(Registry& registry) {
+    YinPitchDetector::Settings yin;
+    registry.engines["yin"] = {
+            "yin",
+            "YIN with an absolute threshold, the cheapest",
+            {
+                    {"threshold", yin.threshold, "absolute threshold of the normalized difference"},
+                    {"minFrequency", yin.minFrequency, "Hz"},
+                    {"maxFrequency", yin.maxFrequency, "Hz"},
+            },
+            [] (const PitchDetectorSettings& settings) -> PitchDetector* {
+                YinPitchDetector::Settings yin;
+                yin.threshold = settings.at("threshold");
+                yin.minFrequency = settings.at("minFrequency");
+                yin.maxFrequency = settings.at("maxFrequency");
+                CheckTunable(yin.threshold > 0 && yin.threshold <= 1, "yin", "0 < threshold <= 1");
+                CheckFrequencies("yin", yin.minFrequency, yin.maxFrequency);
+                return new YinPitchDetector(yin);
+            }
+    };
+
+    MpmPitchDetector::Settings mpm;
+    registry.engines["mpm"] = {
+            "mpm",
+            "McLeod pitch method, fewer octave errors on the bright voices",
+            {
+                    {"cutoff", mpm.cutoff, "share of the highest key maximum the period should reach"},
+                    {"smallCutoff", mpm.smallCutoff, "key maxima below are ignored"},
+                    {"minFrequency", mpm.minFrequency, "Hz"},
+                    {"maxFrequency", mpm.maxFrequency, "Hz"},
+            },
+            [] (const PitchDetectorSettings& settings) -> PitchDetector* {
+                MpmPitchDetector::Settings mpm;
+                mpm.cutoff = settings.at("cutoff");
+                mpm.smallCutoff = settings.at("smallCutoff");
+                mpm.minFrequency = settings.at("minFrequency");
+                mpm.maxFrequency = settings.at("maxFrequency");
+                CheckTunable(mpm.cutoff > 0 && mpm.cutoff <= 1, "mpm", "0 < cutoff <= 1");
+                CheckTunable(mpm.smallCutoff >= 0 && mpm.smallCutoff < 1, "mpm", "0 <= smallCutoff < 1");
+                CheckFrequencies("mpm", mpm.minFrequency, mpm.maxFrequency);
+                return new MpmPitchDetector(mpm);
+            }
+    };
+
+    ProbabilisticYinPitchDetector::Settings pyin;
+    registry.engines["pyin"] = {
+            "pyin",
+            "Probabilistic YIN with an online pitch tracking HMM, the most stable and the most expensive",
+            {
+                    {"minFrequency", pyin.minFrequency, "Hz"},
+                    {"maxFrequency", pyin.maxFrequency, "Hz"},
+                    {"thresholdMean", pyin.thresholdMean, "mean of the thresholds beta distribution"},
+                    {"voicedTrust", pyin.voicedTrust, "share of the candidates probability trusted to be voiced"},
+                    {"voicingStayProbability", pyin.voicingStayProbability,
+                            "probability to keep the voicing in the next frame"},
+                    {"maxStepSemitones", pyin.maxStepSemitones, "the largest gradual pitch change between two frames"},
+                    {"jumpProbability", pyin.jumpProbability, "probability of a jump to any pitch"},
+                    {"binCents", pyin.binCents, "pitch resolution of the HMM states"},
+            },
+            [] (const PitchDetectorSettings& settings) -> PitchDetector* {
+                ProbabilisticYinPitchDetector::Settings pyin;
+                pyin.minFrequency = settings.at("minFrequency");
+                pyin.maxFrequency = settings.at("maxFrequency");
+                pyin.thresholdMean = settings.at("thresholdMean");
+                pyin.voicedTrust = settings.at("voicedTrust");
+                pyin.voicingStayProbability = settings.at("voicingStayProbability");
+                pyin.maxStepSemitones = settings.at("maxStepSemitones");
+                pyin.jumpProbability = settings.at("jumpProbability");
+                pyin.binCents = settings.at("binCents");
+                CheckFrequencies("pyin", pyin.minFrequency, pyin.maxFrequency);
+                CheckTunable(pyin.thresholdMean > 0 && pyin.thresholdMean < 1, "pyin", "0 < thresholdMean < 1");
+                CheckTunable(pyin.voicedTrust >= 0 && pyin.voicedTrust <= 1, "pyin", "0 <= voicedTrust <= 1");
+                CheckTunable(pyin.voicingStayProbability >= 0 && pyin.voicingStayProbability <= 1, "pyin",
+                        "0 <= voicingStayProbability <= 1");
+                CheckTunable(pyin.maxStepSemitones > 0, "pyin", "maxStepSemitones > 0");
+                CheckTunable(pyin.jumpProbability >= 0 && pyin.jumpProbability <= 1, "pyin",
+                        "0 <= jumpProbability <= 1");
+                CheckTunable(pyin.binCents > 0, "pyin", "binCents > 0");
+                return new ProbabilisticYinPitchDetector(pyin);
+            }
+    };
+
+#ifdef SEVAGH_PITCH_DETECTOR
+    // The former default, kept for comparison
+    registry.engines["sevagh-yin"] = {
+            "sevagh-yin",
+            "YIN of the bundled Sevagh pitch detection library",
+            {},
+            [] (const PitchDetectorSettings&) -> PitchDetector* {
+                return new SevaghPitchDetector();
+            }
+    };
+#endif
+}
+
+static Registry& GetRegistry() {
+    static Registry registry;
+    static std::once_flag builtInEnginesRegistered;
+    std::call_once(builtInEnginesRegistered, [] {
+        RegisterBuiltInEngines(registry);
+    });
+    return registry;
+}
+
+void PitchDetectorFactory::registerEngine(const Engine& engine) {
+    Registry& registry = GetRegistry();
+    LOCK;
+    registry.engines[engine.name] = engine;
+}
+
+PitchDetectorFactory::Engine PitchDetectorFactory::getEngine(const std::string& engineName) {
+    Registry& registry = GetRegistry();
+    LOCK;
+    auto iter = registry.engines.find(engineName);
+    if (iter == registry.engines.end()) {
+        throw std::invalid_argument("Pitch detector engine " + engineName + " is not registered");
+    }
+    return iter->second;
+}
+
+PitchDetector* PitchDetectorFactory::create(const std::string& engineName, const PitchDetectorSettings& settings) {
+    Engine engine = getEngine(engineName);
+    PitchDetectorSettings completeSettings;
+    for (const Tunable& tunable : engine.tunables) {
+        completeSettings[tunable.name] = tunable.defaultValue;
+    }
+
+    for (const auto& setting : settings) {
+        auto iter = completeSettings.find(setting.first);
+        if (iter == completeSettings.end()) {
+            throw std::invalid_argument("Pitch detector engine " + engineName + " has no tunable " + setting.first);
+        }
+        iter->second = setting.second;
+    }
+
+    return engine.creator(completeSettings);
+}
+
+std::vector<std::string> PitchDetectorFactory::getEngineNames() {
+    Registry& registry = GetRegistry();
+    LOCK;
+    std::vector<std::string> result;
+    for (const auto& engine : registry.engines) {
+        result.push_back(engine.first);
+    }
+    return result;
+}
+
+PitchDetectorSettings PitchDetectorFactory::parseSettings(const std::string& string) {
+    PitchDetectorSettings settings;
+    size_t begin = 0;
+    while (begin < string.size()) {
+        size_t end = string.find(',', begin);
+        if (end == std::string::npos) {
+            end = string.size();
+        }
+
+        std::string setting = string.substr(begin, end - begin);
+        size_t equalsPosition = setting.find('=');
+        if (equalsPosition == std::string::npos || equalsPosition == 0) {
+            throw std::invalid_argument("Invalid pitch detector setting " + setting);
+        }
+
+        std::string value = setting.substr(equalsPosition + 1);
+        char* valueEnd = nullptr;
+        float parsedValue = strtof(value.c_str(), &valueEnd);
+        if (value.empty() || *valueEnd != '\0') {
+            throw std::invalid_argument("Invalid pitch detector setting value " + setting);
+        }
+
+        settings[setting.substr(0, equalsPosition)] = parsedValue;
+        begin = end + 1;
+    }
+
+    return settings;
+}
@@ -0,0 +1,50 @@
+#ifndef VOCALTRAINER_PITCHDETECTORFACTORY_H
+#define VOCALTRAINER_PITCHDETECTORFACTORY_H
+
+#include "PitchDetector.h"
+#include <map>
+#include <string>
+#include <vector>
+#include <functional>
+
+// Tunable name -> value
+typedef std::map<std::string, float> PitchDetectorSettings;
+
+// Registry of the pitch detection engines, so the engine and its tunables are chosen at runtime, e.g. from
+// the preferences or a command line. The built-in engines are "yin", "mpm" and "pyin".
+class PitchDetectorFactory {
+public:
+    static constexpr const char* DEFAULT_ENGINE = "yin";
+
+    struct Tunable {
+        std::string name;
+        float defaultValue;
+        std::string description;
+    };
+
+    // The settings contain all the tunables of the engine, the ones not given to create have their defaults.
+    // Throws std::invalid_argument if a tunable is out of its range.
+    typedef std::function<PitchDetector*(const PitchDetectorSettings& settings)> Creator;
+
+    struct Engine {
+        std::string name;
+        std::string description;
+        std::vector<Tunable> tunables;
+        Creator creator;
+    };
+
+    // Replaces the engine with the same name
+    static void registerEngine(const Engine& engine);
+    // Throws std::invalid_argument if the engine is not registered, a setting is not its tunable or is out of range
+    static PitchDetector* create(const std::string& engineName, const PitchDetectorSettings& settings = {});
+    // Sorted by name
+    static std::vector<std::string> getEngineNames();
+    // Throws std::invalid_argument if the engine is not registered
+    static Engine getEngine(const std::string& engineName);
+
+    // Parses "name=value,name=value", throws std::invalid_argument if it is malformed
+    static PitchDetectorSettings parseSettings(const std::string& string);
+};
+
+
+#endif //VOCALTRAINER_PITCHDETECTORFACTORY_H
@@ -9,11 +9,37 @@
 using namespace CppUtils;
 
 void PitchInputReader::operator()(const int16_t* buffer, int size) {
+    bool gateEnabled = voicingGateEnabled.load(std::memory_order_relaxed);
+    if (gateEnabled && !voicingGateApplied) {
+        voicingGate.reset();
+    }
+    voicingGateApplied = gateEnabled;
+    // The gate sees every piece, so it knows whether the window contains a voiced one
+    bool voiceMayBePresent = !gateEnabled || voicingGate.process(buffer, size);
+    if (decimator.getFactor() > 1) {
+        size = decimator.process(buffer, size, decimatedBuffer.data());
+        buffer = decimatedBuffer.data();
+    }
     buffer = smoothingAudioBuffer.getRunPitchDetectionBufferIfReady(buffer, (size_t) size);
     if (!buffer) {
         return;
     }
 
+    if (!voiceMayBePresent) {
+        // The state tracked by the detector is stale when the voice comes back
+        if (!voicingGateClosed) {
+            pitchDetector->reset();
+            voicingGateClosed = true;
+        }
+        skippedFramesCount++;
+        if (executeCallBackOnInvalidPitches && callback) {
+            callback(Pitch(-1));
+        }
+        return;
+    }
+
+    voicingGateClosed = false;
+    processedFramesCount++;
     float frequency = pitchDetector->getFrequencyFromBuffer(buffer);
     if (frequency > 0) {
         lastDetectedPitch = Pitch(frequency);
@@ -25,11 +51,25 @@ void PitchInputReader::operator()(const int16_t* buffer, int size) {
     }
 }
 
-PitchInputReader::PitchInputReader(AudioInputReader* audioInputReader, PitchDetector* pitchDetector, int smoothLevel) :
+PitchInputReader::PitchInputReader(AudioInputReader* audioInputReader, PitchDetector* pitchDetector, int smoothLevel,
+        int decimationFactor) :
+        PitchInputReader(audioInputReader->getSampleRate(), audioInputReader->getMaximumBufferSize(), pitchDetector,
+                smoothLevel, decimationFactor) {
+}
+
+PitchInputReader::PitchInputReader(int sampleRate, int maximumBufferSize, PitchDetector* pitchDetector,
+        int smoothLevel, int decimationFactor) :
         pitchDetector(pitchDetector),
-        smoothingAudioBuffer((size_t) smoothLevel, (size_t) audioInputReader->getMaximumBufferSize()) {
-    int sampleRate = audioInputReader->getSampleRate();
-    pitchDetector->init(audioInputReader->getMaximumBufferSize() * smoothLevel, sampleRate);
+        decimator(decimationFactor),
+        decimatedBuffer((size_t) decimator.getMaxOutputSize(maximumBufferSize)),
+        smoothingAudioBuffer((size_t) smoothLevel, decimatedBuffer.size()),
+        voicingGateEnabled(true),
+        processedFramesCount(0),
+        skippedFramesCount(0) {
+    pitchDetectionSampleRate = sampleRate / decimationFactor;
+    pitchDetector->init(int(decimatedBuffer.size()) * smoothLevel, pitchDetectionSampleRate);
+    // The gate works on the full rate pieces, the crossing rates are known for them
+    voicingGate.init(sampleRate, smoothLevel);
 }
 
 PitchInputReader::~PitchInputReader() {
@@ -54,3 +94,31 @@ void PitchInputReader::setExecuteCallBackOnInvalidPitches(bool executeCallBackOn
 PitchDetector* PitchInputReader::getPitchDetector() const {
     return pitchDetector.get();
 }
+
+bool PitchInputReader::isVoicingGateEnabled() const {
+    return voicingGateEnabled.load(std::memory_order_relaxed);
+}
+
+void PitchInputReader::setVoicingGateEnabled(bool voicingGateEnabled) {
+    this->voicingGateEnabled.store(voicingGateEnabled, std::memory_order_relaxed);
+}
+
+VoicingGate& PitchInputReader::getVoicingGate() {
+    return voicingGate;
+}
+
+int64_t PitchInputReader::getProcessedFramesCount() const {
+    return processedFramesCount;
+}
+
+int64_t PitchInputReader::getSkippedFramesCount() const {
+    return skippedFramesCount;
+}
+
+int PitchInputReader::getDecimationFactor() const {
+    return decimator.getFactor();
+}
+
+int PitchInputReader::getPitchDetectionSampleRate() const {
+    return pitchDetectionSampleRate;
+}
@@ -10,26 +10,60 @@
 #include "Pitch.h"
 #include "PitchDetector.h"
 #include "PitchDetectionSmoothingAudioBuffer.h"
+#include "VoicingGate.h"
+#include "Decimator.h"
 #include <memory>
+#include <atomic>
 
 class PitchInputReader {
     std::unique_ptr<PitchDetector> pitchDetector;
     std::function<void(Pitch)> callback;
     Pitch lastDetectedPitch;
+    Decimator decimator;
+    std::vector<int16_t> decimatedBuffer;
     PitchDetectionSmoothingAudioBuffer smoothingAudioBuffer;
     bool executeCallBackOnInvalidPitches = false;
+    VoicingGate voicingGate;
+    // Set from any thread, applied by the audio thread
+    std::atomic<bool> voicingGateEnabled;
+    // Owned by the audio thread
+    bool voicingGateApplied = true;
+    bool voicingGateClosed = false;
+    // Read from any thread
+    std::atomic<int64_t> processedFramesCount;
+    std::atomic<int64_t> skippedFramesCount;
+    int pitchDetectionSampleRate;
 public:
-    PitchInputReader(AudioInputReader* audioInputReader, PitchDetector* pitchDetector, int smoothLevel);
+    // The input is decimated by decimationFactor before the pitch detection, the detector and the smoothing buffer
+    // work at the reduced sample rate then
+    PitchInputReader(AudioInputReader* audioInputReader, PitchDetector* pitchDetector, int smoothLevel,
+            int decimationFactor = 1);
+    // maximumBufferSize is in samples of the mono input given to operator()
+    PitchInputReader(int sampleRate, int maximumBufferSize, PitchDetector* pitchDetector, int smoothLevel,
+            int decimationFactor = 1);
     void operator()(const int16_t* data, int size);
 
     void setCallback(const std::function<void(Pitch)>& callback);
     const Pitch &getLastDetectedPitch() const;
 
     PitchDetector* getPitchDetector() const;
+    int getDecimationFactor() const;
+    // Sample rate the pitch detector works at
+    int getPitchDetectionSampleRate() const;
 
     bool willExecuteCallBackOnInvalidPitches() const;
     void setExecuteCallBackOnInvalidPitches(bool executeCallBackOnInvalidPitches);
 
+    // The detection windows without voice are reported as invalid pitches without running the pitch detector,
+    // enabled by default. The pitch detector is reset when the gate closes, so its tracking starts over with the
+    // next voiced window. Can be called from any thread, the gate is reset by the audio thread when it's enabled.
+    bool isVoicingGateEnabled() const;
+    void setVoicingGateEnabled(bool voicingGateEnabled);
+    VoicingGate& getVoicingGate();
+    // Detection windows analyzed by the pitch detector and skipped by the voicing gate
+    int64_t getProcessedFramesCount() const;
+    int64_t getSkippedFramesCount() const;
+
     ~PitchInputReader();
 };
 
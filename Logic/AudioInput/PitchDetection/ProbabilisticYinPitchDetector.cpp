@@ -0,0 +1,187 @@
+#include "ProbabilisticYinPitchDetector.h"
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+static constexpr int THRESHOLDS_COUNT = 100;
+static constexpr float THRESHOLDS_STEP = 0.01f;
+// Alpha of the thresholds beta distribution, beta is derived from the mean
+static constexpr float THRESHOLD_DISTRIBUTION_ALPHA = 2;
+// Weight of the global minimum when no dip is below a threshold
+static constexpr float GLOBAL_MINIMUM_PROBABILITY = 0.01f;
+
+ProbabilisticYinPitchDetector::ProbabilisticYinPitchDetector() : ProbabilisticYinPitchDetector(Settings()) {
+}
+
+ProbabilisticYinPitchDetector::ProbabilisticYinPitchDetector(const Settings& settings) : settings(settings) {
+    assert(settings.thresholdMean > 0 && settings.thresholdMean < 1);
+    assert(settings.binCents > 0 && settings.maxStepSemitones > 0);
+    assert(settings.jumpProbability >= 0 && settings.jumpProbability <= 1);
+}
+
+void ProbabilisticYinPitchDetector::init(int maxBufferSize, int sampleRate) {
+    initYin(maxBufferSize, sampleRate, settings.minFrequency, settings.maxFrequency);
+    prefixMinimums.resize(yinBuffer.size());
+
+    float alpha = THRESHOLD_DISTRIBUTION_ALPHA;
+    float beta = alpha / settings.thresholdMean - alpha;
+    thresholds.resize(THRESHOLDS_COUNT);
+    thresholdProbabilities.resize(THRESHOLDS_COUNT);
+    float sum = 0;
+    for (int i = 0; i < THRESHOLDS_COUNT; ++i) {
+        float threshold = (i + 1) * THRESHOLDS_STEP;
+        thresholds[i] = threshold;
+        thresholdProbabilities[i] = powf(threshold, alpha - 1) * powf(1 - threshold, beta - 1);
+        sum += thresholdProbabilities[i];
+    }
+    for (float& probability : thresholdProbabilities) {
+        probability /= sum;
+    }
+
+    binsCount = getBin(settings.maxFrequency) + 1;
+    maxStepBins = std::max(1, int(settings.maxStepSemitones * 100 / settings.binCents));
+    stepWeights.resize(static_cast<size_t>(maxStepBins + 1));
+    float weightsSum = 0;
+    for (int step = -maxStepBins; step <= maxStepBins; ++step) {
+        weightsSum += maxStepBins + 1 - abs(step);
+    }
+    for (int step = 0; step <= maxStepBins; ++step) {
+        stepWeights[step] = (maxStepBins + 1 - step) / weightsSum;
+    }
+
+    pathProbabilities.resize(static_cast<size_t>(binsCount * 2));
+    nextPathProbabilities.resize(pathProbabilities.size());
+    observations.resize(pathProbabilities.size());
+    reset();
+}
+
+void ProbabilisticYinPitchDetector::reset() {
+    std::fill(pathProbabilities.begin(), pathProbabilities.end(), 1.0f / pathProbabilities.size());
+}
+
+int ProbabilisticYinPitchDetector::getBin(float frequency) const {
+    float cents = 1200 * log2f(frequency / settings.minFrequency);
+    return int(roundf(cents / settings.binCents));
+}
+
+void ProbabilisticYinPitchDetector::collectCandidates() {
+    candidates.clear();
+    float minimum = yinBuffer[minTau];
+    int globalMinimumTau = minTau;
+    for (int tau = minTau; tau < maxTau; ++tau) {
+        if (yinBuffer[tau] < minimum) {
+            minimum = yinBuffer[tau];
+            globalMinimumTau = tau;
+        }
+        prefixMinimums[tau] = minimum;
+    }
+
+    auto addCandidate = [&] (int tau, float probability) {
+        for (Candidate& candidate : candidates) {
+            if (candidate.tau == tau) {
+                candidate.probability += probability;
+                return;
+            }
+        }
+        candidates.push_back({tau, probability, 0, 0});
+    };
+
+    // The first tau below a threshold is found by a binary search on the non increasing prefix minimums,
+    // then the dip is followed to its local minimum
+    auto begin = prefixMinimums.begin() + minTau;
+    auto end = prefixMinimums.begin() + maxTau;
+    for (int i = 0; i < THRESHOLDS_COUNT; ++i) {
+        float threshold = thresholds[i];
+        auto iter = std::partition_point(begin, end, [=] (float value) {
+            return value >= threshold;
+        });
+        if (iter == end) {
+            addCandidate(globalMinimumTau, thresholdProbabilities[i] * GLOBAL_MINIMUM_PROBABILITY);
+            continue;
+        }
+
+        int tau = int(iter - prefixMinimums.begin());
+        while (tau + 1 < maxTau && yinBuffer[tau + 1] < yinBuffer[tau]) {
+            tau++;
+        }
+        addCandidate(tau, thresholdProbabilities[i]);
+    }
+
+    for (Candidate& candidate : candidates) {
+        candidate.frequency = sampleRate / getRefinedTau(candidate.tau);
+        candidate.bin = std::max(0, std::min(binsCount - 1, getBin(candidate.frequency)));
+    }
+}
+
+// The transition is a mixture of the gradual step and the jump, its larger part is taken as the Viterbi maximum
+float ProbabilisticYinPitchDetector::getMaxTransitionFrom(int bin, int begin, float maxProbability) const {
+    int from = std::max(0, bin - maxStepBins);
+    int to = std::min(binsCount - 1, bin + maxStepBins);
+    float step = 0;
+    for (int i = from; i <= to; ++i) {
+        step = std::max(step, pathProbabilities[begin + i] * stepWeights[abs(i - bin)]);
+    }
+    float jump = settings.jumpProbability;
+    return std::max(step * (1 - jump), maxProbability * jump / binsCount);
+}
+
+float ProbabilisticYinPitchDetector::getFrequencyFromBuffer(const int16_t *buffer) {
+    bool hasSignal = computeYinBuffer(buffer);
+    if (hasSignal) {
+        collectCandidates();
+    } else {
+        candidates.clear();
+    }
+
+    float voicedProbability = 0;
+    std::fill(observations.begin(), observations.begin() + binsCount, 0.0f);
+    for (const Candidate& candidate : candidates) {
+        float probability = candidate.probability * settings.voicedTrust;
+        observations[candidate.bin] += probability;
+        voicedProbability += probability;
+    }
+    std::fill(observations.begin() + binsCount, observations.end(),
+            std::max(0.0f, 1 - voicedProbability) / binsCount);
+
+    // One Viterbi step, the voiced states without an observation stay at zero
+    float stay = settings.voicingStayProbability;
+    float maxVoiced = *std::max_element(pathProbabilities.begin(), pathProbabilities.begin() + binsCount);
+    float maxUnvoiced = *std::max_element(pathProbabilities.begin() + binsCount, pathProbabilities.end());
+    float sum = 0;
+    for (int bin = 0; bin < binsCount; ++bin) {
+        float fromVoiced = getMaxTransitionFrom(bin, 0, maxVoiced);
+        float fromUnvoiced = getMaxTransitionFrom(bin, binsCount, maxUnvoiced);
+        float voiced = 0;
+        if (observations[bin] > 0) {
+            voiced = std::max(fromVoiced * stay, fromUnvoiced * (1 - stay)) * observations[bin];
+        }
+        float unvoiced = std::max(fromUnvoiced * stay, fromVoiced * (1 - stay)) * observations[binsCount + bin];
+        nextPathProbabilities[bin] = voiced;
+        nextPathProbabilities[binsCount + bin] = unvoiced;
+        sum += voiced + unvoiced;
+    }
+
+    // Normalized to avoid the underflow, the model is reset if it still happens
+    if (sum > 0) {
+        for (float& probability : nextPathProbabilities) {
+            probability /= sum;
+        }
+        pathProbabilities.swap(nextPathProbabilities);
+    } else {
+        reset();
+    }
+
+    int bestState = int(std::max_element(pathProbabilities.begin(), pathProbabilities.end())
+            - pathProbabilities.begin());
+    if (bestState >= binsCount) {
+        return -1;
+    }
+
+    const Candidate* best = nullptr;
+    for (const Candidate& candidate : candidates) {
+        if (candidate.bin == bestState && (!best || candidate.probability > best->probability)) {
+            best = &candidate;
+        }
+    }
+    return best ? best->frequency : -1;
+}
@@ -0,0 +1,66 @@
+#ifndef VOCALTRAINER_PROBABILISTICYINPITCHDETECTOR_H
+#define VOCALTRAINER_PROBABILISTICYINPITCHDETECTOR_H
+
+#include "YinPitchDetector.h"
+
+// pYIN by Mauch and Dixon. Instead of a single threshold, YIN period candidates are collected over a beta
+// distribution of thresholds, and a hidden Markov model over pitch bins and voicing picks the candidate
+// continuing the previous frames best. It runs online: every frame reports the end of the best state path so far,
+// without waiting for the next frames, so it smooths less than the offline pYIN, but adds no latency.
+class ProbabilisticYinPitchDetector : public YinPitchDetector {
+public:
+    struct Settings {
+        float minFrequency = 60;
+        float maxFrequency = 1600;
+        // Mean of the beta distribution of the thresholds
+        float thresholdMean = 0.1f;
+        // Share of the candidates probability trusted to be voiced
+        float voicedTrust = 0.5f;
+        // Probability to stay voiced or unvoiced in the next frame
+        float voicingStayProbability = 0.99f;
+        // The largest gradual pitch change between two frames
+        float maxStepSemitones = 3;
+        // Probability of a jump to any pitch, e.g. to the next note
+        float jumpProbability = 0.01f;
+        float binCents = 20;
+    };
+
+    ProbabilisticYinPitchDetector();
+    explicit ProbabilisticYinPitchDetector(const Settings& settings);
+
+    void init(int maxBufferSize, int sampleRate) override;
+    float getFrequencyFromBuffer(const int16_t *buffer) override;
+    // Restarts the pitch tracking from the uniform state probabilities
+    void reset() override;
+
+private:
+    struct Candidate {
+        int tau;
+        float probability;
+        float frequency;
+        int bin;
+    };
+
+    Settings settings;
+    std::vector<float> thresholds;
+    std::vector<float> thresholdProbabilities;
+    // prefixMinimums[tau] = min(yinBuffer[minTau..tau])
+    std::vector<float> prefixMinimums;
+    std::vector<Candidate> candidates;
+
+    int binsCount = 0;
+    int maxStepBins = 0;
+    // Triangular weights of the pitch bin changes, [0, maxStepBins]
+    std::vector<float> stepWeights;
+    // Viterbi path probabilities, voiced states are [0, binsCount), unvoiced ones are [binsCount, 2 * binsCount)
+    std::vector<float> pathProbabilities;
+    std::vector<float> nextPathProbabilities;
+    std::vector<float> observations;
+
+    void collectCandidates();
+    int getBin(float frequency) const;
+    float getMaxTransitionFrom(int bin, int begin, float maxProbability) const;
+};
+
+
+#endif //VOCALTRAINER_PROBABILISTICYINPITCHDETECTOR_H
@@ -0,0 +1,91 @@
+#include "VoicingGate.h"
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+static constexpr float SILENCE_LEVEL_DB = -120;
+// The noise floor falls to a quieter piece this fast, per piece
+static constexpr float NOISE_FLOOR_FALL_RATE = 0.5f;
+
+VoicingGate::VoicingGate() : VoicingGate(Settings()) {
+}
+
+VoicingGate::VoicingGate(const Settings& settings) : settings(settings) {
+    assert(settings.openThresholdDb >= settings.closeThresholdDb);
+}
+
+void VoicingGate::init(int sampleRate, int holdPiecesCount) {
+    assert(sampleRate > 0 && holdPiecesCount >= 1);
+    this->sampleRate = sampleRate;
+    this->holdPiecesCount = holdPiecesCount;
+    reset();
+}
+
+VoicingGate::PieceFeatures VoicingGate::computeFeatures(const int16_t* data, int size) {
+    if (size <= 0) {
+        return {SILENCE_LEVEL_DB, 0};
+    }
+
+    int64_t sumOfSquares = 0;
+    int crossingsCount = 0;
+    bool previousNegative = data[0] < 0;
+    for (int i = 0; i < size; ++i) {
+        int32_t sample = data[i];
+        sumOfSquares += sample * sample;
+        bool negative = sample < 0;
+        crossingsCount += negative != previousNegative;
+        previousNegative = negative;
+    }
+
+    double meanSquare = double(sumOfSquares) / size / (32768.0 * 32768.0);
+    float levelDb = meanSquare > 0 ? std::max(SILENCE_LEVEL_DB, float(10 * log10(meanSquare))) : SILENCE_LEVEL_DB;
+    return {levelDb, float(crossingsCount) / size};
+}
+
+bool VoicingGate::process(const int16_t* data, int size) {
+    assert(sampleRate > 0 && "call init before");
+    lastPieceFeatures = computeFeatures(data, size);
+    float levelDb = lastPieceFeatures.levelDb;
+
+    if (levelDb < noiseFloorDb) {
+        noiseFloorDb += (levelDb - noiseFloorDb) * NOISE_FLOOR_FALL_RATE;
+    } else {
+        float rate = open ? settings.openNoiseFloorRiseDbPerSecond : settings.closedNoiseFloorRiseDbPerSecond;
+        noiseFloorDb = std::min(levelDb, noiseFloorDb + rate * size / sampleRate);
+    }
+
+    float openThreshold = std::max(noiseFloorDb + settings.openThresholdDb, settings.minLevelDb);
+    float closeThreshold = openThreshold - (settings.openThresholdDb - settings.closeThresholdDb);
+    if (open) {
+        open = levelDb >= closeThreshold;
+    } else {
+        open = levelDb >= openThreshold && lastPieceFeatures.zeroCrossingRate <= settings.maxZeroCrossingRate;
+    }
+
+    if (open) {
+        piecesSinceOpen = 0;
+    } else if (piecesSinceOpen < holdPiecesCount) {
+        piecesSinceOpen++;
+    }
+
+    return piecesSinceOpen < holdPiecesCount;
+}
+
+bool VoicingGate::isOpen() const {
+    return open;
+}
+
+float VoicingGate::getNoiseFloorDb() const {
+    return noiseFloorDb;
+}
+
+const VoicingGate::PieceFeatures& VoicingGate::getLastPieceFeatures() const {
+    return lastPieceFeatures;
+}
+
+void VoicingGate::reset() {
+    open = false;
+    noiseFloorDb = settings.minLevelDb - settings.openThresholdDb;
+    piecesSinceOpen = holdPiecesCount;
+    lastPieceFeatures = {SILENCE_LEVEL_DB, 0};
+}
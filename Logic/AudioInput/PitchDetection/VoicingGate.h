@@ -0,0 +1,58 @@
+#ifndef VOCALTRAINER_VOICINGGATE_H
+#define VOCALTRAINER_VOICINGGATE_H
+
+#include <cstdint>
+
+// Cheap stage before the pitch detection. The energy and the zero crossing rate of every input piece are computed
+// once, the gate opens when the level rises above the noise floor and the piece is not noise like, and closes
+// when the level falls back, with a hysteresis between the two thresholds. The noise floor starts at the lowest level
+// opening the gate, follows the quieter pieces quickly and rises slowly, slower while the gate is open, so it adapts to the room
+// without following a sustained note or a soft onset.
+// The gate stays open for holdPiecesCount pieces after the last open one, so a detection window is analyzed
+// while it contains any voiced piece.
+class VoicingGate {
+public:
+    struct Settings {
+        // dB above the noise floor to open and to close the gate
+        float openThresholdDb = 8;
+        float closeThresholdDb = 4;
+        // dBFS, the gate is closed below regardless of the noise floor
+        float minLevelDb = -60;
+        // Crossings per sample, the pieces above don't open the gate: white noise has 0.5, a sung vowel
+        // ~0.1, a vowel in the noise 10 dB below it ~0.35
+        float maxZeroCrossingRate = 0.45f;
+        // dB per second the noise floor rises while the level is above it
+        float closedNoiseFloorRiseDbPerSecond = 20;
+        float openNoiseFloorRiseDbPerSecond = 3;
+    };
+
+    struct PieceFeatures {
+        float levelDb;
+        float zeroCrossingRate;
+    };
+
+    VoicingGate();
+    explicit VoicingGate(const Settings& settings);
+
+    void init(int sampleRate, int holdPiecesCount);
+    // Returns true if the detection window ending with the piece may contain voice
+    bool process(const int16_t* data, int size);
+    static PieceFeatures computeFeatures(const int16_t* data, int size);
+
+    bool isOpen() const;
+    float getNoiseFloorDb() const;
+    const PieceFeatures& getLastPieceFeatures() const;
+    void reset();
+
+private:
+    Settings settings;
+    int sampleRate = 0;
+    int holdPiecesCount = 1;
+    int piecesSinceOpen = 0;
+    bool open = false;
+    float noiseFloorDb = 0;
+    PieceFeatures lastPieceFeatures = {-120, 0};
+};
+
+
+#endif //VOCALTRAINER_VOICINGGATE_H
@@ -0,0 +1,89 @@
+#include "WorkerPool.h"
+#include <cassert>
+
+WorkerPool::WorkerPool(int threadsCount) : nextTaskIndex(0) {
+    assert(threadsCount >= 0);
+    threads.reserve(threadsCount);
+    for (int i = 0; i < threadsCount; ++i) {
+        threads.emplace_back([this] {
+            workerLoop();
+        });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> _(mutex);
+        stopped = true;
+    }
+    batchStarted.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::runTasks(const std::function<void(int)>& task, int tasksCount) {
+    int taskIndex;
+    while ((taskIndex = nextTaskIndex++) < tasksCount) {
+        task(taskIndex);
+    }
+}
+
+void WorkerPool::workerLoop() {
+    int64_t lastBatchIndex = 0;
+    while (true) {
+        const std::function<void(int)>* batchTask;
+        int batchTasksCount;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            batchStarted.wait(lock, [&] {
+                return stopped || batchIndex != lastBatchIndex;
+            });
+            if (stopped) {
+                return;
+            }
+
+            lastBatchIndex = batchIndex;
+            batchTask = task;
+            batchTasksCount = tasksCount;
+        }
+
+        runTasks(*batchTask, batchTasksCount);
+
+        std::lock_guard<std::mutex> _(mutex);
+        if (++finishedWorkersCount == int(threads.size())) {
+            batchFinished.notify_one();
+        }
+    }
+}
+
+void WorkerPool::run(int tasksCount, const std::function<void(int)>& task) {
+    if (threads.empty() || tasksCount <= 1) {
+        for (int i = 0; i < tasksCount; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> _(mutex);
+        this->task = &task;
+        this->tasksCount = tasksCount;
+        nextTaskIndex = 0;
+        finishedWorkersCount = 0;
+        batchIndex++;
+    }
+    batchStarted.notify_all();
+
+    runTasks(task, tasksCount);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    batchFinished.wait(lock, [&] {
+        return finishedWorkersCount == int(threads.size());
+    });
+    this->task = nullptr;
+}
+
+int WorkerPool::getThreadsCount() const {
+    return int(threads.size());
+}
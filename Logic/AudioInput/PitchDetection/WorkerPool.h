@@ -0,0 +1,40 @@
+#ifndef VOCALTRAINER_WORKERPOOL_H
+#define VOCALTRAINER_WORKERPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+// Fixed set of threads running batches of indexed tasks, the thread calling run executes the tasks too and returns
+// when the whole batch is finished. Batches are run one at a time, run shouldn't be called concurrently.
+class WorkerPool {
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable batchStarted;
+    std::condition_variable batchFinished;
+    const std::function<void(int)>* task = nullptr;
+    int tasksCount = 0;
+    std::atomic<int> nextTaskIndex;
+    // Every worker takes part in every batch, so no worker is left in the previous batch when a new one starts
+    int finishedWorkersCount = 0;
+    int64_t batchIndex = 0;
+    bool stopped = false;
+
+    void workerLoop();
+    void runTasks(const std::function<void(int)>& task, int tasksCount);
+public:
+    // threadsCount additional threads, the tasks are executed on the calling thread only if it's 0
+    explicit WorkerPool(int threadsCount);
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    ~WorkerPool();
+
+    void run(int tasksCount, const std::function<void(int)>& task);
+    int getThreadsCount() const;
+};
+
+
+#endif //VOCALTRAINER_WORKERPOOL_H
@@ -0,0 +1,120 @@
+#include "YinPitchDetector.h"
+#include "AudioUtils.h"
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+using namespace CppUtils;
+
+static int NextPowerOfTwo(int value) {
+    int result = 4;
+    while (result < value) {
+        result *= 2;
+    }
+    return result;
+}
+
+YinPitchDetector::YinPitchDetector() : YinPitchDetector(Settings()) {
+}
+
+YinPitchDetector::YinPitchDetector(const Settings& settings) : settings(settings) {
+}
+
+void YinPitchDetector::init(int maxBufferSize, int sampleRate) {
+    initYin(maxBufferSize, sampleRate, settings.minFrequency, settings.maxFrequency);
+}
+
+void YinPitchDetector::initYin(int maxBufferSize, int sampleRate, float minFrequency, float maxFrequency) {
+    assert(maxBufferSize >= 8 && sampleRate > 0);
+    assert(minFrequency > 0 && maxFrequency > minFrequency);
+    bufferSize = maxBufferSize;
+    this->sampleRate = sampleRate;
+
+    int windowSize = bufferSize / 2;
+    // One more period on both sides is needed for the local minimum search and the interpolation
+    maxTau = std::min(windowSize - 1, int(ceil(sampleRate / minFrequency)) + 1);
+    minTau = std::max(2, std::min(maxTau - 1, int(sampleRate / maxFrequency) - 1));
+
+    // The correlation is circular, the window shifted by maxTau still fits the buffer, so no padding is needed
+    // beyond the power of 2
+    int fftSize = NextPowerOfTwo(bufferSize);
+    fft.reset(new RealFFT(fftSize));
+    samples.resize(static_cast<size_t>(bufferSize));
+    fftInput.assign(static_cast<size_t>(fftSize), 0.0f);
+    windowSpectrum.resize(static_cast<size_t>(fft->getSpectrumSize()));
+    samplesSpectrum.resize(static_cast<size_t>(fft->getSpectrumSize()));
+    correlation.resize(static_cast<size_t>(fftSize));
+    energyPrefixSums.resize(static_cast<size_t>(bufferSize + 1));
+    yinBuffer.resize(static_cast<size_t>(maxTau + 1));
+}
+
+bool YinPitchDetector::computeYinBuffer(const int16_t *buffer) {
+    AudioUtils::Int16SamplesIntoFloatSamples(buffer, bufferSize, samples.data());
+    int windowSize = bufferSize / 2;
+
+    energyPrefixSums[0] = 0;
+    for (int i = 0; i < bufferSize; ++i) {
+        energyPrefixSums[i + 1] = energyPrefixSums[i] + double(samples[i]) * samples[i];
+    }
+    double windowEnergy = energyPrefixSums[windowSize];
+    if (windowEnergy <= 0) {
+        return false;
+    }
+
+    // correlation[tau] = sum(x[j] * x[j + tau]), j < windowSize, as the inverse of conj(W) * X
+    std::copy(samples.begin(), samples.end(), fftInput.begin());
+    fft->forward(fftInput.data(), samplesSpectrum.data());
+    std::fill(fftInput.begin() + windowSize, fftInput.begin() + bufferSize, 0.0f);
+    fft->forward(fftInput.data(), windowSpectrum.data());
+    for (int i = 0; i < fft->getSpectrumSize(); ++i) {
+        samplesSpectrum[i] *= std::conj(windowSpectrum[i]);
+    }
+    fft->inverse(samplesSpectrum.data(), correlation.data());
+    float scale = 1.0f / fft->getSize();
+
+    // d(tau) = sum(x[j]^2) + sum(x[j + tau]^2) - 2 * correlation[tau], then normalized by its cumulative mean
+    yinBuffer[0] = 1;
+    double runningSum = 0;
+    for (int tau = 1; tau <= maxTau; ++tau) {
+        double shiftedEnergy = energyPrefixSums[tau + windowSize] - energyPrefixSums[tau];
+        double difference = std::max(0.0, windowEnergy + shiftedEnergy - 2.0 * correlation[tau] * scale);
+        runningSum += difference;
+        yinBuffer[tau] = runningSum > 0 ? float(difference * tau / runningSum) : 1.0f;
+    }
+
+    return true;
+}
+
+float YinPitchDetector::getRefinedTau(int tau) const {
+    if (tau <= 0 || tau >= maxTau) {
+        return tau;
+    }
+
+    float previous = yinBuffer[tau - 1];
+    float current = yinBuffer[tau];
+    float next = yinBuffer[tau + 1];
+    float denominator = previous + next - 2 * current;
+    if (denominator == 0) {
+        return tau;
+    }
+
+    float shift = (previous - next) / (2 * denominator);
+    return tau + std::max(-1.0f, std::min(1.0f, shift));
+}
+
+float YinPitchDetector::getFrequencyFromBuffer(const int16_t *buffer) {
+    if (!computeYinBuffer(buffer)) {
+        return -1;
+    }
+
+    for (int tau = minTau; tau < maxTau; ++tau) {
+        if (yinBuffer[tau] < settings.threshold) {
+            while (tau + 1 < maxTau && yinBuffer[tau + 1] < yinBuffer[tau]) {
+                tau++;
+            }
+            return sampleRate / getRefinedTau(tau);
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,53 @@
+#ifndef VOCALTRAINER_YINPITCHDETECTOR_H
+#define VOCALTRAINER_YINPITCHDETECTOR_H
+
+#include "PitchDetector.h"
+#include "RealFFT.h"
+#include <vector>
+#include <memory>
+
+// YIN by de Cheveigne and Kawahara. The first half of the buffer is the integration window, the correlation term
+// of the difference function is computed by a real FFT, the energy terms by prefix sums.
+class YinPitchDetector : public PitchDetector {
+public:
+    struct Settings {
+        // Absolute threshold of the cumulative mean normalized difference
+        float threshold = 0.2f;
+        // Hz, limit the searched periods
+        float minFrequency = 60;
+        float maxFrequency = 1600;
+    };
+
+    YinPitchDetector();
+    explicit YinPitchDetector(const Settings& settings);
+
+    void init(int maxBufferSize, int sampleRate) override;
+    float getFrequencyFromBuffer(const int16_t *buffer) override;
+
+protected:
+    int bufferSize = 0;
+    int sampleRate = 0;
+    int minTau = 0;
+    int maxTau = 0;
+    // Cumulative mean normalized difference, indexes [0, maxTau]
+    std::vector<float> yinBuffer;
+
+    void initYin(int maxBufferSize, int sampleRate, float minFrequency, float maxFrequency);
+    // Returns false if the buffer is silent
+    bool computeYinBuffer(const int16_t *buffer);
+    // Period in samples refined by the parabolic interpolation
+    float getRefinedTau(int tau) const;
+
+private:
+    Settings settings;
+    std::unique_ptr<RealFFT> fft;
+    std::vector<float> samples;
+    std::vector<float> fftInput;
+    std::vector<std::complex<float>> windowSpectrum;
+    std::vector<std::complex<float>> samplesSpectrum;
+    std::vector<float> correlation;
+    std::vector<double> energyPrefixSums;
+};
+
+
+#endif //VOCALTRAINER_YINPITCHDETECTOR_H
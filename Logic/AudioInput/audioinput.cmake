@@ -1,14 +1,24 @@
 set(pitchDetectionSources
         AubioPitchDetector.cpp
         AudioAverageInputLevelMonitor.cpp
-        Pitch.cpp
-        PitchDetectionSmoothingAudioBuffer.cpp
-        PitchInputReader.cpp
+        PitchDetection/PitchDetectionSmoothingAudioBuffer.cpp
+        PitchDetection/PitchInputReader.cpp
         AudioInputPitchesRecorder.cpp
         PortAudioInputReader.cpp
         AudioInputRecorder.cpp
-        PitchesMutableList.cpp
-        SeekablePitchesList.cpp
+        AudioInputGraph.cpp
+        DirectMonitor.cpp
+        PitchDetection/PitchDetectorFactory.cpp
+        PitchDetection/YinPitchDetector.cpp
+        PitchDetection/ProbabilisticYinPitchDetector.cpp
+        PitchDetection/MpmPitchDetector.cpp
+        PitchDetection/VoicingGate.cpp
+        PitchDetection/Decimator.cpp
+        PitchDetection/WorkerPool.cpp
+        PitchDetection/MultiChannelPitchInputReader.cpp
+        ../FFT/FFT.cpp
+        ../FFT/RealFFT.cpp
+        ../FFT/RadixTwoFFT.cpp
         )
 
 list(TRANSFORM pitchDetectionSources PREPEND ${CMAKE_CURRENT_LIST_DIR}/)
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef VOCALTRAINER_AUDIOTOOLBOXDUPLEXUNIT_H
+#define VOCALTRAINER_AUDIOTOOLBOXDUPLEXUNIT_H
+
+#include <AudioToolbox/AudioToolbox.h>
+#include "AudioStreamDescription.h"
+
+// Records and plays through a single I/O audio unit, RemoteIO on iOS and HAL output on macOS. The render callback
+// gets the input of a hardware cycle and fills the output of the same cycle, nothing is queued in between.
+// On macOS the default input and output devices are combined into a private aggregate device when they differ,
+// e.g. the built-in microphone and speakers or a USB microphone and headphones.
+class AudioToolboxDuplexUnit {
+public:
+    // data contains size input samples of all the channels, it's played as is after the callback returns
+    typedef void (*Callback)(void* userData, int16_t* data, int size);
+private:
+    AudioComponentInstance unit = NULL;
+    Callback callback;
+    void* userData;
+    AudioStreamDescription description;
+    // AudioObjectID of the aggregate device created on macOS, 0 if the input and the output device is the same
+    UInt32 aggregateDevice = 0;
+    // The I/O buffer size before start, the preferred duration of the session on iOS and the frames count of
+    // the device on macOS, it's restored on pause. Negative while the unit isn't running.
+    double previousBufferSize = -1;
+
+    static OSStatus HandleRender(void* inRefCon,
+            AudioUnitRenderActionFlags* ioActionFlags,
+            const AudioTimeStamp* inTimeStamp,
+            UInt32 inBusNumber,
+            UInt32 inNumberFrames,
+            AudioBufferList* ioData);
+
+    void requestBufferFramesCount();
+    void restoreBufferFramesCount();
+public:
+    // samplesPerBuffer of the description is the I/O buffer size in frames requested from the device while
+    // the unit is running, the device may choose another one.
+    // Throws AudioOperationFailedException if there is no input or output device or it can't be configured.
+    void init(const AudioStreamDescription& description, Callback callback, void* userData);
+    void start();
+    void pause();
+
+    // Delay between the input and the output in seconds: the device or the session latencies, an I/O buffer
+    // in each direction and the latency of the unit itself
+    double getLatency() const;
+
+    ~AudioToolboxDuplexUnit();
+};
+
+
+#endif //VOCALTRAINER_AUDIOTOOLBOXDUPLEXUNIT_H
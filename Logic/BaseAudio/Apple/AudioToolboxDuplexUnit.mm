@@ -0,0 +1,294 @@
+#include "AudioToolboxDuplexUnit.h"
+#include "AudioToolboxUtils.h"
+#include "AudioOperationFailedException.h"
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+#if TARGET_OS_IPHONE
+#import <AVFoundation/AVFoundation.h>
+#else
+#import <Foundation/Foundation.h>
+#include <CoreAudio/CoreAudio.h>
+#endif
+
+// Buses of an I/O unit
+static const AudioUnitElement OUTPUT_BUS = 0;
+static const AudioUnitElement INPUT_BUS = 1;
+
+#if !TARGET_OS_IPHONE
+template<typename T>
+static T GetProperty(AudioObjectID object, AudioObjectPropertySelector selector,
+        AudioObjectPropertyScope scope = kAudioObjectPropertyScopeGlobal) {
+    AudioObjectPropertyAddress address = {selector, scope, kAudioObjectPropertyElementMaster};
+    T value = T();
+    UInt32 size = sizeof(value);
+    auto status = AudioObjectGetPropertyData(object, &address, 0, NULL, &size, &value);
+    AudioToolboxUtils::throwExceptionIfError(status);
+    return value;
+}
+
+static void SetBufferFramesCount(AudioObjectID device, UInt32 framesCount) {
+    AudioObjectPropertyAddress address = {kAudioDevicePropertyBufferFrameSize, kAudioObjectPropertyScopeGlobal,
+            kAudioObjectPropertyElementMaster};
+    // The device keeps its buffer size if it doesn't support the requested one
+    AudioObjectSetPropertyData(device, &address, 0, NULL, sizeof(framesCount), &framesCount);
+}
+
+static int GetChannelsCount(AudioObjectID device, AudioObjectPropertyScope scope) {
+    AudioObjectPropertyAddress address = {kAudioDevicePropertyStreamConfiguration, scope,
+            kAudioObjectPropertyElementMaster};
+    UInt32 size = 0;
+    auto status = AudioObjectGetPropertyDataSize(device, &address, 0, NULL, &size);
+    AudioToolboxUtils::throwExceptionIfError(status);
+    // AudioBufferList has a variable size, uint64_t keeps its alignment
+    std::vector<uint64_t> data((size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    AudioBufferList* bufferList = reinterpret_cast<AudioBufferList*>(data.data());
+    status = AudioObjectGetPropertyData(device, &address, 0, NULL, &size, bufferList);
+    AudioToolboxUtils::throwExceptionIfError(status);
+
+    int channelsCount = 0;
+    for (UInt32 i = 0; i < bufferList->mNumberBuffers; ++i) {
+        channelsCount += bufferList->mBuffers[i].mNumberChannels;
+    }
+    return channelsCount;
+}
+
+static AudioDeviceID GetDefaultDevice(AudioObjectPropertySelector selector, AudioObjectPropertyScope scope) {
+    AudioDeviceID device = GetProperty<AudioDeviceID>(kAudioObjectSystemObject, selector);
+    if (device == kAudioObjectUnknown || GetChannelsCount(device, scope) == 0) {
+        throw AudioOperationFailedException(scope == kAudioObjectPropertyScopeInput ?
+                "No default input device" : "No default output device");
+    }
+    return device;
+}
+
+static AudioDeviceID GetCurrentDevice(AudioComponentInstance unit) {
+    AudioDeviceID device = kAudioObjectUnknown;
+    UInt32 size = sizeof(device);
+    auto status = AudioUnitGetProperty(unit, kAudioOutputUnitProperty_CurrentDevice, kAudioUnitScope_Global, 0,
+            &device, &size);
+    AudioToolboxUtils::throwExceptionIfError(status);
+    return device;
+}
+
+// A private aggregate device visible to this process only, the input device goes first, so its input channels
+// are the first channels of the aggregate. The output device clocks the aggregate, the input follows it.
+static AudioObjectID CreateAggregateDevice(AudioDeviceID inputDevice, AudioDeviceID outputDevice,
+        const void* owner) {
+    CFStringRef inputUID = GetProperty<CFStringRef>(inputDevice, kAudioDevicePropertyDeviceUID);
+    CFStringRef outputUID = GetProperty<CFStringRef>(outputDevice, kAudioDevicePropertyDeviceUID);
+    NSDictionary* description = @{
+        @kAudioAggregateDeviceUIDKey: [NSString stringWithFormat:@"VocalTrainerMonitoring%p", owner],
+        @kAudioAggregateDeviceNameKey: @"VocalTrainer Monitoring",
+        @kAudioAggregateDeviceIsPrivateKey: @1,
+        @kAudioAggregateDeviceMasterSubDeviceKey: (__bridge NSString*) outputUID,
+        @kAudioAggregateDeviceSubDeviceListKey: @[
+            @{@kAudioSubDeviceUIDKey: (__bridge NSString*) inputUID, @kAudioSubDeviceDriftCompensationKey: @1},
+            @{@kAudioSubDeviceUIDKey: (__bridge NSString*) outputUID},
+        ],
+    };
+    AudioObjectID aggregateDevice = kAudioObjectUnknown;
+    auto status = AudioHardwareCreateAggregateDevice((__bridge CFDictionaryRef) description, &aggregateDevice);
+    CFRelease(inputUID);
+    CFRelease(outputUID);
+    AudioToolboxUtils::throwExceptionIfError(status);
+    return aggregateDevice;
+}
+#endif
+
+OSStatus AudioToolboxDuplexUnit::HandleRender(void* inRefCon,
+        AudioUnitRenderActionFlags* ioActionFlags,
+        const AudioTimeStamp* inTimeStamp,
+        UInt32 inBusNumber,
+        UInt32 inNumberFrames,
+        AudioBufferList* ioData) {
+    AudioToolboxDuplexUnit* self = static_cast<AudioToolboxDuplexUnit*>(inRefCon);
+    AudioBuffer& buffer = ioData->mBuffers[0];
+    // The input of the cycle is rendered right into the output buffer, the formats are the same
+    OSStatus status = AudioUnitRender(self->unit, ioActionFlags, inTimeStamp, INPUT_BUS, inNumberFrames, ioData);
+    if (status != noErr) {
+        // No input yet, e.g. the first cycles after start
+        memset(buffer.mData, 0, buffer.mDataByteSize);
+        return noErr;
+    }
+
+    self->callback(self->userData, static_cast<int16_t*>(buffer.mData), buffer.mDataByteSize / sizeof(int16_t));
+    return noErr;
+}
+
+void AudioToolboxDuplexUnit::init(const AudioStreamDescription& description, Callback callback, void* userData) {
+    assert(!unit && "unit has been already initialized");
+    assert(description.samplesPerBuffer > 0);
+    this->description = description;
+    this->callback = callback;
+    this->userData = userData;
+
+    AudioComponentDescription componentDescription = {0};
+    componentDescription.componentType = kAudioUnitType_Output;
+#if TARGET_OS_IPHONE
+    componentDescription.componentSubType = kAudioUnitSubType_RemoteIO;
+#else
+    componentDescription.componentSubType = kAudioUnitSubType_HALOutput;
+#endif
+    componentDescription.componentManufacturer = kAudioUnitManufacturer_Apple;
+    AudioComponent component = AudioComponentFindNext(NULL, &componentDescription);
+    if (!component) {
+        throw AudioOperationFailedException("No I/O audio unit");
+    }
+    auto status = AudioComponentInstanceNew(component, &unit);
+    AudioToolboxUtils::throwExceptionIfError(status);
+
+    UInt32 enabled = 1;
+    status = AudioUnitSetProperty(unit, kAudioOutputUnitProperty_EnableIO, kAudioUnitScope_Input, INPUT_BUS,
+            &enabled, sizeof(enabled));
+    AudioToolboxUtils::throwExceptionIfError(status);
+    status = AudioUnitSetProperty(unit, kAudioOutputUnitProperty_EnableIO, kAudioUnitScope_Output, OUTPUT_BUS,
+            &enabled, sizeof(enabled));
+    AudioToolboxUtils::throwExceptionIfError(status);
+
+#if !TARGET_OS_IPHONE
+    // A HAL unit records and plays through a single device
+    AudioDeviceID inputDevice = GetDefaultDevice(kAudioHardwarePropertyDefaultInputDevice,
+            kAudioObjectPropertyScopeInput);
+    AudioDeviceID outputDevice = GetDefaultDevice(kAudioHardwarePropertyDefaultOutputDevice,
+            kAudioObjectPropertyScopeOutput);
+    AudioDeviceID device = inputDevice;
+    // Output channels of the device preceding the ones of the output device
+    int skippedOutputChannelsCount = 0;
+    if (inputDevice != outputDevice) {
+        aggregateDevice = CreateAggregateDevice(inputDevice, outputDevice, this);
+        device = aggregateDevice;
+        skippedOutputChannelsCount = GetChannelsCount(inputDevice, kAudioObjectPropertyScopeOutput);
+    }
+    status = AudioUnitSetProperty(unit, kAudioOutputUnitProperty_CurrentDevice, kAudioUnitScope_Global, 0,
+            &device, sizeof(device));
+    AudioToolboxUtils::throwExceptionIfError(status);
+
+    // Every channel of the output device plays the input, so a mono input is heard on both sides
+    int deviceOutputChannelsCount = GetChannelsCount(device, kAudioObjectPropertyScopeOutput);
+    std::vector<SInt32> channelMap(deviceOutputChannelsCount, -1);
+    for (int i = skippedOutputChannelsCount; i < deviceOutputChannelsCount; ++i) {
+        channelMap[i] = (i - skippedOutputChannelsCount) % description.numberOfChannels;
+    }
+    status = AudioUnitSetProperty(unit, kAudioOutputUnitProperty_ChannelMap, kAudioUnitScope_Output, OUTPUT_BUS,
+            channelMap.data(), UInt32(channelMap.size() * sizeof(SInt32)));
+    AudioToolboxUtils::throwExceptionIfError(status);
+#endif
+
+    // The unit converts the hardware format to the client one on both sides
+    AudioStreamBasicDescription format;
+    AudioToolboxUtils::createFormat(description, &format);
+    status = AudioUnitSetProperty(unit, kAudioUnitProperty_StreamFormat, kAudioUnitScope_Output, INPUT_BUS,
+            &format, sizeof(format));
+    AudioToolboxUtils::throwExceptionIfError(status);
+    status = AudioUnitSetProperty(unit, kAudioUnitProperty_StreamFormat, kAudioUnitScope_Input, OUTPUT_BUS,
+            &format, sizeof(format));
+    AudioToolboxUtils::throwExceptionIfError(status);
+
+    AURenderCallbackStruct renderCallback;
+    renderCallback.inputProc = HandleRender;
+    renderCallback.inputProcRefCon = this;
+    status = AudioUnitSetProperty(unit, kAudioUnitProperty_SetRenderCallback, kAudioUnitScope_Input, OUTPUT_BUS,
+            &renderCallback, sizeof(renderCallback));
+    AudioToolboxUtils::throwExceptionIfError(status);
+
+    status = AudioUnitInitialize(unit);
+    AudioToolboxUtils::throwExceptionIfError(status);
+}
+
+// The small buffer is requested only while the unit is running, it affects the other clients of the session or
+// the device, e.g. the players
+void AudioToolboxDuplexUnit::requestBufferFramesCount() {
+    assert(previousBufferSize < 0);
+#if TARGET_OS_IPHONE
+    AVAudioSession* session = [AVAudioSession sharedInstance];
+    // The preferred duration is 0 if it has never been set
+    previousBufferSize = session.preferredIOBufferDuration > 0 ?
+            session.preferredIOBufferDuration : session.IOBufferDuration;
+    NSTimeInterval duration = double(description.samplesPerBuffer) / description.sampleRate;
+    [session setPreferredIOBufferDuration:duration error:nil];
+#else
+    AudioDeviceID device = GetCurrentDevice(unit);
+    Float64 deviceSampleRate = GetProperty<Float64>(device, kAudioDevicePropertyNominalSampleRate);
+    AudioValueRange range = GetProperty<AudioValueRange>(device, kAudioDevicePropertyBufferFrameSizeRange);
+    double framesCount = double(description.samplesPerBuffer) * deviceSampleRate / description.sampleRate;
+    previousBufferSize = GetProperty<UInt32>(device, kAudioDevicePropertyBufferFrameSize);
+    SetBufferFramesCount(device, UInt32(std::max(range.mMinimum, std::min(range.mMaximum, round(framesCount)))));
+#endif
+}
+
+void AudioToolboxDuplexUnit::restoreBufferFramesCount() {
+    if (previousBufferSize < 0) {
+        return;
+    }
+#if TARGET_OS_IPHONE
+    [[AVAudioSession sharedInstance] setPreferredIOBufferDuration:previousBufferSize error:nil];
+#else
+    // Doesn't throw, it's called from the destructor
+    AudioDeviceID device = kAudioObjectUnknown;
+    UInt32 size = sizeof(device);
+    if (AudioUnitGetProperty(unit, kAudioOutputUnitProperty_CurrentDevice, kAudioUnitScope_Global, 0,
+            &device, &size) == noErr) {
+        SetBufferFramesCount(device, UInt32(previousBufferSize));
+    }
+#endif
+    previousBufferSize = -1;
+}
+
+void AudioToolboxDuplexUnit::start() {
+    assert(unit);
+    requestBufferFramesCount();
+    auto status = AudioOutputUnitStart(unit);
+    if (status != noErr) {
+        restoreBufferFramesCount();
+    }
+    AudioToolboxUtils::throwExceptionIfError(status);
+}
+
+void AudioToolboxDuplexUnit::pause() {
+    assert(unit);
+    auto status = AudioOutputUnitStop(unit);
+    restoreBufferFramesCount();
+    AudioToolboxUtils::throwExceptionIfError(status);
+}
+
+double AudioToolboxDuplexUnit::getLatency() const {
+    assert(unit);
+    // Sample rate converters of the unit
+    Float64 unitLatency = 0;
+    UInt32 size = sizeof(unitLatency);
+    AudioUnitGetProperty(unit, kAudioUnitProperty_Latency, kAudioUnitScope_Global, 0, &unitLatency, &size);
+
+#if TARGET_OS_IPHONE
+    AVAudioSession* session = [AVAudioSession sharedInstance];
+    return session.inputLatency + session.outputLatency + 2 * session.IOBufferDuration + unitLatency;
+#else
+    AudioDeviceID device = GetCurrentDevice(unit);
+    UInt32 framesCount = 2 * GetProperty<UInt32>(device, kAudioDevicePropertyBufferFrameSize);
+    for (AudioObjectPropertyScope scope : {kAudioObjectPropertyScopeInput, kAudioObjectPropertyScopeOutput}) {
+        framesCount += GetProperty<UInt32>(device, kAudioDevicePropertyLatency, scope);
+        framesCount += GetProperty<UInt32>(device, kAudioDevicePropertySafetyOffset, scope);
+    }
+    Float64 deviceSampleRate = GetProperty<Float64>(device, kAudioDevicePropertyNominalSampleRate);
+    return framesCount / deviceSampleRate + unitLatency;
+#endif
+}
+
+AudioToolboxDuplexUnit::~AudioToolboxDuplexUnit() {
+    if (unit) {
+        AudioOutputUnitStop(unit);
+        restoreBufferFramesCount();
+        AudioUnitUninitialize(unit);
+        AudioComponentInstanceDispose(unit);
+        unit = NULL;
+    }
+#if !TARGET_OS_IPHONE
+    if (aggregateDevice != kAudioObjectUnknown) {
+        AudioHardwareDestroyAggregateDevice(aggregateDevice);
+        aggregateDevice = kAudioObjectUnknown;
+    }
+#endif
+}
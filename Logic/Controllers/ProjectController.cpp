@@ -22,6 +22,12 @@ ProjectController::ProjectController(ProjectControllerDelegate* delegate) : dele
         onStopPlaybackRequested();
     });
 
+    if (audioInputManager) {
+        audioInputManager->getPitchDetectedListeners().addListener([this] (const Pitch& pitch, double time) {
+            singingScorer.addPitch(time, pitch.isValid() ? pitch.getFrequency() : -1);
+        });
+    }
+
     player->isPlayingChangedListeners.addListener([this] (bool playing) {
         if (audioInputManager) {
             if (playing) {
@@ -43,6 +49,7 @@ ProjectController::ProjectController(ProjectControllerDelegate* delegate) : dele
     });
 
     player->vocalPartChangedListeners.addListener([this] (const VocalPart* vocalPart) {
+        singingScorer.setVocalPart(*vocalPart);
         if (workspaceController) {
             workspaceController->setVocalPart(vocalPart,
                     player->getBeatsPerSecond(),
@@ -61,6 +68,9 @@ ProjectController::ProjectController(ProjectControllerDelegate* delegate) : dele
         if (!player->isCompleted() && audioInputManager) {
             audioInputManager->setPitchesRecorderSeek(seek);
         }
+        if (workspaceController) {
+            workspaceController->syncPlaybackSeek(seek);
+        }
         executeOnMainThread([=] {
             if (player->hasSource()) {
                 this->delegate->updateSeek(seek);
@@ -421,6 +431,7 @@ void ProjectController::setTempoFactor(double value) {
     if (audioInputManager) {
         audioInputManager->clearRecordedData();
     }
+    singingScorer.reset();
     player->setTempoFactor(value);
     delegate->updateTempoFactor(value);
 }
@@ -472,6 +483,7 @@ MvxFile *ProjectController::generateRecording() const {
     recordingFile->setRecordedPitchesFrequencies(recordedPitches->getFrequencies());
     recordingFile->setRecordingTonalityChanges(player->getTonalityChanges());
     recordingFile->setRecordingTempoFactor(player->getTempoFactor());
+    recordingFile->setSingingScore(singingScorer.getScore());
     std::vector<short> previewSamples = AudioUtils::ResizePreviewSamplesFromWavData(
             recordingData,
             RECORDING_PREVIEW_SAMPLES_COUNT);
@@ -482,6 +494,7 @@ MvxFile *ProjectController::generateRecording() const {
 
 // Song completion flow
 void ProjectController::tryAgain() {
+    singingScorer.reset();
     player->setSeek(0);
     player->play();
     delegate->hideSingingCompletionFlow();
@@ -504,6 +517,10 @@ void ProjectController::listen() {
     delegate->startListeningToRecording(recordingFile);
 }
 
+const SingingScore& ProjectController::getSingingScore() const {
+    return singingScorer.getScore();
+}
+
 void ProjectController::setPlaybackSource(const char* filePath) {
     std::fstream is = Streams::OpenFile(filePath, std::ios::in | std::ios::binary);
     auto* source = VocalTrainerFile::read(is);
@@ -550,6 +567,10 @@ std::vector<float> ProjectController::getRecordingPreview(int numberOfSamples) c
     );
 }
 
+const PitchStabilityAnalyzer& ProjectController::getPitchStabilityAnalyzer() const {
+    return singingScorer.getStabilityAnalyzer();
+}
+
 void ProjectController::setWorkspaceColors(WorkspaceColorScheme colorScheme) {
     workspaceColorScheme = colorScheme;
     if (workspaceController) {
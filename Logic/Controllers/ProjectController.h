@@ -52,6 +52,7 @@ class ProjectController : CppUtils::DestructorQueue, public WorkspaceControllerD
     VocalTrainerFilePlayer* player = nullptr;
     VocalTrainerFile* source = nullptr;
     AudioInputManager* audioInputManager = nullptr;
+    SingingScorer singingScorer;
     bool lyricsVisible = true;
     Rewinder* rewinder = nullptr;
     mutable std::vector<Lyrics::Section> sections;
@@ -66,6 +67,7 @@ class ProjectController : CppUtils::DestructorQueue, public WorkspaceControllerD
     void tryAgain() override;
     void save() override;
     void listen() override;
+    const SingingScore& getSingingScore() const override;
 public:
     explicit ProjectController(ProjectControllerDelegate* delegate);
 
@@ -145,6 +147,8 @@ public:
     void setPlaybackSource(const char* filePath);
 
     std::vector<float> getRecordingPreview(int numberOfSamples) const;
+    // Live vibrato, jitter and drift of the singing
+    const PitchStabilityAnalyzer& getPitchStabilityAnalyzer() const;
 
     void setWorkspaceColors(WorkspaceColorScheme colorScheme);
 
@@ -6,12 +6,14 @@
 #ifndef VOCALTRAINER_SINGINGCOMPLETIONFLOW_H
 #define VOCALTRAINER_SINGINGCOMPLETIONFLOW_H
 
+#include "SingingScorer.h"
 
 class SingingCompletionFlow {
 public:
     virtual void tryAgain() = 0;
     virtual void save() = 0;
     virtual void listen() = 0;
+    virtual const SingingScore& getSingingScore() const = 0;
     virtual ~SingingCompletionFlow() = default;
 };
 
@@ -0,0 +1,859 @@
+#include "CommandBufferDrawer.h"
+#include "FrameProfiler.h"
+#include <cstring>
+#include <cstdio>
+#include <sstream>
+#include <algorithm>
+
+using namespace CppUtils;
+
+static constexpr uint32_t SERIALIZATION_MAGIC = 0x56584342; // VXCB
+static constexpr uint32_t SERIALIZATION_VERSION = 1;
+static constexpr int OPCODE_BITS = 8;
+static constexpr uint32_t OPCODE_MASK = (1u << OPCODE_BITS) - 1;
+static constexpr int QUAD_FLOATS_COUNT = sizeof(Drawer::ImageQuad) / sizeof(float);
+static constexpr int ROUNDED_RECT_FLOATS_COUNT = sizeof(Drawer::RoundedRectShape) / sizeof(float);
+static_assert(sizeof(Drawer::ImageQuad) == QUAD_FLOATS_COUNT * sizeof(float), "ImageQuad should contain floats only");
+static_assert(sizeof(Drawer::RoundedRectShape) == ROUNDED_RECT_FLOATS_COUNT * sizeof(float),
+        "RoundedRectShape should contain floats only");
+
+static const char* const OPCODE_NAMES[DrawerCommandBuffer::OPCODES_COUNT] = {
+    "clear", "beginFrame", "endFrame", "translate", "rotate", "scale", "path", "stroke", "fill",
+    "fillWithImage", "drawImage", "drawImageQuads", "fillRoundedRects", "setStrokeColor", "setFillColor",
+    "setStrokeWidth", "lineJoin", "drawShadow", "setTextFontFamily", "setTextFontSize", "setTextAlign",
+    "setTextStyle", "setTextBaseline", "fillText",
+    "beginPath", "closePath", "moveTo", "lineTo", "arcTo", "arc", "bezierCurveTo", "quadraticCurveTo", "rect",
+    "roundedRect", "roundedRectDifferentCorners", "circle"
+};
+
+static uint32_t makeHeader(DrawerCommandBuffer::Opcode opcode, size_t argumentsCount) {
+    assert(argumentsCount < (1u << (32 - OPCODE_BITS)));
+    return opcode | static_cast<uint32_t>(argumentsCount) << OPCODE_BITS;
+}
+
+static DrawerCommandBuffer::Opcode getOpcode(uint32_t header) {
+    return static_cast<DrawerCommandBuffer::Opcode>(header & OPCODE_MASK);
+}
+
+static int getArgumentsCount(uint32_t header) {
+    return static_cast<int>(header >> OPCODE_BITS);
+}
+
+static int toIndex(float argument) {
+    return static_cast<int>(argument);
+}
+
+// FNV-1a
+static void hashBytes(uint64_t& hash, const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+}
+
+template <typename T>
+static void hashVector(uint64_t& hash, const std::vector<T>& vector) {
+    uint64_t size = vector.size();
+    hashBytes(hash, &size, sizeof(size));
+    hashBytes(hash, vector.data(), vector.size() * sizeof(T));
+}
+
+static uint32_t toRgba(const Drawer::Color& color) {
+    return uint32_t(color[0]) << 24 | uint32_t(color[1]) << 16 | uint32_t(color[2]) << 8 | uint32_t(color[3]);
+}
+
+template <typename T>
+static void writeVector(std::ostream& os, const std::vector<T>& vector) {
+    auto size = static_cast<uint32_t>(vector.size());
+    os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    os.write(reinterpret_cast<const char*>(vector.data()), vector.size() * sizeof(T));
+}
+
+template <typename T>
+static bool readVector(std::istream& is, std::vector<T>& vector) {
+    uint32_t size = 0;
+    if (!is.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+        return false;
+    }
+    vector.resize(size);
+    return bool(is.read(reinterpret_cast<char*>(vector.data()), size * sizeof(T)));
+}
+
+void DrawerCommandBuffer::clear() {
+    commands.clear();
+    arguments.clear();
+    colors.clear();
+    colorIndexes.clear();
+    strings.clear();
+    stringIndexes.clear();
+    images.clear();
+    imageIndexes.clear();
+    pathCommands.clear();
+    pathArguments.clear();
+    paths.clear();
+    pathIndexes.clear();
+}
+
+void DrawerCommandBuffer::addCommand(Opcode opcode, std::initializer_list<float> arguments,
+        const float* extraArguments, int extraArgumentsCount) {
+    assert(opcode < BEGIN_PATH);
+    finish();
+    commands.push_back(makeHeader(opcode, arguments.size() + extraArgumentsCount));
+    this->arguments.insert(this->arguments.end(), arguments);
+    if (extraArgumentsCount > 0) {
+        this->arguments.insert(this->arguments.end(), extraArguments, extraArguments + extraArgumentsCount);
+    }
+}
+
+void DrawerCommandBuffer::addPathCommand(Opcode opcode, std::initializer_list<float> arguments) {
+    assert(opcode >= BEGIN_PATH && opcode < OPCODES_COUNT);
+    pathCommands.push_back(makeHeader(opcode, arguments.size()));
+    pathArguments.insert(pathArguments.end(), arguments);
+}
+
+bool DrawerCommandBuffer::hasCollectedPath() const {
+    uint32_t commandsEnd = paths.empty() ? 0 : paths.back().commandsEnd;
+    return pathCommands.size() > commandsEnd;
+}
+
+void DrawerCommandBuffer::finish() {
+    if (!hasCollectedPath()) {
+        return;
+    }
+
+    Path path;
+    path.commandsBegin = paths.empty() ? 0 : paths.back().commandsEnd;
+    path.argumentsBegin = paths.empty() ? 0 : paths.back().argumentsEnd;
+    path.commandsEnd = static_cast<uint32_t>(pathCommands.size());
+    path.argumentsEnd = static_cast<uint32_t>(pathArguments.size());
+    size_t commandsCount = path.commandsEnd - path.commandsBegin;
+    size_t argumentsCount = path.argumentsEnd - path.argumentsBegin;
+
+    uint64_t hash = 14695981039346656037ull;
+    hashBytes(hash, pathCommands.data() + path.commandsBegin, commandsCount * sizeof(uint32_t));
+    hashBytes(hash, pathArguments.data() + path.argumentsBegin, argumentsCount * sizeof(float));
+
+    int pathIndex = -1;
+    auto range = pathIndexes.equal_range(hash);
+    for (auto iter = range.first; iter != range.second; ++iter) {
+        const Path& existing = paths[iter->second];
+        if (existing.commandsEnd - existing.commandsBegin == commandsCount &&
+                existing.argumentsEnd - existing.argumentsBegin == argumentsCount &&
+                std::equal(pathCommands.begin() + path.commandsBegin, pathCommands.end(),
+                        pathCommands.begin() + existing.commandsBegin) &&
+                memcmp(pathArguments.data() + path.argumentsBegin, pathArguments.data() + existing.argumentsBegin,
+                        argumentsCount * sizeof(float)) == 0) {
+            pathIndex = iter->second;
+            break;
+        }
+    }
+
+    if (pathIndex >= 0) {
+        pathCommands.resize(path.commandsBegin);
+        pathArguments.resize(path.argumentsBegin);
+    } else {
+        pathIndex = static_cast<int>(paths.size());
+        paths.push_back(path);
+        pathIndexes.emplace(hash, pathIndex);
+    }
+
+    commands.push_back(makeHeader(PATH, 1));
+    arguments.push_back(static_cast<float>(pathIndex));
+}
+
+int DrawerCommandBuffer::internColor(const Drawer::Color& color) {
+    uint32_t rgba = toRgba(color);
+    auto iter = colorIndexes.find(rgba);
+    if (iter != colorIndexes.end()) {
+        return iter->second;
+    }
+
+    int index = static_cast<int>(colors.size());
+    colors.push_back(rgba);
+    colorIndexes[rgba] = index;
+    return index;
+}
+
+int DrawerCommandBuffer::internString(const std::string& string) {
+    auto iter = stringIndexes.find(string);
+    if (iter != stringIndexes.end()) {
+        return iter->second;
+    }
+
+    int index = static_cast<int>(strings.size());
+    strings.push_back(string);
+    stringIndexes[string] = index;
+    return index;
+}
+
+int DrawerCommandBuffer::internImage(Drawer::Image* image) {
+    assert(image);
+    auto iter = imageIndexes.find(image);
+    if (iter != imageIndexes.end()) {
+        return iter->second;
+    }
+
+    int index = static_cast<int>(images.size());
+    images.push_back({image, image->width(), image->height()});
+    imageIndexes[image] = index;
+    return index;
+}
+
+void DrawerCommandBuffer::execute(Drawer* drawer, Opcode opcode, const float* a, int argumentsCount,
+        std::vector<Drawer::ImageQuad>& quads, std::vector<Drawer::RoundedRectShape>& rects) const {
+    switch (opcode) {
+        case CLEAR:
+            drawer->clear();
+            break;
+        case BEGIN_FRAME:
+            drawer->beginFrame(a[0], a[1], a[2]);
+            break;
+        case END_FRAME:
+            drawer->endFrame();
+            break;
+        case TRANSLATE:
+            drawer->translate(a[0], a[1]);
+            break;
+        case ROTATE:
+            drawer->rotate(a[0]);
+            break;
+        case SCALE:
+            drawer->scale(a[0], a[1]);
+            break;
+        case PATH: {
+            const Path& path = paths[toIndex(a[0])];
+            const float* pathArgument = pathArguments.data() + path.argumentsBegin;
+            for (uint32_t i = path.commandsBegin; i < path.commandsEnd; ++i) {
+                int count = getArgumentsCount(pathCommands[i]);
+                execute(drawer, getOpcode(pathCommands[i]), pathArgument, count, quads, rects);
+                pathArgument += count;
+            }
+            break;
+        }
+        case STROKE:
+            drawer->stroke();
+            break;
+        case FILL:
+            drawer->fill();
+            break;
+        case FILL_WITH_IMAGE:
+            drawer->fillWithImage(images[toIndex(a[0])].image, a[1], a[2], a[3], a[4]);
+            break;
+        case DRAW_IMAGE:
+            drawer->drawImage(a[1], a[2], a[3], a[4], images[toIndex(a[0])].image);
+            break;
+        case DRAW_IMAGE_QUADS: {
+            int quadsCount = (argumentsCount - 1) / QUAD_FLOATS_COUNT;
+            quads.resize(quadsCount);
+            memcpy(quads.data(), a + 1, quadsCount * sizeof(Drawer::ImageQuad));
+            drawer->drawImageQuads(images[toIndex(a[0])].image, quads.data(), quadsCount);
+            break;
+        }
+        case FILL_ROUNDED_RECTS: {
+            int rectsCount = (argumentsCount - 1) / ROUNDED_RECT_FLOATS_COUNT;
+            rects.resize(rectsCount);
+            memcpy(rects.data(), a + 1, rectsCount * sizeof(Drawer::RoundedRectShape));
+            drawer->fillRoundedRects(rects.data(), rectsCount, Color::fromRgba(colors[toIndex(a[0])]));
+            break;
+        }
+        case SET_STROKE_COLOR:
+            drawer->setStrokeColor(Color::fromRgba(colors[toIndex(a[0])]));
+            break;
+        case SET_FILL_COLOR:
+            drawer->setFillColor(Color::fromRgba(colors[toIndex(a[0])]));
+            break;
+        case SET_STROKE_WIDTH:
+            drawer->setStrokeWidth(a[0]);
+            break;
+        case LINE_JOIN:
+            drawer->lineJoin(static_cast<Drawer::LineJoin>(toIndex(a[0])));
+            break;
+        case DRAW_SHADOW:
+            drawer->drawShadow(a[0], a[1], a[2], a[3], a[4], a[5], Color::fromRgba(colors[toIndex(a[6])]));
+            break;
+        case SET_TEXT_FONT_FAMILY:
+            drawer->setTextFontFamily(strings[toIndex(a[0])].c_str());
+            break;
+        case SET_TEXT_FONT_SIZE:
+            drawer->setTextFontSize(a[0]);
+            break;
+        case SET_TEXT_ALIGN:
+            drawer->setTextAlign(static_cast<Drawer::TextAlign>(toIndex(a[0])));
+            break;
+        case SET_TEXT_STYLE:
+            drawer->setTextStyle(static_cast<Drawer::FontStyle>(toIndex(a[0])));
+            break;
+        case SET_TEXT_BASELINE:
+            drawer->setTextBaseline(static_cast<Drawer::TextBaseline>(toIndex(a[0])));
+            break;
+        case FILL_TEXT:
+            drawer->fillText(strings[toIndex(a[0])], a[1], a[2]);
+            break;
+        case BEGIN_PATH:
+            drawer->beginPath();
+            break;
+        case CLOSE_PATH:
+            drawer->closePath();
+            break;
+        case MOVE_TO:
+            drawer->moveTo(a[0], a[1]);
+            break;
+        case LINE_TO:
+            drawer->lineTo(a[0], a[1]);
+            break;
+        case ARC_TO:
+            drawer->arcTo(a[0], a[1], a[2], a[3], a[4]);
+            break;
+        case ARC:
+            drawer->arc(a[0], a[1], a[2], a[3], a[4]);
+            break;
+        case BEZIER_CURVE_TO:
+            drawer->bezierCurveTo(a[0], a[1], a[2], a[3], a[4], a[5]);
+            break;
+        case QUADRATIC_CURVE_TO:
+            drawer->quadraticCurveTo(a[0], a[1], a[2], a[3]);
+            break;
+        case RECT:
+            drawer->rect(a[0], a[1], a[2], a[3]);
+            break;
+        case ROUNDED_RECT:
+            drawer->roundedRect(a[0], a[1], a[2], a[3], a[4]);
+            break;
+        case ROUNDED_RECT_DIFFERENT_CORNERS:
+            drawer->roundedRectDifferentCorners(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+            break;
+        case CIRCLE:
+            drawer->circle(a[0], a[1], a[2]);
+            break;
+        default:
+            assert(false && "Unknown opcode");
+    }
+}
+
+void DrawerCommandBuffer::replay(Drawer* drawer) const {
+    assert(!hasCollectedPath() && "call finish before replay");
+    std::vector<Drawer::ImageQuad> quads;
+    std::vector<Drawer::RoundedRectShape> rects;
+    const float* argument = arguments.data();
+    for (uint32_t header : commands) {
+        int count = getArgumentsCount(header);
+        execute(drawer, getOpcode(header), argument, count, quads, rects);
+        argument += count;
+    }
+}
+
+uint64_t DrawerCommandBuffer::getHash() const {
+    assert(!hasCollectedPath() && "call finish before getHash");
+    uint64_t hash = 14695981039346656037ull;
+    hashVector(hash, commands);
+    hashVector(hash, arguments);
+    hashVector(hash, colors);
+    hashVector(hash, pathCommands);
+    hashVector(hash, pathArguments);
+    hashVector(hash, paths);
+    for (const std::string& string : strings) {
+        hashBytes(hash, string.c_str(), string.size() + 1);
+    }
+    for (const ImageEntry& entry : images) {
+        hashBytes(hash, &entry.image, sizeof(entry.image));
+    }
+    return hash;
+}
+
+bool DrawerCommandBuffer::operator==(const DrawerCommandBuffer& other) const {
+    auto floatsEqual = [] (const std::vector<float>& a, const std::vector<float>& b) {
+        return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+    };
+    auto pathsEqual = [] (const Path& a, const Path& b) {
+        return a.commandsBegin == b.commandsBegin && a.commandsEnd == b.commandsEnd &&
+                a.argumentsBegin == b.argumentsBegin && a.argumentsEnd == b.argumentsEnd;
+    };
+    auto imagesEqual = [] (const ImageEntry& a, const ImageEntry& b) {
+        return a.image == b.image && a.width == b.width && a.height == b.height;
+    };
+    return commands == other.commands && floatsEqual(arguments, other.arguments) && colors == other.colors &&
+            strings == other.strings && pathCommands == other.pathCommands &&
+            floatsEqual(pathArguments, other.pathArguments) &&
+            std::equal(paths.begin(), paths.end(), other.paths.begin(), other.paths.end(), pathsEqual) &&
+            std::equal(images.begin(), images.end(), other.images.begin(), other.images.end(), imagesEqual);
+}
+
+bool DrawerCommandBuffer::operator!=(const DrawerCommandBuffer& other) const {
+    return !(*this == other);
+}
+
+void DrawerCommandBuffer::writeCommand(std::ostream& os, Opcode opcode, const float* a, int argumentsCount) const {
+    char buffer[32];
+    auto writeFloat = [&] (float value) {
+        snprintf(buffer, sizeof(buffer), " %.3f", value);
+        // -0.000 and 0.000 are the same for a reader
+        os << (strcmp(buffer, " -0.000") == 0 ? " 0.000" : buffer);
+    };
+    auto writeColor = [&] (float index) {
+        snprintf(buffer, sizeof(buffer), " #%08x", colors[toIndex(index)]);
+        os << buffer;
+    };
+    auto writeImage = [&] (float index) {
+        const ImageEntry& entry = images[toIndex(index)];
+        os << " image" << toIndex(index) << "(" << entry.width << "x" << entry.height << ")";
+    };
+
+    os << OPCODE_NAMES[opcode];
+    switch (opcode) {
+        case PATH: {
+            const Path& path = paths[toIndex(a[0])];
+            const float* pathArgument = pathArguments.data() + path.argumentsBegin;
+            os << " {";
+            for (uint32_t i = path.commandsBegin; i < path.commandsEnd; ++i) {
+                int count = getArgumentsCount(pathCommands[i]);
+                os << (i == path.commandsBegin ? " " : "; ");
+                writeCommand(os, getOpcode(pathCommands[i]), pathArgument, count);
+                pathArgument += count;
+            }
+            os << " }";
+            break;
+        }
+        case FILL_WITH_IMAGE:
+        case DRAW_IMAGE:
+        case DRAW_IMAGE_QUADS:
+            writeImage(a[0]);
+            for (int i = 1; i < argumentsCount; ++i) {
+                writeFloat(a[i]);
+            }
+            break;
+        case FILL_ROUNDED_RECTS:
+        case SET_STROKE_COLOR:
+        case SET_FILL_COLOR:
+            writeColor(a[0]);
+            for (int i = 1; i < argumentsCount; ++i) {
+                writeFloat(a[i]);
+            }
+            break;
+        case DRAW_SHADOW:
+            for (int i = 0; i < 6; ++i) {
+                writeFloat(a[i]);
+            }
+            writeColor(a[6]);
+            break;
+        case SET_TEXT_FONT_FAMILY:
+            os << " \"" << strings[toIndex(a[0])] << "\"";
+            break;
+        case FILL_TEXT:
+            os << " \"" << strings[toIndex(a[0])] << "\"";
+            writeFloat(a[1]);
+            writeFloat(a[2]);
+            break;
+        case LINE_JOIN:
+        case SET_TEXT_ALIGN:
+        case SET_TEXT_STYLE:
+        case SET_TEXT_BASELINE:
+            os << " " << toIndex(a[0]);
+            break;
+        default:
+            for (int i = 0; i < argumentsCount; ++i) {
+                writeFloat(a[i]);
+            }
+    }
+}
+
+std::vector<std::string> DrawerCommandBuffer::getCommandLines() const {
+    std::vector<std::string> lines;
+    lines.reserve(commands.size());
+    std::stringstream line;
+    const float* argument = arguments.data();
+    for (uint32_t header : commands) {
+        int count = getArgumentsCount(header);
+        line.str(std::string());
+        writeCommand(line, getOpcode(header), argument, count);
+        lines.push_back(line.str());
+        argument += count;
+    }
+    return lines;
+}
+
+int DrawerCommandBuffer::findFirstDifference(const DrawerCommandBuffer& other) const {
+    std::vector<std::string> lines = getCommandLines();
+    std::vector<std::string> otherLines = other.getCommandLines();
+    auto difference = std::mismatch(lines.begin(), lines.end(), otherLines.begin(), otherLines.end());
+    if (difference.first == lines.end() && difference.second == otherLines.end()) {
+        return -1;
+    }
+    return static_cast<int>(difference.first - lines.begin());
+}
+
+void DrawerCommandBuffer::writeText(std::ostream& os) const {
+    assert(!hasCollectedPath() && "call finish before writeText");
+    for (const std::string& line : getCommandLines()) {
+        os << line << "\n";
+    }
+}
+
+void DrawerCommandBuffer::serialize(std::ostream& os) const {
+    assert(!hasCollectedPath() && "call finish before serialize");
+    uint32_t header[] = {SERIALIZATION_MAGIC, SERIALIZATION_VERSION};
+    os.write(reinterpret_cast<const char*>(header), sizeof(header));
+    writeVector(os, commands);
+    writeVector(os, arguments);
+    writeVector(os, colors);
+    writeVector(os, pathCommands);
+    writeVector(os, pathArguments);
+    writeVector(os, paths);
+
+    auto stringsCount = static_cast<uint32_t>(strings.size());
+    os.write(reinterpret_cast<const char*>(&stringsCount), sizeof(stringsCount));
+    for (const std::string& string : strings) {
+        writeVector(os, std::vector<char>(string.begin(), string.end()));
+    }
+
+    std::vector<int32_t> imageSizes;
+    for (const ImageEntry& entry : images) {
+        imageSizes.push_back(entry.width);
+        imageSizes.push_back(entry.height);
+    }
+    writeVector(os, imageSizes);
+}
+
+bool DrawerCommandBuffer::deserialize(std::istream& is) {
+    clear();
+    uint32_t header[2];
+    bool valid = bool(is.read(reinterpret_cast<char*>(header), sizeof(header))) &&
+            header[0] == SERIALIZATION_MAGIC && header[1] == SERIALIZATION_VERSION &&
+            readVector(is, commands) && readVector(is, arguments) && readVector(is, colors) &&
+            readVector(is, pathCommands) && readVector(is, pathArguments) && readVector(is, paths);
+
+    uint32_t stringsCount = 0;
+    valid = valid && is.read(reinterpret_cast<char*>(&stringsCount), sizeof(stringsCount));
+    for (uint32_t i = 0; valid && i < stringsCount; ++i) {
+        std::vector<char> string;
+        valid = readVector(is, string);
+        strings.emplace_back(string.begin(), string.end());
+    }
+
+    std::vector<int32_t> imageSizes;
+    valid = valid && readVector(is, imageSizes) && imageSizes.size() % 2 == 0;
+    for (size_t i = 0; valid && i < imageSizes.size(); i += 2) {
+        images.push_back({nullptr, imageSizes[i], imageSizes[i + 1]});
+    }
+
+    // Every argument should belong to a command and every path to the path streams
+    size_t argumentsCount = 0;
+    for (uint32_t command : commands) {
+        valid = valid && getOpcode(command) < BEGIN_PATH;
+        argumentsCount += getArgumentsCount(command);
+    }
+    valid = valid && argumentsCount == arguments.size();
+    uint32_t pathCommandsBegin = 0;
+    uint32_t pathArgumentsBegin = 0;
+    for (const Path& path : paths) {
+        valid = valid && path.commandsBegin == pathCommandsBegin && path.argumentsBegin == pathArgumentsBegin &&
+                path.commandsEnd >= path.commandsBegin && path.argumentsEnd >= path.argumentsBegin;
+        pathCommandsBegin = path.commandsEnd;
+        pathArgumentsBegin = path.argumentsEnd;
+    }
+    valid = valid && pathCommandsBegin == pathCommands.size() && pathArgumentsBegin == pathArguments.size();
+
+    if (!valid) {
+        clear();
+        return false;
+    }
+
+    rebuildIndexes();
+    return true;
+}
+
+void DrawerCommandBuffer::rebuildIndexes() {
+    for (int i = 0; i < colors.size(); ++i) {
+        colorIndexes[colors[i]] = i;
+    }
+    for (int i = 0; i < strings.size(); ++i) {
+        stringIndexes[strings[i]] = i;
+    }
+    for (int i = 0; i < paths.size(); ++i) {
+        const Path& path = paths[i];
+        uint64_t hash = 14695981039346656037ull;
+        hashBytes(hash, pathCommands.data() + path.commandsBegin,
+                (path.commandsEnd - path.commandsBegin) * sizeof(uint32_t));
+        hashBytes(hash, pathArguments.data() + path.argumentsBegin,
+                (path.argumentsEnd - path.argumentsBegin) * sizeof(float));
+        pathIndexes.emplace(hash, i);
+    }
+}
+
+int DrawerCommandBuffer::getCommandsCount() const {
+    return static_cast<int>(commands.size());
+}
+
+int DrawerCommandBuffer::getPathsCount() const {
+    return static_cast<int>(paths.size());
+}
+
+int DrawerCommandBuffer::getImagesCount() const {
+    return static_cast<int>(images.size());
+}
+
+void DrawerCommandBuffer::setImage(int index, Drawer::Image* image) {
+    ImageEntry& entry = images.at(index);
+    assert(image && image->width() == entry.width && image->height() == entry.height);
+    if (entry.image) {
+        imageIndexes.erase(entry.image);
+    }
+    entry.image = image;
+    imageIndexes[image] = index;
+}
+
+size_t DrawerCommandBuffer::getSizeInBytes() const {
+    size_t size = commands.size() * sizeof(uint32_t) + arguments.size() * sizeof(float) +
+            colors.size() * sizeof(uint32_t) + pathCommands.size() * sizeof(uint32_t) +
+            pathArguments.size() * sizeof(float) + paths.size() * sizeof(Path) + images.size() * sizeof(ImageEntry);
+    for (const std::string& string : strings) {
+        size += string.size();
+    }
+    return size;
+}
+
+CommandBufferDrawer::CommandBufferDrawer(Drawer* backend) : backend(backend), recording(&frame) {
+    assert(backend);
+}
+
+CommandBufferDrawer::~CommandBufferDrawer() {
+    delete backend;
+}
+
+void CommandBufferDrawer::setFrameProfiler(FrameProfiler* frameProfiler) {
+    Drawer::setFrameProfiler(frameProfiler);
+    backend->setFrameProfiler(frameProfiler);
+}
+
+void CommandBufferDrawer::clear() {
+    recording->addCommand(DrawerCommandBuffer::CLEAR);
+}
+
+void CommandBufferDrawer::beginFrame(float width, float height, float devicePixelRatio) {
+    Drawer::beginFrame(width, height, devicePixelRatio);
+    recording->addCommand(DrawerCommandBuffer::BEGIN_FRAME, {width, height, devicePixelRatio});
+}
+
+void CommandBufferDrawer::endFrame() {
+    assert(recording == &frame);
+    frame.addCommand(DrawerCommandBuffer::END_FRAME);
+    frame.finish();
+    if (submitOnEndFrame) {
+        submit();
+    }
+    std::swap(frame, lastFrame);
+    frame.clear();
+}
+
+void CommandBufferDrawer::submit() {
+    uint64_t hash = frame.getHash();
+    lastFrameSkipped = skipIdenticalFrames && hash == submittedHash && imagesVersion == submittedImagesVersion &&
+            frame == lastFrame;
+    if (lastFrameSkipped) {
+        return;
+    }
+
+    PROFILE_FRAME_SECTION(getFrameProfiler(), "replay");
+    frame.replay(backend);
+    submittedHash = hash;
+    submittedImagesVersion = imagesVersion;
+}
+
+void CommandBufferDrawer::moveTo(float x, float y) {
+    recording->addPathCommand(DrawerCommandBuffer::MOVE_TO, {x, y});
+}
+
+void CommandBufferDrawer::lineTo(float x, float y) {
+    recording->addPathCommand(DrawerCommandBuffer::LINE_TO, {x, y});
+}
+
+void CommandBufferDrawer::arcTo(float x1, float y1, float x2, float y2, float radius) {
+    recording->addPathCommand(DrawerCommandBuffer::ARC_TO, {x1, y1, x2, y2, radius});
+}
+
+void CommandBufferDrawer::arc(float x, float y, float r, float sAngle, float eAngle) {
+    recording->addPathCommand(DrawerCommandBuffer::ARC, {x, y, r, sAngle, eAngle});
+}
+
+void CommandBufferDrawer::circle(float x, float y, float r) {
+    recording->addPathCommand(DrawerCommandBuffer::CIRCLE, {x, y, r});
+}
+
+void CommandBufferDrawer::setStrokeColor(const Color& color) {
+    recording->addCommand(DrawerCommandBuffer::SET_STROKE_COLOR, {float(recording->internColor(color))});
+}
+
+void CommandBufferDrawer::setFillColor(const Color& color) {
+    fillColor = color;
+    recording->addCommand(DrawerCommandBuffer::SET_FILL_COLOR, {float(recording->internColor(color))});
+}
+
+void CommandBufferDrawer::setStrokeWidth(float strokeWidth) {
+    recording->addCommand(DrawerCommandBuffer::SET_STROKE_WIDTH, {strokeWidth});
+}
+
+void CommandBufferDrawer::stroke() {
+    recording->addCommand(DrawerCommandBuffer::STROKE);
+}
+
+void CommandBufferDrawer::fill() {
+    recording->addCommand(DrawerCommandBuffer::FILL);
+}
+
+void CommandBufferDrawer::fillWithImage(Image* image, float textureX1, float textureY1, float textureX2,
+        float textureY2) {
+    recording->addCommand(DrawerCommandBuffer::FILL_WITH_IMAGE,
+            {float(recording->internImage(image)), textureX1, textureY1, textureX2, textureY2});
+}
+
+void CommandBufferDrawer::drawImage(float x, float y, float w, float h, Image* image) {
+    recording->addCommand(DrawerCommandBuffer::DRAW_IMAGE, {float(recording->internImage(image)), x, y, w, h});
+}
+
+void CommandBufferDrawer::drawImageQuads(Image* image, const ImageQuad* quads, int quadsCount) {
+    recording->addCommand(DrawerCommandBuffer::DRAW_IMAGE_QUADS, {float(recording->internImage(image))},
+            reinterpret_cast<const float*>(quads), quadsCount * QUAD_FLOATS_COUNT);
+}
+
+void CommandBufferDrawer::beginPath() {
+    recording->addPathCommand(DrawerCommandBuffer::BEGIN_PATH);
+}
+
+void CommandBufferDrawer::closePath() {
+    recording->addPathCommand(DrawerCommandBuffer::CLOSE_PATH);
+}
+
+void CommandBufferDrawer::bezierCurveTo(float c1x, float c1y, float c2x, float c2y, float x, float y) {
+    recording->addPathCommand(DrawerCommandBuffer::BEZIER_CURVE_TO, {c1x, c1y, c2x, c2y, x, y});
+}
+
+void CommandBufferDrawer::quadraticCurveTo(float cpx, float cpy, float x, float y) {
+    recording->addPathCommand(DrawerCommandBuffer::QUADRATIC_CURVE_TO, {cpx, cpy, x, y});
+}
+
+void CommandBufferDrawer::lineJoin(LineJoin type) {
+    recording->addCommand(DrawerCommandBuffer::LINE_JOIN, {float(type)});
+}
+
+void CommandBufferDrawer::rotate(float angle) {
+    recording->addCommand(DrawerCommandBuffer::ROTATE, {angle});
+}
+
+void CommandBufferDrawer::scale(float x, float y) {
+    recording->addCommand(DrawerCommandBuffer::SCALE, {x, y});
+}
+
+void CommandBufferDrawer::rect(float x, float y, float w, float h) {
+    recording->addPathCommand(DrawerCommandBuffer::RECT, {x, y, w, h});
+}
+
+void CommandBufferDrawer::roundedRect(float x, float y, float w, float h, float r) {
+    recording->addPathCommand(DrawerCommandBuffer::ROUNDED_RECT, {x, y, w, h, r});
+}
+
+void CommandBufferDrawer::roundedRectDifferentCorners(float x, float y, float w, float h, float radiusLeftTop,
+        float radiusRightTop, float radiusBottomRight, float radiusBottomLeft) {
+    recording->addPathCommand(DrawerCommandBuffer::ROUNDED_RECT_DIFFERENT_CORNERS,
+            {x, y, w, h, radiusLeftTop, radiusRightTop, radiusBottomRight, radiusBottomLeft});
+}
+
+void CommandBufferDrawer::fillRoundedRects(const RoundedRectShape* rects, int rectsCount, const Color& color) {
+    recording->addCommand(DrawerCommandBuffer::FILL_ROUNDED_RECTS, {float(recording->internColor(color))},
+            reinterpret_cast<const float*>(rects), rectsCount * ROUNDED_RECT_FLOATS_COUNT);
+}
+
+void CommandBufferDrawer::setTextFontFamily(const char* fontFamily) {
+    Drawer::setTextFontFamily(fontFamily);
+    recording->addCommand(DrawerCommandBuffer::SET_TEXT_FONT_FAMILY, {float(recording->internString(fontFamily))});
+}
+
+void CommandBufferDrawer::setTextFontSize(float fontSize) {
+    Drawer::setTextFontSize(fontSize);
+    recording->addCommand(DrawerCommandBuffer::SET_TEXT_FONT_SIZE, {fontSize});
+}
+
+void CommandBufferDrawer::setTextAlign(TextAlign align) {
+    Drawer::setTextAlign(align);
+    recording->addCommand(DrawerCommandBuffer::SET_TEXT_ALIGN, {float(align)});
+}
+
+void CommandBufferDrawer::setTextStyle(FontStyle fontStyle) {
+    Drawer::setTextStyle(fontStyle);
+    recording->addCommand(DrawerCommandBuffer::SET_TEXT_STYLE, {float(fontStyle)});
+}
+
+void CommandBufferDrawer::setTextBaseline(TextBaseline baseline) {
+    Drawer::setTextBaseline(baseline);
+    recording->addCommand(DrawerCommandBuffer::SET_TEXT_BASELINE, {float(baseline)});
+}
+
+void CommandBufferDrawer::drawTextUsingFonts(const std::string& text, float x, float y) {
+    recording->addCommand(DrawerCommandBuffer::FILL_TEXT, {float(recording->internString(text)), x, y});
+}
+
+void CommandBufferDrawer::drawShadow(float x, float y, float w, float h, float radius, float blurFactor,
+        const Color& color) {
+    recording->addCommand(DrawerCommandBuffer::DRAW_SHADOW,
+            {x, y, w, h, radius, blurFactor, float(recording->internColor(color))});
+}
+
+void CommandBufferDrawer::doTranslate(float x, float y) {
+    recording->addCommand(DrawerCommandBuffer::TRANSLATE, {x, y});
+}
+
+Drawer::Image* CommandBufferDrawer::createImage(const void* data, int w, int h) {
+    imagesVersion++;
+    return backend->createImage(data, w, h);
+}
+
+void CommandBufferDrawer::deleteImage(Image*& image) {
+    if (image == nullptr) {
+        return;
+    }
+
+    imagesVersion++;
+    backend->deleteImage(image);
+}
+
+Drawer::Image* CommandBufferDrawer::createImageNative(int w, int h, const void* data) {
+    return createImage(data, w, h);
+}
+
+Drawer::Image* CommandBufferDrawer::renderIntoImageNative(const std::function<void()>& renderingFunction,
+        int w, int h) {
+    DrawerCommandBuffer layer;
+    DrawerCommandBuffer* frameRecording = recording;
+    recording = &layer;
+    renderingFunction();
+    layer.finish();
+    recording = frameRecording;
+
+    imagesVersion++;
+    return backend->renderIntoImage([&] {
+        layer.replay(backend);
+    }, w, h, getDevicePixelRatio());
+}
+
+Drawer::Color CommandBufferDrawer::getFillColor() const {
+    return fillColor;
+}
+
+void CommandBufferDrawer::setSubmitOnEndFrame(bool submitOnEndFrame) {
+    this->submitOnEndFrame = submitOnEndFrame;
+}
+
+void CommandBufferDrawer::setSkipIdenticalFrames(bool skipIdenticalFrames) {
+    this->skipIdenticalFrames = skipIdenticalFrames;
+}
+
+bool CommandBufferDrawer::isLastFrameSkipped() const {
+    return lastFrameSkipped;
+}
+
+const DrawerCommandBuffer& CommandBufferDrawer::getLastFrame() const {
+    return lastFrame;
+}
+
+Drawer* CommandBufferDrawer::getBackend() const {
+    return backend;
+}
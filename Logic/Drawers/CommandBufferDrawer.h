@@ -0,0 +1,231 @@
+#ifndef VOCALTRAINER_COMMANDBUFFERDRAWER_H
+#define VOCALTRAINER_COMMANDBUFFERDRAWER_H
+
+#include "Drawer.h"
+#include <cstdint>
+#include <initializer_list>
+#include <unordered_map>
+
+// Recorded Drawer calls. Every command is a header word, opcode | argumentsCount << 8, followed by its float
+// arguments in a separate stream. Colors, strings and images are interned into tables and referenced by index,
+// a run of path building commands is interned as a path, so a geometry repeated in the frame is stored once.
+// Indexes are stored as floats, they are exact below 2^24.
+// Buffers are replayable on any drawer, comparable by hash and serializable, images are not serialized,
+// only their sizes, a deserialized buffer should be given the images by setImage before replay.
+class DrawerCommandBuffer {
+public:
+    enum Opcode : uint8_t {
+        CLEAR,
+        BEGIN_FRAME,
+        END_FRAME,
+        TRANSLATE,
+        ROTATE,
+        SCALE,
+        PATH,
+        STROKE,
+        FILL,
+        FILL_WITH_IMAGE,
+        DRAW_IMAGE,
+        DRAW_IMAGE_QUADS,
+        FILL_ROUNDED_RECTS,
+        SET_STROKE_COLOR,
+        SET_FILL_COLOR,
+        SET_STROKE_WIDTH,
+        LINE_JOIN,
+        DRAW_SHADOW,
+        SET_TEXT_FONT_FAMILY,
+        SET_TEXT_FONT_SIZE,
+        SET_TEXT_ALIGN,
+        SET_TEXT_STYLE,
+        SET_TEXT_BASELINE,
+        FILL_TEXT,
+
+        // Path building commands, recorded by addPathCommand
+        BEGIN_PATH,
+        CLOSE_PATH,
+        MOVE_TO,
+        LINE_TO,
+        ARC_TO,
+        ARC,
+        BEZIER_CURVE_TO,
+        QUADRATIC_CURVE_TO,
+        RECT,
+        ROUNDED_RECT,
+        ROUNDED_RECT_DIFFERENT_CORNERS,
+        CIRCLE,
+
+        OPCODES_COUNT
+    };
+
+    void clear();
+
+    // extraArguments follow the arguments, e.g. the quads of DRAW_IMAGE_QUADS
+    void addCommand(Opcode opcode, std::initializer_list<float> arguments = {},
+            const float* extraArguments = nullptr, int extraArgumentsCount = 0);
+    // Path building commands are collected until the next addCommand or finish and added as a PATH command
+    void addPathCommand(Opcode opcode, std::initializer_list<float> arguments = {});
+    // Adds the collected path commands, should be called before the buffer is used
+    void finish();
+
+    int internColor(const Drawer::Color& color);
+    int internString(const std::string& string);
+    int internImage(Drawer::Image* image);
+
+    void replay(Drawer* drawer) const;
+
+    // Hash of the commands and the interned tables, equal for the buffers drawing the same
+    uint64_t getHash() const;
+    bool operator==(const DrawerCommandBuffer& other) const;
+    bool operator!=(const DrawerCommandBuffer& other) const;
+    // Index of the first command drawing differently from the other buffer, -1 if the buffers draw the same.
+    // Interned values are compared, so the buffers may have different tables.
+    int findFirstDifference(const DrawerCommandBuffer& other) const;
+
+    // Human readable dump, one command per line with the interned values and paths resolved, coordinates are
+    // rounded to 0.001. Suitable for golden files.
+    void writeText(std::ostream& os) const;
+    void serialize(std::ostream& os) const;
+    // Returns false if the data is broken, the buffer is cleared in this case
+    bool deserialize(std::istream& is);
+
+    int getCommandsCount() const;
+    int getPathsCount() const;
+    int getImagesCount() const;
+    void setImage(int index, Drawer::Image* image);
+    size_t getSizeInBytes() const;
+
+private:
+    struct Path {
+        uint32_t commandsBegin;
+        uint32_t commandsEnd;
+        uint32_t argumentsBegin;
+        uint32_t argumentsEnd;
+    };
+
+    struct ImageEntry {
+        Drawer::Image* image;
+        int width;
+        int height;
+    };
+
+    std::vector<uint32_t> commands;
+    std::vector<float> arguments;
+
+    std::vector<uint32_t> colors;
+    std::unordered_map<uint32_t, int> colorIndexes;
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, int> stringIndexes;
+    std::vector<ImageEntry> images;
+    std::unordered_map<Drawer::Image*, int> imageIndexes;
+
+    // Commands of the interned paths, the collected path commands are appended after the last path
+    std::vector<uint32_t> pathCommands;
+    std::vector<float> pathArguments;
+    std::vector<Path> paths;
+    std::unordered_multimap<uint64_t, int> pathIndexes;
+
+    bool hasCollectedPath() const;
+    void execute(Drawer* drawer, Opcode opcode, const float* arguments, int argumentsCount,
+            std::vector<Drawer::ImageQuad>& quads, std::vector<Drawer::RoundedRectShape>& rects) const;
+    void writeCommand(std::ostream& os, Opcode opcode, const float* arguments, int argumentsCount) const;
+    std::vector<std::string> getCommandLines() const;
+    void rebuildIndexes();
+};
+
+// Drawer recording the calls into a DrawerCommandBuffer, the recorded frame is replayed on the backend drawer at
+// endFrame. Images are created by the backend immediately, a layer rendered by renderIntoImage is recorded and
+// replayed into the backend image right away.
+// The frame can be recorded on one thread and replayed on another with setSubmitOnEndFrame(false) and
+// getLastFrame, the images should be created on the thread the backend requires then.
+class CommandBufferDrawer : public Drawer {
+    Drawer* backend;
+    DrawerCommandBuffer frame;
+    DrawerCommandBuffer lastFrame;
+    // frame or the layer being rendered by renderIntoImage
+    DrawerCommandBuffer* recording;
+    Color fillColor;
+
+    bool submitOnEndFrame = true;
+    bool skipIdenticalFrames = false;
+    bool lastFrameSkipped = false;
+    // Images are referenced by pointers, which may be reused after delete, so a frame is never skipped after
+    // an image is created or deleted
+    int imagesVersion = 0;
+    int submittedImagesVersion = -1;
+    uint64_t submittedHash = 0;
+
+    void submit();
+
+protected:
+    void drawTextUsingFonts(const std::string &text, float x, float y) override;
+    void doTranslate(float x, float y) override;
+    Image *createImageNative(int w, int h, const void *data) override;
+    Image *renderIntoImageNative(const std::function<void()> &renderingFunction, int w, int h) override;
+    Color getFillColor() const override;
+
+public:
+    // Takes the ownership of the backend
+    explicit CommandBufferDrawer(Drawer* backend);
+    ~CommandBufferDrawer() override;
+
+    using Drawer::circle;
+    using Drawer::roundedRect;
+    using Drawer::createImage;
+
+    void clear() override;
+    void beginFrame(float width, float height, float devicePixelRatio) override;
+    void endFrame() override;
+    void moveTo(float x, float y) override;
+    void lineTo(float x, float y) override;
+    void arcTo(float x1, float y1, float x2, float y2, float radius) override;
+    void arc(float x, float y, float r, float sAngle, float eAngle) override;
+    void circle(float x, float y, float r) override;
+    void setStrokeColor(const Color& color) override;
+    void setFillColor(const Color& color) override;
+    void setStrokeWidth(float strokeWidth) override;
+    void stroke() override;
+    void fill() override;
+    void fillWithImage(Image *image, float textureX1, float textureY1, float textureX2, float textureY2) override;
+    void drawImage(float x, float y, float w, float h, Image *image) override;
+    void drawImageQuads(Image* image, const ImageQuad* quads, int quadsCount) override;
+    void beginPath() override;
+    void closePath() override;
+    void bezierCurveTo(float c1x, float c1y, float c2x, float c2y, float x, float y) override;
+    void quadraticCurveTo(float cpx, float cpy, float x, float y) override;
+    void lineJoin(LineJoin type) override;
+    void rotate(float angle) override;
+    void scale(float x, float y) override;
+    void rect(float x, float y, float w, float h) override;
+    void roundedRect(float x, float y, float w, float h, float r) override;
+    void roundedRectDifferentCorners(float x, float y, float w,
+            float h, float radiusLeftTop,
+            float radiusRightTop, float radiusBottomRight, float radiusBottomLeft) override;
+    void fillRoundedRects(const RoundedRectShape* rects, int rectsCount, const Color& color) override;
+
+    void setTextFontFamily(const char* fontFamily) override;
+    void setTextFontSize(float fontSize) override;
+    void setTextAlign(TextAlign align) override;
+    void setTextStyle(FontStyle fontStyle) override;
+    void setTextBaseline(TextBaseline baseline) override;
+
+    void drawShadow(float x, float y, float w, float h, float radius, float blurFactor, const Color &color) override;
+
+    Image* createImage(const void* data, int w, int h) override;
+    void deleteImage(Image*& image) override;
+    // The backend sections are measured by the same profiler
+    void setFrameProfiler(FrameProfiler* frameProfiler) override;
+
+    // Replays the frame on the backend at endFrame, true by default
+    void setSubmitOnEndFrame(bool submitOnEndFrame);
+    // Doesn't replay a frame drawing the same as the previous submitted one, false by default. The backend should
+    // keep the previous frame content then, e.g. the view shouldn't swap its buffers if isLastFrameSkipped.
+    void setSkipIdenticalFrames(bool skipIdenticalFrames);
+    bool isLastFrameSkipped() const;
+
+    // The last frame finished by endFrame
+    const DrawerCommandBuffer& getLastFrame() const;
+    Drawer* getBackend() const;
+};
+
+
+#endif //VOCALTRAINER_COMMANDBUFFERDRAWER_H
@@ -1,10 +1,13 @@
 #define _USE_MATH_DEFINES
 #include "Drawer.h"
-#include "Sets.h"
 #include "Core.h"
 #include "TimeUtils.h"
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
 
 using namespace CppUtils;
 using namespace std;
@@ -34,6 +37,24 @@ void Drawer::roundedRect(const RoundedRectF &rect) {
     roundedRect(rect.A.x, rect.A.y, rect.width, rect.height, rect.getRadius());
 }
 
+void Drawer::fillRoundedRects(const RoundedRectShape* rects, int rectsCount, const Color& color) {
+    Color fillColor = getFillColor();
+    setFillColor(color);
+    for (int i = 0; i < rectsCount; ++i) {
+        const RoundedRectShape& rect = rects[i];
+        if (rect.radiusLeftTop == rect.radiusRightTop && rect.radiusLeftTop == rect.radiusBottomRight &&
+                rect.radiusLeftTop == rect.radiusBottomLeft) {
+            roundedRect(rect.x, rect.y, rect.width, rect.height, rect.radiusLeftTop);
+        } else {
+            roundedRectDifferentCorners(rect.x, rect.y, rect.width, rect.height, rect.radiusLeftTop,
+                    rect.radiusRightTop, rect.radiusBottomRight, rect.radiusBottomLeft);
+        }
+        fill();
+    }
+    beginPath();
+    setFillColor(fillColor);
+}
+
 void Drawer::lineTo(const CppUtils::PointF &point) {
     lineTo(point.x, point.y);
 }
@@ -168,6 +189,29 @@ Drawer::Image* Drawer::createImage(const CppUtils::Bitmap& bitmap) {
     }
 }
 
+Drawer::Image* Drawer::renderIntoImage(const std::function<void()>& renderingFunction, int w, int h,
+        float devicePixelRatio) {
+    float frameWidth = width;
+    float frameHeight = height;
+    float frameDevicePixelRatio = this->devicePixelRatio;
+    float frameTranslateX = translateX;
+    float frameTranslateY = translateY;
+
+    width = w / devicePixelRatio;
+    height = h / devicePixelRatio;
+    this->devicePixelRatio = devicePixelRatio;
+    translateX = 0;
+    translateY = 0;
+    Image* image = renderIntoImageNative(renderingFunction, w, h);
+
+    width = frameWidth;
+    height = frameHeight;
+    this->devicePixelRatio = frameDevicePixelRatio;
+    translateX = frameTranslateX;
+    translateY = frameTranslateY;
+    return image;
+}
+
 void Drawer::deleteImage(Drawer::Image *&image) {
     if (image == nullptr) {
         return;
@@ -225,6 +269,13 @@ void Drawer::setTextFontSize(float fontSize) {
 
 void Drawer::setTextImagesFactory(DrawerTextImagesFactory *textImagesFactory) {
     assert(textImagesFactory);
+    if (this->textImagesFactory) {
+        // The atlas image is created by this drawer and is not used by the new factory
+        Image* atlasImage = this->textImagesFactory->getAtlasImage();
+        if (atlasImage != textImagesFactory->getAtlasImage()) {
+            deleteImage(atlasImage);
+        }
+    }
     delete this->textImagesFactory;
     this->textImagesFactory = textImagesFactory;
 }
@@ -240,29 +291,42 @@ void Drawer::fillText(const std::string &text, float x, float y) {
 static constexpr float LETTER_SPACING_FACTOR = 0.5f;
 
 void Drawer::drawTextUsingImages(const std::string &text, float x, float y) {
-    tempTextImages.clear();
+    if (text.empty()) {
+        return;
+    }
+
+    tempTextQuads.clear();
+    Color color = getFillColor();
+    const DrawerTextImagesFactory::Font* font = textImagesFactory->findFont((int) round(fontSize), color, fontStyle);
     float height = 0;
     float width = 0;
     for (char ch : text) {
-        Color color = getFillColor();
-        Image* image = textImagesFactory->findImage(ch, (int) round(fontSize), color, fontStyle);
-        if (!image) {
+        const DrawerTextImagesFactory::Glyph* glyph = font ? textImagesFactory->findGlyph(*font, ch) : nullptr;
+        if (!glyph) {
             std::stringstream errorMessage;
             errorMessage << "Image not found for character='"
             << ch << "', color=" << color.toHexString() << ", fontSize=" << fontSize << ", style=" << fontStyle;
             throw std::runtime_error(errorMessage.str());
         }
 
-        if (height < image->height()) {
-            height = image->height();
+        if (height < glyph->height) {
+            height = glyph->height;
         }
-        width += image->width();
-        tempTextImages.push_back(image);
+        width += glyph->width;
+
+        ImageQuad quad;
+        quad.width = glyph->width / devicePixelRatio;
+        quad.height = glyph->height / devicePixelRatio;
+        quad.imageX = glyph->x;
+        quad.imageY = glyph->y;
+        quad.imageWidth = glyph->width;
+        quad.imageHeight = glyph->height;
+        tempTextQuads.push_back(quad);
     }
     height /= devicePixelRatio;
     width /= devicePixelRatio;
 
-    width += (tempTextImages.size() - 1) * LETTER_SPACING_FACTOR;
+    width += (tempTextQuads.size() - 1) * LETTER_SPACING_FACTOR;
 
     if (textAlign == CENTER) {
         x -= width / 2;
@@ -275,14 +339,30 @@ void Drawer::drawTextUsingImages(const std::string &text, float x, float y) {
         y -= height;
     }
 
-    for (Image* image : tempTextImages) {
-        drawImage(x, y, image);
-        x += image->width() / devicePixelRatio + LETTER_SPACING_FACTOR;
+    for (ImageQuad& quad : tempTextQuads) {
+        quad.x = x;
+        quad.y = y;
+        x += quad.width + LETTER_SPACING_FACTOR;
+    }
+
+    drawImageQuads(textImagesFactory->getAtlasImage(), tempTextQuads.data(), int(tempTextQuads.size()));
+}
+
+void Drawer::drawImageQuads(Drawer::Image *image, const ImageQuad *quads, int quadsCount) {
+    float imageWidth = image->width();
+    float imageHeight = image->height();
+    for (int i = 0; i < quadsCount; ++i) {
+        const ImageQuad& quad = quads[i];
+        float scaleX = quad.width / quad.imageWidth;
+        float scaleY = quad.height / quad.imageHeight;
+        rect(quad.x, quad.y, quad.width, quad.height);
+        fillWithImage(image, quad.x - quad.imageX * scaleX, quad.y - quad.imageY * scaleY,
+                imageWidth * scaleX, imageHeight * scaleY);
     }
 }
 
 Drawer::Drawer() {
-    tempTextImages.reserve(10);
+    tempTextQuads.reserve(10);
 }
 
 void Drawer::drawImage(float x, float y, Drawer::Image *image) {
@@ -338,26 +418,181 @@ float Drawer::getTimeBetweenFrames() const {
     return timeBetweenFrames;
 }
 
-void DrawerTextImagesFactory::addImage(const DrawerTextImagesFactoryCharacterData &data) {
-    assert(data.character != '\0' && data.fontSize > 0);
-    set.insert(data);
+void Drawer::setFrameProfiler(FrameProfiler* frameProfiler) {
+    this->frameProfiler = frameProfiler;
+}
+
+FrameProfiler* Drawer::getFrameProfiler() const {
+    return frameProfiler;
+}
+
+// Transparent border around every glyph in the atlas, so texture filtering doesn't mix neighbour glyphs
+static constexpr int ATLAS_GLYPH_PADDING = 1;
+
+int DrawerTextImagesFactory::addGlyphToFont(char character, int fontSize, const Color &color,
+        Drawer::FontStyle style, const Glyph &glyph) {
+    assert(character > '\0' && fontSize > 0);
+    auto fontIterator = std::find_if(fonts.begin(), fonts.end(), [&] (const Font& font) {
+        return font.fontSize == fontSize && font.color == color && font.style == style;
+    });
+    if (fontIterator == fonts.end()) {
+        Font font;
+        font.fontSize = fontSize;
+        font.color = color;
+        font.style = style;
+        font.glyphIndexes.fill(-1);
+        fonts.push_back(font);
+        fontIterator = fonts.end() - 1;
+    }
+
+    int& glyphIndex = fontIterator->glyphIndexes[character];
+    if (glyphIndex < 0) {
+        glyphIndex = int(glyphs.size());
+        glyphs.push_back(glyph);
+    } else {
+        glyphs[glyphIndex] = glyph;
+    }
+
+    return glyphIndex;
+}
+
+void DrawerTextImagesFactory::addGlyph(char character, int fontSize, const Color &color, Drawer::FontStyle style,
+        const Bitmap &bitmap) {
+    Glyph glyph;
+    glyph.width = bitmap.getWidth();
+    glyph.height = bitmap.getHeight();
+    int glyphIndex = addGlyphToFont(character, fontSize, color, style, glyph);
+    if (glyphBitmaps.size() <= glyphIndex) {
+        glyphBitmaps.resize(glyphIndex + 1);
+    }
+    glyphBitmaps[glyphIndex] = bitmap;
+}
+
+Bitmap DrawerTextImagesFactory::packAtlas() {
+    assert(glyphBitmaps.size() == glyphs.size() && "packAtlas should be called after addGlyph calls");
+    // Shelf packing: glyphs sorted by height are placed in rows
+    std::vector<int> order(glyphs.size());
+    int area = 0;
+    int maxGlyphWidth = 0;
+    for (int i = 0; i < glyphs.size(); ++i) {
+        order[i] = i;
+        area += (glyphs[i].width + ATLAS_GLYPH_PADDING * 2) * (glyphs[i].height + ATLAS_GLYPH_PADDING * 2);
+        maxGlyphWidth = std::max(maxGlyphWidth, glyphs[i].width + ATLAS_GLYPH_PADDING * 2);
+    }
+    std::sort(order.begin(), order.end(), [&] (int a, int b) {
+        return glyphs[a].height > glyphs[b].height;
+    });
+
+    int atlasWidth = 1;
+    while (atlasWidth * atlasWidth < area || atlasWidth < maxGlyphWidth) {
+        atlasWidth *= 2;
+    }
+
+    int x = 0;
+    int y = 0;
+    int rowHeight = 0;
+    for (int index : order) {
+        Glyph& glyph = glyphs[index];
+        int paddedWidth = glyph.width + ATLAS_GLYPH_PADDING * 2;
+        if (x + paddedWidth > atlasWidth) {
+            x = 0;
+            y += rowHeight;
+            rowHeight = 0;
+        }
+        glyph.x = x + ATLAS_GLYPH_PADDING;
+        glyph.y = y + ATLAS_GLYPH_PADDING;
+        x += paddedWidth;
+        rowHeight = std::max(rowHeight, glyph.height + ATLAS_GLYPH_PADDING * 2);
+    }
+    int atlasHeight = std::max(1, y + rowHeight);
+
+    Bitmap atlas(atlasWidth, atlasHeight);
+    atlas.fill(Color::transparent());
+    unsigned char* atlasData = atlas.getData();
+    for (int i = 0; i < glyphs.size(); ++i) {
+        const Glyph& glyph = glyphs[i];
+        const unsigned char* glyphData = glyphBitmaps[i].getData();
+        if (!glyphData) {
+            continue;
+        }
+
+        for (int row = 0; row < glyph.height; ++row) {
+            memcpy(atlasData + ((glyph.y + row) * atlasWidth + glyph.x) * 4,
+                    glyphData + row * glyph.width * 4, glyph.width * 4);
+        }
+    }
+
+    glyphBitmaps.clear();
+    return atlas;
+}
+
+void DrawerTextImagesFactory::createAtlasImage(Drawer *drawer) {
+    Bitmap atlas = packAtlas();
+    setAtlasImage(drawer->createImage(atlas));
+}
+
+void DrawerTextImagesFactory::writeMetrics(std::ostream &os) const {
+    for (const Font& font : fonts) {
+        for (int character = 0; character < CHARACTERS_COUNT; ++character) {
+            int glyphIndex = font.glyphIndexes[character];
+            if (glyphIndex < 0) {
+                continue;
+            }
+
+            const Glyph& glyph = glyphs[glyphIndex];
+            char color[9];
+            snprintf(color, sizeof(color), "%02x%02x%02x%02x",
+                    (int)font.color[0], (int)font.color[1], (int)font.color[2], (int)font.color[3]);
+            os << character << " " << font.fontSize << " " << color << " " << font.style << " "
+               << glyph.x << " " << glyph.y << " " << glyph.width << " " << glyph.height << "\n";
+        }
+    }
+}
+
+bool DrawerTextImagesFactory::readMetrics(std::istream &is) {
+    fonts.clear();
+    glyphs.clear();
+    glyphBitmaps.clear();
+
+    int character, fontSize, style;
+    std::string color;
+    Glyph glyph;
+    while (is >> character >> fontSize >> color >> style >> glyph.x >> glyph.y >> glyph.width >> glyph.height) {
+        if (character <= 0 || character >= CHARACTERS_COUNT || fontSize <= 0 || color.size() != 8) {
+            return false;
+        }
+
+        auto rgba = static_cast<uint32_t>(strtoul(color.data(), nullptr, 16));
+        addGlyphToFont(char(character), fontSize, Color::fromRgba(rgba), Drawer::FontStyle(style), glyph);
+    }
+
+    return is.eof();
 }
 
-Drawer::Image *DrawerTextImagesFactory::findImage(char character, int fontSize, const CppUtils::Color &color, Drawer::FontStyle style) {
-    DrawerTextImagesFactoryCharacterData stub;
-    stub.character = character;
-    stub.fontSize = fontSize;
-    stub.color = color;
-    stub.style = style;
-    return Sets::FindOrDefault(set, stub, stub).image;
+void DrawerTextImagesFactory::setAtlasImage(Drawer::Image *atlasImage) {
+    this->atlasImage = atlasImage;
 }
 
-bool DrawerTextImagesFactoryCharacterData::operator==(const DrawerTextImagesFactoryCharacterData &rhs) const {
-    return character == rhs.character &&
-            fontSize == rhs.fontSize &&
-            color == rhs.color;
+Drawer::Image *DrawerTextImagesFactory::getAtlasImage() const {
+    return atlasImage;
 }
 
-bool DrawerTextImagesFactoryCharacterData::operator!=(const DrawerTextImagesFactoryCharacterData &rhs) const {
-    return !(rhs == *this);
+const DrawerTextImagesFactory::Font *DrawerTextImagesFactory::findFont(int fontSize, const Color &color,
+        Drawer::FontStyle style) const {
+    for (const Font& font : fonts) {
+        if (font.fontSize == fontSize && font.color == color && font.style == style) {
+            return &font;
+        }
+    }
+
+    return nullptr;
+}
+
+const DrawerTextImagesFactory::Glyph *DrawerTextImagesFactory::findGlyph(const Font &font, char character) const {
+    if (character <= '\0') {
+        return nullptr;
+    }
+
+    int glyphIndex = font.glyphIndexes[character];
+    return glyphIndex >= 0 ? &glyphs[glyphIndex] : nullptr;
 }
@@ -15,8 +15,10 @@
 #include "Bitmap.h"
 #include <string>
 #include <unordered_set>
+#include <iostream>
 
 class DrawerTextImagesFactory;
+class FrameProfiler;
 
 class Drawer {
 public:
@@ -51,6 +53,18 @@ public:
 
     typedef CppUtils::Color Color;
 
+    // Destination rectangle in local coordinates and source rectangle in image pixels
+    struct ImageQuad {
+        float x, y, width, height;
+        float imageX, imageY, imageWidth, imageHeight;
+    };
+
+    // Rectangle in local coordinates with a radius for every corner
+    struct RoundedRectShape {
+        float x, y, width, height;
+        float radiusLeftTop, radiusRightTop, radiusBottomRight, radiusBottomLeft;
+    };
+
     virtual void clear();
 
     virtual void translate(float x, float y);
@@ -76,6 +90,8 @@ public:
     virtual void fillWithImage(Image* image);
     virtual void drawImage(float x, float y, Image *image);
     virtual void drawImage(float x, float y, float w, float h, Image *image) = 0;
+    // Draws parts of the image, e.g. glyphs from an atlas. Backends supporting it should do it in a single draw call
+    virtual void drawImageQuads(Image* image, const ImageQuad* quads, int quadsCount);
     virtual void beginPath() = 0;
     virtual void closePath() = 0;
     virtual void bezierCurveTo(float c1x, float c1y, float c2x, float c2y, float x, float y) = 0;
@@ -95,6 +111,9 @@ public:
             float h, float radiusLeftTop,
             float radiusRightTop, float radiusBottomRight, float radiusBottomLeft);
     void roundedRect(const CppUtils::RoundedRectF& roundedRect);
+    // Fills the shapes with the color, e.g. all the notes. Backends supporting it should do it in a single draw call.
+    // The current path is reset, the fill color is preserved.
+    virtual void fillRoundedRects(const RoundedRectShape* rects, int rectsCount, const Color& color);
     virtual void lineTo(const CppUtils::PointF& point);
     virtual void moveTo(const CppUtils::PointF& point);
 
@@ -128,7 +147,9 @@ public:
 
     void setTextImagesFactory(DrawerTextImagesFactory *textImagesFactory);
 
-    virtual Image *renderIntoImage(const std::function<void()> &renderingFunction, int w, int h) = 0;
+    // Renders into a new w x h pixels image as a separate frame, should be called outside of beginFrame/endFrame.
+    // renderingFunction draws in points starting at 0, 0, the current frame parameters are restored afterwards.
+    Image *renderIntoImage(const std::function<void()> &renderingFunction, int w, int h, float devicePixelRatio);
 
     void resetFrameTime();
 
@@ -136,6 +157,10 @@ public:
 
     float getTimeBetweenFrames() const;
 
+    // Backend sections, e.g. endFrame, are measured while the profiler is set. The profiler is not owned.
+    virtual void setFrameProfiler(FrameProfiler* frameProfiler);
+    FrameProfiler* getFrameProfiler() const;
+
 protected:
 
     float getWidth() const;
@@ -146,6 +171,7 @@ protected:
     virtual void drawTextUsingImages(const std::string &text, float x, float y);
     virtual void doTranslate(float x, float y) = 0;
     virtual Image *createImageNative(int w, int h, const void *data) = 0;
+    virtual Image *renderIntoImageNative(const std::function<void()> &renderingFunction, int w, int h) = 0;
     virtual void registerImage(Image* image);
     virtual bool imageRegistered(Image* image) const;
     virtual void onImageDelete(Image* image);
@@ -156,9 +182,9 @@ protected:
     TextBaseline textBaseline = MIDDLE;
     TextAlign textAlign = LEFT;
 private:
-    float width;
-    float height;
-    float devicePixelRatio;
+    float width = 0;
+    float height = 0;
+    float devicePixelRatio = 1;
 
     float translateX = 0;
     float translateY = 0;
@@ -169,30 +195,60 @@ private:
 
     float frameTime = -1;
     float timeBetweenFrames = 0;
+    FrameProfiler* frameProfiler = nullptr;
 
-    std::vector<Image*> tempTextImages;
+    std::vector<ImageQuad> tempTextQuads;
 };
 
-struct DrawerTextImagesFactoryCharacterData {
-    char character = '\0';
-    int fontSize = -1;
-    CppUtils::Color color;
-    Drawer::FontStyle style;
-    Drawer::Image* image = nullptr;
+// Pre-built text images packed into a single atlas image. Glyphs are grouped by fonts,
+// a font is a combination of size, color and style, characters are looked up by index inside a font.
+class DrawerTextImagesFactory {
+public:
+    static constexpr int CHARACTERS_COUNT = 128;
+
+    // Glyph rectangle in the atlas in pixels
+    struct Glyph {
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+    };
 
-    bool operator==(const DrawerTextImagesFactoryCharacterData &rhs) const;
-    bool operator!=(const DrawerTextImagesFactoryCharacterData &rhs) const;
-};
+    struct Font {
+        int fontSize = -1;
+        CppUtils::Color color;
+        Drawer::FontStyle style = Drawer::NORMAL;
+        // character -> index in glyphs or -1
+        std::array<int, CHARACTERS_COUNT> glyphIndexes;
+    };
 
-MAKE_HASHABLE(DrawerTextImagesFactoryCharacterData, t.character, t.fontSize, t.color, t.style)
+    // Glyph bitmaps are kept until packAtlas is called
+    void addGlyph(char character, int fontSize, const CppUtils::Color& color, Drawer::FontStyle style,
+            const CppUtils::Bitmap& bitmap);
+    // Packs all the added glyph bitmaps into a single RGBA bitmap and updates the glyphs rectangles
+    CppUtils::Bitmap packAtlas();
+    // Packs the atlas and creates its image using the drawer
+    void createAtlasImage(Drawer* drawer);
+
+    // Metrics table, one glyph per line: character code, font size, rgba color in hex, style, x, y, width, height
+    void writeMetrics(std::ostream& os) const;
+    // Replaces all the glyphs, should be followed by setAtlasImage. Returns false if the table is broken
+    bool readMetrics(std::istream& is);
+    void setAtlasImage(Drawer::Image* atlasImage);
+    Drawer::Image* getAtlasImage() const;
+
+    const Font* findFont(int fontSize, const CppUtils::Color &color, Drawer::FontStyle style) const;
+    const Glyph* findGlyph(const Font& font, char character) const;
 
-class DrawerTextImagesFactory {
-public:
-    virtual void addImage(const DrawerTextImagesFactoryCharacterData& data);
-    virtual Drawer::Image *findImage(char character, int fontSize, const CppUtils::Color &color, Drawer::FontStyle style);
     virtual ~DrawerTextImagesFactory() = default;
 private:
-    std::unordered_set<DrawerTextImagesFactoryCharacterData> set;
+    std::vector<Font> fonts;
+    std::vector<Glyph> glyphs;
+    std::vector<CppUtils::Bitmap> glyphBitmaps;
+    Drawer::Image* atlasImage = nullptr;
+
+    int addGlyphToFont(char character, int fontSize, const CppUtils::Color& color, Drawer::FontStyle style,
+            const Glyph& glyph);
 };
 
 
@@ -0,0 +1,54 @@
+#include "DrawerLayer.h"
+#include <cmath>
+#include <algorithm>
+#include <cassert>
+
+DrawerLayer::DrawerLayer(Drawer* drawer) : drawer(drawer) {
+}
+
+void DrawerLayer::update(float width, float height, float devicePixelRatio,
+        const std::function<void()>& renderingFunction) {
+    int imageWidth = std::max(1, static_cast<int>(std::ceil(width * devicePixelRatio)));
+    int imageHeight = std::max(1, static_cast<int>(std::ceil(height * devicePixelRatio)));
+    this->width = width;
+    this->height = height;
+    if (valid && image->width() == imageWidth && image->height() == imageHeight) {
+        return;
+    }
+
+    drawer->deleteImage(image);
+    image = drawer->renderIntoImage(renderingFunction, imageWidth, imageHeight, devicePixelRatio);
+    valid = true;
+}
+
+void DrawerLayer::invalidate() {
+    valid = false;
+}
+
+bool DrawerLayer::isValid() const {
+    return valid;
+}
+
+float DrawerLayer::getWidth() const {
+    return width;
+}
+
+float DrawerLayer::getHeight() const {
+    return height;
+}
+
+void DrawerLayer::draw(float x, float y, float devicePixelRatio) const {
+    assert(image && "call update before draw");
+    x = std::round(x * devicePixelRatio) / devicePixelRatio;
+    y = std::round(y * devicePixelRatio) / devicePixelRatio;
+    drawer->drawImage(x, y, image->width() / devicePixelRatio, image->height() / devicePixelRatio, image);
+}
+
+void DrawerLayer::draw(float x, float y, float width, float height, float devicePixelRatio) const {
+    assert(image && "call update before draw");
+    x = std::round(x * devicePixelRatio) / devicePixelRatio;
+    y = std::round(y * devicePixelRatio) / devicePixelRatio;
+    width = std::round(width * devicePixelRatio) / devicePixelRatio;
+    height = std::round(height * devicePixelRatio) / devicePixelRatio;
+    drawer->drawImage(x, y, width, height, image);
+}
@@ -0,0 +1,37 @@
+#ifndef VOCALTRAINER_DRAWERLAYER_H
+#define VOCALTRAINER_DRAWERLAYER_H
+
+#include "Drawer.h"
+
+// Retained part of a frame. The content is rendered into an image using Drawer::renderIntoImage and
+// the image is drawn every frame, until the layer is invalidated or its size changes.
+// The image is owned by the drawer and released together with it.
+class DrawerLayer {
+    Drawer* drawer;
+    Drawer::Image* image = nullptr;
+    float width = 0;
+    float height = 0;
+    bool valid = false;
+public:
+    explicit DrawerLayer(Drawer* drawer);
+    DrawerLayer(const DrawerLayer&) = delete;
+    DrawerLayer& operator=(const DrawerLayer&) = delete;
+
+    // Renders the layer if it is invalid or its size is changed, should be called outside of beginFrame/endFrame.
+    // width and height are in points, renderingFunction draws in the layer coordinates.
+    void update(float width, float height, float devicePixelRatio, const std::function<void()>& renderingFunction);
+    void invalidate();
+    bool isValid() const;
+    // Size in points passed to the last update
+    float getWidth() const;
+    float getHeight() const;
+
+    // x and y are rounded to device pixels to keep the image sharp
+    void draw(float x, float y, float devicePixelRatio) const;
+    // Draws the image scaled to width and height, e.g. to show the content while it's out of date.
+    // width and height are rounded to device pixels too.
+    void draw(float x, float y, float width, float height, float devicePixelRatio) const;
+};
+
+
+#endif //VOCALTRAINER_DRAWERLAYER_H
@@ -0,0 +1,177 @@
+#include "FrameProfiler.h"
+#include "TimeUtils.h"
+#include <algorithm>
+#include <cstring>
+#include <cassert>
+
+using namespace CppUtils;
+
+#define LOCK std::lock_guard<std::mutex> _(mutex)
+
+double FrameProfiler::FrameRecord::getDuration() const {
+    return end - begin;
+}
+
+FrameProfiler::ScopedSection::ScopedSection(FrameProfiler* profiler, const char* name) : profiler(profiler) {
+    sectionIndex = profiler ? profiler->beginSection(name) : -1;
+}
+
+FrameProfiler::ScopedSection::~ScopedSection() {
+    if (sectionIndex >= 0) {
+        profiler->endSection(sectionIndex);
+    }
+}
+
+FrameProfiler::FrameProfiler(int recordsCount) : records(recordsCount) {
+    assert(recordsCount > 0);
+}
+
+void FrameProfiler::beginFrame() {
+    // A frame interrupted by an exception is dropped
+    current.frameIndex = ++frameIndex;
+    current.begin = TimeUtils::NowInSecondsSinceStart();
+    current.end = current.begin;
+    current.gpuTime = -1;
+    current.sectionsCount = 0;
+    depth = 0;
+    frameStarted = true;
+}
+
+void FrameProfiler::endFrame() {
+    assert(frameStarted);
+    assert(depth == 0 && "a section is not ended");
+    current.end = TimeUtils::NowInSecondsSinceStart();
+    frameStarted = false;
+
+    LOCK;
+    records[nextRecordIndex] = current;
+    nextRecordIndex = (nextRecordIndex + 1) % int(records.size());
+    recordsCount = std::min(recordsCount + 1, int(records.size()));
+}
+
+int FrameProfiler::beginSection(const char* name) {
+    if (!frameStarted || current.sectionsCount >= MAX_SECTIONS_COUNT) {
+        return -1;
+    }
+
+    int sectionIndex = current.sectionsCount++;
+    Section& section = current.sections[sectionIndex];
+    section.name = name;
+    section.depth = depth++;
+    section.begin = TimeUtils::NowInSecondsSinceStart() - current.begin;
+    section.end = section.begin;
+    return sectionIndex;
+}
+
+void FrameProfiler::endSection(int sectionIndex) {
+    assert(frameStarted && sectionIndex < current.sectionsCount);
+    current.sections[sectionIndex].end = TimeUtils::NowInSecondsSinceStart() - current.begin;
+    depth--;
+}
+
+int FrameProfiler::getFrameIndex() const {
+    return frameIndex;
+}
+
+void FrameProfiler::setGpuTime(int frameIndex, double seconds) {
+    LOCK;
+    for (int i = 0; i < recordsCount; ++i) {
+        FrameRecord& record = records[i];
+        if (record.frameIndex == frameIndex) {
+            record.gpuTime = seconds;
+            return;
+        }
+    }
+}
+
+std::vector<FrameProfiler::FrameRecord> FrameProfiler::getRecordsWithoutLock() const {
+    std::vector<FrameRecord> result;
+    result.reserve(recordsCount);
+    int firstRecordIndex = (nextRecordIndex - recordsCount + int(records.size())) % int(records.size());
+    for (int i = 0; i < recordsCount; ++i) {
+        result.push_back(records[(firstRecordIndex + i) % records.size()]);
+    }
+    return result;
+}
+
+std::vector<FrameProfiler::FrameRecord> FrameProfiler::getRecords() const {
+    LOCK;
+    return getRecordsWithoutLock();
+}
+
+std::vector<FrameProfiler::SectionSummary> FrameProfiler::getSummary() const {
+    std::vector<FrameRecord> frames = getRecords();
+    std::vector<SectionSummary> summary;
+    if (frames.empty()) {
+        return summary;
+    }
+
+    auto add = [&] (const char* name, int depth, double time, std::vector<int>& counts) {
+        auto iter = std::find_if(summary.begin(), summary.end(), [&] (const SectionSummary& item) {
+            return strcmp(item.name, name) == 0 && item.depth == depth;
+        });
+        if (iter == summary.end()) {
+            summary.push_back({name, depth, 0, 0});
+            counts.push_back(0);
+            iter = summary.end() - 1;
+        }
+        iter->averageTime += time;
+        iter->maxTime = std::max(iter->maxTime, time);
+        counts[iter - summary.begin()]++;
+    };
+
+    // The last frame defines the order, the sections missing in it are appended
+    std::vector<int> counts;
+    std::reverse(frames.begin(), frames.end());
+    for (const FrameRecord& frame : frames) {
+        add("frame", 0, frame.getDuration(), counts);
+        for (int i = 0; i < frame.sectionsCount; ++i) {
+            const Section& section = frame.sections[i];
+            add(section.name, section.depth + 1, section.end - section.begin, counts);
+        }
+        if (frame.gpuTime >= 0) {
+            add("gpu", 0, frame.gpuTime, counts);
+        }
+    }
+
+    for (int i = 0; i < summary.size(); ++i) {
+        summary[i].averageTime /= counts[i];
+    }
+    return summary;
+}
+
+void FrameProfiler::writeChromeTrace(std::ostream& os) const {
+    std::vector<FrameRecord> frames = getRecords();
+    // Microseconds
+    auto writeEvent = [&] (bool first, const std::string& name, double begin, double duration, int threadId) {
+        if (!first) {
+            os << ",\n";
+        }
+        os << R"({"name":")" << name << R"(","ph":"X","pid":1,"tid":)" << threadId
+                << R"(,"ts":)" << begin * 1e6 << R"(,"dur":)" << duration * 1e6 << "}";
+    };
+
+    std::ios::fmtflags flags = os.flags();
+    os << std::fixed;
+    os << "{\"traceEvents\":[\n";
+    bool first = true;
+    for (const FrameRecord& frame : frames) {
+        writeEvent(first, "frame " + std::to_string(frame.frameIndex), frame.begin, frame.getDuration(), 1);
+        first = false;
+        for (int i = 0; i < frame.sectionsCount; ++i) {
+            const Section& section = frame.sections[i];
+            writeEvent(false, section.name, frame.begin + section.begin, section.end - section.begin, 1);
+        }
+        if (frame.gpuTime >= 0) {
+            writeEvent(false, "gpu", frame.end, frame.gpuTime, 2);
+        }
+    }
+    os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    os.flags(flags);
+}
+
+void FrameProfiler::reset() {
+    LOCK;
+    recordsCount = 0;
+    nextRecordIndex = 0;
+}
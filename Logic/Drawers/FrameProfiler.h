@@ -0,0 +1,103 @@
+#ifndef VOCALTRAINER_FRAMEPROFILER_H
+#define VOCALTRAINER_FRAMEPROFILER_H
+
+#include <array>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <iostream>
+
+// Per-section timings of the rendered frames. Sections are measured with ScopedSection on the rendering thread,
+// sections may be nested. Finished frames are kept in a ring of records, which can be read from any thread.
+// GPU time of a frame is reported by the backend later, when its timer query is finished.
+class FrameProfiler {
+public:
+    static constexpr int MAX_SECTIONS_COUNT = 32;
+
+    struct Section {
+        // Static string
+        const char* name = nullptr;
+        // Seconds since the frame begin
+        double begin = 0;
+        double end = 0;
+        int depth = 0;
+    };
+
+    struct FrameRecord {
+        int frameIndex = -1;
+        // Seconds of TimeUtils::NowInSecondsSinceStart
+        double begin = 0;
+        double end = 0;
+        // Seconds, negative if unknown
+        double gpuTime = -1;
+        int sectionsCount = 0;
+        std::array<Section, MAX_SECTIONS_COUNT> sections;
+
+        double getDuration() const;
+    };
+
+    struct SectionSummary {
+        const char* name;
+        int depth;
+        double averageTime;
+        double maxTime;
+    };
+
+    class ScopedSection {
+        FrameProfiler* profiler;
+        int sectionIndex;
+    public:
+        // profiler can be null, nothing is measured then
+        ScopedSection(FrameProfiler* profiler, const char* name);
+        ~ScopedSection();
+        ScopedSection(const ScopedSection&) = delete;
+        ScopedSection& operator=(const ScopedSection&) = delete;
+    };
+
+    explicit FrameProfiler(int recordsCount = 120);
+    FrameProfiler(const FrameProfiler&) = delete;
+    FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+    // Rendering thread
+    void beginFrame();
+    void endFrame();
+    // Returns the section index or -1 if the frame has too many sections or no frame is started
+    int beginSection(const char* name);
+    void endSection(int sectionIndex);
+    // Index of the current frame, or the last one outside of beginFrame/endFrame
+    int getFrameIndex() const;
+    // Ignored if the frame record is already overwritten
+    void setGpuTime(int frameIndex, double seconds);
+
+    // Any thread. Records are copied, the oldest first.
+    std::vector<FrameRecord> getRecords() const;
+    // Average and max time of every section over the recorded frames measuring it, in the order of the last frame.
+    // The frame time itself is reported as the "frame" section and GPU time as the "gpu" section.
+    std::vector<SectionSummary> getSummary() const;
+    // Chrome trace event format, can be opened by chrome://tracing or Perfetto. CPU sections are on thread 1,
+    // GPU times are on thread 2, placed at the end of their frames.
+    void writeChromeTrace(std::ostream& os) const;
+    void reset();
+
+private:
+    mutable std::mutex mutex;
+    std::vector<FrameRecord> records;
+    int recordsCount = 0;
+    int nextRecordIndex = 0;
+
+    FrameRecord current;
+    int depth = 0;
+    bool frameStarted = false;
+    int frameIndex = -1;
+
+    std::vector<FrameRecord> getRecordsWithoutLock() const;
+};
+
+#define PROFILE_FRAME_SECTION_CONCAT_(a, b) a##b
+#define PROFILE_FRAME_SECTION_CONCAT(a, b) PROFILE_FRAME_SECTION_CONCAT_(a, b)
+// Measures the rest of the scope as a section of the current frame
+#define PROFILE_FRAME_SECTION(profiler, name) \
+    FrameProfiler::ScopedSection PROFILE_FRAME_SECTION_CONCAT(frameProfilerSection, __LINE__)(profiler, name)
+
+
+#endif //VOCALTRAINER_FRAMEPROFILER_H
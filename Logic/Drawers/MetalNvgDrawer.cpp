@@ -28,6 +28,10 @@ void *MetalNvgDrawer::createFrameBuffer(int w, int h) {
 
 void MetalNvgDrawer::bindFrameBuffer(void *frameBuffer) {
     mnvgBindFramebuffer(static_cast<MNVGframebuffer*>(frameBuffer));
+    if (frameBuffer) {
+        // Images rendered into frame buffers start transparent
+        mnvgClearWithColor(ctx, nvgRGBA(0, 0, 0, 0));
+    }
 }
 
 void MetalNvgDrawer::deleteFrameBuffer(void *frameBuffer) {
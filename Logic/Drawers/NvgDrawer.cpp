@@ -4,6 +4,7 @@
 //
 
 #include "NvgDrawer.h"
+#include "FrameProfiler.h"
 #include <nanovg/nanovg.h>
 #include <assert.h>
 
@@ -44,6 +45,8 @@ void NvgDrawer::beginFrame(float width, float height, float devicePixelRatio) {
 }
 
 void NvgDrawer::endFrame() {
+    // The paths are tessellated and the draw calls are submitted here
+    PROFILE_FRAME_SECTION(getFrameProfiler(), "nvgEndFrame");
     nvgEndFrame(ctx);
 }
 
@@ -123,6 +126,26 @@ void NvgDrawer::roundedRect(float x, float y, float w, float h, float r) {
     Drawer::roundedRect(x, y, w, h, r);
 }
 
+void NvgDrawer::fillRoundedRects(const RoundedRectShape* rects, int rectsCount, const Color& color) {
+    roundedRectsBuffer.resize(rectsCount * 8);
+    float* data = roundedRectsBuffer.data();
+    for (int i = 0; i < rectsCount; ++i) {
+        const RoundedRectShape& rect = rects[i];
+        float* r = data + i * 8;
+        r[0] = rect.x;
+        r[1] = rect.y;
+        r[2] = rect.width;
+        r[3] = rect.height;
+        r[4] = rect.radiusLeftTop;
+        r[5] = rect.radiusRightTop;
+        r[6] = rect.radiusBottomRight;
+        r[7] = rect.radiusBottomLeft;
+    }
+    nvgFillColor(ctx, toNvgColor(color));
+    nvgFillRoundedRects(ctx, data, rectsCount);
+    nvgFillColor(ctx, toNvgColor(fillColor));
+}
+
 void NvgDrawer::quadraticCurveTo(float cpx, float cpy, float x, float y) {
     nvgQuadTo(ctx, cpx, cpy, x, y);
 }
@@ -240,6 +263,26 @@ void NvgDrawer::drawImage(float x, float y, float w, float h, Drawer::Image *ima
     translate(-x, -y);
 }
 
+void NvgDrawer::drawImageQuads(Drawer::Image *image, const ImageQuad *quads, int quadsCount) {
+    assert(dynamic_cast<NvgImage*>(image));
+    assert(imageRegistered(image));
+    imageQuadsBuffer.resize(quadsCount * 8);
+    float* data = imageQuadsBuffer.data();
+    for (int i = 0; i < quadsCount; ++i) {
+        const ImageQuad& quad = quads[i];
+        float* q = data + i * 8;
+        q[0] = quad.x;
+        q[1] = quad.y;
+        q[2] = quad.x + quad.width;
+        q[3] = quad.y + quad.height;
+        q[4] = quad.imageX;
+        q[5] = quad.imageY;
+        q[6] = quad.imageX + quad.imageWidth;
+        q[7] = quad.imageY + quad.imageHeight;
+    }
+    nvgImageQuads(ctx, static_cast<NvgImage*>(image)->handle, data, quadsCount);
+}
+
 void
 NvgDrawer::drawShadow(float x, float y, float w, float h, float radius, float blurFactor, const Color &color) {
     NVGcolor nvgColor = toNvgColor(color);
@@ -253,10 +296,13 @@ Color NvgDrawer::getFillColor() const {
     return fillColor;
 }
 
-Drawer::Image *NvgDrawer::renderIntoImage(const std::function<void()> &renderingFunction, int w, int h) {
+Drawer::Image *NvgDrawer::renderIntoImageNative(const std::function<void()> &renderingFunction, int w, int h) {
     void* frameBuffer = createFrameBuffer(w, h);
     bindFrameBuffer(frameBuffer);
+    // nanovg renders the accumulated commands on nvgEndFrame into the currently bound frame buffer
+    nvgBeginFrame(ctx, getWidth(), getHeight(), getDevicePixelRatio());
     renderingFunction();
+    nvgEndFrame(ctx);
     bindFrameBuffer(nullptr);
     int imageHandle = getImageHandleFromFrameBuffer(frameBuffer);
     auto *image = new NvgImage(imageHandle, w, h);
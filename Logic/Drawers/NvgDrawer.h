@@ -16,6 +16,8 @@ class NvgDrawer : public Drawer {
 #endif
     CppUtils::Color fillColor;
     std::unordered_map<Image*, void*> frameBuffersImagesMap;
+    std::vector<float> imageQuadsBuffer;
+    std::vector<float> roundedRectsBuffer;
 protected:
     NVGcontext* ctx = nullptr;
     void setupBase();
@@ -24,6 +26,7 @@ protected:
     void onImageDelete(Image *image) override;
 
     Image *createImageNative(int w, int h, const void *data) override;
+    Image *renderIntoImageNative(const std::function<void()> &renderingFunction, int w, int h) override;
 
     Color getFillColor() const override;
 
@@ -56,6 +59,7 @@ public:
     void scale(float x, float y) override;
 
     void roundedRect(float x, float y, float w, float h, float r) override;
+    void fillRoundedRects(const RoundedRectShape* rects, int rectsCount, const Color& color) override;
 
     void drawTextUsingFonts(const std::string &text, float x, float y) override;
 
@@ -67,10 +71,9 @@ public:
 
     void fillWithImage(Image *image, float textureX1, float textureY1, float textureX2, float textureY2) override;
     void drawImage(float x, float y, float w, float h, Image *image) override;
+    void drawImageQuads(Image *image, const ImageQuad *quads, int quadsCount) override;
 
     void drawShadow(float x, float y, float w, float h, float radius, float blurFactor, const Color &color) override;
-
-    Image *renderIntoImage(const std::function<void()> &renderingFunction, int w, int h) override;
 };
 
 #endif //VOCALTRAINER_NVGOPENGLDRAWER_H
@@ -18,6 +18,7 @@
 #include <nanovg/nanovg_gl.h>
 #include <nanovg/fontstash.h>
 #include <NotImplementedAssert.h>
+#include "FrameProfiler.h"
 
 OpenGLNvgDrawer::OpenGLNvgDrawer() {
 #if defined(_WIN32) or defined(__linux__)
@@ -27,7 +28,7 @@ OpenGLNvgDrawer::OpenGLNvgDrawer() {
         //qDebug() << "ERROR: " << reinterpret_cast<const char *>(er);
     }
     ctx = nvgCreateGL3(NVG_ANTIALIAS | NVG_STENCIL_STROKES);
-
+    timerQueriesSupported = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
 #endif
 
 #ifdef __APPLE__
@@ -42,8 +43,61 @@ void OpenGLNvgDrawer::clear() {
     glClear(GL_COLOR_BUFFER_BIT);
 }
 
+void OpenGLNvgDrawer::endFrame() {
+    FrameProfiler* frameProfiler = getFrameProfiler();
+    if (!timerQueriesSupported || !frameProfiler) {
+        NvgDrawer::endFrame();
+        return;
+    }
+
+#if defined(_WIN32) or defined(__linux__)
+    collectTimerQueries();
+    GLuint query;
+    if (freeTimerQueries.empty()) {
+        glGenQueries(1, &query);
+    } else {
+        query = freeTimerQueries.back();
+        freeTimerQueries.pop_back();
+    }
+
+    // nanovg issues all the draw calls of the frame in nvgEndFrame
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    NvgDrawer::endFrame();
+    glEndQuery(GL_TIME_ELAPSED);
+    pendingTimerQueries.push_back({query, frameProfiler->getFrameIndex()});
+#endif
+}
+
+void OpenGLNvgDrawer::collectTimerQueries() {
+#if defined(_WIN32) or defined(__linux__)
+    // Queries are finished in the order they are issued
+    auto iter = pendingTimerQueries.begin();
+    for (; iter != pendingTimerQueries.end(); ++iter) {
+        GLint available = 0;
+        glGetQueryObjectiv(iter->query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(iter->query, GL_QUERY_RESULT, &nanoseconds);
+        if (FrameProfiler* frameProfiler = getFrameProfiler()) {
+            frameProfiler->setGpuTime(iter->frameIndex, nanoseconds * 1e-9);
+        }
+        freeTimerQueries.push_back(iter->query);
+    }
+    pendingTimerQueries.erase(pendingTimerQueries.begin(), iter);
+#endif
+}
+
 OpenGLNvgDrawer::~OpenGLNvgDrawer() {
 #if defined(_WIN32) or defined(__linux__)
+    for (const TimerQuery& timerQuery : pendingTimerQueries) {
+        freeTimerQueries.push_back(timerQuery.query);
+    }
+    if (!freeTimerQueries.empty()) {
+        glDeleteQueries(GLsizei(freeTimerQueries.size()), freeTimerQueries.data());
+    }
     nvgDeleteGL3(ctx);
 #endif
 
@@ -5,12 +5,28 @@
 #ifndef VOCALTRAINER_OPENGLNVGDRAWER_H
 #define VOCALTRAINER_OPENGLNVGDRAWER_H
 
+#include "NvgDrawer.h"
+#include <vector>
 
 class OpenGLNvgDrawer : public NvgDrawer {
+    struct TimerQuery {
+        unsigned int query;
+        int frameIndex;
+    };
+
+    // GPU time of the frames is measured with GL_TIME_ELAPSED queries while a frame profiler is set.
+    // The results are read a few frames later, when they are available, so the CPU never waits for the GPU.
+    // Not supported by the legacy OpenGL on Apple platforms.
+    bool timerQueriesSupported = false;
+    std::vector<TimerQuery> pendingTimerQueries;
+    std::vector<unsigned int> freeTimerQueries;
+
+    void collectTimerQueries();
 public:
     OpenGLNvgDrawer();
     ~OpenGLNvgDrawer() override;
     void clear() override;
+    void endFrame() override;
 };
 
 
@@ -0,0 +1,846 @@
+#define _USE_MATH_DEFINES
+#include "SoftwareDrawer.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <assert.h>
+#include "config.h"
+
+using namespace CppUtils;
+
+// Max distance between a curve and its flattened polygon in device pixels
+static constexpr float FLATTENING_TOLERANCE = 0.25f;
+static constexpr int MAX_CURVE_SEGMENTS_COUNT = 256;
+static constexpr float EPSILON = 1e-4f;
+// Coverage below this value doesn't change an 8 bit color
+static constexpr float MIN_VISIBLE_COVERAGE = 0.5f / 255.0f;
+// Max distance from device pixel boundaries for an image to be blended without sampling
+static constexpr float PIXEL_ALIGNMENT_TOLERANCE = 1e-3f;
+
+class CPP_UTILS_DLLHIDE SoftwareImage : public Drawer::Image {
+    int w;
+    int h;
+public:
+    // RGBA, non-premultiplied
+    std::vector<unsigned char> data;
+
+    SoftwareImage(int w, int h, const void* pixels) : w(w), h(h), data(size_t(w) * h * 4) {
+        if (pixels) {
+            memcpy(data.data(), pixels, data.size());
+        }
+    }
+
+    int width() override {
+        return w;
+    }
+
+    int height() override {
+        return h;
+    }
+};
+
+static Color makeColor(float r, float g, float b, float a) {
+    auto toByte = [] (float value) {
+        return static_cast<uint32_t>(std::max(0.0f, std::min(255.0f, value + 0.5f)));
+    };
+    return Color::fromRgba(toByte(r) << 24 | toByte(g) << 16 | toByte(b) << 8 | toByte(a));
+}
+
+// Source over, non-premultiplied
+static void blendPixel(unsigned char* pixel, unsigned char r, unsigned char g, unsigned char b, float sourceAlpha) {
+    float destinationAlpha = pixel[3] / 255.0f;
+    float resultAlpha = sourceAlpha + destinationAlpha * (1 - sourceAlpha);
+    float destinationFactor = destinationAlpha * (1 - sourceAlpha);
+    unsigned char source[3] = {r, g, b};
+    for (int channel = 0; channel < 3; ++channel) {
+        float value = (source[channel] * sourceAlpha + pixel[channel] * destinationFactor) / resultAlpha;
+        pixel[channel] = static_cast<unsigned char>(std::min(255.0f, value + 0.5f));
+    }
+    pixel[3] = static_cast<unsigned char>(std::min(255.0f, resultAlpha * 255.0f + 0.5f));
+}
+
+static inline void blendTexel(unsigned char* pixel, const unsigned char* texel) {
+    int alpha = texel[3];
+    if (alpha == 0) {
+        return;
+    }
+
+    if (alpha == 255 || pixel[3] == 0) {
+        memcpy(pixel, texel, 4);
+    } else if (pixel[3] == 255) {
+        // Opaque destination, the most common case for a frame
+        for (int channel = 0; channel < 3; ++channel) {
+            pixel[channel] = static_cast<unsigned char>(
+                    (texel[channel] * alpha + pixel[channel] * (255 - alpha) + 127) / 255);
+        }
+    } else {
+        blendPixel(pixel, texel[0], texel[1], texel[2], alpha / 255.0f);
+    }
+}
+
+static float signedArea(const std::vector<PointF>& polygon) {
+    float area = 0;
+    for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+        area += polygon[j].x * polygon[i].y - polygon[i].x * polygon[j].y;
+    }
+
+    return area * 0.5f;
+}
+
+static float roundedRectSignedDistance(float x, float y, float extentX, float extentY, float radius) {
+    float dx = fabsf(x) - (extentX - radius);
+    float dy = fabsf(y) - (extentY - radius);
+    float outsideX = std::max(dx, 0.0f);
+    float outsideY = std::max(dy, 0.0f);
+    return std::min(std::max(dx, dy), 0.0f) + sqrtf(outsideX * outsideX + outsideY * outsideY) - radius;
+}
+
+PointF SoftwareDrawer::Transform::apply(float x, float y) const {
+    return PointF(a * x + c * y + e, b * x + d * y + f);
+}
+
+PointF SoftwareDrawer::Transform::applyInverse(float x, float y) const {
+    float det = a * d - b * c;
+    if (fabsf(det) < 1e-12f) {
+        return PointF(0, 0);
+    }
+
+    x -= e;
+    y -= f;
+    return PointF((d * x - c * y) / det, (a * y - b * x) / det);
+}
+
+void SoftwareDrawer::Transform::premultiply(const Transform& other) {
+    Transform result;
+    result.a = a * other.a + c * other.b;
+    result.b = b * other.a + d * other.b;
+    result.c = a * other.c + c * other.d;
+    result.d = b * other.c + d * other.d;
+    result.e = a * other.e + c * other.f + e;
+    result.f = b * other.e + d * other.f + f;
+    *this = result;
+}
+
+float SoftwareDrawer::Transform::getAverageScale() const {
+    return sqrtf(fabsf(a * d - b * c));
+}
+
+SoftwareDrawer::SoftwareDrawer() {
+    fillColor = makeColor(0, 0, 0, 255);
+    strokeColor = fillColor;
+}
+
+void SoftwareDrawer::clear() {
+    if (bitmap.getData()) {
+        bitmap.fill(Color::white());
+    }
+}
+
+void SoftwareDrawer::beginFrame(float width, float height, float devicePixelRatio) {
+    Drawer::beginFrame(width, height, devicePixelRatio);
+    int bitmapWidth = static_cast<int>(roundf(width * devicePixelRatio));
+    int bitmapHeight = static_cast<int>(roundf(height * devicePixelRatio));
+    if (bitmap.getWidth() != bitmapWidth || bitmap.getHeight() != bitmapHeight) {
+        bitmap = Bitmap(bitmapWidth, bitmapHeight);
+        bitmap.fill(Color::white());
+    }
+
+    transform = Transform();
+    transform.a = transform.d = devicePixelRatio;
+    subPaths.clear();
+    hasLastPoint = false;
+}
+
+void SoftwareDrawer::endFrame() {
+    subPaths.clear();
+    hasLastPoint = false;
+}
+
+void SoftwareDrawer::addPoint(float x, float y) {
+    if (subPaths.empty()) {
+        subPaths.emplace_back();
+    }
+
+    subPaths.back().points.push_back(transform.apply(x, y));
+    lastPoint = PointF(x, y);
+    hasLastPoint = true;
+}
+
+void SoftwareDrawer::moveTo(float x, float y) {
+    if (subPaths.empty() || !subPaths.back().points.empty()) {
+        subPaths.emplace_back();
+    }
+
+    addPoint(x, y);
+}
+
+void SoftwareDrawer::lineTo(float x, float y) {
+    if (!hasLastPoint) {
+        moveTo(x, y);
+        return;
+    }
+
+    // A sub path started after closePath begins from the first point of the closed one
+    if (subPaths.back().points.empty()) {
+        subPaths.back().points.push_back(transform.apply(lastPoint.x, lastPoint.y));
+    }
+    addPoint(x, y);
+}
+
+float SoftwareDrawer::getFlatteningTolerance() const {
+    return FLATTENING_TOLERANCE / std::max(transform.getAverageScale(), EPSILON);
+}
+
+// Appends the arc from a0 to a0 + da, connects it to the current sub path if there is one
+void SoftwareDrawer::flattenArc(float cx, float cy, float r, float a0, float da) {
+    float tolerance = getFlatteningTolerance();
+    int segmentsCount = 1;
+    if (r > tolerance) {
+        float maxSegmentAngle = 2 * acosf(1 - tolerance / r);
+        segmentsCount = static_cast<int>(ceilf(fabsf(da) / maxSegmentAngle));
+        segmentsCount = std::max(1, std::min(segmentsCount, MAX_CURVE_SEGMENTS_COUNT));
+    }
+
+    for (int i = 0; i <= segmentsCount; ++i) {
+        float angle = a0 + da * i / segmentsCount;
+        float x = cx + cosf(angle) * r;
+        float y = cy + sinf(angle) * r;
+        if (i == 0 && !hasLastPoint) {
+            moveTo(x, y);
+        } else {
+            lineTo(x, y);
+        }
+    }
+}
+
+void SoftwareDrawer::arc(float x, float y, float r, float sAngle, float eAngle) {
+    // Clockwise, the same way as NvgDrawer
+    float da = eAngle - sAngle;
+    if (fabsf(da) >= 2 * M_PI) {
+        da = 2 * M_PI;
+    } else {
+        while (da < 0) {
+            da += 2 * M_PI;
+        }
+    }
+
+    flattenArc(x, y, r, sAngle, da);
+}
+
+void SoftwareDrawer::arcTo(float x1, float y1, float x2, float y2, float radius) {
+    assert(radius >= 0);
+    if (!hasLastPoint) {
+        return;
+    }
+
+    // The same construction as nvgArcTo
+    float x0 = lastPoint.x;
+    float y0 = lastPoint.y;
+    float dx0 = x0 - x1;
+    float dy0 = y0 - y1;
+    float dx1 = x2 - x1;
+    float dy1 = y2 - y1;
+    float length0 = sqrtf(dx0 * dx0 + dy0 * dy0);
+    float length1 = sqrtf(dx1 * dx1 + dy1 * dy1);
+    if (length0 < EPSILON || length1 < EPSILON || radius < EPSILON) {
+        lineTo(x1, y1);
+        return;
+    }
+
+    dx0 /= length0;
+    dy0 /= length0;
+    dx1 /= length1;
+    dy1 /= length1;
+    float cross = dx1 * dy0 - dx0 * dy1;
+    if (fabsf(cross) < EPSILON) {
+        lineTo(x1, y1);
+        return;
+    }
+
+    float angle = acosf(std::max(-1.0f, std::min(1.0f, dx0 * dx1 + dy0 * dy1)));
+    float distance = radius / tanf(angle / 2);
+    if (distance > 10000.0f) {
+        lineTo(x1, y1);
+        return;
+    }
+
+    float cx, cy, a0, a1;
+    bool clockwise;
+    if (cross > 0) {
+        cx = x1 + dx0 * distance + dy0 * radius;
+        cy = y1 + dy0 * distance - dx0 * radius;
+        a0 = atan2f(dx0, -dy0);
+        a1 = atan2f(-dx1, dy1);
+        clockwise = true;
+    } else {
+        cx = x1 + dx0 * distance - dy0 * radius;
+        cy = y1 + dy0 * distance + dx0 * radius;
+        a0 = atan2f(-dx0, dy0);
+        a1 = atan2f(dx1, -dy1);
+        clockwise = false;
+    }
+
+    float da = a1 - a0;
+    if (clockwise) {
+        while (da < 0) {
+            da += 2 * M_PI;
+        }
+    } else {
+        while (da > 0) {
+            da -= 2 * M_PI;
+        }
+    }
+
+    flattenArc(cx, cy, radius, a0, da);
+}
+
+void SoftwareDrawer::bezierCurveTo(float c1x, float c1y, float c2x, float c2y, float x, float y) {
+    if (!hasLastPoint) {
+        moveTo(c1x, c1y);
+    }
+
+    float x0 = lastPoint.x;
+    float y0 = lastPoint.y;
+    // Flattening error of n segments is bounded by max|B''| / (8 * n^2)
+    float ddx = std::max(fabsf(x0 - 2 * c1x + c2x), fabsf(c1x - 2 * c2x + x));
+    float ddy = std::max(fabsf(y0 - 2 * c1y + c2y), fabsf(c1y - 2 * c2y + y));
+    float maxSecondDerivative = 6 * sqrtf(ddx * ddx + ddy * ddy);
+    int segmentsCount = static_cast<int>(ceilf(sqrtf(maxSecondDerivative / (8 * getFlatteningTolerance()))));
+    segmentsCount = std::max(1, std::min(segmentsCount, MAX_CURVE_SEGMENTS_COUNT));
+
+    for (int i = 1; i <= segmentsCount; ++i) {
+        float t = float(i) / segmentsCount;
+        float mt = 1 - t;
+        float k0 = mt * mt * mt;
+        float k1 = 3 * mt * mt * t;
+        float k2 = 3 * mt * t * t;
+        float k3 = t * t * t;
+        lineTo(k0 * x0 + k1 * c1x + k2 * c2x + k3 * x, k0 * y0 + k1 * c1y + k2 * c2y + k3 * y);
+    }
+}
+
+void SoftwareDrawer::quadraticCurveTo(float cpx, float cpy, float x, float y) {
+    if (!hasLastPoint) {
+        moveTo(cpx, cpy);
+    }
+
+    float x0 = lastPoint.x;
+    float y0 = lastPoint.y;
+    bezierCurveTo(x0 + 2.0f / 3.0f * (cpx - x0), y0 + 2.0f / 3.0f * (cpy - y0),
+            x + 2.0f / 3.0f * (cpx - x), y + 2.0f / 3.0f * (cpy - y), x, y);
+}
+
+void SoftwareDrawer::beginPath() {
+    subPaths.clear();
+    hasLastPoint = false;
+}
+
+void SoftwareDrawer::closePath() {
+    if (subPaths.empty() || subPaths.back().points.empty()) {
+        return;
+    }
+
+    SubPath& subPath = subPaths.back();
+    subPath.closed = true;
+    PointF first = transform.applyInverse(subPath.points.front().x, subPath.points.front().y);
+    subPaths.emplace_back();
+    lastPoint = first;
+}
+
+void SoftwareDrawer::setStrokeColor(const Color& color) {
+    strokeColor = color;
+}
+
+void SoftwareDrawer::setFillColor(const Color& color) {
+    fillColor = color;
+}
+
+Color SoftwareDrawer::getFillColor() const {
+    return fillColor;
+}
+
+void SoftwareDrawer::setStrokeWidth(float strokeWidth) {
+    assert(strokeWidth > 0);
+    this->strokeWidth = strokeWidth;
+}
+
+void SoftwareDrawer::lineJoin(LineJoin type) {
+    lineJoinType = type;
+}
+
+void SoftwareDrawer::doTranslate(float x, float y) {
+    Transform translation;
+    translation.e = x;
+    translation.f = y;
+    transform.premultiply(translation);
+}
+
+void SoftwareDrawer::rotate(float angle) {
+    Transform rotation;
+    rotation.a = cosf(angle);
+    rotation.b = sinf(angle);
+    rotation.c = -rotation.b;
+    rotation.d = rotation.a;
+    transform.premultiply(rotation);
+}
+
+void SoftwareDrawer::scale(float x, float y) {
+    Transform scaling;
+    scaling.a = x;
+    scaling.d = y;
+    transform.premultiply(scaling);
+}
+
+void SoftwareDrawer::addPolygon(std::vector<PointF>&& polygon) {
+    // All the stroke pieces are oriented the same way, so their overlaps add up instead of cancelling each other
+    if (signedArea(polygon) < 0) {
+        std::reverse(polygon.begin(), polygon.end());
+    }
+
+    polygons.push_back(std::move(polygon));
+}
+
+void SoftwareDrawer::addStrokeSegment(const PointF& p0, const PointF& p1, float halfWidth) {
+    float dx = p1.x - p0.x;
+    float dy = p1.y - p0.y;
+    float length = sqrtf(dx * dx + dy * dy);
+    if (length < EPSILON) {
+        return;
+    }
+
+    float nx = -dy / length * halfWidth;
+    float ny = dx / length * halfWidth;
+    addPolygon({
+        PointF(p0.x + nx, p0.y + ny),
+        PointF(p1.x + nx, p1.y + ny),
+        PointF(p1.x - nx, p1.y - ny),
+        PointF(p0.x - nx, p0.y - ny)
+    });
+}
+
+void SoftwareDrawer::addStrokeJoin(const PointF& prev, const PointF& point, const PointF& next, float halfWidth) {
+    if (lineJoinType == ROUND) {
+        float tolerance = FLATTENING_TOLERANCE;
+        int segmentsCount = 8;
+        if (halfWidth > tolerance) {
+            segmentsCount = static_cast<int>(ceilf(2 * M_PI / (2 * acosf(1 - tolerance / halfWidth))));
+            segmentsCount = std::max(8, std::min(segmentsCount, MAX_CURVE_SEGMENTS_COUNT));
+        }
+
+        std::vector<PointF> circle(segmentsCount);
+        for (int i = 0; i < segmentsCount; ++i) {
+            float angle = 2 * M_PI * i / segmentsCount;
+            circle[i] = PointF(point.x + cosf(angle) * halfWidth, point.y + sinf(angle) * halfWidth);
+        }
+        addPolygon(std::move(circle));
+        return;
+    }
+
+    // Bevel: fill the gap between the outer corners of the adjacent segments
+    float dx0 = point.x - prev.x;
+    float dy0 = point.y - prev.y;
+    float dx1 = next.x - point.x;
+    float dy1 = next.y - point.y;
+    float length0 = sqrtf(dx0 * dx0 + dy0 * dy0);
+    float length1 = sqrtf(dx1 * dx1 + dy1 * dy1);
+    if (length0 < EPSILON || length1 < EPSILON) {
+        return;
+    }
+
+    float cross = dx0 * dy1 - dy0 * dx1;
+    float side = cross > 0 ? -halfWidth : halfWidth;
+    PointF corner0(point.x - dy0 / length0 * side, point.y + dx0 / length0 * side);
+    PointF corner1(point.x - dy1 / length1 * side, point.y + dx1 / length1 * side);
+    addPolygon({point, corner0, corner1});
+}
+
+// Adds the signed area covered by the edge to the accumulation buffer, see font-rs accumulation rasterizer
+void SoftwareDrawer::accumulateLine(PointF p0, PointF p1, int originX, int originY, int areaWidth, int areaHeight) {
+    p0.x -= originX;
+    p1.x -= originX;
+    p0.y -= originY;
+    p1.y -= originY;
+    if (fabsf(p0.y - p1.y) <= EPSILON) {
+        return;
+    }
+
+    float direction = 1;
+    if (p0.y > p1.y) {
+        std::swap(p0, p1);
+        direction = -1;
+    }
+
+    // Parts of the edge outside the area horizontally contribute as vertical edges on the area border
+    float xMin = 0;
+    float xMax = areaWidth;
+    auto clampX = [=] (float x) {
+        return std::max(xMin, std::min(xMax, x));
+    };
+    PointF pieces[4];
+    int piecesCount = 0;
+    pieces[piecesCount++] = p0;
+    float splitXs[2] = {std::min(p0.x, p1.x) < xMin ? xMin : NAN, std::max(p0.x, p1.x) > xMax ? xMax : NAN};
+    if (p0.x > p1.x) {
+        std::swap(splitXs[0], splitXs[1]);
+    }
+    for (float splitX : splitXs) {
+        if (std::isnan(splitX) || fabsf(p1.x - p0.x) < EPSILON) {
+            continue;
+        }
+        float t = (splitX - p0.x) / (p1.x - p0.x);
+        if (t > 0 && t < 1) {
+            pieces[piecesCount++] = PointF(splitX, p0.y + (p1.y - p0.y) * t);
+        }
+    }
+    pieces[piecesCount++] = p1;
+
+    int rowStride = areaWidth + 2;
+    for (int pieceIndex = 0; pieceIndex < piecesCount - 1; ++pieceIndex) {
+        PointF a(clampX(pieces[pieceIndex].x), pieces[pieceIndex].y);
+        PointF b(clampX(pieces[pieceIndex + 1].x), pieces[pieceIndex + 1].y);
+        if (b.y - a.y <= EPSILON) {
+            continue;
+        }
+
+        float dxdy = (b.x - a.x) / (b.y - a.y);
+        float x = a.x;
+        int y0 = static_cast<int>(floorf(a.y));
+        if (a.y < 0) {
+            x -= a.y * dxdy;
+            y0 = 0;
+        }
+        int y1 = std::min(areaHeight, static_cast<int>(ceilf(b.y)));
+
+        for (int y = y0; y < y1; ++y) {
+            float* row = coverage.data() + size_t(y) * rowStride;
+            float dy = std::min(float(y + 1), b.y) - std::max(float(y), a.y);
+            float xNext = x + dxdy * dy;
+            float d = dy * direction;
+            float left = std::min(x, xNext);
+            float right = std::max(x, xNext);
+            float leftFloor = floorf(left);
+            int leftIndex = static_cast<int>(leftFloor);
+            float rightCeil = ceilf(right);
+            int rightIndex = static_cast<int>(rightCeil);
+            if (rightIndex <= leftIndex + 1) {
+                float middle = 0.5f * (x + xNext) - leftFloor;
+                row[leftIndex] += d - d * middle;
+                row[leftIndex + 1] += d * middle;
+            } else {
+                float s = 1.0f / (right - left);
+                float leftFraction = left - leftFloor;
+                float a0 = 0.5f * s * (1 - leftFraction) * (1 - leftFraction);
+                float rightFraction = right - rightCeil + 1;
+                float am = 0.5f * s * rightFraction * rightFraction;
+                row[leftIndex] += d * a0;
+                if (rightIndex == leftIndex + 2) {
+                    row[leftIndex + 1] += d * (1 - a0 - am);
+                } else {
+                    float a1 = s * (1.5f - leftFraction);
+                    row[leftIndex + 1] += d * (a1 - a0);
+                    for (int xi = leftIndex + 2; xi < rightIndex - 1; ++xi) {
+                        row[xi] += d * s;
+                    }
+                    float a2 = a1 + (rightIndex - leftIndex - 3) * s;
+                    row[rightIndex - 1] += d * (1 - a2 - am);
+                }
+                row[rightIndex] += d * am;
+            }
+            x = xNext;
+        }
+    }
+}
+
+void SoftwareDrawer::rasterizePolygons(const Paint& paint) {
+    int bitmapWidth = bitmap.getWidth();
+    int bitmapHeight = bitmap.getHeight();
+    unsigned char* data = bitmap.getData();
+    if (polygons.empty() || !data) {
+        polygons.clear();
+        return;
+    }
+
+    float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+    for (const auto& polygon : polygons) {
+        for (const PointF& point : polygon) {
+            minX = std::min(minX, point.x);
+            minY = std::min(minY, point.y);
+            maxX = std::max(maxX, point.x);
+            maxY = std::max(maxY, point.y);
+        }
+    }
+
+    int originX = std::max(0, static_cast<int>(floorf(minX)));
+    int originY = std::max(0, static_cast<int>(floorf(minY)));
+    int endX = std::min(bitmapWidth, static_cast<int>(ceilf(maxX)));
+    int endY = std::min(bitmapHeight, static_cast<int>(ceilf(maxY)));
+    if (endX <= originX || endY <= originY) {
+        polygons.clear();
+        return;
+    }
+
+    int areaWidth = endX - originX;
+    int areaHeight = endY - originY;
+    int rowStride = areaWidth + 2;
+    coverage.assign(size_t(rowStride) * areaHeight, 0.0f);
+
+    for (const auto& polygon : polygons) {
+        for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+            accumulateLine(polygon[j], polygon[i], originX, originY, areaWidth, areaHeight);
+        }
+    }
+    polygons.clear();
+
+    bool isSolidColor = paint.type == COLOR_PAINT;
+    for (int y = 0; y < areaHeight; ++y) {
+        const float* row = coverage.data() + size_t(y) * rowStride;
+        unsigned char* pixel = data + (size_t(y + originY) * bitmapWidth + originX) * 4;
+        float accumulated = 0;
+        for (int x = 0; x < areaWidth; ++x, pixel += 4) {
+            accumulated += row[x];
+            float pixelCoverage = std::min(fabsf(accumulated), 1.0f);
+            if (pixelCoverage < MIN_VISIBLE_COVERAGE) {
+                continue;
+            }
+
+            Color color = isSolidColor ? paint.color : samplePaint(paint, originX + x + 0.5f, originY + y + 0.5f);
+            float sourceAlpha = color[3] / 255.0f * pixelCoverage;
+            if (sourceAlpha <= 0) {
+                continue;
+            }
+
+            blendPixel(pixel, color[0], color[1], color[2], sourceAlpha);
+        }
+    }
+}
+
+Color SoftwareDrawer::samplePaint(const Paint& paint, float x, float y) const {
+    PointF local = paint.transform.applyInverse(x, y);
+    if (paint.type == IMAGE_PAINT) {
+        auto* image = static_cast<SoftwareImage*>(paint.image);
+        int imageWidth = image->width();
+        int imageHeight = image->height();
+        if (imageWidth <= 0 || imageHeight <= 0 || paint.patternWidth <= 0 || paint.patternHeight <= 0) {
+            return Color::transparent();
+        }
+
+        int imageX = static_cast<int>(floorf((local.x - paint.patternX) / paint.patternWidth * imageWidth));
+        int imageY = static_cast<int>(floorf((local.y - paint.patternY) / paint.patternHeight * imageHeight));
+        imageX = std::max(0, std::min(imageWidth - 1, imageX));
+        imageY = std::max(0, std::min(imageHeight - 1, imageY));
+        const unsigned char* texel = image->data.data() + (size_t(imageY) * imageWidth + imageX) * 4;
+        return makeColor(texel[0], texel[1], texel[2], texel[3]);
+    }
+
+    assert(paint.type == BOX_GRADIENT_PAINT);
+    float distance = roundedRectSignedDistance(local.x - paint.boxCenterX, local.y - paint.boxCenterY,
+            paint.boxExtentX, paint.boxExtentY, paint.boxRadius);
+    float t = std::max(0.0f, std::min(1.0f, (distance + paint.feather * 0.5f) / paint.feather));
+    // Interpolate premultiplied colors, like the nanovg shader does
+    float innerAlpha = paint.color[3] / 255.0f * (1 - t);
+    float outerAlpha = paint.outerColor[3] / 255.0f * t;
+    float alpha = innerAlpha + outerAlpha;
+    if (alpha <= 0) {
+        return Color::transparent();
+    }
+
+    float channels[3];
+    for (int channel = 0; channel < 3; ++channel) {
+        channels[channel] = (paint.color[channel] * innerAlpha + paint.outerColor[channel] * outerAlpha) / alpha;
+    }
+    return makeColor(channels[0], channels[1], channels[2], alpha * 255.0f);
+}
+
+SoftwareDrawer::Paint SoftwareDrawer::createColorPaint(const Color& color) const {
+    Paint paint;
+    paint.type = COLOR_PAINT;
+    paint.color = color;
+    paint.transform = transform;
+    return paint;
+}
+
+void SoftwareDrawer::fill() {
+    for (SubPath& subPath : subPaths) {
+        if (subPath.points.size() >= 3) {
+            polygons.push_back(subPath.points);
+        }
+    }
+
+    rasterizePolygons(createColorPaint(fillColor));
+}
+
+void SoftwareDrawer::stroke() {
+    float halfWidth = strokeWidth * transform.getAverageScale() / 2;
+    for (const SubPath& subPath : subPaths) {
+        const std::vector<PointF>& points = subPath.points;
+        if (points.size() < 2) {
+            continue;
+        }
+
+        size_t pointsCount = points.size();
+        size_t segmentsCount = subPath.closed ? pointsCount : pointsCount - 1;
+        for (size_t i = 0; i < segmentsCount; ++i) {
+            addStrokeSegment(points[i], points[(i + 1) % pointsCount], halfWidth);
+        }
+
+        size_t firstJoinIndex = subPath.closed ? 0 : 1;
+        size_t endJoinIndex = subPath.closed ? pointsCount : pointsCount - 1;
+        for (size_t i = firstJoinIndex; i < endJoinIndex; ++i) {
+            addStrokeJoin(points[(i + pointsCount - 1) % pointsCount], points[i],
+                    points[(i + 1) % pointsCount], halfWidth);
+        }
+    }
+
+    rasterizePolygons(createColorPaint(strokeColor));
+}
+
+void SoftwareDrawer::fillWithImage(Image* image, float textureX1, float textureY1, float textureX2, float textureY2) {
+    assert(dynamic_cast<SoftwareImage*>(image));
+    assert(imageRegistered(image));
+    // Arguments have the same meaning as nvgImagePattern: origin and size of a single image
+    Paint paint = createColorPaint(Color::white());
+    paint.type = IMAGE_PAINT;
+    paint.image = image;
+    paint.patternX = textureX1;
+    paint.patternY = textureY1;
+    paint.patternWidth = textureX2;
+    paint.patternHeight = textureY2;
+
+    for (SubPath& subPath : subPaths) {
+        if (subPath.points.size() >= 3) {
+            polygons.push_back(subPath.points);
+        }
+    }
+    rasterizePolygons(paint);
+}
+
+void SoftwareDrawer::drawImage(float x, float y, float w, float h, Image* image) {
+    if (blitImage(x, y, w, h, image)) {
+        return;
+    }
+
+    rect(x, y, w, h);
+    fillWithImage(image, x, y, w, h);
+}
+
+bool SoftwareDrawer::blitImage(float x, float y, float w, float h, Image* image) {
+    assert(dynamic_cast<SoftwareImage*>(image));
+    unsigned char* data = bitmap.getData();
+    if (!data || transform.b != 0 || transform.c != 0 || transform.a <= 0 || transform.d <= 0) {
+        return false;
+    }
+
+    auto* softwareImage = static_cast<SoftwareImage*>(image);
+    int imageWidth = softwareImage->width();
+    int imageHeight = softwareImage->height();
+    PointF origin = transform.apply(x, y);
+    float originX = roundf(origin.x);
+    float originY = roundf(origin.y);
+    float destinationWidth = roundf(w * transform.a);
+    float destinationHeight = roundf(h * transform.d);
+    if (fabsf(origin.x - originX) > PIXEL_ALIGNMENT_TOLERANCE ||
+            fabsf(origin.y - originY) > PIXEL_ALIGNMENT_TOLERANCE ||
+            fabsf(w * transform.a - destinationWidth) > PIXEL_ALIGNMENT_TOLERANCE ||
+            fabsf(h * transform.d - destinationHeight) > PIXEL_ALIGNMENT_TOLERANCE ||
+            imageWidth <= 0 || imageHeight <= 0) {
+        return false;
+    }
+
+    int bitmapWidth = bitmap.getWidth();
+    int left = static_cast<int>(originX);
+    int top = static_cast<int>(originY);
+    int beginX = std::max(0, left);
+    int endX = std::min(bitmapWidth, left + static_cast<int>(destinationWidth));
+    int beginY = std::max(0, top);
+    int endY = std::min(bitmap.getHeight(), top + static_cast<int>(destinationHeight));
+    if (beginX >= endX || beginY >= endY) {
+        return true;
+    }
+
+    bool scaled = destinationWidth != imageWidth || destinationHeight != imageHeight;
+    if (scaled) {
+        // Texel under the center of the pixel
+        blitColumns.resize(std::max(0, endX - beginX));
+        for (int x = beginX; x < endX; ++x) {
+            int imageX = static_cast<int>((x - left + 0.5f) / destinationWidth * imageWidth);
+            blitColumns[x - beginX] = std::min(imageWidth - 1, imageX) * 4;
+        }
+    }
+
+    for (int y = beginY; y < endY; ++y) {
+        unsigned char* pixel = data + (size_t(y) * bitmapWidth + beginX) * 4;
+        if (!scaled) {
+            const unsigned char* texel = softwareImage->data.data() +
+                    (size_t(y - top) * imageWidth + beginX - left) * 4;
+            for (int x = beginX; x < endX; ++x, texel += 4, pixel += 4) {
+                blendTexel(pixel, texel);
+            }
+            continue;
+        }
+
+        int imageY = std::min(imageHeight - 1, static_cast<int>((y - top + 0.5f) / destinationHeight * imageHeight));
+        const unsigned char* row = softwareImage->data.data() + size_t(imageY) * imageWidth * 4;
+        for (const int* column = blitColumns.data(); column != blitColumns.data() + (endX - beginX); ++column) {
+            blendTexel(pixel, row + *column);
+            pixel += 4;
+        }
+    }
+
+    return true;
+}
+
+void SoftwareDrawer::drawShadow(float x, float y, float w, float h, float radius, float blurFactor, const Color& color) {
+    Paint paint = createColorPaint(color);
+    paint.type = BOX_GRADIENT_PAINT;
+    paint.boxCenterX = x + w / 2;
+    paint.boxCenterY = y + h / 2;
+    paint.boxExtentX = w / 2;
+    paint.boxExtentY = h / 2;
+    paint.boxRadius = radius;
+    paint.feather = std::max(1.0f, blurFactor);
+    paint.outerColor = Color::transparent();
+
+    rect(x - radius, y - radius, w + radius * 2, h + radius * 2);
+    for (SubPath& subPath : subPaths) {
+        if (subPath.points.size() >= 3) {
+            polygons.push_back(subPath.points);
+        }
+    }
+    rasterizePolygons(paint);
+}
+
+void SoftwareDrawer::drawTextUsingFonts(const std::string& text, float x, float y) {
+    throw std::runtime_error("SoftwareDrawer can't render fonts, use DRAW_USING_PRE_BUILD_IMAGES text draw strategy");
+}
+
+Drawer::Image* SoftwareDrawer::createImageNative(int w, int h, const void* data) {
+    return new SoftwareImage(w, h, data);
+}
+
+Drawer::Image* SoftwareDrawer::renderIntoImageNative(const std::function<void()>& renderingFunction, int w, int h) {
+    Bitmap frameBitmap = std::move(bitmap);
+    Transform frameTransform = transform;
+    std::vector<SubPath> framePath = std::move(subPaths);
+    subPaths.clear();
+    hasLastPoint = false;
+
+    bitmap = Bitmap(w, h);
+    bitmap.fill(Color::transparent());
+    transform = Transform();
+    transform.a = transform.d = getDevicePixelRatio();
+    renderingFunction();
+
+    Image* image = createImage(bitmap.getData(), w, h);
+
+    bitmap = std::move(frameBitmap);
+    transform = frameTransform;
+    subPaths = std::move(framePath);
+    hasLastPoint = false;
+    return image;
+}
+
+const Bitmap& SoftwareDrawer::getBitmap() const {
+    return bitmap;
+}
@@ -0,0 +1,123 @@
+#ifndef VOCALTRAINER_SOFTWAREDRAWER_H
+#define VOCALTRAINER_SOFTWAREDRAWER_H
+
+#include "Drawer.h"
+#include <vector>
+
+// Renders into a CppUtils::Bitmap on the CPU, no GPU or windowing system is required.
+// Used for headless rendering: benchmarks, tests and server side thumbnails.
+// Paths are flattened to polygons in device pixels and filled with an anti-aliased
+// scanline rasterizer using the accumulated signed area of the polygon edges.
+// Text can only be drawn using DRAW_USING_PRE_BUILD_IMAGES strategy.
+class SoftwareDrawer : public Drawer {
+    struct Transform {
+        float a = 1, b = 0, c = 0, d = 1, e = 0, f = 0;
+
+        CppUtils::PointF apply(float x, float y) const;
+        CppUtils::PointF applyInverse(float x, float y) const;
+        // Applies other before this transform
+        void premultiply(const Transform& other);
+        float getAverageScale() const;
+    };
+
+    enum PaintType {
+        COLOR_PAINT, IMAGE_PAINT, BOX_GRADIENT_PAINT
+    };
+
+    struct Paint {
+        PaintType type = COLOR_PAINT;
+        Color color;
+
+        Image* image = nullptr;
+        // Image pattern origin and size in local coordinates
+        float patternX = 0, patternY = 0, patternWidth = 0, patternHeight = 0;
+
+        // Box gradient center, extent, corner radius and feather in local coordinates
+        float boxCenterX = 0, boxCenterY = 0, boxExtentX = 0, boxExtentY = 0, boxRadius = 0, feather = 1;
+        Color outerColor;
+
+        Transform transform;
+    };
+
+    struct SubPath {
+        std::vector<CppUtils::PointF> points;
+        bool closed = false;
+    };
+
+    CppUtils::Bitmap bitmap;
+    Transform transform;
+
+    std::vector<SubPath> subPaths;
+    // Last path point in local coordinates, used by arcTo
+    CppUtils::PointF lastPoint;
+    bool hasLastPoint = false;
+
+    Color fillColor;
+    Color strokeColor;
+    float strokeWidth = 1;
+    LineJoin lineJoinType = MITER;
+
+    // Polygons passed to the rasterizer in device pixels
+    std::vector<std::vector<CppUtils::PointF>> polygons;
+    // Accumulated signed area per pixel, one extra column on the right for the carry
+    std::vector<float> coverage;
+    // Image columns of the destination columns of a scaled blit
+    std::vector<int> blitColumns;
+
+    void addPoint(float x, float y);
+    void flattenArc(float cx, float cy, float r, float a0, float da);
+    float getFlatteningTolerance() const;
+
+    void addPolygon(std::vector<CppUtils::PointF>&& polygon);
+    void addStrokeSegment(const CppUtils::PointF& p0, const CppUtils::PointF& p1, float halfWidth);
+    void addStrokeJoin(const CppUtils::PointF& prev, const CppUtils::PointF& point, const CppUtils::PointF& next, float halfWidth);
+    void accumulateLine(CppUtils::PointF p0, CppUtils::PointF p1, int originX, int originY, int areaWidth, int areaHeight);
+    void rasterizePolygons(const Paint& paint);
+
+    Color samplePaint(const Paint& paint, float x, float y) const;
+    // Blends the image without rasterization if it's drawn at device pixel boundaries without rotation,
+    // e.g. a retained layer. A scaled image is sampled with the nearest texel like samplePaint does.
+    bool blitImage(float x, float y, float w, float h, Image* image);
+    Paint createColorPaint(const Color& color) const;
+
+protected:
+    void drawTextUsingFonts(const std::string &text, float x, float y) override;
+    void doTranslate(float x, float y) override;
+    Image *createImageNative(int w, int h, const void *data) override;
+    Image *renderIntoImageNative(const std::function<void()> &renderingFunction, int w, int h) override;
+    Color getFillColor() const override;
+
+public:
+    SoftwareDrawer();
+
+    void clear() override;
+    void beginFrame(float width, float height, float devicePixelRatio) override;
+    void endFrame() override;
+    void moveTo(float x, float y) override;
+    void lineTo(float x, float y) override;
+    void arcTo(float x1, float y1, float x2, float y2, float radius) override;
+    void arc(float x, float y, float r, float sAngle, float eAngle) override;
+    void setStrokeColor(const Color& color) override;
+    void setFillColor(const Color& color) override;
+    void setStrokeWidth(float strokeWidth) override;
+    void stroke() override;
+    void fill() override;
+    void fillWithImage(Image *image, float textureX1, float textureY1, float textureX2, float textureY2) override;
+    void drawImage(float x, float y, float w, float h, Image *image) override;
+    void beginPath() override;
+    void closePath() override;
+    void bezierCurveTo(float c1x, float c1y, float c2x, float c2y, float x, float y) override;
+    void quadraticCurveTo(float cpx, float cpy, float x, float y) override;
+    // MITER joins are drawn as BEVEL
+    void lineJoin(LineJoin type) override;
+    void rotate(float angle) override;
+    void scale(float x, float y) override;
+
+    void drawShadow(float x, float y, float w, float h, float radius, float blurFactor, const Color &color) override;
+
+    // Result of the last frame, RGBA, non-premultiplied, size is width * devicePixelRatio x height * devicePixelRatio
+    const CppUtils::Bitmap& getBitmap() const;
+};
+
+
+#endif //VOCALTRAINER_SOFTWAREDRAWER_H
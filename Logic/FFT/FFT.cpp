@@ -1,10 +1,15 @@
 #include "FFT.h"
+
+#ifdef __APPLE__
 #include "AccelerateFFT.h"
+#else
+#include "RadixTwoFFT.h"
+#endif
 
 FFT* FFT::create() {
 #ifdef __APPLE__
     return new AccelerateFFT();
 #else
-#error Define FFT
+    return new RadixTwoFFT();
 #endif
-}
\ No newline at end of file
+}
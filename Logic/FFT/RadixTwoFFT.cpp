@@ -0,0 +1,57 @@
+#include "RadixTwoFFT.h"
+#include <cassert>
+#include <cmath>
+
+void RadixTwoFFT::setup(int size) {
+    assert(size > 0 && (size & (size - 1)) == 0 && "size should be a power of 2");
+    this->size = size;
+
+    // exp(-2*pi*i*k/size) for the forward direction, conjugated for the inverse one
+    twiddles.resize(static_cast<size_t>(size / 2));
+    for (int k = 0; k < size / 2; ++k) {
+        double angle = -2.0 * M_PI * k / size;
+        twiddles[k] = std::complex<float>(float(cos(angle)), float(sin(angle)));
+    }
+
+    bitReversedIndexes.resize(static_cast<size_t>(size));
+    int bitsCount = 0;
+    while ((1 << bitsCount) < size) {
+        bitsCount++;
+    }
+    for (int i = 0; i < size; ++i) {
+        int reversed = 0;
+        for (int bit = 0; bit < bitsCount; ++bit) {
+            reversed |= ((i >> bit) & 1) << (bitsCount - 1 - bit);
+        }
+        bitReversedIndexes[i] = reversed;
+    }
+}
+
+void RadixTwoFFT::execute(std::vector<std::complex<float>> *inOutData, bool forward) {
+    assert(size > 0 && "call setup before execute");
+    inOutData->resize(static_cast<size_t>(size));
+    std::complex<float>* data = inOutData->data();
+
+    for (int i = 0; i < size; ++i) {
+        int j = bitReversedIndexes[i];
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+
+    for (int length = 2; length <= size; length *= 2) {
+        int half = length / 2;
+        int twiddleStep = size / length;
+        for (int begin = 0; begin < size; begin += length) {
+            for (int k = 0; k < half; ++k) {
+                std::complex<float> twiddle = twiddles[k * twiddleStep];
+                if (!forward) {
+                    twiddle = std::conj(twiddle);
+                }
+                std::complex<float> odd = data[begin + k + half] * twiddle;
+                data[begin + k + half] = data[begin + k] - odd;
+                data[begin + k] += odd;
+            }
+        }
+    }
+}
@@ -0,0 +1,17 @@
+#ifndef VOCALTRAINER_RADIXTWOFFT_H
+#define VOCALTRAINER_RADIXTWOFFT_H
+
+#include "FFT.h"
+
+// Portable iterative radix-2 FFT, used where Accelerate is not available. Like vDSP, neither direction is scaled.
+class RadixTwoFFT : public FFT {
+    int size = 0;
+    std::vector<std::complex<float>> twiddles;
+    std::vector<int> bitReversedIndexes;
+public:
+    void setup(int size) override;
+    void execute(std::vector<std::complex<float>> *inOutData, bool forward) override;
+};
+
+
+#endif //VOCALTRAINER_RADIXTWOFFT_H
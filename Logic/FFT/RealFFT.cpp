@@ -0,0 +1,61 @@
+#include "RealFFT.h"
+#include <cassert>
+#include <cmath>
+
+RealFFT::RealFFT(int size) : size(size), fft(FFT::create()) {
+    assert(size >= 4 && (size & (size - 1)) == 0 && "size should be a power of 2");
+    int half = size / 2;
+    fft->setup(half);
+    buffer.resize(static_cast<size_t>(half));
+    twiddles.resize(static_cast<size_t>(half));
+    for (int k = 0; k < half; ++k) {
+        double angle = -2.0 * M_PI * k / size;
+        twiddles[k] = std::complex<float>(float(cos(angle)), float(sin(angle)));
+    }
+}
+
+void RealFFT::forward(const float* input, std::complex<float>* spectrum) {
+    int half = size / 2;
+    // Even samples as the real parts, odd ones as the imaginary parts
+    for (int i = 0; i < half; ++i) {
+        buffer[i] = std::complex<float>(input[2 * i], input[2 * i + 1]);
+    }
+    fft->execute(&buffer, true);
+
+    // Split the spectra of the even and odd samples and combine them with the twiddles
+    const std::complex<float> minusHalfI(0, -0.5f);
+    for (int k = 0; k <= half; ++k) {
+        std::complex<float> z = buffer[k % half];
+        std::complex<float> mirrored = std::conj(buffer[(half - k) % half]);
+        std::complex<float> even = (z + mirrored) * 0.5f;
+        std::complex<float> odd = (z - mirrored) * minusHalfI;
+        std::complex<float> twiddle = k < half ? twiddles[k] : std::complex<float>(-1, 0);
+        spectrum[k] = even + odd * twiddle;
+    }
+}
+
+void RealFFT::inverse(const std::complex<float>* spectrum, float* output) {
+    int half = size / 2;
+    const std::complex<float> i(0, 1);
+    for (int k = 0; k < half; ++k) {
+        std::complex<float> x = spectrum[k];
+        std::complex<float> mirrored = std::conj(spectrum[half - k]);
+        std::complex<float> even = x + mirrored;
+        std::complex<float> odd = (x - mirrored) * std::conj(twiddles[k]);
+        buffer[k] = even + i * odd;
+    }
+    fft->execute(&buffer, false);
+
+    for (int k = 0; k < half; ++k) {
+        output[2 * k] = buffer[k].real();
+        output[2 * k + 1] = buffer[k].imag();
+    }
+}
+
+int RealFFT::getSize() const {
+    return size;
+}
+
+int RealFFT::getSpectrumSize() const {
+    return size / 2 + 1;
+}
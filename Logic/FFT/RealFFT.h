@@ -0,0 +1,27 @@
+#ifndef VOCALTRAINER_REALFFT_H
+#define VOCALTRAINER_REALFFT_H
+
+#include "FFT.h"
+#include <memory>
+
+// FFT of a real signal of a power of 2 size, computed by a complex FFT of the half size. The spectrum has
+// size / 2 + 1 bins, the rest is its conjugate mirror. Like FFT, neither direction is scaled, so
+// inverse(forward(x)) is size * x.
+class RealFFT {
+    int size;
+    std::unique_ptr<FFT> fft;
+    std::vector<std::complex<float>> buffer;
+    // exp(-2*pi*i*k/size), k < size / 2
+    std::vector<std::complex<float>> twiddles;
+public:
+    explicit RealFFT(int size);
+
+    void forward(const float* input, std::complex<float>* spectrum);
+    void inverse(const std::complex<float>* spectrum, float* output);
+
+    int getSize() const;
+    int getSpectrumSize() const;
+};
+
+
+#endif //VOCALTRAINER_REALFFT_H
@@ -4,31 +4,68 @@
 //
 
 #include "AudioInputManager.h"
-#include "SevaghPitchDetector.h"
 #include "Executors.h"
 #include "AudioInputReader.h"
 #include "AudioAverageInputLevelMonitor.h"
 #include "AudioUtils.h"
 #include "AudioToolboxInputReader.h"
 #include "NotImplementedAssert.h"
+#include <memory>
 
 static constexpr float THRESHOLD = 0.1;
 static const int BUFFER_SIZE = 1024;
 static const int SMOOTH_LEVEL = 4;
+// About an input callback
+static const int INPUT_LEVEL_POLLING_INTERVAL_IN_MILLISECONDS = 25;
 
 using namespace CppUtils;
 
-AudioInputManager::AudioInputManager(const char* deviceName) {
+AudioInputManager::AudioInputManager(const char* deviceName, const std::string& pitchDetectorEngine,
+        const PitchDetectorSettings& pitchDetectorSettings) :
+        inputLevel(0),
+        inputLevelUpdated(false),
+        levelMonitorsCount(0),
+        pitchDetectorEngine(pitchDetectorEngine) {
+    // Throws before anything is allocated, if the engine or its settings are unknown
+    std::unique_ptr<PitchDetector> firstChannelPitchDetector(
+            PitchDetectorFactory::create(pitchDetectorEngine, pitchDetectorSettings));
     audioInputReader = new AudioToolboxInputReader(BUFFER_SIZE);
     pitchesRecorder = new AudioInputPitchesRecorder();
-    pitchesRecorder->init(audioInputReader, SMOOTH_LEVEL, new SevaghPitchDetector());
-    audioInputReader->start();
-
+    pitchesRecorder->init(audioInputReader, SMOOTH_LEVEL, [&] () -> PitchDetector* {
+        if (firstChannelPitchDetector) {
+            return firstChannelPitchDetector.release();
+        }
+        return PitchDetectorFactory::create(pitchDetectorEngine, pitchDetectorSettings);
+    });
     audioRecorder = new AudioInputRecorder();
+
+    inputGraph = new AudioInputGraph(audioInputReader);
+    // The level is computed once for all the monitors, the audio thread only publishes it
+    AudioAverageInputLevelMonitor levelMonitor([=] (double value) {
+        inputLevel.store(value, std::memory_order_relaxed);
+        inputLevelUpdated.store(true, std::memory_order_release);
+    });
+    levelMonitorNodeIndex = inputGraph->addNode("level", [=] (const AudioInputBuffer& buffer) {
+        levelMonitor(buffer.getFloatData(), buffer.getSize());
+    }, false);
+    pitchesRecorderNodeIndex = inputGraph->addNode("pitches", [=] (const AudioInputBuffer& buffer) {
+        pitchesRecorder->operator()(buffer);
+    }, false);
+    audioRecorderNodeIndex = inputGraph->addNode("recording", [=] (const AudioInputBuffer& buffer) {
+        audioRecorder->operator()(buffer.getData(), buffer.getSize());
+    }, false);
+    audioInputReader->callbacks.addListener([=] (const int16_t* data, int size) {
+        inputGraph->operator()(data, size);
+    });
+    audioInputReader->start();
 }
 
 AudioInputManager::~AudioInputManager() {
+    inputLevelTimer.stop();
     delete audioInputReader;
+    delete inputGraph;
+    // The remaining level monitors are removed with inputLevelListeners
+    inputGraph = nullptr;
     delete audioRecorder;
     delete pitchesRecorder;
 }
@@ -42,13 +79,21 @@ float AudioInputManager::getInputSensitivity() const {
 }
 
 void AudioInputManager::setOutputVolume(float value) {
-    //audioInputReader->setOutputVolume(value);
+    audioInputReader->setOutputVolume(value);
 }
 
 float AudioInputManager::getOutputVolume() const {
     return audioInputReader->getOutputVolume();
 }
 
+double AudioInputManager::getOutputLatency() const {
+    return audioInputReader->getOutputLatency();
+}
+
+bool AudioInputManager::isOutputAvailable() const {
+    return audioInputReader->isOutputAvailable();
+}
+
 const char* AudioInputManager::getInputDeviceName() const {
     return audioInputReader->getDeviceName();
 }
@@ -64,22 +109,48 @@ void AudioInputManager::addAudioInputReaderCallback(const AudioInputReader::Call
 void AudioInputManager::startPitchDetection(double seek) {
     setAudioRecorderSeek(seek);
     setPitchesRecorderSeek(seek);
-    audioInputReader->callbacks.addListener(pitchesRecorder);
-    if (audioRecordingEnabled) {
-        audioInputReader->callbacks.addListener(audioRecorder);
-    }
+    inputGraph->setNodeEnabled(pitchesRecorderNodeIndex, true);
+    inputGraph->setNodeEnabled(audioRecorderNodeIndex, audioRecordingEnabled);
 }
 
 void AudioInputManager::stopPitchDetection() {
-    audioInputReader->callbacks.removeListeners(pitchesRecorder, audioRecorder);
+    inputGraph->setNodeEnabled(pitchesRecorderNodeIndex, false);
+    inputGraph->setNodeEnabled(audioRecorderNodeIndex, false);
 }
 
 void AudioInputManager::addAudioInputLevelMonitor(const std::function<void(double)> &callback, CppUtils::AbstractDestructorQueue* parent) {
-    addAudioInputReaderCallback(AudioAverageInputLevelMonitor([=] (double value) {
-        executeOnMainThread([=] {
-            callback(value);
-        });
-    }), parent);
+    // Destroyed with the last copy of the listener, when it's removed from inputLevelListeners
+    std::shared_ptr<void> removalHandle(nullptr, [this] (void*) {
+        onLevelMonitorRemoved();
+    });
+    inputLevelListeners.addListener([callback, removalHandle] (double value) {
+        callback(value);
+    }, parent);
+    if (levelMonitorsCount++ == 0) {
+        inputGraph->setNodeEnabled(levelMonitorNodeIndex, true);
+        inputLevelTimer.start(INPUT_LEVEL_POLLING_INTERVAL_IN_MILLISECONDS, [this] {
+            dispatchInputLevel();
+        }, INPUT_LEVEL_POLLING_INTERVAL_IN_MILLISECONDS);
+    }
+}
+
+void AudioInputManager::onLevelMonitorRemoved() {
+    if (--levelMonitorsCount == 0 && inputGraph) {
+        inputGraph->setNodeEnabled(levelMonitorNodeIndex, false);
+        inputLevelTimer.stop();
+    }
+}
+
+void AudioInputManager::dispatchInputLevel() {
+    // Nothing is posted while the input is stopped
+    if (!inputLevelUpdated.exchange(false, std::memory_order_acquire)) {
+        return;
+    }
+
+    double value = inputLevel.load(std::memory_order_relaxed);
+    executeOnMainThread([=] {
+        inputLevelListeners.executeAll(value);
+    });
 }
 
 bool AudioInputManager::isAudioRecordingEnabled() const {
@@ -100,14 +171,34 @@ void AudioInputManager::setPitchesRecorderSeek(double timeSeek) {
     pitchesRecorder->setSeek(timeSeek);
 }
 
+const std::string& AudioInputManager::getPitchDetectorEngine() const {
+    return pitchDetectorEngine;
+}
+
+std::vector<AudioInputGraph::StageStatistics> AudioInputManager::getInputProcessingStatistics() const {
+    return inputGraph->getStatistics();
+}
+
 CppUtils::ListenersSet<const Pitch &, double> &AudioInputManager::getPitchDetectedListeners() {
     return pitchesRecorder->pitchDetectedListeners;
 }
 
+CppUtils::ListenersSet<int, const Pitch &, double> &AudioInputManager::getChannelPitchDetectedListeners() {
+    return pitchesRecorder->channelPitchDetectedListeners;
+}
+
 const PitchesCollection *AudioInputManager::getRecordedPitches() const {
     return pitchesRecorder->getPitches();
 }
 
+const PitchesCollection *AudioInputManager::getRecordedPitches(int channel) const {
+    return pitchesRecorder->getPitches(channel);
+}
+
+int AudioInputManager::getInputChannelsCount() const {
+    return pitchesRecorder->getChannelsCount();
+}
+
 std::string AudioInputManager::getRecordedDataInWavFormat() const {
     WavConfig wavConfig = audioInputReader->generateWavConfig();
     const std::string& recordedData = audioRecorder->getRecordedData()->toBinaryString();
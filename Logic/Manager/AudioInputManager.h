@@ -7,23 +7,52 @@
 #define VOCALTRAINER_VOCALTRAINERPITCHINPUTREADER_H
 
 #include "AudioInputPitchesRecorder.h"
+#include "PitchDetectorFactory.h"
 #include "AudioInputRecorder.h"
+#include "AudioInputGraph.h"
 #include "DestructorQueue.h"
 #include "AudioDataBuffer.h"
 #include "Executors.h"
+#include "Timer.h"
+#include <atomic>
 
 class AudioInputManager : private CppUtils::OnThreadExecutor {
     AudioInputReaderWithOutput* audioInputReader = nullptr;
     AudioInputRecorder* audioRecorder = nullptr;
     AudioInputPitchesRecorder* pitchesRecorder;
+    // Executed on every input callback, converts and deinterleaves the input once for all the nodes
+    AudioInputGraph* inputGraph = nullptr;
+    int levelMonitorNodeIndex;
+    int pitchesRecorderNodeIndex;
+    int audioRecorderNodeIndex;
+    // Executed on the main thread with the last level published by the level node
+    CppUtils::SynchronizedListenersSet<double> inputLevelListeners;
+    // Written by the level node on the audio input thread, polled by inputLevelTimer
+    std::atomic<double> inputLevel;
+    std::atomic<bool> inputLevelUpdated;
+    CppUtils::Timer inputLevelTimer;
+    // The level node and the timer are running while there are level monitors
+    std::atomic<int> levelMonitorsCount;
+    std::string pitchDetectorEngine;
     bool audioRecordingEnabled = true;
+
+    void onLevelMonitorRemoved();
+    void dispatchInputLevel();
 public:
-    explicit AudioInputManager(const char* deviceName);
+    // Throws std::invalid_argument if the pitch detector engine or its settings are unknown
+    explicit AudioInputManager(const char* deviceName,
+            const std::string& pitchDetectorEngine = PitchDetectorFactory::DEFAULT_ENGINE,
+            const PitchDetectorSettings& pitchDetectorSettings = {});
 
     void setInputSensitivity(float value);
     float getInputSensitivity() const;
+    // The input is played back to the singer while the output volume is above 0
     void setOutputVolume(float value);
     float getOutputVolume() const;
+    // Delay of the played back input in seconds
+    double getOutputLatency() const;
+    // False if the input can't be played back, the output volume is ignored then
+    bool isOutputAvailable() const;
 
     void startPitchDetection(double seek);
     void stopPitchDetection();
@@ -41,8 +70,17 @@ public:
     void setAudioRecorderSeek(double timeSeek);
     void setPitchesRecorderSeek(double timeSeek);
 
+    const std::string& getPitchDetectorEngine() const;
+    // Execution time of the input processing stages
+    std::vector<AudioInputGraph::StageStatistics> getInputProcessingStatistics() const;
+
+    // Pitches of the first input channel
     CppUtils::ListenersSet<const Pitch&, double >& getPitchDetectedListeners();
     const PitchesCollection *getRecordedPitches() const;
+    // A pitch stream is recorded for every input channel, e.g. for duets
+    CppUtils::ListenersSet<int, const Pitch&, double >& getChannelPitchDetectedListeners();
+    const PitchesCollection *getRecordedPitches(int channel) const;
+    int getInputChannelsCount() const;
 
     void clearRecordedData();
 
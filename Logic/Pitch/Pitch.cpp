@@ -3,6 +3,7 @@
 //
 
 #include "Pitch.h"
+#include "PitchValue.h"
 
 #include <iostream>
 #include <assert.h>
@@ -12,12 +13,6 @@
 #include <unordered_map>
 #include "Maps.h"
 
-#ifndef NDEBUG
-#define DEBUG_INIT fullName = getFullName();
-#else
-#define DEBUG_INIT
-#endif
-
 using namespace CppUtils;
 
 static const int SOUND_FONT2_INDEX_DIFF = 24;
@@ -68,41 +63,16 @@ static const int PITCH_NAME_TO_IN_OCTAVE_INDEX[] = {
         9, 11, 0, 2, 4, 5, 7
 };
 
-// used in distance to next frequency calculation A = 2**(1/24)
-static const float A = 1.029302236643492f;
-
-static const float log2A = log2f(A);
-
 float Pitch::getFrequency() const {
     return frequency;
 }
 
 Pitch::Pitch(float frequency) : frequency(frequency) {
-    if (frequency < 0) {
-        perfectFrequencyIndex = -1;
-        return;
-    }
-
-    const float* end = FREQUENCIES + FREQUENCIES_COUNT;
-    const float* frequencyLowerBound = std::lower_bound(FREQUENCIES, end, frequency);
-    if (frequencyLowerBound == end) {
-        if (frequency > PITCHES_BOUNDS_FREQUENCIES[FREQUENCIES_COUNT]) {
-            perfectFrequencyIndex = -1;
-        } else {
-            perfectFrequencyIndex = FREQUENCIES_COUNT - 1;
-        }
-        return;
-    }
-
-    int index = (int) (frequencyLowerBound - FREQUENCIES);
-    const float * perfectFrequencyPointer = frequencyLowerBound;
-    if (frequency < PITCHES_BOUNDS_FREQUENCIES[index]) {
-        perfectFrequencyPointer--;
-    }
-
-    perfectFrequencyIndex = (int) (perfectFrequencyPointer - FREQUENCIES);
+    perfectFrequencyIndex = PitchValue::fromFrequency(frequency).getPerfectFrequencyIndex();
+}
 
-    DEBUG_INIT
+float Pitch::getContinuousPerfectFrequencyIndex(float frequency) {
+    return PitchValue::fromFrequency(frequency).getContinuousPerfectFrequencyIndex();
 }
 
 const char *Pitch::getName() const {
@@ -139,8 +109,9 @@ float Pitch::getDistanceToPerfectFrequency() const {
 
 float Pitch::getDistanceFromLowerBound() const {
     assert(hasPerfectFrequency());
-    float lowerBound = PITCHES_BOUNDS_FREQUENCIES[perfectFrequencyIndex];
-    return log2f(frequency / lowerBound) / log2A;
+    // In quarter tones, the frequency may be out of the pitch bounds after shift
+    float lowerBoundMidiNumber = MIDI_PITCH_INDEX_OFFSET + perfectFrequencyIndex - 0.5f;
+    return (PitchValue::frequencyToMidiNumber(frequency) - lowerBoundMidiNumber) * 2.0f;
 }
 
 std::string Pitch::getNameAsStdString() const {
@@ -152,10 +123,9 @@ Pitch::Pitch(float frequency, int perfectFrequencyIndex) {
     this->perfectFrequencyIndex = perfectFrequencyIndex;
     assert(perfectFrequencyIndex >= 0);
     assert(perfectFrequencyIndex < FREQUENCIES_COUNT);
-    assert(frequency >= PITCHES_BOUNDS_FREQUENCIES[perfectFrequencyIndex]);
-    assert(frequency <= PITCHES_BOUNDS_FREQUENCIES[perfectFrequencyIndex + 1]);
-
-    DEBUG_INIT
+    // The table bounds are approximate, up to 0.7 cents off the exact ones used by PitchValue
+    assert(frequency >= PITCHES_BOUNDS_FREQUENCIES[perfectFrequencyIndex] * 0.999f);
+    assert(frequency <= PITCHES_BOUNDS_FREQUENCIES[perfectFrequencyIndex + 1] * 1.001f);
 }
 
 int Pitch::getPerfectFrequencyIndex() const {
@@ -165,8 +135,6 @@ int Pitch::getPerfectFrequencyIndex() const {
 Pitch::Pitch() {
     frequency = -1;
     perfectFrequencyIndex = -1;
-
-    DEBUG_INIT
 }
 
 int Pitch::getPitchInOctaveIndex() const {
@@ -297,8 +265,6 @@ Pitch::Pitch(const char *name) {
         frequency = -1;
         perfectFrequencyIndex = -1;
     }
-
-    DEBUG_INIT
 }
 
 bool Pitch::isPerfect() const {
@@ -7,19 +7,11 @@
 
 #include <string>
 
-#ifndef NDEBUG
-#define DEBUG_INIT fullName = getFullName();
-#else
-#define DEBUG_INIT
-#endif
-
+// The frequency is mapped to the note by PitchValue. Use PitchValue in the hot paths, which need the
+// fractional position of the frequency between the notes.
 class Pitch {
     float frequency;
     int perfectFrequencyIndex;
-
-#ifndef NDEBUG
-    std::string fullName;
-#endif
 public:
     static const int OCTAVES_COUNT = 7;
     static const int FIRST_SUPPORTED_OCTAVE = 1;
@@ -53,6 +45,7 @@ public:
     float getFrequency() const;
     const char* getName() const;
     std::string getNameAsStdString() const;
+    // Computed on demand, e.g. "C#4"
     std::string getFullName() const;
     float getPerfectFrequency() const;
     int getOctave() const;
@@ -68,6 +61,10 @@ public:
     // returns value (0.0f, 2.0f). Where 1.0 - perfect frequency
     float getDistanceFromLowerBound() const;
     int getPerfectFrequencyIndex() const;
+    // perfectFrequencyIndex + getDistanceFromLowerBound() / 2 without constructing a Pitch,
+    // a continuous value in semitones, where index + 0.5 is the perfect frequency of the index.
+    // returns -1.0f if the frequency is invalid. Same as PitchValue::getContinuousPerfectFrequencyIndex.
+    static float getContinuousPerfectFrequencyIndex(float frequency);
     int getPitchInOctaveIndex() const;
     // Get index of the pitch, used in SoundFont2 format
     int getSoundFont2Index() const;
@@ -98,13 +95,10 @@ public:
     void saveOrLoad(Archive& archive, bool save) {
         archive(frequency);
         archive(perfectFrequencyIndex);
-        DEBUG_INIT
     }
 };
 
 std::ostream& operator<<(std::ostream& os, const Pitch& pitch);
 std::istream& operator>>(std::istream& is, Pitch& pitch);
 
-#undef DEBUG_INIT
-
 #endif //PITCHDETECTION_PITCH_H
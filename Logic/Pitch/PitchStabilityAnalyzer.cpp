@@ -0,0 +1,249 @@
+#include "PitchStabilityAnalyzer.h"
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+// Pole of the DC blocking filter applied to the cents before the autocorrelation, the cutoff is about 2Hz at
+// 43 pitches per second, so the drift doesn't hide the vibrato
+static constexpr float HIGH_PASS_POLE = 0.75f;
+// Running sums are recomputed from the window after this number of windows to avoid the rounding errors
+// accumulation
+static constexpr int RECOMPUTE_INTERVAL_IN_WINDOWS = 8;
+
+float PitchStabilityAnalyzer::NoteStability::getVibratoShare() const {
+    return analyzedPitchesCount > 0 ? float(vibratoPitchesCount) / analyzedPitchesCount : 0;
+}
+
+float PitchStabilityAnalyzer::NoteStability::getMeanVibratoRate() const {
+    return vibratoPitchesCount > 0 ? float(vibratoRateSum / vibratoPitchesCount) : 0;
+}
+
+float PitchStabilityAnalyzer::NoteStability::getMeanVibratoExtent() const {
+    return vibratoPitchesCount > 0 ? float(vibratoExtentSum / vibratoPitchesCount) : 0;
+}
+
+float PitchStabilityAnalyzer::NoteStability::getMeanJitter() const {
+    return analyzedPitchesCount > 0 ? float(jitterSum / analyzedPitchesCount) : 0;
+}
+
+float PitchStabilityAnalyzer::NoteStability::getDrift() const {
+    double denominator = voicedPitchesCount * timeSquaresSum - timeSum * timeSum;
+    if (voicedPitchesCount < 2 || denominator <= 0) {
+        return 0;
+    }
+
+    return float((voicedPitchesCount * timeCentsSum - timeSum * centsSum) / denominator);
+}
+
+PitchStabilityAnalyzer::PitchStabilityAnalyzer() : PitchStabilityAnalyzer(Settings()) {
+}
+
+PitchStabilityAnalyzer::PitchStabilityAnalyzer(const Settings& settings) :
+        settings(settings),
+        maxLag(settings.windowSize / 2),
+        times((size_t) settings.windowSize),
+        centsErrors((size_t) settings.windowSize),
+        filteredCents((size_t) settings.windowSize),
+        lagProductsSums((size_t) maxLag + 1) {
+    assert(settings.windowSize >= 8);
+    assert(settings.minVibratoRate > 0 && settings.minVibratoRate < settings.maxVibratoRate);
+}
+
+int PitchStabilityAnalyzer::ringIndex(int windowIndex) const {
+    return (windowBegin + windowIndex) % settings.windowSize;
+}
+
+void PitchStabilityAnalyzer::restartWindow() {
+    windowBegin = 0;
+    windowLength = 0;
+    addedSinceRecompute = 0;
+    filteredSum = 0;
+    std::fill(lagProductsSums.begin(), lagProductsSums.end(), 0.0);
+    absDifferencesSum = 0;
+    centsErrorsSum = 0;
+}
+
+void PitchStabilityAnalyzer::removeOldestPitch() {
+    assert(windowLength > 0);
+    float oldest = filteredCents[ringIndex(0)];
+    filteredSum -= oldest;
+    int lagsCount = std::min(maxLag, windowLength - 1);
+    for (int lag = 0; lag <= lagsCount; ++lag) {
+        lagProductsSums[lag] -= double(oldest) * filteredCents[ringIndex(lag)];
+    }
+    if (windowLength > 1) {
+        absDifferencesSum -= std::abs(centsErrors[ringIndex(1)] - centsErrors[ringIndex(0)]);
+    }
+    centsErrorsSum -= centsErrors[ringIndex(0)];
+
+    windowBegin = ringIndex(1);
+    windowLength--;
+}
+
+void PitchStabilityAnalyzer::recomputeSums() {
+    filteredSum = 0;
+    std::fill(lagProductsSums.begin(), lagProductsSums.end(), 0.0);
+    absDifferencesSum = 0;
+    centsErrorsSum = 0;
+    for (int i = 0; i < windowLength; ++i) {
+        float value = filteredCents[ringIndex(i)];
+        filteredSum += value;
+        for (int lag = 0; lag <= std::min(maxLag, i); ++lag) {
+            lagProductsSums[lag] += double(value) * filteredCents[ringIndex(i - lag)];
+        }
+        if (i > 0) {
+            absDifferencesSum += std::abs(centsErrors[ringIndex(i)] - centsErrors[ringIndex(i - 1)]);
+        }
+        centsErrorsSum += centsErrors[ringIndex(i)];
+    }
+    addedSinceRecompute = 0;
+}
+
+void PitchStabilityAnalyzer::updateStability() {
+    int n = windowLength;
+    stability = Stability();
+    stability.meanCentsError = float(centsErrorsSum / n);
+    stability.jitter = n > 1 ? float(absDifferencesSum / (n - 1)) : 0;
+    if (n < settings.windowSize) {
+        return;
+    }
+
+    double mean = filteredSum / n;
+    double variance = lagProductsSums[0] / n - mean * mean;
+    double interval = (times[ringIndex(n - 1)] - times[ringIndex(0)]) / (n - 1);
+    if (variance <= 1e-6 || interval <= 0) {
+        return;
+    }
+
+    auto correlation = [&] (int lag) {
+        return (lagProductsSums[lag] / (n - lag) - mean * mean) / variance;
+    };
+
+    int minLag = std::max(2, int(floor(1 / (settings.maxVibratoRate * interval))));
+    int maxVibratoLag = std::min(maxLag - 1, int(ceil(1 / (settings.minVibratoRate * interval))));
+    int bestLag = -1;
+    double bestCorrelation = settings.minVibratoCorrelation;
+    for (int lag = minLag; lag <= maxVibratoLag; ++lag) {
+        double value = correlation(lag);
+        if (value > bestCorrelation && value >= correlation(lag - 1) && value >= correlation(lag + 1)) {
+            bestLag = lag;
+            bestCorrelation = value;
+        }
+    }
+    if (bestLag < 0) {
+        return;
+    }
+
+    // Parabolic interpolation of the peak
+    double a = correlation(bestLag - 1);
+    double b = bestCorrelation;
+    double c = correlation(bestLag + 1);
+    double denominator = a - 2 * b + c;
+    double period = bestLag;
+    if (denominator < 0) {
+        period += 0.5 * (a - c) / denominator;
+    }
+    float rate = float(1 / (period * interval));
+    // Sine amplitude from its variance
+    float extent = float(sqrt(2 * variance));
+    if (rate < settings.minVibratoRate || rate > settings.maxVibratoRate || extent < settings.minVibratoExtent) {
+        return;
+    }
+
+    stability.hasVibrato = true;
+    stability.vibratoRate = rate;
+    stability.vibratoExtent = extent;
+}
+
+void PitchStabilityAnalyzer::addPitch(double time, float centsError, int noteIndex) {
+    if (noteIndex != currentNoteIndex) {
+        restartWindow();
+        currentNoteIndex = noteIndex;
+    }
+
+    if (noteIndex < 0 || std::isnan(centsError)) {
+        restartWindow();
+        stability = Stability();
+        return;
+    }
+
+    assert(noteIndex < notes.size());
+    NoteStability& note = notes[noteIndex];
+    if (note.voicedPitchesCount == 0) {
+        noteFirstPitchTime = time;
+    }
+    double timeInNote = time - noteFirstPitchTime;
+    note.voicedPitchesCount++;
+    note.timeSum += timeInNote;
+    note.centsSum += centsError;
+    note.timeSquaresSum += timeInNote * timeInNote;
+    note.timeCentsSum += timeInNote * centsError;
+
+    float filtered = 0;
+    if (windowLength > 0) {
+        filtered = centsError - lastFilterInput + HIGH_PASS_POLE * lastFilterOutput;
+    }
+    lastFilterInput = centsError;
+    lastFilterOutput = filtered;
+
+    if (windowLength == settings.windowSize) {
+        removeOldestPitch();
+    }
+
+    int index = ringIndex(windowLength);
+    times[index] = time;
+    centsErrors[index] = centsError;
+    filteredCents[index] = filtered;
+    filteredSum += filtered;
+    int lagsCount = std::min(maxLag, windowLength);
+    for (int lag = 0; lag <= lagsCount; ++lag) {
+        lagProductsSums[lag] += double(filtered) * filteredCents[ringIndex(windowLength - lag)];
+    }
+    if (windowLength > 0) {
+        absDifferencesSum += std::abs(centsError - centsErrors[ringIndex(windowLength - 1)]);
+    }
+    centsErrorsSum += centsError;
+    windowLength++;
+
+    if (++addedSinceRecompute >= settings.windowSize * RECOMPUTE_INTERVAL_IN_WINDOWS) {
+        recomputeSums();
+    }
+
+    updateStability();
+    if (windowLength == settings.windowSize) {
+        note.analyzedPitchesCount++;
+        note.jitterSum += stability.jitter;
+        if (stability.hasVibrato) {
+            note.vibratoPitchesCount++;
+            note.vibratoRateSum += stability.vibratoRate;
+            note.vibratoExtentSum += stability.vibratoExtent;
+        }
+    }
+}
+
+void PitchStabilityAnalyzer::setNotesCount(int notesCount) {
+    notes.assign((size_t) notesCount, NoteStability());
+    restartWindow();
+    currentNoteIndex = -1;
+    stability = Stability();
+}
+
+void PitchStabilityAnalyzer::resetNote(int noteIndex) {
+    notes[noteIndex] = NoteStability();
+    if (noteIndex == currentNoteIndex) {
+        restartWindow();
+        currentNoteIndex = -1;
+    }
+}
+
+const PitchStabilityAnalyzer::Stability& PitchStabilityAnalyzer::getStability() const {
+    return stability;
+}
+
+const std::vector<PitchStabilityAnalyzer::NoteStability>& PitchStabilityAnalyzer::getNotes() const {
+    return notes;
+}
+
+const PitchStabilityAnalyzer::Settings& PitchStabilityAnalyzer::getSettings() const {
+    return settings;
+}
@@ -0,0 +1,107 @@
+#ifndef VOCALTRAINER_PITCHSTABILITYANALYZER_H
+#define VOCALTRAINER_PITCHSTABILITYANALYZER_H
+
+#include <vector>
+
+// Vibrato, jitter and drift of the sung notes, updated with every pitch of the stream.
+// Pitches are given as the cents error against the target note. The analysis window is the last pitches of the
+// current voiced part of a note, it is restarted by an unvoiced pitch or a note change. Vibrato is found by
+// the autocorrelation of the high-pass filtered cents, its sums are updated incrementally, so a pitch costs
+// O(maxLag) regardless of the take length.
+class PitchStabilityAnalyzer {
+public:
+    struct Settings {
+        // Pitches in the window, about 0.75s at 43 pitches per second
+        int windowSize = 32;
+        float minVibratoRate = 3;
+        float maxVibratoRate = 9;
+        // Min normalized autocorrelation at the vibrato period
+        float minVibratoCorrelation = 0.5;
+        // Cents, smaller periodic deviations are the detector noise
+        float minVibratoExtent = 10;
+    };
+
+    // Values of the current window
+    struct Stability {
+        bool hasVibrato = false;
+        // Hz
+        float vibratoRate = 0;
+        // Cents, half of the peak to peak deviation
+        float vibratoExtent = 0;
+        // Mean absolute difference between the consecutive pitches in cents
+        float jitter = 0;
+        // Mean cents error against the target note
+        float meanCentsError = 0;
+    };
+
+    struct NoteStability {
+        // Pitches analyzed with a full window
+        int analyzedPitchesCount = 0;
+        int vibratoPitchesCount = 0;
+        double vibratoRateSum = 0;
+        double vibratoExtentSum = 0;
+        double jitterSum = 0;
+        // Linear regression of the cents error on the time since the first voiced pitch
+        int voicedPitchesCount = 0;
+        double timeSum = 0;
+        double centsSum = 0;
+        double timeSquaresSum = 0;
+        double timeCentsSum = 0;
+
+        // Share of the analyzed pitches with vibrato
+        float getVibratoShare() const;
+        float getMeanVibratoRate() const;
+        float getMeanVibratoExtent() const;
+        float getMeanJitter() const;
+        // Slope of the cents error in cents per second, positive if the pitch goes sharp
+        float getDrift() const;
+    };
+
+private:
+    Settings settings;
+    int maxLag;
+    // Ring buffers of the window
+    std::vector<double> times;
+    std::vector<float> centsErrors;
+    std::vector<float> filteredCents;
+    int windowBegin = 0;
+    int windowLength = 0;
+    int addedSinceRecompute = 0;
+    // Sums over the window: filtered cents, their products at every lag, abs differences of the consecutive
+    // cents errors and cents errors
+    double filteredSum = 0;
+    std::vector<double> lagProductsSums;
+    double absDifferencesSum = 0;
+    double centsErrorsSum = 0;
+    float lastFilterInput = 0;
+    float lastFilterOutput = 0;
+
+    int currentNoteIndex = -1;
+    double noteFirstPitchTime = 0;
+    Stability stability;
+    std::vector<NoteStability> notes;
+
+    int ringIndex(int windowIndex) const;
+    void restartWindow();
+    void removeOldestPitch();
+    void recomputeSums();
+    void updateStability();
+public:
+    PitchStabilityAnalyzer();
+    explicit PitchStabilityAnalyzer(const Settings& settings);
+
+    // centsError is NAN for unvoiced pitches, noteIndex is -1 for the pitches between the notes
+    void addPitch(double time, float centsError, int noteIndex);
+
+    // Clears the notes summaries and the window
+    void setNotesCount(int notesCount);
+    // Clears the note summary, e.g. before the note is sung again
+    void resetNote(int noteIndex);
+
+    const Stability& getStability() const;
+    const std::vector<NoteStability>& getNotes() const;
+    const Settings& getSettings() const;
+};
+
+
+#endif //VOCALTRAINER_PITCHSTABILITYANALYZER_H
@@ -0,0 +1,45 @@
+#include "PitchValue.h"
+#include "Pitch.h"
+#include <cmath>
+#include <iostream>
+
+PitchValue::PitchValue(const Pitch& pitch) {
+    if (pitch.isValid()) {
+        *this = fromFrequency(pitch.getFrequency());
+    }
+}
+
+float PitchValue::getFrequency() const {
+    if (!isValid()) {
+        return -1.0f;
+    }
+
+    return 440.0f * exp2f((midiNumber - 69) / 12);
+}
+
+Pitch PitchValue::toPitch() const {
+    if (!isValid()) {
+        return Pitch();
+    }
+
+    return Pitch(getFrequency(), getPerfectFrequencyIndex());
+}
+
+bool operator==(const PitchValue& a, const PitchValue& b) {
+    return a.getMidiNumber() == b.getMidiNumber();
+}
+
+bool operator!=(const PitchValue& a, const PitchValue& b) {
+    return !(a == b);
+}
+
+std::ostream& operator<<(std::ostream& os, const PitchValue& pitchValue) {
+    if (!pitchValue.isValid()) {
+        return os << "Invalid";
+    }
+
+    Pitch pitch = Pitch::fromMidiIndex(pitchValue.getMidiIndex());
+    os << pitch.getName() << pitch.getOctave() << std::showpos << " (" << pitchValue.getCents() << " cents)"
+            << std::noshowpos;
+    return os;
+}
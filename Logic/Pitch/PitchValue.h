@@ -0,0 +1,113 @@
+#ifndef VOCALTRAINER_PITCHVALUE_H
+#define VOCALTRAINER_PITCHVALUE_H
+
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+
+class Pitch;
+
+// Compact pitch value for the hot paths: a fractional MIDI number, 69.0 is A4 = 440 Hz, converted from a
+// frequency with a single fast log2, with the nearest note index and the cents from it cached. Invalid for the
+// frequencies outside of the Pitch range C1-B7, the same as Pitch, but the bounds are the exact quarter tones.
+class PitchValue {
+    float midiNumber = -1;
+    // [-50, 50)
+    float cents = 0;
+    int midiIndex = -1;
+
+    static constexpr int FIRST_MIDI_INDEX = 24;
+    static constexpr int LAST_MIDI_INDEX = 107;
+public:
+    PitchValue() = default;
+    static PitchValue fromFrequency(float frequency);
+    static PitchValue fromMidiNumber(float midiNumber);
+    explicit PitchValue(const Pitch& pitch);
+
+    bool isValid() const {
+        return midiIndex >= 0;
+    }
+
+    // -1 if invalid
+    float getMidiNumber() const {
+        return midiNumber;
+    }
+
+    // Nearest note, -1 if invalid
+    int getMidiIndex() const {
+        return midiIndex;
+    }
+
+    // Deviation from the nearest note
+    float getCents() const {
+        return cents;
+    }
+
+    // Same as Pitch::getPerfectFrequencyIndex
+    int getPerfectFrequencyIndex() const {
+        return isValid() ? midiIndex - FIRST_MIDI_INDEX : -1;
+    }
+
+    // Continuous value in semitones, where index + 0.5 is the perfect frequency of the index, -1 if invalid
+    float getContinuousPerfectFrequencyIndex() const {
+        return isValid() ? midiNumber - FIRST_MIDI_INDEX + 0.5f : -1.0f;
+    }
+
+    float getFrequency() const;
+    Pitch toPitch() const;
+
+    // Fractional MIDI number of any positive frequency
+    static float frequencyToMidiNumber(float frequency) {
+        // 69 + 12 * log2(frequency / 440)
+        return 12 * fastLog2(frequency) - 36.376316562f;
+    }
+
+    // Accurate to 1e-6, the error is below 0.001 cents
+    static float fastLog2(float value) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        int exponent = int((bits >> 23) & 0xFF) - 127;
+        // Mantissa in [sqrt(1/2), sqrt(2))
+        bits = (bits & 0x007FFFFF) | 0x3F800000;
+        float mantissa;
+        memcpy(&mantissa, &bits, sizeof(mantissa));
+        if (mantissa > 1.41421356f) {
+            mantissa *= 0.5f;
+            exponent++;
+        }
+
+        // log2(m) = 2 / ln(2) * atanh((m - 1) / (m + 1))
+        float t = (mantissa - 1) / (mantissa + 1);
+        float t2 = t * t;
+        float series = t * (2.88539008f + t2 * (0.961796694f + t2 * (0.577078016f + t2 * 0.412198583f)));
+        return float(exponent) + series;
+    }
+};
+
+bool operator==(const PitchValue& a, const PitchValue& b);
+bool operator!=(const PitchValue& a, const PitchValue& b);
+std::ostream& operator<<(std::ostream& os, const PitchValue& pitchValue);
+
+inline PitchValue PitchValue::fromFrequency(float frequency) {
+    if (!(frequency > 0)) {
+        return PitchValue();
+    }
+
+    return fromMidiNumber(frequencyToMidiNumber(frequency));
+}
+
+inline PitchValue PitchValue::fromMidiNumber(float midiNumber) {
+    PitchValue result;
+    if (!(midiNumber >= FIRST_MIDI_INDEX - 0.5f && midiNumber < LAST_MIDI_INDEX + 0.5f)) {
+        return result;
+    }
+
+    result.midiNumber = midiNumber;
+    // Rounds half up, the same as the bounds of Pitch
+    result.midiIndex = int(midiNumber + 0.5f);
+    result.cents = (midiNumber - float(result.midiIndex)) * 100;
+    return result;
+}
+
+
+#endif //VOCALTRAINER_PITCHVALUE_H
@@ -7,12 +7,19 @@
 #define VOCALTRAINER_PITCHESCOLLECTOR_H
 
 #include "Pitch.h"
+#include "PitchValue.h"
+#include <vector>
 
 class PitchesCollection {
 public:
     virtual void getPitchesInTimeRange(double begin, double end,
             std::vector<double>* timesOut,
             std::vector<float>* frequenciesOut) const = 0;
+    // Same as getPitchesInTimeRange, but outputs PitchValue of the frequencies, which are calculated once,
+    // when the pitches are added
+    virtual void getPitchValuesInTimeRange(double begin, double end,
+            std::vector<double>* timesOut,
+            std::vector<PitchValue>* pitchValuesOut) const = 0;
     virtual Pitch getNearestPitch(double time) const = 0;
     virtual std::vector<double> getTimes() const = 0;
     virtual std::vector<float> getFrequencies() const = 0;
@@ -4,26 +4,48 @@
 
 #include "PitchesMutableList.h"
 #include "Algorithms.h"
+#include <algorithm>
 
 #define LOCK std::lock_guard<std::mutex> _(mutex)
 
-void PitchesMutableList::getPitchesInTimeRange(
+template <typename Value>
+void PitchesMutableList::copyInTimeRange(
         double begin,
         double end,
+        const std::vector<Value>& values,
         std::vector<double> *timesOut,
-        std::vector<float> *frequenciesOut
+        std::vector<Value> *valuesOut
         ) const {
-    LOCK;
     auto range = CppUtils::FindRangeInSortedCollection(times, begin, end);
     size_t i1 = range.first - times.begin();
     size_t i2 = range.second - times.begin();
 
     size_t size = i2 - i1;
-    frequenciesOut->resize(size);
+    valuesOut->resize(size);
     timesOut->resize(size);
 
     std::copy(range.first, range.second, timesOut->begin());
-    std::copy(frequencies.begin() + i1, frequencies.begin() + i2, frequenciesOut->begin());
+    std::copy(values.begin() + i1, values.begin() + i2, valuesOut->begin());
+}
+
+void PitchesMutableList::getPitchesInTimeRange(
+        double begin,
+        double end,
+        std::vector<double> *timesOut,
+        std::vector<float> *frequenciesOut
+        ) const {
+    LOCK;
+    copyInTimeRange(begin, end, frequencies, timesOut, frequenciesOut);
+}
+
+void PitchesMutableList::getPitchValuesInTimeRange(
+        double begin,
+        double end,
+        std::vector<double> *timesOut,
+        std::vector<PitchValue> *pitchValuesOut
+        ) const {
+    LOCK;
+    copyInTimeRange(begin, end, pitchValues, timesOut, pitchValuesOut);
 }
 
 void PitchesMutableList::appendPitch(double time, float frequency) {
@@ -31,6 +53,7 @@ void PitchesMutableList::appendPitch(double time, float frequency) {
     assert(time >= CppUtils::GetLastOrDefault(times, -1) && "Unable to add a new pitch behind the time");
     frequencies.push_back(frequency);
     times.push_back(time);
+    pitchValues.push_back(PitchValue::fromFrequency(frequency));
 }
 
 std::vector<double> PitchesMutableList::getTimes() const {
@@ -55,15 +78,24 @@ Pitch PitchesMutableList::getNearestPitch(double time) const {
 }
 
 PitchesMutableList::PitchesMutableList(const std::vector<float> &frequencies, const std::vector<double> &times)
-        : frequencies(frequencies), times(times) {}
+        : frequencies(frequencies), times(times) {
+    initPitchValues();
+}
 
 PitchesMutableList::PitchesMutableList(std::vector<float> &&frequencies, std::vector<double> &&times) {
     this->frequencies = std::move(frequencies);
     this->times = std::move(times);
+    initPitchValues();
+}
+
+void PitchesMutableList::initPitchValues() {
+    pitchValues.resize(frequencies.size());
+    std::transform(frequencies.begin(), frequencies.end(), pitchValues.begin(), &PitchValue::fromFrequency);
 }
 
 void PitchesMutableList::clearPitches() {
     LOCK;
     frequencies.clear();
     times.clear();
+    pitchValues.clear();
 }
@@ -13,7 +13,14 @@ class PitchesMutableList : public PitchesCollection {
 protected:
     std::vector<float> frequencies;
     std::vector<double> times;
+    // PitchValue of frequencies
+    std::vector<PitchValue> pitchValues;
     mutable std::mutex mutex;
+
+    void initPitchValues();
+    template <typename Value>
+    void copyInTimeRange(double begin, double end, const std::vector<Value>& values,
+                         std::vector<double> *timesOut, std::vector<Value> *valuesOut) const;
 public:
     PitchesMutableList(const std::vector<float> &frequencies, const std::vector<double> &times);
     PitchesMutableList(std::vector<float> &&frequencies, std::vector<double> &&times);
@@ -21,6 +28,8 @@ public:
 
     void getPitchesInTimeRange(double begin, double end, std::vector<double> *timesOut,
                                std::vector<float> *frequenciesOut) const override;
+    void getPitchValuesInTimeRange(double begin, double end, std::vector<double> *timesOut,
+                                   std::vector<PitchValue> *pitchValuesOut) const override;
 
     void appendPitch(double time, float frequency);
     std::vector<double> getTimes() const override;
@@ -19,8 +19,8 @@ void SeekablePitchesList::setSeek(double seek) {
         // remove all pitches after seek
         auto iter = std::lower_bound(times.begin(), times.end(), seek);
         times.erase(iter, times.end());
-        int index = static_cast<int>(times.end() - iter);
-        CppUtils::EraseEndingOfCollection(frequencies, index);
+        frequencies.resize(times.size());
+        pitchValues.resize(times.size());
     }
 }
 
@@ -4,29 +4,37 @@
 //
 
 #include "MidiFileReader.h"
-#include "MidiFile.h"
 #include "VocalPart.h"
 #include "MidiFileReaderException.h"
+#include "StringUtils.h"
 
 #include <iostream>
+#include <fstream>
 #include <algorithm>
+#include <cstring>
+#include <cassert>
 
 using namespace CppUtils;
 
-static constexpr int    MAX_MIDI_CHANNELS = 15;
+static constexpr int    MAX_MIDI_CHANNELS = 16;
 
 static constexpr int    NO_CHANNEL_PREFIX = -1;
 
 static constexpr int    MICROSECONDS_IN_MINUTE = 60'000'000;
 static constexpr int    SECONDS_IN_MINUTE = 60;
 
-// MIDI Message = array[status_midi_message_byte, midi_message_byte_1, midi_message_byte_2, midi_message_byte_3, ...]
-static constexpr int    STATUS_MIDI_MESSAGE_BYTE_INDEX = 0;
-static constexpr int    MIDI_MESSAGE_BYTE_INDEX_1 = 1;
-static constexpr int    MIDI_MESSAGE_BYTE_INDEX_2 = 2;
-static constexpr int    MIDI_MESSAGE_BYTE_INDEX_3 = 3;
-static constexpr int    MIDI_MESSAGE_BYTE_INDEX_4 = 4;
-static constexpr int    MIDI_MESSAGE_BYTE_INDEX_5 = 5;
+static constexpr int    DEFAULT_MICROSECONDS_PER_QUARTER = 500'000;
+
+// Standard MIDI file layout: "MThd" header chunk followed by "MTrk" track chunks
+static constexpr int    CHUNK_ID_LENGTH = 4;
+static constexpr int    CHUNK_HEADER_LENGTH = 8;
+static constexpr int    HEADER_CHUNK_MIN_LENGTH = 6;
+static constexpr char   HEADER_CHUNK_ID[] = "MThd";
+static constexpr char   TRACK_CHUNK_ID[] = "MTrk";
+
+static constexpr int    META_EVENT_STATUS = 0xFF;
+static constexpr int    SYSEX_EVENT_STATUS = 0xF0;
+static constexpr int    SYSEX_ESCAPE_EVENT_STATUS = 0xF7;
 
 static constexpr int    MIN_NOTE_COUNT = 40;
 static constexpr int    MAX_NOTE_COUNT = 1000;
@@ -69,7 +77,8 @@ MidiFileReader::MidiFileReader()
       beatsPerMinute(0.0),
       ticksPerBeat(0),
       beatsPerTick(0.0),
-      currentChannelPrefix(-1)
+      currentChannelPrefix(-1),
+      firstMicrosecondsPerQuarter(-1)
 {
 
 }
@@ -81,26 +90,26 @@ MidiFileReader::~MidiFileReader()
 
 bool MidiFileReader::read(const std::string &filename)
 {
-    reset();
-    MidiFile midifile;
-    if (midifile.read(filename) != 0) {
-        processMidiFile(midifile);
-        return true;
+    std::ifstream is(filename, std::ios::binary | std::ios::in);
+    if (!is.is_open()) {
+        reset();
+        return false;
     }
 
-    return false;
+    return read(is);
 }
 
 bool MidiFileReader::read(std::istream &is)
 {
     reset();
-    MidiFile midifile;
-    if (midifile.read(is) != 0) {
-        processMidiFile(midifile);
-        return true;
+    std::string data = Strings::StreamToString(is);
+    if (!parse(reinterpret_cast<const unsigned char*>(data.data()), data.size())) {
+        reset();
+        return false;
     }
 
-    return false;
+    postProcess();
+    return true;
 }
 
 /*!
@@ -118,274 +127,437 @@ void MidiFileReader::reset()
     ticksPerBeat = 0;
     beatsPerTick = 0.0;
     currentChannelPrefix = NO_CHANNEL_PREFIX;
-    tracksMap.clear();
-    trackNamesMap.clear();
+    firstMicrosecondsPerQuarter = -1;
+    currentTrackName.clear();
+    tracks.clear();
+    currentTrackChannelIndexes.fill(-1);
+    tempoChanges.clear();
+}
+
+static inline int readBigEndian(const unsigned char* data, int bytesCount) {
+    int result = 0;
+    for (int i = 0; i < bytesCount; ++i) {
+        result = (result << 8) | data[i];
+    }
+
+    return result;
 }
 
 /*!
- * \brief MidiFileReader::processMidiFile
+ * \brief MidiFileReader::parse
  *
- * Processes MidiFile object
- * \param midi
- * \param outResult
- * \param outBeatsPerMinute
+ * Reads standard MIDI file in a single pass. Events are decoded directly from the file data
+ * into per-track note buffers, no intermediate event lists are created.
+ * SMPTE time division is not supported.
+ * \param data
+ * \param size
+ * \return false if the data is not a valid standard MIDI file
  */
-void MidiFileReader::processMidiFile(MidiFile &midi)
+bool MidiFileReader::parse(const unsigned char* data, size_t size)
 {
-    currentChannelPrefix = NO_CHANNEL_PREFIX;
-    durationInSeconds = midi.getTotalTimeInSeconds();
-    durationInTicks = midi.getTotalTimeInTicks();
-    ticksPerQuarter = midi.getTPQ();
-    ticksPerSecond = durationInTicks / durationInSeconds;
+    const unsigned char* end = data + size;
+    if (size < CHUNK_HEADER_LENGTH + HEADER_CHUNK_MIN_LENGTH ||
+            memcmp(data, HEADER_CHUNK_ID, CHUNK_ID_LENGTH) != 0) {
+        return false;
+    }
+
+    int headerLength = readBigEndian(data + CHUNK_ID_LENGTH, 4);
+    if (headerLength < HEADER_CHUNK_MIN_LENGTH || headerLength > end - data - CHUNK_HEADER_LENGTH) {
+        return false;
+    }
 
-    int trackCount = midi.getTrackCount();
-    for (int track = 0; track < trackCount; ++ track) {
-        for (size_t event = 0; event < midi[track].size(); ++ event) {
-            processEvent(midi[track][event]);
+    const unsigned char* header = data + CHUNK_HEADER_LENGTH;
+    int trackCount = readBigEndian(header + 2, 2);
+    int division = readBigEndian(header + 4, 2);
+    if (division & 0x8000 || division == 0) {
+        return false;
+    }
+    ticksPerQuarter = division;
+
+    const unsigned char* ptr = header + headerLength;
+    int trackID = 0;
+    while (trackID < trackCount && end - ptr >= CHUNK_HEADER_LENGTH) {
+        int chunkLength = readBigEndian(ptr + CHUNK_ID_LENGTH, 4);
+        const unsigned char* chunkBegin = ptr + CHUNK_HEADER_LENGTH;
+        // Some files have a wrong length in the last chunk, truncate it to the file size
+        const unsigned char* chunkEnd = chunkLength < 0 || chunkLength > end - chunkBegin ? end : chunkBegin + chunkLength;
+        // Unknown chunks should be skipped
+        if (memcmp(ptr, TRACK_CHUNK_ID, CHUNK_ID_LENGTH) == 0) {
+            if (!readTrackChunk(chunkBegin, chunkEnd, trackID)) {
+                return false;
+            }
+            trackID++;
         }
+
+        ptr = chunkEnd;
     }
-    postProcess();
+
+    return trackID > 0;
 }
 
 /*!
- * \brief MidiFileReader::processEvent
+ * \brief MidiFileReader::readTrackChunk
  *
- * Processes single MIDI or META event
- * \param event
+ * Decodes all the events of a single MTrk chunk
+ * \param begin
+ * \param end
+ * \param trackID
+ * \return false if the chunk is broken
  */
-void MidiFileReader::processEvent(const MidiEvent &event)
+bool MidiFileReader::readTrackChunk(const unsigned char* begin, const unsigned char* end, int trackID)
 {
-    int eventChannelID = event.getChannel();
-    int eventTrackID = event.track;
-    int eventTick = event.tick;
+    currentTrackChannelIndexes.fill(-1);
+    currentChannelPrefix = NO_CHANNEL_PREFIX;
+    currentTrackName.clear();
+
+    const unsigned char* ptr = begin;
+    int tick = 0;
+    int runningStatus = 0;
+    while (ptr < end) {
+        int delta;
+        if (!readVariableLengthQuantity(ptr, end, delta) || ptr >= end) {
+            return false;
+        }
+        tick += delta;
+
+        int status = *ptr;
+        if (status & 0x80) {
+            ptr++;
+        } else if (runningStatus != 0) {
+            // Running status, the status byte is omitted and the previous channel status is used
+            status = runningStatus;
+        } else {
+            return false;
+        }
 
-    //! ***********************************************
-    //! All the data below was got from tutorial      *
-    //! http://www.somascape.org/midi/tech/mfile.html *
-    //! ***********************************************
+        if (status == META_EVENT_STATUS) {
+            if (ptr >= end) {
+                return false;
+            }
 
-    // META events
-    if (event.isMeta()) {
-        switch (event.getP1()) {
-        // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-        // FF 03 length text.
-        // This event is optional. It's interpretation depends on its context. If it occurs in the first track of a format 0 or 1 MIDI file, then it gives the Sequence Name. Otherwise it gives the Track Name
-        case 0x03: {
-            std::string trackName = eventText(event, MIDI_MESSAGE_BYTE_INDEX_3, event[MIDI_MESSAGE_BYTE_INDEX_2]);
-            trackNamesMap[eventTrackID] = trackName;
-            break;
-        }
-            // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-            // FF 04 length text
-            // Instrument name of length. This optional event is used to provide a textual clue regarding the intended instrumentation for a track (e.g. 'Piano' or 'Flute', etc). If used, it is reccommended to place this event near the start of a track)
-        case 0x04: {
-            std::string instrumentName = eventText(event, MIDI_MESSAGE_BYTE_INDEX_3, event[MIDI_MESSAGE_BYTE_INDEX_2]);
-            // If prefix is set, appending name to track
-            if (currentChannelPrefix != NO_CHANNEL_PREFIX) {
-                auto track = getTrack(eventTrackID, currentChannelPrefix);
-                track->instrumentName = instrumentName;
+            int type = *ptr++;
+            int length;
+            if (!readVariableLengthQuantity(ptr, end, length) || length > end - ptr) {
+                return false;
             }
-            break;
-        }
-            // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-            // FF 20 01 сс
-            // Midi channel prefix (cc is a byte specifying the MIDI channel (0-15). This optional event is used to associate any subsequent SysEx and Meta events with a particular MIDI channel, and will remain in effect until the next MIDI Channel Prefix Meta event or the next MIDI event)
-        case 0x20: {
-            currentChannelPrefix = event[MIDI_MESSAGE_BYTE_INDEX_3];
-            break;
-        }
-            // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-            // FF 2F 00
-            // End of track
-        case 0x2F: {
-            for (auto &track: tracksMap) {
-                if(track.second->trackId == eventTrackID) {
-                    track.second->closeAllNotes(eventTick);
-                }
+
+            processMetaEvent(type, ptr, length, trackID, tick);
+            ptr += length;
+            if (type == 0x2F) {
+                break;
+            }
+        } else if (status == SYSEX_EVENT_STATUS || status == SYSEX_ESCAPE_EVENT_STATUS) {
+            int length;
+            if (!readVariableLengthQuantity(ptr, end, length) || length > end - ptr) {
+                return false;
+            }
+            ptr += length;
+        } else if (status < 0xF0) {
+            runningStatus = status;
+            int command = status & 0xF0;
+            int dataBytesCount = command == 0xC0 || command == 0xD0 ? 1 : 2;
+            if (end - ptr < dataBytesCount) {
+                return false;
             }
-            break;
-        }
 
-            // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-            // FF 51 03 tt tt tt
-            // Tempo (tt tt tt is a 24-bit value specifying the tempo as the number of microseconds per quarter note)
-        case 0x51: {
-			int microsecondsPerQuarter = event[MIDI_MESSAGE_BYTE_INDEX_3] << 16 | 
-									     event[MIDI_MESSAGE_BYTE_INDEX_4] << 8  | 
-				                         event[MIDI_MESSAGE_BYTE_INDEX_5];
-			// Assign beatsPerMinute only ones
-            if (beatsPerMinute < 0) {
-                beatsPerMinute = 1.0 * MICROSECONDS_IN_MINUTE / microsecondsPerQuarter;
-                ticksPerBeat   =  ticksPerSecond * SECONDS_IN_MINUTE / beatsPerMinute;
-                beatsPerTick =   1.0 / ticksPerBeat;
+            int data1 = ptr[0];
+            int data2 = dataBytesCount == 2 ? ptr[1] : 0;
+            if ((data1 | data2) & 0x80) {
+                return false;
             }
-            break;
+            ptr += dataBytesCount;
+            processChannelEvent(status, data1, data2, trackID, tick);
+        } else {
+            // System common and real-time messages are not allowed in standard midi files
+            return false;
         }
+    }
 
-            // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-            // FF 20 01 сс mi
-            // Key signature (sf is a byte specifying the number of flats (-ve) or sharps (+ve) that identifies the key signature (-7 = 7 flats, -1 = 1 flat, 0 = key of C, 1 = 1 sharp, etc). mi is a byte specifying a major (0) or minor (1) key)
-        case 0x59: {
-            int key =  event[MIDI_MESSAGE_BYTE_INDEX_3];
-            int pitchInOctaveIndex = key >= 0 ? key : Pitch::getInOctaveIndexFromWhitePitchIndex(-key);
-            bool isMajor = event[MIDI_MESSAGE_BYTE_INDEX_4] == 0;
-            tonality = Tonality(pitchInOctaveIndex, isMajor);
-            break;
-        }
+    durationInTicks = std::max(durationInTicks, tick);
 
-        /*
-         FF 58 04 nn dd cc bb
-        Time signature is expressed as 4 numbers. nn and dd represent the "numerator" and "denominator" of the signature as notated on sheet music. The denominator is a negative power of 2: 2 = quarter note, 3 = eighth, etc.
-        The cc expresses the number of MIDI clocks in a metronome click.
-        The bb parameter expresses the number of notated 32nd notes in a MIDI quarter note (24 MIDI clocks). This event allows a program to relate what MIDI thinks of as a quarter, to something entirely different.
-        */
-        case 0x58: {
-            int beatsInBar = event[MIDI_MESSAGE_BYTE_INDEX_3];
-            int beatDuration = event[MIDI_MESSAGE_BYTE_INDEX_4];
-            timeSignature = TimeSignature(beatsInBar, beatDuration);
-            break;
+    // Assigning track name
+    if (!currentTrackName.empty()) {
+        for (int index : currentTrackChannelIndexes) {
+            if (index >= 0) {
+                tracks[index].trackName = currentTrackName;
+            }
         }
+    }
 
-        default: {
-            break;
-        }
+    return true;
+}
+
+/*!
+ * \brief MidiFileReader::readVariableLengthQuantity
+ *
+ * Reads variable-length quantity value, 7 bits per byte, the most significant bit is set for all bytes except the last one
+ * \param ptr is moved to the first byte after the value
+ * \param end
+ * \param outValue
+ * \return
+ */
+bool MidiFileReader::readVariableLengthQuantity(const unsigned char*& ptr, const unsigned char* end, int& outValue)
+{
+    outValue = 0;
+    // The value is limited to 4 bytes by the standard
+    for (int i = 0; i < 4 && ptr < end; ++i) {
+        int byte = *ptr++;
+        outValue = (outValue << 7) | (byte & 0x7F);
+        if (!(byte & 0x80)) {
+            return true;
         }
-    } else {
-        currentChannelPrefix = NO_CHANNEL_PREFIX; // If event is midi-event, channel prefix removes
-        int command = event.getCommandNibble(); // P0 & 0x11110000
-        auto currentTrack = getTrack(eventTrackID, eventChannelID);
+    }
 
-        switch (command) {
+    return false;
+}
 
+/*!
+ * \brief MidiFileReader::processMetaEvent
+ *
+ * Processes single META event
+ * \param type
+ * \param data
+ * \param length
+ * \param trackID
+ * \param tick
+ */
+void MidiFileReader::processMetaEvent(int type, const unsigned char* data, int length, int trackID, int tick)
+{
+    //! ***********************************************
+    //! All the data below was got from tutorial      *
+    //! http://www.somascape.org/midi/tech/mfile.html *
+    //! ***********************************************
+
+    switch (type) {
+    // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    // FF 03 length text.
+    // This event is optional. It's interpretation depends on its context. If it occurs in the first track of a format 0 or 1 MIDI file, then it gives the Sequence Name. Otherwise it gives the Track Name
+    case 0x03: {
+        currentTrackName.assign(reinterpret_cast<const char*>(data), static_cast<size_t>(length));
+        break;
+    }
         // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-        // 8n note velocity
-        // Note OFF (Stop sounding the specified note, on MIDI channel n)
-        case 0x80: {
-            currentTrack->closeNote(event.getKeyNumber(), eventTick);
-            break;
+        // FF 04 length text
+        // Instrument name of length. This optional event is used to provide a textual clue regarding the intended instrumentation for a track (e.g. 'Piano' or 'Flute', etc). If used, it is reccommended to place this event near the start of a track)
+    case 0x04: {
+        // If prefix is set, appending name to track
+        if (currentChannelPrefix != NO_CHANNEL_PREFIX) {
+            MidiTrack& track = getTrack(trackID, currentChannelPrefix);
+            track.instrumentName.assign(reinterpret_cast<const char*>(data), static_cast<size_t>(length));
         }
-
-            // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-            // 9n note velocity
-            // Note ON (Start sounding the specified note, on MIDI channel n)
-        case 0x90: {
-            //            debugEvent(event);
-            int keyNumber = event.getKeyNumber();
-            int velocity = event.getVelocity();
-            if (velocity == 0) { // same as Note OFF
-                currentTrack->closeNote(keyNumber, eventTick);
-            } else {
-                currentTrack->openNote(keyNumber, eventTick, velocity);
+        break;
+    }
+        // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+        // FF 20 01 сс
+        // Midi channel prefix (cc is a byte specifying the MIDI channel (0-15). This optional event is used to associate any subsequent SysEx and Meta events with a particular MIDI channel, and will remain in effect until the next MIDI Channel Prefix Meta event or the next MIDI event)
+    case 0x20: {
+        if (length >= 1 && data[0] < MAX_MIDI_CHANNELS) {
+            currentChannelPrefix = data[0];
+        }
+        break;
+    }
+        // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+        // FF 2F 00
+        // End of track
+    case 0x2F: {
+        for (int index : currentTrackChannelIndexes) {
+            if (index >= 0) {
+                tracks[index].closeAllNotes(tick);
             }
-            break;
         }
+        break;
+    }
 
-            // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-            // An note pressure
-            // Polyphonic Pressure (Apply aftertouch pressure to the specified note, on MIDI channel n)
-        case 0xA0: {
-            // TODO: Handle this shity staff
-            //currentTrack->isPolyphonical = true;
+        // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+        // FF 51 03 tt tt tt
+        // Tempo (tt tt tt is a 24-bit value specifying the tempo as the number of microseconds per quarter note)
+    case 0x51: {
+        if (length < 3) {
             break;
         }
 
-            // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-            // Bn controller value
-            // Controller (Set the specified controller, on MIDI channel n, to value)
-        case 0xB0: {
+        int microsecondsPerQuarter = readBigEndian(data, 3);
+        if (microsecondsPerQuarter <= 0) {
             break;
         }
 
-            // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-            // Cn program
-            // Program Change (Select the specified program (i.e. voice, or instrument), on MIDI channel n)
-        case 0xC0: {
-            break;
+        tempoChanges.push_back({tick, microsecondsPerQuarter});
+        // Assign beatsPerMinute only ones
+        if (firstMicrosecondsPerQuarter < 0) {
+            firstMicrosecondsPerQuarter = microsecondsPerQuarter;
         }
+        break;
+    }
 
-            // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-            // Dn pressure
-            // Channel Pressure (Apply aftertouch pressure to all notes currently sounding on MIDI channel n)
-        case 0xD0: {
+        // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+        // FF 59 02 sf mi
+        // Key signature (sf is a byte specifying the number of flats (-ve) or sharps (+ve) that identifies the key signature (-7 = 7 flats, -1 = 1 flat, 0 = key of C, 1 = 1 sharp, etc). mi is a byte specifying a major (0) or minor (1) key)
+    case 0x59: {
+        if (length < 2) {
             break;
         }
 
-            // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-            // En lsb msb
-            // Pitch Bend (Apply pitch bend to all notes currently sounding on MIDI channel n)
-        case 0xE0: {
-            break;
-        }
-        default: {
+        int key = data[0];
+        int pitchInOctaveIndex = key >= 0 ? key : Pitch::getInOctaveIndexFromWhitePitchIndex(-key);
+        bool isMajor = data[1] == 0;
+        tonality = Tonality(pitchInOctaveIndex, isMajor);
+        break;
+    }
+
+    /*
+     FF 58 04 nn dd cc bb
+    Time signature is expressed as 4 numbers. nn and dd represent the "numerator" and "denominator" of the signature as notated on sheet music. The denominator is a negative power of 2: 2 = quarter note, 3 = eighth, etc.
+    The cc expresses the number of MIDI clocks in a metronome click.
+    The bb parameter expresses the number of notated 32nd notes in a MIDI quarter note (24 MIDI clocks). This event allows a program to relate what MIDI thinks of as a quarter, to something entirely different.
+    */
+    case 0x58: {
+        if (length < 2) {
             break;
         }
+
+        int beatsInBar = data[0];
+        int beatDuration = data[1];
+        timeSignature = TimeSignature(beatsInBar, beatDuration);
+        break;
+    }
+
+    default: {
+        break;
+    }
+    }
+}
+
+/*!
+ * \brief MidiFileReader::processChannelEvent
+ *
+ * Processes single MIDI channel event
+ * \param status
+ * \param data1
+ * \param data2
+ * \param trackID
+ * \param tick
+ */
+void MidiFileReader::processChannelEvent(int status, int data1, int data2, int trackID, int tick)
+{
+    currentChannelPrefix = NO_CHANNEL_PREFIX; // If event is midi-event, channel prefix removes
+    int command = status & 0xF0;
+    int channelID = status & 0x0F;
+
+    switch (command) {
+
+    // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    // 8n note velocity
+    // Note OFF (Stop sounding the specified note, on MIDI channel n)
+    case 0x80: {
+        getTrack(trackID, channelID).closeNote(data1, tick);
+        break;
+    }
+
+        // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+        // 9n note velocity
+        // Note ON (Start sounding the specified note, on MIDI channel n)
+    case 0x90: {
+        int keyNumber = data1;
+        int velocity = data2;
+        MidiTrack& currentTrack = getTrack(trackID, channelID);
+        if (velocity == 0) { // same as Note OFF
+            currentTrack.closeNote(keyNumber, tick);
+        } else {
+            currentTrack.openNote(keyNumber, tick, velocity);
         }
+        break;
+    }
+
+        // ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+        // An note pressure
+        // Polyphonic Pressure (Apply aftertouch pressure to the specified note, on MIDI channel n)
+        // Bn controller value
+        // Controller (Set the specified controller, on MIDI channel n, to value)
+        // Cn program
+        // Program Change (Select the specified program (i.e. voice, or instrument), on MIDI channel n)
+        // Dn pressure
+        // Channel Pressure (Apply aftertouch pressure to all notes currently sounding on MIDI channel n)
+        // En lsb msb
+        // Pitch Bend (Apply pitch bend to all notes currently sounding on MIDI channel n)
+    default: {
+        // Tracks are created for every channel with midi events
+        getTrack(trackID, channelID);
+        break;
+    }
     }
 }
 
 /*!
  * \brief MidiFileReader::getTrack
  *
- * Returns track with trackID and channelID, and if this track not exists, creates it
+ * Returns track with trackID and channelID, and if this track not exists, creates it.
+ * trackID should be the id of the track chunk being read.
  * \param trackID
  * \param channelID
- * \return
+ * \return reference, which is valid until the next getTrack call
  */
-std::shared_ptr<MidiTrack> MidiFileReader::getTrack(const int trackID, const int channelID)
+MidiTrack& MidiFileReader::getTrack(const int trackID, const int channelID)
 {
-    int id = trackID * MAX_MIDI_CHANNELS + channelID;
-    TrackMap::iterator it = tracksMap.find(id);
-    if (it == tracksMap.end()) {
-        std::shared_ptr<MidiTrack> track = std::make_shared<MidiTrack>();
-        tracksMap[id] = track;
-        track->trackId = trackID;
-        track->channelId = channelID;
-        return track;
-    } else {
-        return it->second;
+    int& index = currentTrackChannelIndexes[channelID];
+    if (index < 0) {
+        index = static_cast<int>(tracks.size());
+        tracks.emplace_back(ticksPerQuarter);
+        MidiTrack& track = tracks.back();
+        track.trackId = trackID;
+        track.channelId = channelID;
     }
+
+    return tracks[index];
 }
 
 /*!
- * \brief MidiFileReader::eventText
- * Transformates n bytes from start to ASCII-std::string
+ * \brief MidiFileReader::ticksToSeconds
  *
- * \param event
- * \param start
- * \param n
+ * Converts tick to seconds using the tempo changes of all tracks
+ * \param tick
  * \return
  */
-std::string MidiFileReader::eventText(const MidiEvent &event, const int start, const int n)
+double MidiFileReader::ticksToSeconds(int tick) const
 {
-    size_t fin = start + n;
-    if (fin > event.size()) {
-        fin = event.size();
-    }
-    std::string s;
-    for (size_t i = start; i < fin; i++) {
-        s += (char)event[i];
+    double seconds = 0;
+    int lastTick = 0;
+    int microsecondsPerQuarter = DEFAULT_MICROSECONDS_PER_QUARTER;
+    for (const TempoChange& change : tempoChanges) {
+        if (change.tick >= tick) {
+            break;
+        }
+
+        seconds += 1e-6 * (change.tick - lastTick) * microsecondsPerQuarter / ticksPerQuarter;
+        lastTick = change.tick;
+        microsecondsPerQuarter = change.microsecondsPerQuarter;
     }
-    return s;
+
+    return seconds + 1e-6 * (tick - lastTick) * microsecondsPerQuarter / ticksPerQuarter;
 }
 
 /*!
  * \brief MidiFileReader::postProcess
  *
- * Counts necessary values for all stored MIDI tracks
+ * Counts timing values and finalizes statistics for all stored MIDI tracks
  */
 void MidiFileReader::postProcess()
 {
-    for (auto &trackMapItem : tracksMap) {
-        std::shared_ptr<MidiTrack> track = trackMapItem.second;
+    // Tempo changes may come from different tracks
+    std::stable_sort(tempoChanges.begin(), tempoChanges.end(), [] (const TempoChange& a, const TempoChange& b) {
+        return a.tick < b.tick;
+    });
+    durationInSeconds = ticksToSeconds(durationInTicks);
+    ticksPerSecond = durationInTicks / durationInSeconds;
 
-        // Assigning track name
-        TrackNamesMap::iterator it = trackNamesMap.find(track->trackId);
-        if (it != trackNamesMap.end()) {
-            track->trackName = it->second;
-        }
+    if (firstMicrosecondsPerQuarter > 0) {
+        beatsPerMinute = 1.0 * MICROSECONDS_IN_MINUTE / firstMicrosecondsPerQuarter;
+        ticksPerBeat   =  ticksPerSecond * SECONDS_IN_MINUTE / beatsPerMinute;
+        beatsPerTick =   1.0 / ticksPerBeat;
+    }
 
-        track->postProcess(ticksPerQuarter, durationInTicks);
-        track->durationInTime = 1.0 * track->durationInTicks() / ticksPerSecond;
+    for (auto &track : tracks) {
+        track.postProcess(durationInTicks);
+        track.durationInTime = 1.0 * track.durationInTicks() / ticksPerSecond;
     }
 }
 
@@ -397,7 +569,7 @@ void MidiFileReader::postProcess()
  * \param second
  * \return
  */
-bool MidiFileReader::sortCompare(const std::shared_ptr<MidiTrack> &left, const std::shared_ptr<MidiTrack> &right)
+bool MidiFileReader::sortCompare(const MidiTrack &left, const MidiTrack &right)
 {
     double lPoints = getSummaryWeight(left);
     double rPoints = getSummaryWeight(right);
@@ -421,32 +593,32 @@ double MidiFileReader::getWeight(const double &value, const double &baseWeight,
     return isGood ? baseWeight : 0.0;
 }
 
-double MidiFileReader::getSummaryWeight(const std::shared_ptr<MidiTrack> &value) {
+double MidiFileReader::getSummaryWeight(const MidiTrack &value) {
     double result = 0.0;
 
-    if (containsTrackName(value->trackName + value->instrumentName)) {
+    if (containsTrackName(value.trackName + value.instrumentName)) {
         result += NAME_WEIGHT;
     }
 
-    int noteCount = value->noteCount;
+    int noteCount = value.noteCount;
     if (noteCount >= MIN_NOTE_COUNT && noteCount <= MAX_NOTE_COUNT) {
         result += NOTE_COUNT_WEIGHT;
     }
 
     // Lowest note distribution
-    result += getWeight(value->lowestNote,  LOWEST_NOTE_WEIGHT, LOWEST_NOTE_MX, LOWEST_NOTE_SIGMA);
+    result += getWeight(value.lowestNote,  LOWEST_NOTE_WEIGHT, LOWEST_NOTE_MX, LOWEST_NOTE_SIGMA);
 
     // Highest note distribution
-    result += getWeight(value->highestNote,  HEIGHEST_NOTE_WEIGHT, HEIGHEST_NOTE_MX, HEIGHEST_NOTE_SIGMA);
+    result += getWeight(value.highestNote,  HEIGHEST_NOTE_WEIGHT, HEIGHEST_NOTE_MX, HEIGHEST_NOTE_SIGMA);
 
     // Note range distribution
-    result += getWeight(value->highestNote - value->lowestNote, RANGE_OF_NOTES_WEIGHT, RANGE_OF_NOTES_MX, RANGE_OF_NOTES_SIGMA);
+    result += getWeight(value.highestNote - value.lowestNote, RANGE_OF_NOTES_WEIGHT, RANGE_OF_NOTES_MX, RANGE_OF_NOTES_SIGMA);
 
     // Note values distribution
-    result += getWeight(value->maxNoteValuePercent, MAX_NOTE_VALUE_WEIGHT, MAX_NOTE_VALUE_MX, MAX_NOTE_VALUE_SIGMA);
+    result += getWeight(value.maxNoteValuePercent, MAX_NOTE_VALUE_WEIGHT, MAX_NOTE_VALUE_MX, MAX_NOTE_VALUE_SIGMA);
 
     // Notes per second distribution
-    result += getWeight(noteCount / value->durationInTime, NOTES_PER_SECOND_WEIGHT, NOTES_PER_SECOND_MX, NOTES_PER_SECOND_SIGMA);
+    result += getWeight(noteCount / value.durationInTime, NOTES_PER_SECOND_WEIGHT, NOTES_PER_SECOND_MX, NOTES_PER_SECOND_SIGMA);
 
     return result;
 }
@@ -495,15 +667,15 @@ double MidiFileReader::getBeatsPerMinute() const {
 VocalPart MidiFileReader::tryGetVocalPartFromMidiTrackWithId(int midiTrackId) const {
     assert(beatsPerMinute >= 0 && "The midifile has not been parsed, call read before tryGetVocalPartFromMidiTrackWithId");
 
-    auto iter = std::find_if(tracksMap.begin(), tracksMap.end(), [=] (const auto& pair) {
-        return pair.second->trackId == midiTrackId;
+    auto iter = std::find_if(tracks.begin(), tracks.end(), [=] (const MidiTrack& track) {
+        return track.trackId == midiTrackId;
     });
 
-    if (iter == tracksMap.end()) {
+    if (iter == tracks.end()) {
         throw MidiFileReaderException(MidiFileReaderException::OUT_OF_RANGE);
     }
 
-    std::shared_ptr<MidiTrack> track = iter->second;
+    const MidiTrack* track = &*iter;
 
     // Check if track satisfies base conditions
     if (track->channelId == DRUMS_CHANNEL_ID) {
@@ -516,13 +688,15 @@ VocalPart MidiFileReader::tryGetVocalPartFromMidiTrackWithId(int midiTrackId) co
     }
 
     std::vector<NoteInterval> pitches;
-    const auto &notes = track->getNotes();
-    pitches.reserve(notes.size());
-    for (const auto &note : notes) {
+    int notesCount = track->getNotesCount();
+    const std::vector<int>& keyNumbers = track->getNotesKeyNumbers();
+    const std::vector<int>& startTicks = track->getNotesStartTicks();
+    pitches.reserve(notesCount);
+    for (int i = 0; i < notesCount; ++i) {
         NoteInterval pitch;
-        pitch.pitch = Pitch::fromMidiIndex(note->keyNumber);
-        pitch.startTickNumber = note->startTick;
-        pitch.ticksCount = note->durationInTicks();
+        pitch.pitch = Pitch::fromMidiIndex(keyNumbers[i]);
+        pitch.startTickNumber = startTicks[i];
+        pitch.ticksCount = track->getNoteDurationInTicks(i);
         pitches.push_back(pitch);
     }
 
@@ -538,3 +712,19 @@ const Tonality &MidiFileReader::getTonality() const {
 const TimeSignature &MidiFileReader::getTimeSignature() const {
     return timeSignature;
 }
+
+const std::vector<MidiTrack> &MidiFileReader::getTracks() const {
+    return tracks;
+}
+
+int MidiFileReader::getTicksPerQuarter() const {
+    return ticksPerQuarter;
+}
+
+int MidiFileReader::getDurationInTicks() const {
+    return durationInTicks;
+}
+
+double MidiFileReader::getDurationInSeconds() const {
+    return durationInSeconds;
+}
@@ -7,15 +7,12 @@
 #define MIDIFILEREADER_H
 
 #include <string>
-#include <unordered_map>
 #include <vector>
-#include <list>
-#include <memory>
+#include <array>
 #include <iostream>
 
 #include "MidiNote.h"
 #include "MidiTrack.h"
-#include "MidiFile.h"
 
 #include "VocalPart.h"
 #include "Tonality.h"
@@ -34,11 +31,18 @@ class MidiFileReader {
     TimeSignature timeSignature;
 
     int    currentChannelPrefix;
-
-    using TrackMap      = std::unordered_map<int, std::shared_ptr<MidiTrack > >;
-    using TrackNamesMap = std::unordered_map<int, std::string>;
-    TrackMap      tracksMap;     // key = 15 * trackID + channelID
-    TrackNamesMap trackNamesMap; // key = trackID
+    int    firstMicrosecondsPerQuarter;
+    std::string currentTrackName;
+
+    struct TempoChange {
+        int tick;
+        int microsecondsPerQuarter;
+    };
+
+    std::vector<MidiTrack> tracks;
+    // channelID -> index in tracks for the track chunk being read, -1 if the channel has no events yet
+    std::array<int, 16> currentTrackChannelIndexes;
+    std::vector<TempoChange> tempoChanges;
 public:
     explicit MidiFileReader();
     ~MidiFileReader();
@@ -54,16 +58,26 @@ public:
 
 	VocalPart tryGetVocalPartFromMidiTrackWithId(int midiTrackId) const;
 
+	// Tracks are split by the track chunk and the channel
+	const std::vector<MidiTrack>& getTracks() const;
+	int getTicksPerQuarter() const;
+	int getDurationInTicks() const;
+	double getDurationInSeconds() const;
+	// Converts tick to seconds using the tempo changes of all tracks
+	double ticksToSeconds(int tick) const;
+
 private:
 	void reset();
-    void processMidiFile(MidiFile &midi);
-    void processEvent(const MidiEvent &event);
-    std::shared_ptr<MidiTrack> getTrack(const int trackID, const int channelID);
-    std::string eventText(const MidiEvent &event, const int startByte, const int bytesAmount);
+    bool parse(const unsigned char* data, size_t size);
+    bool readTrackChunk(const unsigned char* begin, const unsigned char* end, int trackID);
+    void processMetaEvent(int type, const unsigned char* data, int length, int trackID, int tick);
+    void processChannelEvent(int status, int data1, int data2, int trackID, int tick);
+    MidiTrack& getTrack(const int trackID, const int channelID);
     void postProcess();
-    static bool sortCompare(const std::shared_ptr<MidiTrack> &first, const std::shared_ptr<MidiTrack> &second);
+    static bool readVariableLengthQuantity(const unsigned char*& ptr, const unsigned char* end, int& outValue);
+    static bool sortCompare(const MidiTrack &first, const MidiTrack &second);
     static double getWeight(const double &value, const double &baseWeight, const double &mx, const double &sigma);
-    static double getSummaryWeight(const std::shared_ptr<MidiTrack> &value);
+    static double getSummaryWeight(const MidiTrack &value);
 
     static bool containsTrackName(const std::string &name);
     static bool satisfiesDistribution(const double &value, const double &mid, const double &sko);
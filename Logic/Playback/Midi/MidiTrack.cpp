@@ -7,6 +7,7 @@
 
 #include <iostream>
 #include <algorithm>
+#include <cassert>
 
 // Considering 
 // value of 4th      note == n, 
@@ -23,7 +24,7 @@ static constexpr double    NOTE_VALUE_8TH_DOT_RELATIVE_TO_4TH  = 3.0 / 4.0;
 static constexpr double    NOTE_VALUE_4TH_DOT_RELATIVE_TO_4TH  = 3.0 / 2.0;
 static constexpr double    NOTE_VALUE_2ND_DOT_RELATIVE_TO_4TH  = 3.0 / 1.0;
 
-MidiTrack::MidiTrack()
+MidiTrack::MidiTrack(int ticksPerQuarter) : ticksPerQuarter(ticksPerQuarter)
 {
     reset();
 }
@@ -45,157 +46,174 @@ void MidiTrack::reset()
     startTick = -1;
     finalTick = -1;
 
-    notes.clear();
-    durationDistrib.clear();
-    pendingNoteIndexes.clear();
+    notesKeyNumbers.clear();
+    notesStartTicks.clear();
+    notesFinalTicks.clear();
+    noteValuesDistribution.fill(0);
+    velocitySum = 0.0;
+    openNotesIndexes.fill(-1);
+    openNotesCount = 0;
 }
 
-std::vector<std::shared_ptr<MidiNote> > &MidiTrack::getNotes() {
-	return notes;
+int MidiTrack::getNotesCount() const {
+    return static_cast<int>(notesKeyNumbers.size());
 }
 
-	/*!
+const std::vector<int> &MidiTrack::getNotesKeyNumbers() const {
+    return notesKeyNumbers;
+}
+
+const std::vector<int> &MidiTrack::getNotesStartTicks() const {
+    return notesStartTicks;
+}
+
+const std::vector<int> &MidiTrack::getNotesFinalTicks() const {
+    return notesFinalTicks;
+}
+
+int MidiTrack::getNoteDurationInTicks(int noteIndex) const {
+    return notesFinalTicks[noteIndex] - notesStartTicks[noteIndex];
+}
+
+/*!
  * \brief MidiTrack::openNote
  *
  * Creates new note with keyNumber, startTick = tick and velocity.
- * Adds index of note in array to pendingNoteIndexes.
- * If the same note is already in pending, closing it and opening new
- * If pending notes anyway contains some indexes, setting isPolyphonical to true
+ * Stores index of the note in openNotesIndexes.
+ * If the same note is already open, closing it and opening new
+ * polyphonicTracksCount is the max number of simultaneously open notes
  * If start tick of track is not set, setting it
+ * Updates lowest and highest notes and velocity sum
  * \param keyNumber
  * \param tick
  * \param velocity
  */
 void MidiTrack::openNote(const int keyNumber, const int tick, const int velocity) {
-    std::shared_ptr<MidiNote> note = std::make_shared<MidiNote>();
-    note->startTick = tick;
-    note->keyNumber = keyNumber;
-    note->velocity = velocity;
-    notes.push_back(note);
+    assert(keyNumber >= 0 && keyNumber < KEYS_COUNT);
+    if (openNotesIndexes[keyNumber] >= 0) {
+        closeNote(keyNumber, tick);
+    }
+
+    if (notesKeyNumbers.empty()) {
+        lowestNote = keyNumber;
+        highestNote = keyNumber;
+    } else if (keyNumber > highestNote) {
+        highestNote = keyNumber;
+    } else if (keyNumber < lowestNote) {
+        lowestNote = keyNumber;
+    }
+
+    velocitySum += velocity;
 
-    pendingNoteIndexes.push_back(notes.size() - 1);
-    polyphonicTracksCount = std::max(polyphonicTracksCount, (int)pendingNoteIndexes.size());
+    openNotesIndexes[keyNumber] = static_cast<int>(notesKeyNumbers.size());
+    notesKeyNumbers.push_back(keyNumber);
+    notesStartTicks.push_back(tick);
+    notesFinalTicks.push_back(tick);
+
+    openNotesCount++;
+    polyphonicTracksCount = std::max(polyphonicTracksCount, openNotesCount);
 
     if (startTick == -1) {
         startTick = tick;
     }
-
 }
 
 /*!
  * \brief MidiTrack::closeNote
  *
- * Sets note's finalTick and removing its index from pendingNoteIndexes
+ * Sets note's finalTick, removes it from openNotesIndexes and
+ * counts its value in note values distribution
  * \param keyNumber
  * \param tick
- * \return
  */
-std::list<int>::iterator MidiTrack::closeNote(const int keyNumber, const int tick) {
-    std::list<int>::iterator it;
-    for (it = pendingNoteIndexes.begin(); it != pendingNoteIndexes.end();) {
-        auto &note = notes.at(*it);
-        if (note->keyNumber == keyNumber) {
-            note->finalTick = tick;
-			if (finalTick < tick)
-				finalTick = tick;
-            it = pendingNoteIndexes.erase(it);
-            return it;
-        } else {
-            ++it;
-        }
+void MidiTrack::closeNote(const int keyNumber, const int tick) {
+    assert(keyNumber >= 0 && keyNumber < KEYS_COUNT);
+    int index = openNotesIndexes[keyNumber];
+    if (index < 0) {
+        return;
+    }
+
+    notesFinalTicks[index] = tick;
+    if (finalTick < tick) {
+        finalTick = tick;
     }
-    return it;
+
+    MidiNote::NoteValue noteValue = getNoteValue(getNoteDurationInTicks(index), ticksPerQuarter);
+    noteValuesDistribution[static_cast<int>(noteValue)]++;
+
+    openNotesIndexes[keyNumber] = -1;
+    openNotesCount--;
 }
 
 /*!
  * \brief MidiTrack::closeAllNotes
  *
- * Closes all pending notes (see closeNote)
+ * Closes all open notes (see closeNote)
  * \param tick
  */
 void MidiTrack::closeAllNotes(const int tick) {
-    for (auto index : pendingNoteIndexes) {
-        const auto &note = notes.at(index);
-        closeNote(note->keyNumber, tick);
+    if (openNotesCount == 0) {
+        return;
+    }
+
+    for (int keyNumber = 0; keyNumber < KEYS_COUNT; ++keyNumber) {
+        closeNote(keyNumber, tick);
     }
 }
 
 /*!
- * \brief MidiTrack::postProcess
+ * \brief MidiTrack::getNoteValue
  *
- * Counts necessary values for current track
- * Among others, counts note values distribution and percent of most frequently used value
  * All notes with values between 2n'th dot and n'th dot are considered to be n'th value (say, notes between 8th dot and 4th dot are considered to be 4th value)
- * \param tpq
+ * \param ticks
+ * \param ticksPerQuarter
+ * \return
+ */
+MidiNote::NoteValue MidiTrack::getNoteValue(int ticks, int ticksPerQuarter) {
+    double noteValueRelativeToQuater = 1.0 * ticks / ticksPerQuarter;
+    if (noteValueRelativeToQuater < NOTE_VALUE_64TH_DOT_RELATIVE_TO_4TH) {
+        return MidiNote::NoteValue::SIXTY_FOURTH_NOTE;
+    } else if (noteValueRelativeToQuater < NOTE_VALUE_32TH_DOT_RELATIVE_TO_4TH) {
+        return MidiNote::NoteValue::THIRTY_SECOND_NOTE;
+    } else if (noteValueRelativeToQuater < NOTE_VALUE_16TH_DOT_RELATIVE_TO_4TH) {
+        return MidiNote::NoteValue::SIXTEENTH_NOTE;
+    } else if (noteValueRelativeToQuater < NOTE_VALUE_8TH_DOT_RELATIVE_TO_4TH) {
+        return MidiNote::NoteValue::EIGHTH_NOTE;
+    } else if (noteValueRelativeToQuater < NOTE_VALUE_4TH_DOT_RELATIVE_TO_4TH) {
+        return MidiNote::NoteValue::QUARTER_NOTE;
+    } else if (noteValueRelativeToQuater < NOTE_VALUE_2ND_DOT_RELATIVE_TO_4TH) {
+        return MidiNote::NoteValue::HALF_NOTE;
+    } else {
+        return MidiNote::NoteValue::WHOLE_NOTE;
+    }
+}
+
+/*!
+ * \brief MidiTrack::postProcess
+ *
+ * Finalizes statistics of the current track, collected while reading the notes
+ * Among others, counts percent of most frequently used note value
  * \param lastTick
  */
-void MidiTrack::postProcess(const int tpq, const int lastTick) {
+void MidiTrack::postProcess(const int lastTick) {
 
-    noteCount = notes.size();
+    noteCount = getNotesCount();
 
     if (finalTick == -1) {
         finalTick = lastTick;
     }
 
     // Closing all unclosed notes and throwing error
-    if (!pendingNoteIndexes.empty()) {
+    if (openNotesCount > 0) {
         closeAllNotes(lastTick);
         std::cerr << "Not all notes were closed to the end of track";
     }
 
-    // Counting minNote, maxNote, averageVelocity
-    if (!notes.empty()) {
-        lowestNote = notes[0]->keyNumber;
-        highestNote = notes[0]->keyNumber;
-    }
-
-    double velocitySum = 0.0;
-
-    int maxNoteValue = 0;
-    for (auto &note: notes) {
-        int ticks = note->durationInTicks();
-        double noteValueRelativeToQuater = 1.0 * ticks / tpq;
-        if (noteValueRelativeToQuater < NOTE_VALUE_64TH_DOT_RELATIVE_TO_4TH) {
-            note->duration = MidiNote::NoteValue::SIXTY_FOURTH_NOTE;
-        } else if (noteValueRelativeToQuater < NOTE_VALUE_32TH_DOT_RELATIVE_TO_4TH) {
-            note->duration = MidiNote::NoteValue::THIRTY_SECOND_NOTE;
-        } else if (noteValueRelativeToQuater < NOTE_VALUE_16TH_DOT_RELATIVE_TO_4TH) {
-            note->duration = MidiNote::NoteValue::SIXTEENTH_NOTE;
-        } else if (noteValueRelativeToQuater < NOTE_VALUE_8TH_DOT_RELATIVE_TO_4TH) {
-            note->duration = MidiNote::NoteValue::EIGHTH_NOTE;
-        } else if (noteValueRelativeToQuater < NOTE_VALUE_4TH_DOT_RELATIVE_TO_4TH) {
-            note->duration = MidiNote::NoteValue::QUARTER_NOTE;
-        } else if (noteValueRelativeToQuater < NOTE_VALUE_2ND_DOT_RELATIVE_TO_4TH) {
-            note->duration = MidiNote::NoteValue::HALF_NOTE;
-        } else {
-            note->duration = MidiNote::NoteValue::WHOLE_NOTE;
-        }
-
-        // Getting distribution of note's length
-        MidiNoteDurationDistib::iterator it = durationDistrib.find(static_cast<int>(note->duration));
-        if (it == durationDistrib.end()) {
-            durationDistrib[static_cast<int>(note->duration)] = 1;
-        } else {
-            it->second += 1;
-            if (it->second > maxNoteValue)
-                maxNoteValue = it->second;
-        }
-
-        // Updating top and bottom notes
-        int noteKey = note->keyNumber;
-        if (noteKey > highestNote) {
-            highestNote = noteKey;
-        } else if (noteKey < lowestNote) {
-            lowestNote = noteKey;
-        }
-
-        // Updating velocity summ
-        velocitySum += note->velocity;
-    }
+    int maxNoteValue = *std::max_element(noteValuesDistribution.begin(), noteValuesDistribution.end());
     averageVelocity = velocitySum / noteCount;
     maxNoteValuePercent = 100.0 * maxNoteValue / noteCount;
 }
 
-int MidiTrack::durationInTicks() {
+int MidiTrack::durationInTicks() const {
     return finalTick - startTick;
 }
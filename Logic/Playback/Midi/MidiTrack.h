@@ -9,12 +9,13 @@
 #include "MidiNote.h"
 #include <string>
 #include <vector>
-#include <list>
-#include <memory>
-#include <unordered_map>
+#include <array>
 
 struct MidiTrack
 {
+    static constexpr int KEYS_COUNT = 128;
+    static constexpr int NOTE_VALUES_COUNT = static_cast<int>(MidiNote::NoteValue::WHOLE_NOTE) + 1;
+
     std::string           instrumentName;
     std::string           trackName;
     int                   polyphonicTracksCount = 1;
@@ -30,25 +31,40 @@ struct MidiTrack
     int                   startTick = -1;
     int                   finalTick = -1;
 
-    MidiTrack();
+    explicit MidiTrack(int ticksPerQuarter = 0);
 
 private:
-    using MidiNotePointersVector = std::vector<std::shared_ptr<MidiNote> >;
-    using MidiNoteDurationDistib = std::unordered_map <int, int>;
-    MidiNotePointersVector notes;
-    MidiNoteDurationDistib durationDistrib;
+    int ticksPerQuarter;
+
+    // Notes are stored as structure of arrays, the same index is used for all the arrays
+    std::vector<int> notesKeyNumbers;
+    std::vector<int> notesStartTicks;
+    std::vector<int> notesFinalTicks;
+
+    // Statistics are collected while the notes are being opened and closed
+    std::array<int, NOTE_VALUES_COUNT> noteValuesDistribution;
+    double velocitySum;
 
-    std::list<int> pendingNoteIndexes;
+    // keyNumber -> index of the currently sounding note or -1
+    std::array<int, KEYS_COUNT> openNotesIndexes;
+    int openNotesCount;
+
+    static MidiNote::NoteValue getNoteValue(int ticks, int ticksPerQuarter);
 
 public:
     void reset();
-	std::vector<std::shared_ptr<MidiNote> > &getNotes();
+    int getNotesCount() const;
+    const std::vector<int>& getNotesKeyNumbers() const;
+    const std::vector<int>& getNotesStartTicks() const;
+    const std::vector<int>& getNotesFinalTicks() const;
+    int getNoteDurationInTicks(int noteIndex) const;
+
     void openNote(const int keyNumber, const int tick, const int velocity);
-    std::list<int>::iterator closeNote(const int keyNumber, const int tick);
+    void closeNote(const int keyNumber, const int tick);
     void closeAllNotes(const int tick);
 
-    void postProcess(const int tpq, const int lastTick);
-    int durationInTicks();
+    void postProcess(const int lastTick);
+    int durationInTicks() const;
 };
 
 #endif // MIDITRACK_H
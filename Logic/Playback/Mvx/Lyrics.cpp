@@ -6,10 +6,10 @@
 #include "Algorithms.h"
 #include "StringEncodingUtils.h"
 #include "StringUtils.h"
-#include "Maps.h"
 #include "MathUtils.h"
 #include <boost/logic/tribool.hpp>
 #include <iostream>
+#include <algorithm>
 
 using namespace CppUtils;
 using boost::logic::tribool;
@@ -23,7 +23,6 @@ Lyrics::Lyrics(const std::string &utf8, const VocalPart* vocalPart) {
 
     text.reserve(u32.size());
     int skippedCharactersCount = 0;
-    const Range* previousRange = nullptr;
     int rangeStartCharacter = -1;
     int currentLineIndex = -1;
     int currentSectionIndex = -1;
@@ -96,7 +95,8 @@ Lyrics::Lyrics(const std::string &utf8, const VocalPart* vocalPart) {
             range.charactersCount = i - rangeStartCharacter;
             range.sectionIndex = currentSectionIndex;
 
-            if (previousRange && previousRange->endSeek > range.startSeek) {
+            if (!ranges.empty() && ranges.back().endSeek > range.startSeek) {
+                const Range* previousRange = &ranges.back();
                 std::stringstream message;
                 message << "Lyrics parse failed, invalid range: ["
                         << range.startSeek << ";" << range.endSeek << "] "
@@ -104,7 +104,7 @@ Lyrics::Lyrics(const std::string &utf8, const VocalPart* vocalPart) {
                 throw std::runtime_error(message.str());
             }
 
-            previousRange = Maps::InsertAndGetInsertedValue(ranges, range.startSeek, range);
+            ranges.push_back(range);
 
             if (currentLineIndex < 0) {
                 Line line;
@@ -165,10 +165,6 @@ Lyrics::Lyrics(const std::string &utf8, const VocalPart* vocalPart) {
             }
         }
     }
-
-    for (int i = 0; i < lines.size(); ++i) {
-        endSeekLineIndexesMap[lines[i].getEndSeek()] = i;
-    }
 }
 
 std::pair<double, double> Lyrics::parseRange(const std::u32string text, int begin, int end) {
@@ -219,7 +215,7 @@ std::string Lyrics::toUtf8String() const {
     for (int i = 0; i < sectionsCount; ++i) {
         const Section& section = sections[i];
         result << "\n{" << sectionTypeToChar(section.sectionType) << section.number << "}\n";
-        const Range* range = &rangeIter->second;
+        const Range* range = &*rangeIter;
         while (range->sectionIndex == i) {
             if (lineIter->startCharacterIndex + lineIter->charactersCount < range->startCharacterIndex) {
                 result << "\n";
@@ -232,7 +228,7 @@ std::string Lyrics::toUtf8String() const {
                 break;
             }
 
-            range = &rangeIter->second;
+            range = &*rangeIter;
         }
     }
 
@@ -281,12 +277,14 @@ Lyrics::LineSelection Lyrics::getLineSelection(
         double seek) const
 {
     LineSelection selection;
-    auto upper = ranges.upper_bound(seek);
+    auto upper = std::upper_bound(ranges.begin(), ranges.end(), seek, [] (double seek, const Range& range) {
+        return seek < range.startSeek;
+    });
     if (upper == ranges.begin()) {
         return selection;
     }
 
-    const Range& range = (--upper)->second;
+    const Range& range = *(--upper);
     if (range.endSeek < seek) {
         return selection;
     } else {
@@ -318,12 +316,14 @@ const Lyrics::Line &Lyrics::getLastLine() const {
 }
 
 int Lyrics::getNextOrCurrentLineIndexBySeek(double seek) const {
-    auto iter = endSeekLineIndexesMap.upper_bound(seek);
-    if (iter == endSeekLineIndexesMap.end()) {
+    auto iter = std::upper_bound(lines.begin(), lines.end(), seek, [] (double seek, const Line& line) {
+        return seek < line.getEndSeek();
+    });
+    if (iter == lines.end()) {
         return -1;
     }
 
-    return iter->second;
+    return static_cast<int>(iter - lines.begin());
 }
 
 void Lyrics::Range::writeToStream(std::ostream &os) const {
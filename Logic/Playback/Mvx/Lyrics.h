@@ -5,10 +5,10 @@
 #ifndef TEXTIMAGESGENERATOR_LYRICS_H
 #define TEXTIMAGESGENERATOR_LYRICS_H
 
-#include <map>
 #include <vector>
 #include <string>
 #include <optional>
+#include <cstring>
 #include "VocalPart.h"
 
 class Lyrics {
@@ -24,6 +24,18 @@ public:
         int linesCount = 0;
         int startCharacterIndex = 0;
         double seek = -1;
+
+        template<typename Archive>
+        void saveOrLoad(Archive& archive, bool save) {
+            int sectionTypeId = sectionType;
+            archive(sectionTypeId);
+            sectionType = static_cast<SectionType>(sectionTypeId);
+            archive(number);
+            archive(firstLineIndex);
+            archive(linesCount);
+            archive(startCharacterIndex);
+            archive(seek);
+        }
     };
 
     struct Range {
@@ -38,6 +50,15 @@ public:
         }
 
         void writeToStream(std::ostream& os) const;
+
+        template<typename Archive>
+        void saveOrLoad(Archive& archive, bool save) {
+            archive(startCharacterIndex);
+            archive(charactersCount);
+            archive(startSeek);
+            archive(endSeek);
+            archive(sectionIndex);
+        }
     };
 
     struct Line {
@@ -49,6 +70,14 @@ public:
         inline double getEndSeek() const {
             return startSeek + duration;
         }
+
+        template<typename Archive>
+        void saveOrLoad(Archive& archive, bool save) {
+            archive(startCharacterIndex);
+            archive(charactersCount);
+            archive(startSeek);
+            archive(duration);
+        }
     };
 
     struct LineSelection {
@@ -68,11 +97,14 @@ public:
     };
 
 private:
+    static constexpr int BINARY_FORMAT_VERSION = 1;
+
     std::u32string text;
     std::vector<Section> sections;
-    std::map<double, Range> ranges;
+    // Sorted by startSeek, ranges don't overlap
+    std::vector<Range> ranges;
+    // Sorted by startSeek, lines don't overlap, so end seeks are sorted as well
     std::vector<Line> lines;
-    std::map<double, int> endSeekLineIndexesMap;
 
     static std::pair<double, double> parseRange(const std::u32string, int begin, int end);
     static SectionType getSectionTypeByTypeId(char32_t sectionType);
@@ -80,6 +112,22 @@ private:
 
     std::u32string getRangeText(const Range& range) const;
     std::string getRangeUtf8Text(const Range& range) const;
+
+    // The text is written as raw utf32 characters and read back with a single memcpy
+    static std::string textToBinaryString(const std::u32string& text) {
+        return std::string(reinterpret_cast<const char*>(text.data()), text.size() * sizeof(char32_t));
+    }
+
+    static void textFromBinaryString(const std::string& data, std::u32string& text) {
+        if (data.size() % sizeof(char32_t) != 0) {
+            throw std::runtime_error("Lyrics binary data is corrupted");
+        }
+
+        text.resize(data.size() / sizeof(char32_t));
+        if (!data.empty()) {
+            memcpy(&text[0], data.data(), data.size());
+        }
+    }
 public:
     static Lyrics EMPTY;
 
@@ -108,6 +156,29 @@ public:
 
     template<typename Archive>
     void saveOrLoad(Archive &ar, bool isSave) {
+        int version = BINARY_FORMAT_VERSION;
+        ar(version);
+        if (version != BINARY_FORMAT_VERSION) {
+            throw std::runtime_error("Unsupported lyrics binary format version");
+        }
+
+        std::string textData;
+        if (isSave) {
+            textData = textToBinaryString(text);
+        }
+        ar(textData);
+        if (!isSave) {
+            textFromBinaryString(textData, text);
+        }
+
+        ar(sections);
+        ar(ranges);
+        ar(lines);
+    }
+
+    // Legacy format, lyrics are stored as annotated utf8 text and parsed on load. Used by mvx files of version 1.
+    template<typename Archive>
+    void saveOrLoadAsUtf8String(Archive &ar, bool isSave) {
         std::string str;
         if (isSave) {
             str = toUtf8String();
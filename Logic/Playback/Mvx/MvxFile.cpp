@@ -202,6 +202,14 @@ void MvxFile::setRecordingTempoFactor(double tempoFactor) {
     MvxFile::recordingTempoFactor = tempoFactor;
 }
 
+const SingingScore &MvxFile::getSingingScore() const {
+    return singingScore;
+}
+
+void MvxFile::setSingingScore(const SingingScore &singingScore) {
+    this->singingScore = singingScore;
+}
+
 MvxFile::MvxFile(const VocalTrainerFile* file) {
     setVocalPart(file->getVocalPart());
     setOriginalTonality(file->getOriginalTonality());
@@ -19,6 +19,7 @@
 #include "Serializers.h"
 #include "TimeSignature.h"
 #include "AudioDataBufferSerialization.h"
+#include "SingingScorer.h"
 
 struct MvxFileHeader {
     bool recording = false;
@@ -56,10 +57,13 @@ class MvxFile : private MvxFileHeader, public VocalTrainerFile {
     std::vector<float> recordedPitchesFrequencies;
     std::vector<short> instrumentalPreviewSamples;
     std::map<double, int> recordingTonalityChanges; // seek -> pitchSifting
+    SingingScore singingScore;
 
     Lyrics lyrics;
 public:
-    static constexpr int VERSION = 1;
+    // Version 2: lyrics are stored in binary format instead of annotated utf8 text
+    // Version 3: singing score of the recording
+    static constexpr int VERSION = 3;
     static constexpr int SERIALIZATION_ID = 12343434;
 
     template<typename Archive>
@@ -76,8 +80,15 @@ public:
         ar(recordedPitchesTimes);
         ar(recordedPitchesFrequencies);
         ar(recordingTonalityChanges);
-        ar(lyrics);
+        if (version >= 2) {
+            ar(lyrics);
+        } else {
+            lyrics.saveOrLoadAsUtf8String(ar, isSave);
+        }
         ar(instrumentalPreviewSamples);
+        if (version >= 3) {
+            ar(singingScore);
+        }
     }
 
     // Preferably use move constructor instead
@@ -128,6 +139,9 @@ public:
     void setRecordingTonalityChanges(const std::map<double, int> &recordingTonalityChanges);
     double getRecordingTempoFactor() const override;
     void setRecordingTempoFactor(double tempoFactor);
+    // Empty for the recordings made before version 3
+    const SingingScore &getSingingScore() const;
+    void setSingingScore(const SingingScore &singingScore);
 
     const std::vector<short> &getInstrumentalPreviewSamples() const;
     void setInstrumentalPreviewSamples(const std::vector<short> &instrumentalPreviewSamples);
@@ -0,0 +1,253 @@
+#include "SingingScorer.h"
+#include "PitchValue.h"
+#include <cmath>
+#include <algorithm>
+
+void NoteSingingScore::addPitch(double timeSinceNoteStart, bool voiced, float centsError, float toleranceCents) {
+    pitchesCount++;
+    if (!voiced) {
+        return;
+    }
+
+    voicedPitchesCount++;
+    centsErrorSum += centsError;
+    absCentsErrorSum += std::abs(centsError);
+    centsErrorSquaresSum += double(centsError) * centsError;
+    if (std::abs(centsError) <= toleranceCents) {
+        onPitchPitchesCount++;
+        if (onsetDelay < 0) {
+            onsetDelay = float(std::max(timeSinceNoteStart, 0.0));
+        }
+    }
+}
+
+bool NoteSingingScore::isSung() const {
+    return pitchesCount > 0;
+}
+
+bool NoteSingingScore::isHit() const {
+    return onsetDelay >= 0;
+}
+
+float NoteSingingScore::getCoverage() const {
+    return pitchesCount > 0 ? float(voicedPitchesCount) / pitchesCount : 0;
+}
+
+float NoteSingingScore::getAccuracy() const {
+    return pitchesCount > 0 ? float(onPitchPitchesCount) / pitchesCount : 0;
+}
+
+float NoteSingingScore::getMeanAbsCentsError() const {
+    return voicedPitchesCount > 0 ? float(absCentsErrorSum / voicedPitchesCount) : 0;
+}
+
+float NoteSingingScore::getMeanCentsError() const {
+    return voicedPitchesCount > 0 ? float(centsErrorSum / voicedPitchesCount) : 0;
+}
+
+float NoteSingingScore::getCentsErrorStandardDeviation() const {
+    if (voicedPitchesCount < 2) {
+        return 0;
+    }
+
+    double mean = centsErrorSum / voicedPitchesCount;
+    double variance = centsErrorSquaresSum / voicedPitchesCount - mean * mean;
+    return float(sqrt(std::max(variance, 0.0)));
+}
+
+int SingingScore::getNotesCount() const {
+    return int(notes.size());
+}
+
+int SingingScore::getSungNotesCount() const {
+    return int(std::count_if(notes.begin(), notes.end(), [] (const NoteSingingScore& note) {
+        return note.isSung();
+    }));
+}
+
+int SingingScore::getHitNotesCount() const {
+    return int(std::count_if(notes.begin(), notes.end(), [] (const NoteSingingScore& note) {
+        return note.isHit();
+    }));
+}
+
+float SingingScore::getCoverage() const {
+    int pitchesCount = 0;
+    int voicedPitchesCount = 0;
+    for (const NoteSingingScore& note : notes) {
+        pitchesCount += note.pitchesCount;
+        voicedPitchesCount += note.voicedPitchesCount;
+    }
+    return pitchesCount > 0 ? float(voicedPitchesCount) / pitchesCount : 0;
+}
+
+float SingingScore::getAccuracy() const {
+    int pitchesCount = 0;
+    int onPitchPitchesCount = 0;
+    for (const NoteSingingScore& note : notes) {
+        pitchesCount += note.pitchesCount;
+        onPitchPitchesCount += note.onPitchPitchesCount;
+    }
+    return pitchesCount > 0 ? float(onPitchPitchesCount) / pitchesCount : 0;
+}
+
+float SingingScore::getMeanAbsCentsError() const {
+    int voicedPitchesCount = 0;
+    double absCentsErrorSum = 0;
+    for (const NoteSingingScore& note : notes) {
+        voicedPitchesCount += note.voicedPitchesCount;
+        absCentsErrorSum += note.absCentsErrorSum;
+    }
+    return voicedPitchesCount > 0 ? float(absCentsErrorSum / voicedPitchesCount) : 0;
+}
+
+float SingingScore::getMeanOnsetDelay() const {
+    int count = 0;
+    double sum = 0;
+    for (const NoteSingingScore& note : notes) {
+        if (note.isHit()) {
+            sum += note.onsetDelay;
+            count++;
+        }
+    }
+    return count > 0 ? float(sum / count) : 0;
+}
+
+float SingingScore::getMeanCentsErrorStandardDeviation() const {
+    int count = 0;
+    double sum = 0;
+    for (const NoteSingingScore& note : notes) {
+        if (note.voicedPitchesCount >= 2) {
+            sum += note.getCentsErrorStandardDeviation();
+            count++;
+        }
+    }
+    return count > 0 ? float(sum / count) : 0;
+}
+
+bool SingingScore::operator==(const SingingScore& other) const {
+    if (toleranceCents != other.toleranceCents || notes.size() != other.notes.size()) {
+        return false;
+    }
+
+    for (int i = 0; i < notes.size(); ++i) {
+        const NoteSingingScore& a = notes[i];
+        const NoteSingingScore& b = other.notes[i];
+        if (a.pitchesCount != b.pitchesCount ||
+                a.voicedPitchesCount != b.voicedPitchesCount ||
+                a.onPitchPitchesCount != b.onPitchPitchesCount ||
+                a.centsErrorSum != b.centsErrorSum ||
+                a.absCentsErrorSum != b.absCentsErrorSum ||
+                a.centsErrorSquaresSum != b.centsErrorSquaresSum ||
+                a.onsetDelay != b.onsetDelay) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool SingingScore::operator!=(const SingingScore& other) const {
+    return !(*this == other);
+}
+
+SingingScorer::SingingScorer() : SingingScorer(Settings()) {
+}
+
+SingingScorer::SingingScorer(const Settings& settings) :
+        settings(settings),
+        stabilityAnalyzer(settings.stabilitySettings) {
+    score.toleranceCents = settings.toleranceCents;
+}
+
+void SingingScorer::setVocalPart(const VocalPart& vocalPart) {
+    const std::vector<NoteInterval>& notes = vocalPart.getNotes();
+    bool keepScore = notes.size() == notesBegins.size();
+
+    notesBegins.resize(notes.size());
+    notesEnds.resize(notes.size());
+    notesMidiNumbers.resize(notes.size());
+    for (int i = 0; i < notes.size(); ++i) {
+        const NoteInterval& note = notes[i];
+        notesBegins[i] = vocalPart.ticksToSeconds(note.startTickNumber);
+        notesEnds[i] = vocalPart.ticksToSeconds(note.endTickNumber());
+        notesMidiNumbers[i] = PitchValue(note.pitch).getMidiNumber();
+    }
+
+    if (!keepScore) {
+        reset();
+    }
+}
+
+void SingingScorer::seekBack(double time) {
+    while (startedNotesCount > 0 && notesBegins[startedNotesCount - 1] > time) {
+        score.notes[--startedNotesCount] = NoteSingingScore();
+        stabilityAnalyzer.resetNote(startedNotesCount);
+    }
+
+    // The note is sung again from the seek position
+    int currentNoteIndex = startedNotesCount - 1;
+    if (currentNoteIndex >= 0 && time < notesEnds[currentNoteIndex]) {
+        score.notes[currentNoteIndex] = NoteSingingScore();
+        stabilityAnalyzer.resetNote(currentNoteIndex);
+    }
+}
+
+void SingingScorer::addPitch(double time, float frequency) {
+    if (time < lastPitchTime) {
+        seekBack(time);
+    }
+    lastPitchTime = time;
+
+    int notesCount = int(notesBegins.size());
+    while (startedNotesCount < notesCount && notesBegins[startedNotesCount] <= time) {
+        startedNotesCount++;
+    }
+
+    int noteIndex = getCurrentNoteIndex();
+    if (noteIndex < 0) {
+        stabilityAnalyzer.addPitch(time, NAN, -1);
+        return;
+    }
+
+    bool voiced = frequency > 0;
+    float centsError = 0;
+    if (voiced) {
+        centsError = (PitchValue::frequencyToMidiNumber(frequency) - notesMidiNumbers[noteIndex]) * 100;
+        if (settings.ignoreOctave) {
+            centsError -= 1200 * roundf(centsError / 1200);
+        }
+    }
+
+    score.notes[noteIndex].addPitch(time - notesBegins[noteIndex], voiced, centsError, settings.toleranceCents);
+    stabilityAnalyzer.addPitch(time, voiced ? centsError : NAN, noteIndex);
+}
+
+void SingingScorer::reset() {
+    score.notes.assign(notesBegins.size(), NoteSingingScore());
+    score.toleranceCents = settings.toleranceCents;
+    stabilityAnalyzer.setNotesCount(int(notesBegins.size()));
+    startedNotesCount = 0;
+    lastPitchTime = -std::numeric_limits<double>::infinity();
+}
+
+const SingingScore& SingingScorer::getScore() const {
+    return score;
+}
+
+const SingingScorer::Settings& SingingScorer::getSettings() const {
+    return settings;
+}
+
+const PitchStabilityAnalyzer& SingingScorer::getStabilityAnalyzer() const {
+    return stabilityAnalyzer;
+}
+
+int SingingScorer::getCurrentNoteIndex() const {
+    int index = startedNotesCount - 1;
+    if (index >= 0 && lastPitchTime < notesEnds[index]) {
+        return index;
+    }
+
+    return -1;
+}
@@ -0,0 +1,122 @@
+#ifndef VOCALTRAINER_SINGINGSCORER_H
+#define VOCALTRAINER_SINGINGSCORER_H
+
+#include "VocalPart.h"
+#include "PitchStabilityAnalyzer.h"
+#include <vector>
+#include <limits>
+
+// Accuracy of a single note of the vocal part, accumulated from the detected pitches falling into the note time
+struct NoteSingingScore {
+    int pitchesCount = 0;
+    int voicedPitchesCount = 0;
+    // Voiced pitches within the tolerance from the note pitch
+    int onPitchPitchesCount = 0;
+    // Cents errors of the voiced pitches, positive if sharp
+    double centsErrorSum = 0;
+    double absCentsErrorSum = 0;
+    double centsErrorSquaresSum = 0;
+    // Seconds from the note start to the first on pitch pitch, negative if the note wasn't hit
+    float onsetDelay = -1;
+
+    void addPitch(double timeSinceNoteStart, bool voiced, float centsError, float toleranceCents);
+
+    bool isSung() const;
+    bool isHit() const;
+    // Share of the note pitches, which are voiced
+    float getCoverage() const;
+    // Share of the note pitches, which are on pitch
+    float getAccuracy() const;
+    float getMeanAbsCentsError() const;
+    // Mean signed error, positive if the note was sung sharp
+    float getMeanCentsError() const;
+    // Standard deviation of the cents error, lower is more stable
+    float getCentsErrorStandardDeviation() const;
+
+    template <typename Archive>
+    void saveOrLoad(Archive& archive, bool save) {
+        archive(pitchesCount);
+        archive(voicedPitchesCount);
+        archive(onPitchPitchesCount);
+        archive(centsErrorSum);
+        archive(absCentsErrorSum);
+        archive(centsErrorSquaresSum);
+        archive(onsetDelay);
+    }
+};
+
+// Singing accuracy of a recording, one NoteSingingScore per note of the vocal part. Totals are computed over
+// the notes, which were sung, i.e. the notes skipped by seek don't affect them.
+struct SingingScore {
+    std::vector<NoteSingingScore> notes;
+    float toleranceCents = 0;
+
+    int getNotesCount() const;
+    int getSungNotesCount() const;
+    int getHitNotesCount() const;
+    // Shares of all the pitches of the sung notes
+    float getCoverage() const;
+    float getAccuracy() const;
+    float getMeanAbsCentsError() const;
+    // Mean over the hit notes
+    float getMeanOnsetDelay() const;
+    // Mean over the sung notes with at least 2 voiced pitches
+    float getMeanCentsErrorStandardDeviation() const;
+
+    bool operator==(const SingingScore& other) const;
+    bool operator!=(const SingingScore& other) const;
+
+    template <typename Archive>
+    void saveOrLoad(Archive& archive, bool save) {
+        archive(toleranceCents);
+        archive(notes);
+    }
+};
+
+// Scores the detected pitches against the vocal part notes while singing, in O(1) per pitch, so the score is
+// ready the moment the song ends. Pitches are given in the vocal part time, i.e. the player seek.
+// A pitch earlier than the previous one means seek back, the notes after it and the note containing it are scored
+// from scratch.
+class SingingScorer {
+public:
+    struct Settings {
+        // Max distance from the note pitch counted as on pitch
+        float toleranceCents = 50;
+        // Octave errors are ignored, e.g. a male voice singing a female part an octave lower
+        bool ignoreOctave = true;
+        PitchStabilityAnalyzer::Settings stabilitySettings;
+    };
+
+private:
+    Settings settings;
+    std::vector<double> notesBegins;
+    std::vector<double> notesEnds;
+    std::vector<float> notesMidiNumbers;
+    SingingScore score;
+    PitchStabilityAnalyzer stabilityAnalyzer;
+    // Number of the notes starting not later than the last pitch time
+    int startedNotesCount = 0;
+    double lastPitchTime = -std::numeric_limits<double>::infinity();
+
+    void seekBack(double time);
+public:
+    SingingScorer();
+    explicit SingingScorer(const Settings& settings);
+
+    // The score is reset, unless the new vocal part has the same number of notes, e.g. it is shifted or its tempo
+    // is changed. Keeps the cursor position.
+    void setVocalPart(const VocalPart& vocalPart);
+    // frequency is negative or 0 for unvoiced pitches, pitches between the notes are ignored
+    void addPitch(double time, float frequency);
+    void reset();
+
+    const SingingScore& getScore() const;
+    const Settings& getSettings() const;
+    // Vibrato, jitter and drift of the notes, updated with the score
+    const PitchStabilityAnalyzer& getStabilityAnalyzer() const;
+    // Index of the note being sung at the last pitch time, -1 if none
+    int getCurrentNoteIndex() const;
+};
+
+
+#endif //VOCALTRAINER_SINGINGSCORER_H
@@ -6,6 +6,8 @@
 #include "AudioUtils.h"
 #include "StringUtils.h"
 #include "Algorithms.h"
+#include <algorithm>
+#include <limits>
 
 using namespace CppUtils;
 
@@ -105,6 +107,33 @@ void VocalPart::postInit() {
         });
         durationInTicks = lastPitchIter->endTickNumber() + endSilenceDurationInTicks;
     }
+
+    buildIntervalIndex();
+}
+
+void VocalPart::buildIntervalIndex() {
+    notesMaxEndTicks.resize(notes.size());
+    int maxEndTick = std::numeric_limits<int>::min();
+    for (int i = 0; i < notes.size(); ++i) {
+        maxEndTick = std::max(maxEndTick, notes[i].endTickNumber());
+        notesMaxEndTicks[i] = maxEndTick;
+    }
+}
+
+std::pair<int, int> VocalPart::getNotesIndexesRangeCandidates(int startTick, int endTick) const {
+    assert(notesMaxEndTicks.size() == notes.size());
+    // Interval::intersectsWith also checks startTick - 1 and endTick - 1 ticks, so the bounds are
+    // widened by one tick to match its results exactly for empty or inverted ranges.
+    int lastTick = std::max(startTick, endTick - 1);
+    auto end = std::upper_bound(notes.begin(), notes.end(), lastTick, [] (int tick, const NoteInterval& note) {
+        return tick < note.startTickNumber;
+    });
+    int firstTick = std::min(startTick, endTick - 1);
+    auto begin = std::upper_bound(notesMaxEndTicks.begin(), notesMaxEndTicks.end(), firstTick);
+
+    int beginIndex = static_cast<int>(begin - notesMaxEndTicks.begin());
+    int endIndex = static_cast<int>(end - notes.begin());
+    return std::make_pair(beginIndex, std::max(beginIndex, endIndex));
 }
 
 double VocalPart::getDurationInSeconds() const {
@@ -186,20 +215,33 @@ void VocalPart::removeSilenceSpaceFromBeginning() {
     for (auto& pitch : notes) {
         pitch.startTickNumber -= firstPitchStartTickNumber;
     }
+
+    buildIntervalIndex();
 }
 
 bool VocalPart::hasPitchesInMoment(double time) const {
     int tick = timeInSecondsToTicks(time);
-    return Contains(notes, [=] (const NoteInterval& pitch) {
-        return pitch.containsTick(tick);
-    });
+    auto range = getNotesIndexesRangeCandidates(tick, tick + 1);
+    for (int i = range.first; i < range.second; ++i) {
+        if (notes[i].containsTick(tick)) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 bool VocalPart::hasPitchInMoment(double time, const Pitch &pitch) const {
     int tick = timeInSecondsToTicks(time);
-    return Contains(notes, [=] (const NoteInterval& vxPitch) {
-        return vxPitch.containsTick(tick) && vxPitch.pitch.getPerfectFrequencyIndex() == pitch.getPerfectFrequencyIndex();
-    });
+    auto range = getNotesIndexesRangeCandidates(tick, tick + 1);
+    for (int i = range.first; i < range.second; ++i) {
+        const NoteInterval& vxPitch = notes[i];
+        if (vxPitch.containsTick(tick) && vxPitch.pitch.getPerfectFrequencyIndex() == pitch.getPerfectFrequencyIndex()) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 double VocalPart::getFirstPitchStartTime() const {
@@ -21,9 +21,16 @@ class VocalPart {
     int endSilenceDurationInTicks = 0;
     int lowestPitchIndex;
     int highestPitchIndex;
+    // Static interval index, notes are sorted by startTickNumber and
+    // notesMaxEndTicks[i] is the max endTickNumber of notes[0..i]
+    std::vector<int> notesMaxEndTicks;
 
     bool validateNotes();
     void postInit();
+    void buildIntervalIndex();
+    // Returns [begin, end) range of notes indexes, which may intersect with [startTick, endTick).
+    // Found in O(log n) using the interval index.
+    std::pair<int, int> getNotesIndexesRangeCandidates(int startTick, int endTick) const;
 public:
     VocalPart();
     VocalPart(std::vector<NoteInterval> &&pitches, int distanceInTicksBetweenLastPitchEndAndTrackEnd, double ticksPerSecond);
@@ -80,16 +87,15 @@ public:
 
     template<typename Function>
     void iteratePitchesInTickRange(int startTick, int endTick, const Function& function) const {
-        for (const auto& pitch : notes) {
-            if (pitch.intersectsWith(startTick, endTick)) {
-                function(pitch);
-            }
-        }
+        iteratePitchesIndexesInTickRange(startTick, endTick, [&] (int index) {
+            function(notes[index]);
+        });
     }
 
     template<typename Function>
     void iteratePitchesIndexesInTickRange(int startTick, int endTick, const Function& function) const {
-        for (int i = 0; i < notes.size(); ++i) {
+        auto range = getNotesIndexesRangeCandidates(startTick, endTick);
+        for (int i = range.first; i < range.second; ++i) {
             const NoteInterval& pitch = notes[i];
             if (pitch.intersectsWith(startTick, endTick)) {
                 function(i);
@@ -3,6 +3,10 @@ set(midiSources
         Midi/MidiTrack.cpp
         Midi/MidiFileReaderException.cpp
         Midi/MidiFileReaderException.h
+        )
+
+# Reference reader for the MidiFileReader tests only
+set(midiTestSources
         Midi/CraigsappMidifile/Binasc.cpp
         Midi/CraigsappMidifile/MidiEvent.cpp
         Midi/CraigsappMidifile/MidiEventList.cpp
@@ -14,6 +18,7 @@ set(vxMvxFileSources
         Mvx/MvxFile.cpp
         Mvx/MvxFile.h
         Vx/VocalPart.cpp
+        Vx/SingingScorer.cpp
         )
 
 set(playbackSources
@@ -49,8 +54,8 @@ set(playbackSources
 
 set(playbackTestSources
         ${midiSources}
+        ${midiTestSources}
         ${vxMvxFileSources}
-        ${midiSources}
 
         Vx/VocalPartAudioDataGenerator.cpp
 
@@ -0,0 +1,134 @@
+#include "catch.hpp"
+#include "AudioInputGraph.h"
+#include <thread>
+#include <atomic>
+
+static std::vector<int16_t> GenerateInput(int size) {
+    std::vector<int16_t> result((size_t) size);
+    for (int i = 0; i < size; ++i) {
+        result[i] = int16_t((i % 2 ? -1 : 1) * i * 100);
+    }
+    return result;
+}
+
+TEST_CASE("AudioInputGraph shares the converted and deinterleaved input") {
+    for (int channelsCount : {1, 2, 3}) {
+        int framesCount = 100;
+        AudioInputGraph graph(channelsCount, 128 * channelsCount);
+        std::vector<int16_t> input = GenerateInput(framesCount * channelsCount);
+
+        std::vector<const float*> floatViews;
+        graph.addNode("first", [&] (const AudioInputBuffer& buffer) {
+            REQUIRE(buffer.getData() == input.data());
+            REQUIRE(buffer.getSize() == input.size());
+            REQUIRE(buffer.getChannelsCount() == channelsCount);
+            REQUIRE(buffer.getFramesCount() == framesCount);
+            for (int i = 0; i < buffer.getSize(); ++i) {
+                REQUIRE(buffer.getFloatData()[i] == Approx(input[i] / 32768.0f));
+            }
+            for (int channel = 0; channel < channelsCount; ++channel) {
+                REQUIRE(buffer.getChannels()[channel] == buffer.getChannel(channel));
+                for (int i = 0; i < framesCount; ++i) {
+                    REQUIRE(buffer.getChannel(channel)[i] == input[i * channelsCount + channel]);
+                }
+            }
+            floatViews.push_back(buffer.getFloatData());
+        });
+        graph.addNode("second", [&] (const AudioInputBuffer& buffer) {
+            floatViews.push_back(buffer.getFloatData());
+            if (channelsCount == 1) {
+                REQUIRE(buffer.getChannel(0) == input.data());
+            }
+        });
+
+        graph(input.data(), int(input.size()));
+        REQUIRE(floatViews.size() == 2);
+        REQUIRE(floatViews[0] == floatViews[1]);
+    }
+}
+
+TEST_CASE("AudioInputGraph executes the enabled nodes in order") {
+    AudioInputGraph graph(1, 256);
+    std::vector<int> executed;
+    for (int i = 0; i < 3; ++i) {
+        REQUIRE(graph.addNode(std::to_string(i), [&executed, i] (const AudioInputBuffer&) {
+            executed.push_back(i);
+        }) == i);
+    }
+    REQUIRE(graph.getNodesCount() == 3);
+
+    std::vector<int16_t> input = GenerateInput(256);
+    graph(input.data(), int(input.size()));
+    REQUIRE(executed == std::vector<int>({0, 1, 2}));
+
+    executed.clear();
+    graph.setNodeEnabled(1, false);
+    REQUIRE(!graph.isNodeEnabled(1));
+    graph(input.data(), int(input.size()));
+    REQUIRE(executed == std::vector<int>({0, 2}));
+
+    std::vector<AudioInputGraph::StageStatistics> statistics = graph.getStatistics();
+    REQUIRE(statistics.size() == 4);
+    REQUIRE(statistics[0].name == AudioInputGraph::PREPARATION_STAGE_NAME);
+    REQUIRE(statistics[0].executionsCount == 2);
+    REQUIRE(statistics[1].name == "0");
+    REQUIRE(statistics[1].executionsCount == 2);
+    REQUIRE(statistics[2].executionsCount == 1);
+    REQUIRE(statistics[3].executionsCount == 2);
+    for (const auto& stage : statistics) {
+        REQUIRE(stage.maxSeconds >= 0);
+        REQUIRE(stage.totalSeconds >= stage.maxSeconds);
+        REQUIRE(stage.getMeanSeconds() <= stage.maxSeconds);
+    }
+
+    graph.resetStatistics();
+    statistics = graph.getStatistics();
+    REQUIRE(statistics[2].name == "1");
+    REQUIRE(statistics[2].executionsCount == 0);
+    REQUIRE(statistics[2].getMeanSeconds() == 0);
+}
+
+TEST_CASE("AudioInputGraph skips the preparation without enabled nodes") {
+    AudioInputGraph graph(2, 256);
+    graph.addNode("disabled", [] (const AudioInputBuffer&) {
+        FAIL("Disabled node executed");
+    }, false);
+
+    std::vector<int16_t> input = GenerateInput(256);
+    graph(input.data(), int(input.size()));
+    REQUIRE(graph.getStatistics()[0].executionsCount == 0);
+}
+
+TEST_CASE("AudioInputGraph nodes are added and enabled while the graph runs") {
+    AudioInputGraph graph(2, 256);
+    std::vector<int16_t> input = GenerateInput(256);
+    std::atomic<bool> stopped(false);
+    std::atomic<int> executionsCount(0);
+    graph.addNode("first", [&] (const AudioInputBuffer&) {
+        executionsCount++;
+    });
+
+    std::thread audioThread([&] {
+        while (!stopped) {
+            graph(input.data(), int(input.size()));
+        }
+    });
+
+    for (int i = 1; i < AudioInputGraph::MAX_NODES_COUNT; ++i) {
+        graph.addNode(std::to_string(i), [] (const AudioInputBuffer&) {}, false);
+        graph.setNodeEnabled(i, true);
+        graph.setNodeEnabled(i - 1, i % 2 == 0);
+        graph.getStatistics();
+        graph.resetStatistics();
+    }
+    while (executionsCount == 0) {
+        std::this_thread::yield();
+    }
+    stopped = true;
+    audioThread.join();
+
+    REQUIRE(graph.getNodesCount() == AudioInputGraph::MAX_NODES_COUNT);
+    std::vector<AudioInputGraph::StageStatistics> statistics = graph.getStatistics();
+    REQUIRE(statistics.size() == AudioInputGraph::MAX_NODES_COUNT + 1);
+    REQUIRE(statistics.back().name == std::to_string(AudioInputGraph::MAX_NODES_COUNT - 1));
+}
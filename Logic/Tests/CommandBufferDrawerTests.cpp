@@ -0,0 +1,124 @@
+#include "catch.hpp"
+#include "CommandBufferDrawer.h"
+#include "SoftwareDrawer.h"
+#include <sstream>
+#include <cstring>
+
+using namespace CppUtils;
+
+static void drawScene(Drawer* drawer, float offset) {
+    drawer->clear();
+    drawer->beginFrame(64, 48, 1);
+    drawer->setFillColor(Color(200, 30, 30, 255));
+    for (int i = 0; i < 4; ++i) {
+        drawer->fillRect(4 + i * 12, 4, 8, 8);
+    }
+    drawer->translate(offset, 0);
+    drawer->setStrokeColor(Color(0, 0, 255, 255));
+    drawer->setStrokeWidth(2);
+    drawer->drawLine(0, 20, 40, 40);
+    drawer->translate(-offset, 0);
+    Drawer::RoundedRectShape rects[] = {
+        {2, 30, 20, 10, 3, 3, 3, 3},
+        {30, 30, 20, 10, 5, 0, 5, 0}
+    };
+    drawer->fillRoundedRects(rects, 2, Color(0, 160, 0, 255));
+    drawer->circle(50, 14, 6);
+    drawer->fill();
+    drawer->endFrame();
+}
+
+static bool bitmapsEqual(const Bitmap& a, const Bitmap& b) {
+    return a.getWidth() == b.getWidth() && a.getHeight() == b.getHeight() &&
+            memcmp(a.getData(), b.getData(), size_t(a.getWidth()) * a.getHeight() * 4) == 0;
+}
+
+TEST_CASE("CommandBufferDrawer replay draws the same as the backend") {
+    SoftwareDrawer softwareDrawer;
+    drawScene(&softwareDrawer, 3);
+
+    auto* backend = new SoftwareDrawer();
+    CommandBufferDrawer drawer(backend);
+    drawScene(&drawer, 3);
+    REQUIRE(bitmapsEqual(softwareDrawer.getBitmap(), backend->getBitmap()));
+}
+
+TEST_CASE("CommandBufferDrawer interns repeated paths and colors") {
+    CommandBufferDrawer drawer(new SoftwareDrawer());
+    drawer.beginFrame(64, 48, 1);
+    for (int i = 0; i < 100; ++i) {
+        drawer.setFillColor(Color(i % 2 ? 255 : 0, 0, 0, 255));
+        drawer.fillRect(1, 2, 3, 4);
+    }
+    drawer.endFrame();
+
+    const DrawerCommandBuffer& frame = drawer.getLastFrame();
+    REQUIRE(frame.getPathsCount() == 1);
+    // beginFrame, endFrame and fill color, path, fill per rect
+    REQUIRE(frame.getCommandsCount() == 2 + 100 * 3);
+}
+
+TEST_CASE("DrawerCommandBuffer frames are compared by the drawn commands") {
+    CommandBufferDrawer drawer(new SoftwareDrawer());
+    drawScene(&drawer, 3);
+    DrawerCommandBuffer first = drawer.getLastFrame();
+    drawScene(&drawer, 3);
+    DrawerCommandBuffer second = drawer.getLastFrame();
+    drawScene(&drawer, 5);
+    const DrawerCommandBuffer& third = drawer.getLastFrame();
+
+    REQUIRE(first == second);
+    REQUIRE(first.getHash() == second.getHash());
+    REQUIRE(first.findFirstDifference(second) == -1);
+
+    REQUIRE(first != third);
+    REQUIRE(first.getHash() != third.getHash());
+    std::stringstream firstText;
+    first.writeText(firstText);
+    std::string line;
+    for (int i = 0; i <= first.findFirstDifference(third); ++i) {
+        std::getline(firstText, line);
+    }
+    REQUIRE(line == "translate 3.000 0.000");
+}
+
+TEST_CASE("DrawerCommandBuffer serialization keeps the commands") {
+    CommandBufferDrawer drawer(new SoftwareDrawer());
+    drawScene(&drawer, 3);
+    const DrawerCommandBuffer& frame = drawer.getLastFrame();
+
+    std::stringstream stream;
+    frame.serialize(stream);
+    DrawerCommandBuffer deserialized;
+    REQUIRE(deserialized.deserialize(stream));
+    REQUIRE(deserialized == frame);
+    REQUIRE(deserialized.getHash() == frame.getHash());
+
+    SoftwareDrawer softwareDrawer;
+    deserialized.replay(&softwareDrawer);
+    REQUIRE(bitmapsEqual(softwareDrawer.getBitmap(), static_cast<SoftwareDrawer*>(drawer.getBackend())->getBitmap()));
+
+    std::stringstream broken(stream.str().substr(0, 20));
+    REQUIRE(!deserialized.deserialize(broken));
+    REQUIRE(deserialized.getCommandsCount() == 0);
+}
+
+TEST_CASE("CommandBufferDrawer skips the frames identical to the submitted one") {
+    auto* backend = new SoftwareDrawer();
+    CommandBufferDrawer drawer(backend);
+    drawer.setSkipIdenticalFrames(true);
+    drawScene(&drawer, 3);
+    REQUIRE(!drawer.isLastFrameSkipped());
+    drawScene(&drawer, 3);
+    REQUIRE(drawer.isLastFrameSkipped());
+
+    // A new image may reuse the address of a deleted one, so the frame is submitted
+    Bitmap bitmap(2, 2);
+    Drawer::Image* image = drawer.createImage(bitmap);
+    drawer.deleteImage(image);
+    drawScene(&drawer, 3);
+    REQUIRE(!drawer.isLastFrameSkipped());
+
+    drawScene(&drawer, 5);
+    REQUIRE(!drawer.isLastFrameSkipped());
+}
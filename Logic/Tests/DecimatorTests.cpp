@@ -0,0 +1,76 @@
+#include "catch.hpp"
+#include "Decimator.h"
+#include "YinPitchDetector.h"
+#include "TestTones.h"
+#include <cmath>
+
+static constexpr int SAMPLE_RATE = 44100;
+
+static std::vector<int16_t> Decimate(Decimator& decimator, const std::vector<int16_t>& input, int pieceSize) {
+    std::vector<int16_t> result;
+    std::vector<int16_t> output(static_cast<size_t>(decimator.getMaxOutputSize(pieceSize)));
+    for (int begin = 0; begin < input.size(); begin += pieceSize) {
+        int size = std::min(pieceSize, int(input.size()) - begin);
+        int outputSize = decimator.process(input.data() + begin, size, output.data());
+        REQUIRE(outputSize <= decimator.getMaxOutputSize(size));
+        result.insert(result.end(), output.begin(), output.begin() + outputSize);
+    }
+    return result;
+}
+
+// Amplitude of the output after the filter delay
+static float GetAmplitude(const std::vector<int16_t>& samples, int skip) {
+    int max = 0;
+    for (int i = skip; i < samples.size(); ++i) {
+        max = std::max(max, abs(int(samples[i])));
+    }
+    return float(max);
+}
+
+TEST_CASE("Decimator factor 1 copies the input") {
+    Decimator decimator(1);
+    std::vector<int16_t> input = GenerateTone(440, 1000, 10000);
+    REQUIRE(Decimate(decimator, input, 256) == input);
+}
+
+TEST_CASE("Decimator passes the sung range and suppresses the aliases") {
+    for (int factor : {2, 4}) {
+        Decimator decimator(factor);
+        int outputRate = SAMPLE_RATE / factor;
+        int skip = decimator.getDelay() * 2 / factor;
+
+        std::vector<int16_t> output = Decimate(decimator, GenerateTone(1000, 8192, 10000), 512);
+        REQUIRE(output.size() == 8192 / factor);
+        REQUIRE(fabsf(GetAmplitude(output, skip) / 10000 - 1) < 0.01f);
+
+        // Would alias into the passband
+        decimator.reset();
+        output = Decimate(decimator, GenerateTone(outputRate * 0.75f, 8192, 10000), 512);
+        REQUIRE(GetAmplitude(output, skip) < 10000 * 0.001f);
+    }
+}
+
+TEST_CASE("Decimator output doesn't depend on the piece sizes") {
+    std::vector<int16_t> input = GenerateTone(300, 5000, 10000);
+    Decimator whole(4);
+    std::vector<int16_t> expected = Decimate(whole, input, int(input.size()));
+
+    for (int pieceSize : {1, 3, 127, 512}) {
+        Decimator decimator(4);
+        REQUIRE(Decimate(decimator, input, pieceSize) == expected);
+    }
+}
+
+TEST_CASE("Pitch is detected at the decimated sample rate") {
+    int factor = 4;
+    int windowSize = 4096;
+    Decimator decimator(factor);
+    std::vector<int16_t> input = GenerateTone(220, windowSize * 2, 10000);
+    std::vector<int16_t> output = Decimate(decimator, input, 1024);
+    int decimatedWindowSize = windowSize / factor;
+
+    YinPitchDetector detector;
+    detector.init(decimatedWindowSize, SAMPLE_RATE / factor);
+    float frequency = detector.getFrequencyFromBuffer(output.data() + output.size() - decimatedWindowSize);
+    REQUIRE(fabsf(1200 * log2f(frequency / 220)) < 5);
+}
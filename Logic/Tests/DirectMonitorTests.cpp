@@ -0,0 +1,55 @@
+#include "catch.hpp"
+#include "DirectMonitor.h"
+
+TEST_CASE("DirectMonitor plays the input back with the gain") {
+    DirectMonitor monitor;
+    std::vector<int16_t> input(64, 1000);
+    std::vector<int16_t> output(64, 500);
+    monitor.process(input.data(), output.data(), int(output.size()));
+    for (int16_t sample : output) {
+        REQUIRE(sample == 1000);
+    }
+
+    // The gain is ramped over the first block
+    monitor.setGain(2);
+    monitor.process(input.data(), output.data(), int(output.size()));
+    REQUIRE(output.back() == 2000);
+    for (int i = 1; i < output.size(); ++i) {
+        REQUIRE(output[i] - output[i - 1] > 0);
+        REQUIRE(output[i] - output[i - 1] < 20);
+    }
+
+    monitor.process(input.data(), output.data(), int(output.size()));
+    for (int16_t sample : output) {
+        REQUIRE(sample == 2000);
+    }
+
+    // Saturation
+    monitor.setGain(100);
+    monitor.process(input.data(), output.data(), int(output.size()));
+    monitor.process(input.data(), output.data(), int(output.size()));
+    REQUIRE(output.back() == 32767);
+}
+
+TEST_CASE("DirectMonitor ramps every channel of a frame equally in place") {
+    DirectMonitor monitor(2);
+    REQUIRE(monitor.getChannelsCount() == 2);
+    monitor.setGain(0);
+    // The duplex callback of a device renders the input into the output buffer
+    std::vector<int16_t> data;
+    for (int i = 0; i < 32; ++i) {
+        data.insert(data.end(), {1000, -1000});
+    }
+    monitor.process(data.data(), data.data(), int(data.size()));
+    for (int i = 0; i < data.size(); i += 2) {
+        REQUIRE(data[i] == -data[i + 1]);
+        REQUIRE(data[i] < 1000);
+    }
+    REQUIRE(data[data.size() - 2] == 0);
+
+    std::fill(data.begin(), data.end(), 1000);
+    monitor.process(data.data(), data.data(), int(data.size()));
+    for (int16_t sample : data) {
+        REQUIRE(sample == 0);
+    }
+}
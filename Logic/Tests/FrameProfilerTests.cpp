@@ -0,0 +1,95 @@
+#include "catch.hpp"
+#include "FrameProfiler.h"
+#include <sstream>
+#include <cstring>
+
+static void profileFrame(FrameProfiler* profiler) {
+    profiler->beginFrame();
+    {
+        PROFILE_FRAME_SECTION(profiler, "grid");
+    }
+    {
+        PROFILE_FRAME_SECTION(profiler, "endFrame");
+        PROFILE_FRAME_SECTION(profiler, "nvgEndFrame");
+    }
+    profiler->endFrame();
+}
+
+TEST_CASE("FrameProfiler records nested sections") {
+    FrameProfiler profiler(4);
+    profileFrame(&profiler);
+
+    std::vector<FrameProfiler::FrameRecord> records = profiler.getRecords();
+    REQUIRE(records.size() == 1);
+    const FrameProfiler::FrameRecord& record = records[0];
+    REQUIRE(record.frameIndex == 0);
+    REQUIRE(record.sectionsCount == 3);
+    REQUIRE(strcmp(record.sections[0].name, "grid") == 0);
+    REQUIRE(record.sections[0].depth == 0);
+    REQUIRE(strcmp(record.sections[2].name, "nvgEndFrame") == 0);
+    REQUIRE(record.sections[2].depth == 1);
+    REQUIRE(record.sections[2].begin >= record.sections[1].begin);
+    REQUIRE(record.sections[2].end <= record.sections[1].end);
+    REQUIRE(record.sections[1].end <= record.getDuration());
+}
+
+TEST_CASE("FrameProfiler keeps the last frames in a ring") {
+    FrameProfiler profiler(4);
+    for (int i = 0; i < 10; ++i) {
+        profileFrame(&profiler);
+    }
+
+    std::vector<FrameProfiler::FrameRecord> records = profiler.getRecords();
+    REQUIRE(records.size() == 4);
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(records[i].frameIndex == 6 + i);
+    }
+
+    // GPU time arrives later and is ignored for the overwritten frames
+    profiler.setGpuTime(8, 0.002);
+    profiler.setGpuTime(1, 0.003);
+    records = profiler.getRecords();
+    REQUIRE(records[2].gpuTime == 0.002);
+    for (int i : {0, 1, 3}) {
+        REQUIRE(records[i].gpuTime < 0);
+    }
+
+    std::vector<FrameProfiler::SectionSummary> summary = profiler.getSummary();
+    std::vector<std::string> names;
+    for (const auto& section : summary) {
+        names.push_back(section.name);
+    }
+    REQUIRE(names == std::vector<std::string>({"frame", "grid", "endFrame", "nvgEndFrame", "gpu"}));
+    REQUIRE(summary[3].depth == 2);
+    REQUIRE(summary[4].averageTime == Approx(0.002));
+}
+
+TEST_CASE("FrameProfiler ignores sections outside of frames and above the limit") {
+    FrameProfiler profiler(2);
+    {
+        PROFILE_FRAME_SECTION(&profiler, "outside");
+    }
+    PROFILE_FRAME_SECTION(nullptr, "disabled");
+
+    profiler.beginFrame();
+    for (int i = 0; i < FrameProfiler::MAX_SECTIONS_COUNT + 5; ++i) {
+        PROFILE_FRAME_SECTION(&profiler, "section");
+    }
+    profiler.endFrame();
+    REQUIRE(profiler.getRecords().back().sectionsCount == FrameProfiler::MAX_SECTIONS_COUNT);
+}
+
+TEST_CASE("FrameProfiler writes Chrome trace events") {
+    FrameProfiler profiler(4);
+    profileFrame(&profiler);
+    profiler.setGpuTime(0, 0.001);
+
+    std::stringstream trace;
+    profiler.writeChromeTrace(trace);
+    std::string json = trace.str();
+    REQUIRE(json.find(R"({"traceEvents":[)") == 0);
+    REQUIRE(json.find(R"("name":"frame 0","ph":"X","pid":1,"tid":1)") != std::string::npos);
+    REQUIRE(json.find(R"("name":"nvgEndFrame")") != std::string::npos);
+    REQUIRE(json.find(R"("name":"gpu","ph":"X","pid":1,"tid":2)") != std::string::npos);
+    REQUIRE(json.find(R"("dur":1000.000000})") != std::string::npos);
+}
@@ -0,0 +1,68 @@
+#include "catch.hpp"
+#include "FrameScheduler.h"
+
+TEST_CASE("FrameScheduler renders only changed frames while paused") {
+    int framesRequested = 0;
+    FrameScheduler scheduler([&] {
+        framesRequested++;
+    });
+
+    // The first frame is always rendered
+    REQUIRE(scheduler.shouldRenderFrame());
+    scheduler.beginFrame(0);
+    scheduler.endFrame(0.005);
+    REQUIRE(!scheduler.hasChanges());
+    REQUIRE(!scheduler.shouldRenderFrame());
+    REQUIRE(!scheduler.shouldRenderFrame());
+    REQUIRE(scheduler.getStatistics().skippedFramesCount == 2);
+
+    scheduler.invalidate(FrameScheduler::ZOOM);
+    scheduler.invalidate(FrameScheduler::COLORS);
+    REQUIRE(framesRequested == 1);
+    REQUIRE(scheduler.getChanges() == (FrameScheduler::ZOOM | FrameScheduler::COLORS));
+    REQUIRE(scheduler.shouldRenderFrame());
+    scheduler.beginFrame(1);
+    scheduler.endFrame(1.015);
+
+    REQUIRE(scheduler.getStatistics().framesCount == 2);
+    REQUIRE(scheduler.getStatistics().maxFrameTime == Approx(0.015));
+    REQUIRE(scheduler.getStatistics().averageFrameTime == Approx(0.01));
+}
+
+TEST_CASE("FrameScheduler derives seek from the transport clock") {
+    FrameScheduler scheduler;
+    scheduler.syncPlaybackSeek(10, 100);
+    scheduler.setRunning(true);
+    REQUIRE(scheduler.shouldRenderFrame());
+
+    REQUIRE(scheduler.getPlaybackSeek(100.5) == Approx(10.5));
+    // Doesn't depend on the frame rate
+    REQUIRE(scheduler.getPlaybackSeek(101.5) == Approx(11.5));
+
+    // Small transport jitter is corrected gradually, the seek keeps moving forward
+    scheduler.syncPlaybackSeek(11.48, 101.5);
+    double seek = scheduler.getPlaybackSeek(101.516);
+    REQUIRE(seek > 11.5);
+    REQUIRE(seek < 11.516);
+
+    // A seek made by the user is applied immediately
+    scheduler.syncPlaybackSeek(3, 101.52);
+    REQUIRE(scheduler.getPlaybackSeek(101.532) == Approx(3.012));
+
+    scheduler.setRunning(false);
+    REQUIRE(scheduler.getPlaybackSeek(105) == Approx(3));
+}
+
+TEST_CASE("FrameScheduler counts dropped frames while running") {
+    FrameScheduler scheduler;
+    scheduler.setRefreshInterval(0.01);
+    scheduler.setRunning(true);
+    double times[] = {0, 0.01, 0.02, 0.05, 0.06};
+    for (double time : times) {
+        scheduler.beginFrame(time);
+        scheduler.endFrame(time + 0.001);
+    }
+
+    REQUIRE(scheduler.getStatistics().droppedFramesCount == 2);
+    REQUIRE(scheduler.getStatistics().framesCount == 5);
+}
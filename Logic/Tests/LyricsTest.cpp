@@ -1,13 +1,44 @@
 #include "catch.hpp"
 #include "Lyrics.h"
+#include "BinaryArchive.h"
+#include <sstream>
 
 const char* russianLyrics = "{V1}\n"
-                            "Пр[15.12,15.23]и[15.23,16.43]вет[16.43, 16.98] как ты[18.23, 20.12]\n\n"
+                            "Пр[15.12;15.23]и[15.23;16.43]вет[16.43;16.98] как ты[18.23;20.12]\n\n"
                             "{B1}\n"
-                            "Пр[20.12,20.23]и[20.23,20.43]вет[20.43, 20.98]\n\n"
+                            "Пр[20.12;20.23]и[20.23;20.43]вет[20.43;20.98]\n\n"
                             "{C1}\n"
-                            "Пр[21.12,21.23]и[21.23,21.43]вет[21.43, 21.98]\n";
+                            "Пр[21.12;21.23]и[21.23;21.43]вет[21.43;21.98]\n";
 
 TEST_CASE("Russian lyrics test") {
     Lyrics lyrics(std::string(russianLyrics));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Lyrics binary serialization test") {
+    Lyrics lyrics(std::string{russianLyrics});
+    std::stringstream stream;
+    CppUtils::Serialization::WriteObjectToBinaryStream(lyrics, stream);
+    Lyrics loaded;
+    CppUtils::Serialization::ReadObjectFromBinaryStream(loaded, stream);
+
+    REQUIRE(loaded.toUtf8String() == lyrics.toUtf8String());
+    REQUIRE(loaded.getLinesCount() == lyrics.getLinesCount());
+    REQUIRE(loaded.getSections().size() == lyrics.getSections().size());
+    for (int i = 0; i < lyrics.getSections().size(); ++i) {
+        const Lyrics::Section& section = lyrics.getSections()[i];
+        const Lyrics::Section& loadedSection = loaded.getSections()[i];
+        REQUIRE(loadedSection.sectionType == section.sectionType);
+        REQUIRE(loadedSection.number == section.number);
+        REQUIRE(loadedSection.firstLineIndex == section.firstLineIndex);
+        REQUIRE(loadedSection.seek == section.seek);
+    }
+
+    for (double seek : {0.0, 15.12, 15.5, 16.98, 19.0, 20.3, 21.5, 22.0}) {
+        int lineIndex = lyrics.getNextOrCurrentLineIndexBySeek(seek);
+        REQUIRE(loaded.getNextOrCurrentLineIndexBySeek(seek) == lineIndex);
+        if (lineIndex >= 0) {
+            const Lyrics::Line& line = loaded.getLineAt(lineIndex);
+            REQUIRE(loaded.getLineSelection(line, seek) == lyrics.getLineSelection(lyrics.getLineAt(lineIndex), seek));
+        }
+    }
+}
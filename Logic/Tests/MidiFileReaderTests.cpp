@@ -0,0 +1,251 @@
+#include "catch.hpp"
+#include "MidiFileReader.h"
+#include "MidiFile.h"
+#include <sstream>
+#include <random>
+#include <tuple>
+
+// The craigsapp MidiFile reader is used as the reference implementation
+
+struct ReadNote {
+    int trackId;
+    int channelId;
+    int keyNumber;
+    int startTick;
+    int finalTick;
+    double startSeconds;
+    double finalSeconds;
+
+    bool operator<(const ReadNote& other) const {
+        return std::tie(trackId, channelId, startTick, keyNumber) <
+               std::tie(other.trackId, other.channelId, other.startTick, other.keyNumber);
+    }
+};
+
+static std::vector<ReadNote> GetNotes(const MidiFileReader& reader) {
+    std::vector<ReadNote> result;
+    for (const MidiTrack& track : reader.getTracks()) {
+        for (int i = 0; i < track.getNotesCount(); ++i) {
+            int startTick = track.getNotesStartTicks()[i];
+            int finalTick = track.getNotesFinalTicks()[i];
+            result.push_back({track.trackId, track.channelId, track.getNotesKeyNumbers()[i], startTick, finalTick,
+                              reader.ticksToSeconds(startTick), reader.ticksToSeconds(finalTick)});
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+static std::vector<ReadNote> GetNotes(MidiFile& midiFile) {
+    std::vector<ReadNote> result;
+    for (int trackIndex = 0; trackIndex < midiFile.getTrackCount(); ++trackIndex) {
+        MidiEventList& events = midiFile[trackIndex];
+        for (int i = 0; i < events.size(); ++i) {
+            MidiEvent& event = events[i];
+            MidiEvent* linkedEvent = event.getLinkedEvent();
+            if (!event.isNoteOn() || !linkedEvent) {
+                continue;
+            }
+
+            result.push_back({trackIndex, event.getChannel(), event.getKeyNumber(), event.tick, linkedEvent->tick,
+                              event.seconds, linkedEvent->seconds});
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+static void RequireSameAsReference(const std::string& data, int expectedNotesCount) {
+    MidiFileReader reader;
+    std::istringstream readerStream(data);
+    REQUIRE(reader.read(readerStream));
+
+    MidiFile referenceFile;
+    std::istringstream referenceStream(data);
+    REQUIRE(referenceFile.read(referenceStream));
+    referenceFile.doTimeAnalysis();
+    referenceFile.linkNotePairs();
+
+    REQUIRE(reader.getTicksPerQuarter() == referenceFile.getTicksPerQuarterNote());
+
+    std::vector<ReadNote> notes = GetNotes(reader);
+    std::vector<ReadNote> referenceNotes = GetNotes(referenceFile);
+    REQUIRE(notes.size() == expectedNotesCount);
+    REQUIRE(notes.size() == referenceNotes.size());
+    for (int i = 0; i < notes.size(); ++i) {
+        const ReadNote& note = notes[i];
+        const ReadNote& referenceNote = referenceNotes[i];
+        REQUIRE(note.trackId == referenceNote.trackId);
+        REQUIRE(note.channelId == referenceNote.channelId);
+        REQUIRE(note.keyNumber == referenceNote.keyNumber);
+        REQUIRE(note.startTick == referenceNote.startTick);
+        REQUIRE(note.finalTick == referenceNote.finalTick);
+        REQUIRE(note.startSeconds == Approx(referenceNote.startSeconds));
+        REQUIRE(note.finalSeconds == Approx(referenceNote.finalSeconds));
+    }
+
+    int durationInTicks = 0;
+    int firstTempoTick = -1;
+    double firstBeatsPerMinute = -1;
+    for (int trackIndex = 0; trackIndex < referenceFile.getTrackCount(); ++trackIndex) {
+        MidiEventList& events = referenceFile[trackIndex];
+        for (int i = 0; i < events.size(); ++i) {
+            durationInTicks = std::max(durationInTicks, events[i].tick);
+            if (events[i].isTempo() && (firstTempoTick < 0 || events[i].tick < firstTempoTick)) {
+                firstTempoTick = events[i].tick;
+                firstBeatsPerMinute = 60'000'000.0 / events[i].getTempoMicroseconds();
+            }
+        }
+    }
+    REQUIRE(reader.getDurationInTicks() == durationInTicks);
+    REQUIRE(reader.getDurationInSeconds() == Approx(referenceFile.getTimeInSeconds(durationInTicks)));
+    REQUIRE(reader.getBeatsPerMinute() == Approx(firstBeatsPerMinute));
+}
+
+static std::string WriteToString(MidiFile& midiFile) {
+    midiFile.sortTracks();
+    std::ostringstream stream;
+    REQUIRE(midiFile.write(stream));
+    return stream.str();
+}
+
+// Notes of different keys overlap, the same key is never reopened before it is closed
+static int AddRandomNotes(MidiFile& midiFile, int track, int channel, int notesCount, std::mt19937& random) {
+    std::uniform_int_distribution<int> keyDistribution(40, 80);
+    std::uniform_int_distribution<int> lengthDistribution(1, 480);
+    std::array<int, 128> keysFinalTicks;
+    keysFinalTicks.fill(0);
+    int tick = 0;
+    for (int i = 0; i < notesCount; ++i) {
+        tick += lengthDistribution(random) / 2;
+        int key = keyDistribution(random);
+        tick = std::max(tick, keysFinalTicks[key]);
+        int finalTick = tick + lengthDistribution(random);
+        midiFile.addNoteOn(track, tick, channel, key, 100);
+        // Both note off kinds are used
+        if (i % 2) {
+            midiFile.addNoteOff(track, finalTick, channel, key);
+        } else {
+            midiFile.addNoteOn(track, finalTick, channel, key, 0);
+        }
+        // The note is closed before the same key is opened again
+        keysFinalTicks[key] = finalTick + 1;
+    }
+    return notesCount;
+}
+
+TEST_CASE("MidiFileReader reads format 0 files as the reference reader") {
+    std::mt19937 random(1);
+    MidiFile midiFile;
+    midiFile.setTicksPerQuarterNote(480);
+    midiFile.addTrackName(0, 0, "Vocal");
+    midiFile.addTempo(0, 0, 100);
+    int notesCount = AddRandomNotes(midiFile, 0, 0, 50, random);
+    notesCount += AddRandomNotes(midiFile, 0, 1, 30, random);
+    std::string data = WriteToString(midiFile);
+    // Format 0
+    REQUIRE(data[9] == 0);
+
+    RequireSameAsReference(data, notesCount);
+    MidiFileReader reader;
+    std::istringstream stream(data);
+    REQUIRE(reader.read(stream));
+    REQUIRE(reader.getBeatsPerMinute() == Approx(100));
+    REQUIRE(reader.getTracks().size() == 2);
+    REQUIRE(reader.getTracks()[0].trackName == "Vocal");
+}
+
+TEST_CASE("MidiFileReader reads format 1 files with tempo changes as the reference reader") {
+    std::mt19937 random(2);
+    MidiFile midiFile;
+    midiFile.setTicksPerQuarterNote(192);
+    midiFile.addTrack(3);
+    // Tempo map in the first track and a tempo change in a note track
+    midiFile.addTempo(0, 0, 120);
+    midiFile.addTempo(0, 1000, 90);
+    midiFile.addTempo(0, 3001, 140.5);
+    midiFile.addTempo(2, 5000, 60);
+    int notesCount = 0;
+    for (int track = 1; track <= 3; ++track) {
+        notesCount += AddRandomNotes(midiFile, track, track - 1, 40 * track, random);
+    }
+    std::string data = WriteToString(midiFile);
+    // Format 1
+    REQUIRE(data[9] == 1);
+
+    RequireSameAsReference(data, notesCount);
+}
+
+TEST_CASE("MidiFileReader reads files without tempo with the default tempo") {
+    std::mt19937 random(3);
+    MidiFile midiFile;
+    midiFile.setTicksPerQuarterNote(96);
+    int notesCount = AddRandomNotes(midiFile, 0, 5, 20, random);
+    std::string data = WriteToString(midiFile);
+
+    MidiFileReader reader;
+    std::istringstream stream(data);
+    REQUIRE(reader.read(stream));
+    // 120 beats per minute
+    REQUIRE(reader.ticksToSeconds(96) == Approx(0.5));
+    std::vector<ReadNote> notes = GetNotes(reader);
+    REQUIRE(notes.size() == notesCount);
+
+    MidiFile referenceFile;
+    std::istringstream referenceStream(data);
+    REQUIRE(referenceFile.read(referenceStream));
+    referenceFile.doTimeAnalysis();
+    referenceFile.linkNotePairs();
+    std::vector<ReadNote> referenceNotes = GetNotes(referenceFile);
+    REQUIRE(notes.size() == referenceNotes.size());
+    for (int i = 0; i < notes.size(); ++i) {
+        REQUIRE(notes[i].startTick == referenceNotes[i].startTick);
+        REQUIRE(notes[i].finalTick == referenceNotes[i].finalTick);
+        REQUIRE(notes[i].startSeconds == Approx(referenceNotes[i].startSeconds));
+    }
+}
+
+TEST_CASE("MidiFileReader reads running status and skips unknown chunks") {
+    const unsigned char header[] = {'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96};
+    const unsigned char unknownChunk[] = {'X', 'x', 'x', 'x', 0, 0, 0, 2, 1, 2};
+    const unsigned char trackChunk[] = {
+            'M', 'T', 'r', 'k', 0, 0, 0, 32,
+            // Tempo 500000
+            0, 0xFF, 0x51, 3, 0x07, 0xA1, 0x20,
+            // Note on, then running status note on and note on with zero velocity
+            0, 0x90, 60, 100,
+            48, 64, 90,
+            48, 60, 0,
+            // Tempo 250000 in the middle of the note
+            24, 0xFF, 0x51, 3, 0x03, 0xD0, 0x90,
+            // Note off with its own status
+            24, 0x80, 64, 0,
+            0, 0xFF, 0x2F, 0
+    };
+    std::string data(reinterpret_cast<const char*>(header), sizeof(header));
+    data.append(reinterpret_cast<const char*>(trackChunk), sizeof(trackChunk));
+    RequireSameAsReference(data, 2);
+
+    // The reference reader doesn't support unknown chunks
+    std::string dataWithUnknownChunk(reinterpret_cast<const char*>(header), sizeof(header));
+    dataWithUnknownChunk.append(reinterpret_cast<const char*>(unknownChunk), sizeof(unknownChunk));
+    dataWithUnknownChunk.append(reinterpret_cast<const char*>(trackChunk), sizeof(trackChunk));
+    MidiFileReader reader;
+    std::istringstream stream(dataWithUnknownChunk);
+    REQUIRE(reader.read(stream));
+    std::vector<ReadNote> notes = GetNotes(reader);
+    REQUIRE(notes.size() == 2);
+    REQUIRE(notes[0].keyNumber == 60);
+    REQUIRE(notes[0].finalTick == 96);
+    REQUIRE(notes[1].keyNumber == 64);
+    REQUIRE(notes[1].finalSeconds == Approx(0.5 + 0.25 * 0.5 + 0.125 * 0.5));
+}
+
+TEST_CASE("MidiFileReader rejects broken files") {
+    MidiFileReader reader;
+    for (std::string data : {std::string("MThd"), std::string("RIFF0000000000000000"),
+                             std::string("MThd\0\0\0\6\0\0\0\1\0\0", 14)}) {
+        std::istringstream stream(data);
+        REQUIRE(!reader.read(stream));
+    }
+}
@@ -0,0 +1,210 @@
+#include "catch.hpp"
+#include "MultiChannelPitchInputReader.h"
+#include "PitchDetectorFactory.h"
+#include "TestTones.h"
+#include <cmath>
+#include <mutex>
+#include <thread>
+
+static constexpr int SAMPLE_RATE = 44100;
+static constexpr int FRAMES_PER_CALLBACK = 1024;
+static constexpr int SMOOTH_LEVEL = 4;
+
+// Interleaved callback buffer of the tones, one tone per channel, 0 frequency is silence
+static std::vector<int16_t> GenerateCallbackBuffer(const std::vector<float>& frequencies, int callbackIndex) {
+    int channelsCount = int(frequencies.size());
+    std::vector<int16_t> result(FRAMES_PER_CALLBACK * channelsCount);
+    for (int i = 0; i < FRAMES_PER_CALLBACK; ++i) {
+        for (int channel = 0; channel < channelsCount; ++channel) {
+            float frequency = frequencies[channel];
+            int16_t sample = frequency > 0 ? ToneSample(frequency, callbackIndex * FRAMES_PER_CALLBACK + i, 10000, 2) : 0;
+            result[i * channelsCount + channel] = sample;
+        }
+    }
+    return result;
+}
+
+TEST_CASE("WorkerPool runs every task of every batch once") {
+    for (int threadsCount : {0, 1, 3}) {
+        WorkerPool pool(threadsCount);
+        REQUIRE(pool.getThreadsCount() == threadsCount);
+        for (int tasksCount : {1, 2, 5, 16}) {
+            std::vector<std::atomic<int>> executions(tasksCount);
+            for (auto& count : executions) {
+                count = 0;
+            }
+            std::function<void(int)> task = [&] (int index) {
+                executions[index]++;
+            };
+            for (int batch = 0; batch < 200; ++batch) {
+                pool.run(tasksCount, task);
+            }
+            for (auto& count : executions) {
+                REQUIRE(count == 200);
+            }
+        }
+    }
+}
+
+TEST_CASE("MultiChannelPitchInputReader deinterleaves the channels") {
+    for (int channelsCount : {2, 3}) {
+        int framesCount = 100;
+        std::vector<int16_t> interleaved(framesCount * channelsCount);
+        for (int i = 0; i < interleaved.size(); ++i) {
+            interleaved[i] = int16_t(i);
+        }
+
+        std::vector<std::vector<int16_t>> channels(channelsCount, std::vector<int16_t>(framesCount));
+        std::vector<int16_t*> outputs;
+        for (auto& channel : channels) {
+            outputs.push_back(channel.data());
+        }
+        MultiChannelPitchInputReader::deinterleave(interleaved.data(), framesCount, channelsCount, outputs.data());
+        for (int channel = 0; channel < channelsCount; ++channel) {
+            for (int i = 0; i < framesCount; ++i) {
+                REQUIRE(channels[channel][i] == i * channelsCount + channel);
+            }
+        }
+    }
+}
+
+TEST_CASE("MultiChannelPitchInputReader tracks every channel independently") {
+    // A duet on the first two channels, the third one is silent
+    std::vector<float> frequencies = {220, 330, 0};
+    int channelsCount = int(frequencies.size());
+    for (int workerThreadsCount : {0, 2}) {
+        MultiChannelPitchInputReader reader(SAMPLE_RATE, channelsCount, FRAMES_PER_CALLBACK * channelsCount, [] {
+            return PitchDetectorFactory::create(PitchDetectorFactory::DEFAULT_ENGINE);
+        }, SMOOTH_LEVEL, 1, workerThreadsCount);
+        REQUIRE(reader.getChannelsCount() == channelsCount);
+        REQUIRE(reader.getWorkerThreadsCount() == workerThreadsCount);
+        reader.setExecuteCallBackOnInvalidPitches(true);
+
+        std::mutex mutex;
+        std::vector<std::vector<float>> detected(channelsCount);
+        for (int channel = 0; channel < channelsCount; ++channel) {
+            if (channel > 0) {
+                PitchDetector* firstChannelDetector = reader.getChannelReader(0)->getPitchDetector();
+                REQUIRE(reader.getChannelReader(channel)->getPitchDetector() != firstChannelDetector);
+            }
+            reader.getChannelReader(channel)->setCallback([&, channel] (const Pitch& pitch) {
+                std::lock_guard<std::mutex> _(mutex);
+                detected[channel].push_back(pitch.getFrequency());
+            });
+        }
+
+        int callbacksCount = 40;
+        for (int i = 0; i < callbacksCount; ++i) {
+            std::vector<int16_t> buffer = GenerateCallbackBuffer(frequencies, i);
+            reader(buffer.data(), int(buffer.size()));
+        }
+
+        for (int channel = 0; channel < channelsCount; ++channel) {
+            // A pitch per callback once the smoothing buffer is full
+            REQUIRE(detected[channel].size() == callbacksCount - SMOOTH_LEVEL + 1);
+            for (float frequency : detected[channel]) {
+                if (frequencies[channel] > 0) {
+                    REQUIRE(frequency == Approx(frequencies[channel]).epsilon(0.01));
+                } else {
+                    REQUIRE(frequency <= 0);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("MultiChannelPitchInputReader passes a mono input as is") {
+    MultiChannelPitchInputReader reader(SAMPLE_RATE, 1, FRAMES_PER_CALLBACK, [] {
+        return PitchDetectorFactory::create(PitchDetectorFactory::DEFAULT_ENGINE);
+    }, SMOOTH_LEVEL);
+    REQUIRE(reader.getWorkerThreadsCount() == 0);
+
+    std::vector<float> detected;
+    reader.getChannelReader(0)->setCallback([&] (const Pitch& pitch) {
+        detected.push_back(pitch.getFrequency());
+    });
+    for (int i = 0; i < 20; ++i) {
+        std::vector<int16_t> buffer = GenerateCallbackBuffer({440}, i);
+        reader(buffer.data(), int(buffer.size()));
+    }
+
+    REQUIRE(detected.size() == 20 - SMOOTH_LEVEL + 1);
+    for (float frequency : detected) {
+        REQUIRE(frequency == Approx(440).epsilon(0.01));
+    }
+}
+
+TEST_CASE("MultiChannelPitchInputReader detects the queued channels on its detection thread") {
+    std::vector<float> frequencies = {220, 330};
+    MultiChannelPitchInputReader reader(SAMPLE_RATE, 2, FRAMES_PER_CALLBACK * 2, [] {
+        return PitchDetectorFactory::create(PitchDetectorFactory::DEFAULT_ENGINE);
+    }, SMOOTH_LEVEL, 1, 1);
+    int callbacksCount = 40;
+    reader.startDetectionThread(callbacksCount);
+
+    std::mutex mutex;
+    std::vector<std::vector<float>> detected(2);
+    bool detectedOnCallingThread = false;
+    std::thread::id callingThreadId = std::this_thread::get_id();
+    for (int channel = 0; channel < 2; ++channel) {
+        reader.getChannelReader(channel)->setCallback([&, channel] (const Pitch& pitch) {
+            std::lock_guard<std::mutex> _(mutex);
+            detected[channel].push_back(pitch.getFrequency());
+            detectedOnCallingThread |= std::this_thread::get_id() == callingThreadId;
+        });
+    }
+
+    std::vector<std::vector<int16_t>> channels(2, std::vector<int16_t>(FRAMES_PER_CALLBACK));
+    std::vector<int16_t*> channelsData = {channels[0].data(), channels[1].data()};
+    for (int i = 0; i < callbacksCount; ++i) {
+        std::vector<int16_t> buffer = GenerateCallbackBuffer(frequencies, i);
+        MultiChannelPitchInputReader::deinterleave(buffer.data(), FRAMES_PER_CALLBACK, 2, channelsData.data());
+        reader.enqueueChannels(channelsData.data(), FRAMES_PER_CALLBACK);
+    }
+    reader.waitForQueuedBlocks();
+
+    REQUIRE(reader.getDroppedBlocksCount() == 0);
+    REQUIRE(!detectedOnCallingThread);
+    for (int channel = 0; channel < 2; ++channel) {
+        REQUIRE(detected[channel].size() == callbacksCount - SMOOTH_LEVEL + 1);
+        for (float frequency : detected[channel]) {
+            REQUIRE(frequency == Approx(frequencies[channel]).epsilon(0.01));
+        }
+    }
+}
+
+TEST_CASE("MultiChannelPitchInputReader drops the blocks not fitting into the queue") {
+    MultiChannelPitchInputReader reader(SAMPLE_RATE, 1, FRAMES_PER_CALLBACK, [] {
+        return PitchDetectorFactory::create(PitchDetectorFactory::DEFAULT_ENGINE);
+    }, 1);
+    reader.setExecuteCallBackOnInvalidPitches(true);
+    reader.startDetectionThread(2);
+
+    // The detection of the first block waits until the queue is full
+    std::atomic<bool> detectionStarted(false);
+    std::atomic<bool> queueFilled(false);
+    std::atomic<int> detectedCount(0);
+    reader.getChannelReader(0)->setCallback([&] (const Pitch&) {
+        detectionStarted = true;
+        while (!queueFilled) {
+            std::this_thread::yield();
+        }
+        detectedCount++;
+    });
+
+    std::vector<int16_t> silence(FRAMES_PER_CALLBACK, 0);
+    const int16_t* channels[] = {silence.data()};
+    reader.enqueueChannels(channels, FRAMES_PER_CALLBACK);
+    while (!detectionStarted) {
+        std::this_thread::yield();
+    }
+    for (int i = 0; i < 4; ++i) {
+        reader.enqueueChannels(channels, FRAMES_PER_CALLBACK);
+    }
+    queueFilled = true;
+    reader.waitForQueuedBlocks();
+
+    // The block being processed still takes its slot
+    REQUIRE(reader.getDroppedBlocksCount() == 3);
+    REQUIRE(detectedCount == 2);
+}
@@ -0,0 +1,204 @@
+#include "catch.hpp"
+#include "nanovg.h"
+#include <cstring>
+#include <cmath>
+#include <array>
+#include <vector>
+#include <functional>
+
+// nanovg context with the render callbacks doing nothing but copying the vertices of the last fill and stroke
+class RecordingNvgContext {
+    static void recordPaths(std::vector<float>* out, const NVGpath* paths, int npaths) {
+        out->clear();
+        for (int i = 0; i < npaths; ++i) {
+            for (int j = 0; j < paths[i].nfill; ++j) {
+                const NVGvertex& v = paths[i].fill[j];
+                out->insert(out->end(), {v.x, v.y, v.u, v.v});
+            }
+            for (int j = 0; j < paths[i].nstroke; ++j) {
+                const NVGvertex& v = paths[i].stroke[j];
+                out->insert(out->end(), {v.x, v.y, v.u, v.v});
+            }
+        }
+    }
+public:
+    NVGcontext* ctx;
+    std::vector<float> fillVertices;
+    std::vector<float> strokeVertices;
+
+    RecordingNvgContext() {
+        NVGparams params;
+        memset(&params, 0, sizeof(params));
+        params.userPtr = this;
+        params.edgeAntiAlias = 1;
+        params.renderCreate = [] (void*) { return 1; };
+        params.renderCreateTexture = [] (void*, int, int, int, int, const unsigned char*) { return 1; };
+        params.renderDeleteTexture = [] (void*, int) { return 1; };
+        params.renderUpdateTexture = [] (void*, int, int, int, int, int, const unsigned char*) { return 1; };
+        params.renderGetTextureSize = [] (void*, int, int* w, int* h) { *w = 1; *h = 1; return 1; };
+        params.renderViewport = [] (void*, float, float, float) {};
+        params.renderCancel = [] (void*) {};
+        params.renderFlush = [] (void*) {};
+        params.renderFill = [] (void* userPtr, NVGpaint*, NVGcompositeOperationState, NVGscissor*, float,
+                const float*, const NVGpath* paths, int npaths) {
+            recordPaths(&static_cast<RecordingNvgContext*>(userPtr)->fillVertices, paths, npaths);
+        };
+        params.renderStroke = [] (void* userPtr, NVGpaint*, NVGcompositeOperationState, NVGscissor*, float, float,
+                const NVGpath* paths, int npaths) {
+            recordPaths(&static_cast<RecordingNvgContext*>(userPtr)->strokeVertices, paths, npaths);
+        };
+        params.renderTriangles = [] (void*, NVGpaint*, NVGcompositeOperationState, NVGscissor*,
+                const NVGvertex*, int) {};
+        params.renderRoundedRects = [] (void*, NVGpaint*, NVGcompositeOperationState, NVGscissor*,
+                const NVGvertex*, int) {};
+        ctx = nvgCreateInternal(&params);
+    }
+
+    ~RecordingNvgContext() {
+        nvgDeleteInternal(ctx);
+    }
+
+    void frame(const std::function<void()>& draw) {
+        nvgBeginFrame(ctx, 200, 200, 1);
+        draw();
+        nvgEndFrame(ctx);
+    }
+
+    // Entries, stored entries and hits
+    std::array<int, 3> getStats() {
+        std::array<int, 3> stats;
+        nvgGeometryCacheStats(ctx, &stats[0], &stats[1], &stats[2]);
+        return stats;
+    }
+};
+
+// A star polygon, long enough to be cached
+static void StarPath(NVGcontext* ctx, float offset) {
+    nvgBeginPath(ctx);
+    for (int i = 0; i < 20; ++i) {
+        float radius = i % 2 ? 40 : 90;
+        float angle = float(i * M_PI / 10);
+        float x = 100 + offset + radius * std::cos(angle);
+        float y = 100 + radius * std::sin(angle);
+        if (i == 0) {
+            nvgMoveTo(ctx, x, y);
+        } else {
+            nvgLineTo(ctx, x, y);
+        }
+    }
+    nvgClosePath(ctx);
+}
+
+static std::array<int, 3> Stats(int entries, int stored, int hits) {
+    return {entries, stored, hits};
+}
+
+TEST_CASE("nanovg geometry cache stores a path drawn again and uses it from the third draw") {
+    RecordingNvgContext context;
+    NVGcontext* ctx = context.ctx;
+    auto fill = [&] {
+        StarPath(ctx, 0);
+        nvgFill(ctx);
+    };
+
+    // The first sighting keeps the hash only
+    context.frame(fill);
+    REQUIRE(context.getStats() == Stats(1, 0, 0));
+    std::vector<float> vertices = context.fillVertices;
+    REQUIRE(!vertices.empty());
+
+    // The second draw stores the geometry
+    context.frame(fill);
+    REQUIRE(context.getStats() == Stats(1, 1, 0));
+    REQUIRE(context.fillVertices == vertices);
+
+    // The stored geometry is the same as the tessellated one
+    context.frame(fill);
+    REQUIRE(context.getStats() == Stats(1, 1, 1));
+    REQUIRE(context.fillVertices == vertices);
+
+    // A stroke of the same path and a moved path are different entries
+    context.frame([&] {
+        StarPath(ctx, 0);
+        nvgStrokeWidth(ctx, 3);
+        nvgStroke(ctx);
+        StarPath(ctx, 0.5f);
+        nvgFill(ctx);
+    });
+    REQUIRE(context.getStats() == Stats(3, 1, 1));
+    REQUIRE(context.fillVertices != vertices);
+}
+
+TEST_CASE("nanovg geometry cache skips short paths") {
+    RecordingNvgContext context;
+    NVGcontext* ctx = context.ctx;
+    for (int i = 0; i < 3; ++i) {
+        context.frame([&] {
+            nvgBeginPath(ctx);
+            nvgRect(ctx, 10, 10, 50, 20);
+            nvgFill(ctx);
+        });
+    }
+    REQUIRE(context.getStats() == Stats(0, 0, 0));
+    REQUIRE(!context.fillVertices.empty());
+}
+
+TEST_CASE("nanovg geometry cache evicts paths not drawn for 4 frames") {
+    RecordingNvgContext context;
+    NVGcontext* ctx = context.ctx;
+    auto stroke = [&] {
+        StarPath(ctx, 0);
+        nvgStrokeWidth(ctx, 2);
+        nvgStroke(ctx);
+    };
+    auto skip = [] {};
+
+    context.frame(stroke);
+    context.frame(stroke);
+    REQUIRE(context.getStats() == Stats(1, 1, 0));
+    std::vector<float> vertices = context.strokeVertices;
+
+    // Kept while not drawn for up to 4 frames
+    for (int i = 0; i < 3; ++i) {
+        context.frame(skip);
+    }
+    REQUIRE(context.getStats() == Stats(1, 1, 0));
+    context.frame(stroke);
+    REQUIRE(context.getStats() == Stats(1, 1, 1));
+    REQUIRE(context.strokeVertices == vertices);
+
+    for (int i = 0; i < 4; ++i) {
+        context.frame(skip);
+    }
+    REQUIRE(context.getStats() == Stats(0, 0, 1));
+
+    // Seen for the first time again
+    context.frame(stroke);
+    REQUIRE(context.getStats() == Stats(1, 0, 1));
+    REQUIRE(context.strokeVertices == vertices);
+
+    // Hash only entries are evicted too
+    for (int i = 0; i < 4; ++i) {
+        context.frame(skip);
+    }
+    REQUIRE(context.getStats() == Stats(0, 0, 1));
+}
+
+TEST_CASE("nanovg geometry cache can be disabled") {
+    RecordingNvgContext context;
+    NVGcontext* ctx = context.ctx;
+    auto fill = [&] {
+        StarPath(ctx, 0);
+        nvgFill(ctx);
+    };
+    context.frame(fill);
+    context.frame(fill);
+    REQUIRE(context.getStats() == Stats(1, 1, 0));
+
+    nvgGeometryCaching(ctx, 0);
+    REQUIRE(context.getStats() == Stats(0, 0, 0));
+    for (int i = 0; i < 3; ++i) {
+        context.frame(fill);
+    }
+    REQUIRE(context.getStats() == Stats(0, 0, 0));
+}
@@ -0,0 +1,158 @@
+#include "catch.hpp"
+#include "PitchDetectorFactory.h"
+#include "MpmPitchDetector.h"
+#include "RealFFT.h"
+#include "TestTones.h"
+#include <memory>
+#include <random>
+#include <cmath>
+
+static constexpr int SAMPLE_RATE = 44100;
+static constexpr int BUFFER_SIZE = 4096;
+
+// A voice like tone, the fundamental and the decaying harmonics
+static constexpr int VOICE_HARMONICS_COUNT = 5;
+
+static float GetCents(float frequency, float expected) {
+    return fabsf(1200 * log2f(frequency / expected));
+}
+
+TEST_CASE("RealFFT matches the DFT and inverts") {
+    int size = 64;
+    RealFFT fft(size);
+    std::vector<float> input(static_cast<size_t>(size));
+    std::vector<float> output(static_cast<size_t>(size));
+    for (int i = 0; i < size; ++i) {
+        input[i] = sinf(i * 0.3f) + 0.1f * (i % 7);
+    }
+
+    std::vector<std::complex<float>> spectrum(static_cast<size_t>(fft.getSpectrumSize()));
+    fft.forward(input.data(), spectrum.data());
+    for (int k = 0; k < fft.getSpectrumSize(); ++k) {
+        std::complex<double> expected = 0;
+        for (int j = 0; j < size; ++j) {
+            expected += double(input[j]) * std::polar(1.0, -2 * M_PI * k * j / size);
+        }
+        REQUIRE(std::abs(expected - std::complex<double>(spectrum[k])) < 1e-4);
+    }
+
+    fft.inverse(spectrum.data(), output.data());
+    for (int i = 0; i < size; ++i) {
+        REQUIRE(fabsf(output[i] / size - input[i]) < 1e-5f);
+    }
+}
+
+TEST_CASE("Built-in pitch detector engines detect tones") {
+    std::vector<std::string> names = PitchDetectorFactory::getEngineNames();
+    for (const char* name : {"yin", "mpm", "pyin"}) {
+        REQUIRE(std::find(names.begin(), names.end(), name) != names.end());
+
+        std::unique_ptr<PitchDetector> detector(PitchDetectorFactory::create(name));
+        detector->init(BUFFER_SIZE, SAMPLE_RATE);
+        for (float frequency : {82.4f, 110.0f, 261.6f, 440.0f, 987.8f}) {
+            // pyin needs a few frames to settle
+            float detected = 0;
+            for (int frame = 0; frame < 3; ++frame) {
+                std::vector<int16_t> tone = GenerateTone(frequency, BUFFER_SIZE, 8000, VOICE_HARMONICS_COUNT, 0, frame * 0.7f);
+                detected = detector->getFrequencyFromBuffer(tone.data());
+            }
+            INFO(name << " " << frequency << " " << detected);
+            REQUIRE(GetCents(detected, frequency) < 5);
+        }
+
+        std::vector<int16_t> silence(BUFFER_SIZE, 0);
+        REQUIRE(detector->getFrequencyFromBuffer(silence.data()) < 0);
+    }
+}
+
+TEST_CASE("pyin follows a glide") {
+    std::unique_ptr<PitchDetector> detector(PitchDetectorFactory::create("pyin"));
+    detector->init(BUFFER_SIZE, SAMPLE_RATE);
+    for (int frame = 0; frame < 20; ++frame) {
+        float frequency = 220.0f * powf(2.0f, frame / 24.0f);
+        std::vector<int16_t> tone = GenerateTone(frequency, BUFFER_SIZE, 8000, VOICE_HARMONICS_COUNT);
+        float detected = detector->getFrequencyFromBuffer(tone.data());
+        INFO(frame << " " << frequency << " " << detected);
+        REQUIRE(GetCents(detected, frequency) < 10);
+    }
+}
+
+TEST_CASE("Pitch detector tunables are validated") {
+    PitchDetectorSettings settings = PitchDetectorFactory::parseSettings("threshold=0.15,minFrequency=70");
+    REQUIRE(settings.size() == 2);
+    REQUIRE(settings["threshold"] == Approx(0.15f));
+    REQUIRE(settings["minFrequency"] == Approx(70));
+    REQUIRE(PitchDetectorFactory::parseSettings("").empty());
+    REQUIRE_THROWS_AS(PitchDetectorFactory::parseSettings("threshold"), std::invalid_argument);
+    REQUIRE_THROWS_AS(PitchDetectorFactory::parseSettings("threshold=abc"), std::invalid_argument);
+
+    delete PitchDetectorFactory::create("yin", settings);
+    REQUIRE_THROWS_AS(PitchDetectorFactory::create("mpm", settings), std::invalid_argument);
+    REQUIRE_THROWS_AS(PitchDetectorFactory::create("crepe"), std::invalid_argument);
+
+    PitchDetectorFactory::Engine engine = PitchDetectorFactory::getEngine("mpm");
+    engine.name = "mpm-strict";
+    PitchDetectorFactory::registerEngine(engine);
+    delete PitchDetectorFactory::create("mpm-strict", {{"cutoff", 0.97f}});
+}
+
+TEST_CASE("Pitch detector tunables out of range are rejected") {
+    const std::vector<std::pair<std::string, PitchDetectorSettings>> invalidSettings = {
+            {"yin", {{"threshold", 0}}},
+            {"yin", {{"minFrequency", 500}, {"maxFrequency", 500}}},
+            {"mpm", {{"cutoff", 1.5f}}},
+            {"mpm", {{"smallCutoff", -0.1f}}},
+            {"mpm", {{"minFrequency", 0}}},
+            {"pyin", {{"thresholdMean", 0}}},
+            {"pyin", {{"thresholdMean", 1}}},
+            {"pyin", {{"binCents", 0}}},
+            {"pyin", {{"maxStepSemitones", -1}}},
+            {"pyin", {{"jumpProbability", 2}}},
+            {"pyin", {{"voicingStayProbability", NAN}}},
+            {"pyin", {{"minFrequency", 800}, {"maxFrequency", 400}}},
+    };
+    for (const auto& engineSettings : invalidSettings) {
+        REQUIRE_THROWS_AS(PitchDetectorFactory::create(engineSettings.first, engineSettings.second),
+                std::invalid_argument);
+    }
+
+    // The limits
+    delete PitchDetectorFactory::create("yin", {{"threshold", 1}});
+    delete PitchDetectorFactory::create("mpm", {{"smallCutoff", 0}});
+    delete PitchDetectorFactory::create("pyin", {{"jumpProbability", 0}, {"voicedTrust", 1}});
+}
+
+TEST_CASE("MPM key maxima are the highest maxima of the positive lobes") {
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> distribution(-1, 1);
+    for (int size : {5, 17, 64, 1001}) {
+        std::vector<float> nsdf(static_cast<size_t>(size));
+        for (int i = 0; i < size; ++i) {
+            nsdf[i] = i == 0 ? 1 : 0.7f * sinf(i * 0.35f) + 0.3f * distribution(random);
+        }
+
+        std::vector<int> expected;
+        bool firstLobeFinished = false;
+        int lobeMaximum = -1;
+        for (int i = 1; i < size - 1; ++i) {
+            if (nsdf[i] > 0 && nsdf[i] > nsdf[i - 1] && nsdf[i] >= nsdf[i + 1] && firstLobeFinished &&
+                    (lobeMaximum < 0 || nsdf[i] > nsdf[lobeMaximum])) {
+                lobeMaximum = i;
+            }
+            if (nsdf[i] > 0 && nsdf[i + 1] <= 0) {
+                if (lobeMaximum >= 0) {
+                    expected.push_back(lobeMaximum);
+                    lobeMaximum = -1;
+                }
+                firstLobeFinished = true;
+            }
+        }
+        if (lobeMaximum >= 0) {
+            expected.push_back(lobeMaximum);
+        }
+
+        std::vector<int> keyMaxima;
+        MpmPitchDetector::findKeyMaxima(nsdf.data(), size, &keyMaxima);
+        REQUIRE(keyMaxima == expected);
+    }
+}
@@ -0,0 +1,119 @@
+#include "catch.hpp"
+#include "PitchStabilityAnalyzer.h"
+#include <cmath>
+#include <random>
+
+// A pitch per 1024 samples at 44100Hz
+static constexpr double PITCHES_INTERVAL = 1024.0 / 44100;
+
+template<typename CentsFunction>
+static void AddPitches(PitchStabilityAnalyzer& analyzer, int noteIndex, double begin, int count,
+        const CentsFunction& cents) {
+    for (int i = 0; i < count; ++i) {
+        double time = begin + i * PITCHES_INTERVAL;
+        analyzer.addPitch(time, cents(time), noteIndex);
+    }
+}
+
+TEST_CASE("PitchStabilityAnalyzer detects vibrato") {
+    for (float rate : {4.5f, 5.5f, 7.0f}) {
+        PitchStabilityAnalyzer analyzer;
+        analyzer.setNotesCount(1);
+        std::mt19937 random(1);
+        std::normal_distribution<float> noise(0, 3);
+        AddPitches(analyzer, 0, 0, 200, [&] (double time) {
+            return float(10 + 40 * sin(2 * M_PI * rate * time)) + noise(random);
+        });
+
+        const PitchStabilityAnalyzer::Stability& stability = analyzer.getStability();
+        REQUIRE(stability.hasVibrato);
+        REQUIRE(stability.vibratoRate == Approx(rate).epsilon(0.08));
+        REQUIRE(stability.vibratoExtent == Approx(40).epsilon(0.2));
+        REQUIRE(stability.meanCentsError == Approx(10).margin(8));
+
+        const PitchStabilityAnalyzer::NoteStability& note = analyzer.getNotes()[0];
+        REQUIRE(note.analyzedPitchesCount == 200 - analyzer.getSettings().windowSize + 1);
+        REQUIRE(note.getVibratoShare() > 0.95);
+        REQUIRE(note.getMeanVibratoRate() == Approx(rate).epsilon(0.08));
+        REQUIRE(std::abs(note.getDrift()) < 5);
+    }
+}
+
+TEST_CASE("PitchStabilityAnalyzer doesn't find vibrato in a steady or drifting pitch") {
+    PitchStabilityAnalyzer analyzer;
+    analyzer.setNotesCount(2);
+    std::mt19937 random(2);
+    std::normal_distribution<float> noise(0, 2);
+    int vibratoPitchesCount = 0;
+    for (int i = 0; i < 200; ++i) {
+        analyzer.addPitch(i * PITCHES_INTERVAL, -5 + noise(random), 0);
+        vibratoPitchesCount += analyzer.getStability().hasVibrato;
+    }
+    REQUIRE(vibratoPitchesCount == 0);
+    REQUIRE(analyzer.getStability().meanCentsError == Approx(-5).margin(2));
+    REQUIRE(analyzer.getStability().jitter < 4);
+
+    // Going sharp by 20 cents per second
+    AddPitches(analyzer, 1, 10, 200, [] (double time) {
+        return float(-30 + 20 * (time - 10));
+    });
+    const PitchStabilityAnalyzer::NoteStability& note = analyzer.getNotes()[1];
+    REQUIRE(note.getDrift() == Approx(20).epsilon(0.01));
+    REQUIRE(note.vibratoPitchesCount == 0);
+    REQUIRE(note.getMeanJitter() == Approx(20 * PITCHES_INTERVAL).epsilon(0.01));
+}
+
+TEST_CASE("PitchStabilityAnalyzer jitter") {
+    PitchStabilityAnalyzer analyzer;
+    analyzer.setNotesCount(1);
+    int index = 0;
+    AddPitches(analyzer, 0, 0, 100, [&] (double) {
+        return index++ % 2 ? 10.0f : -10.0f;
+    });
+    REQUIRE(analyzer.getStability().jitter == Approx(20));
+    REQUIRE(analyzer.getNotes()[0].getMeanJitter() == Approx(20));
+    // The period is 2 pitches, far above the vibrato rates
+    REQUIRE(!analyzer.getStability().hasVibrato);
+}
+
+TEST_CASE("PitchStabilityAnalyzer restarts the window") {
+    PitchStabilityAnalyzer analyzer;
+    analyzer.setNotesCount(2);
+    int windowSize = analyzer.getSettings().windowSize;
+    auto vibrato = [] (double time) {
+        return float(30 * sin(2 * M_PI * 5.5 * time));
+    };
+    AddPitches(analyzer, 0, 0, windowSize, vibrato);
+    REQUIRE(analyzer.getStability().hasVibrato);
+    REQUIRE(analyzer.getNotes()[0].analyzedPitchesCount == 1);
+
+    // Unvoiced pitch
+    analyzer.addPitch(windowSize * PITCHES_INTERVAL, NAN, 0);
+    REQUIRE(!analyzer.getStability().hasVibrato);
+    AddPitches(analyzer, 0, (windowSize + 1) * PITCHES_INTERVAL, windowSize - 1, vibrato);
+    REQUIRE(!analyzer.getStability().hasVibrato);
+    REQUIRE(analyzer.getNotes()[0].analyzedPitchesCount == 1);
+
+    // Note change
+    AddPitches(analyzer, 1, 2 * windowSize * PITCHES_INTERVAL, windowSize - 1, vibrato);
+    REQUIRE(!analyzer.getStability().hasVibrato);
+    REQUIRE(analyzer.getNotes()[1].analyzedPitchesCount == 0);
+    REQUIRE(analyzer.getNotes()[1].voicedPitchesCount == windowSize - 1);
+
+    analyzer.resetNote(1);
+    REQUIRE(analyzer.getNotes()[1].voicedPitchesCount == 0);
+    REQUIRE(analyzer.getNotes()[0].voicedPitchesCount == 2 * windowSize - 1);
+}
+
+TEST_CASE("PitchStabilityAnalyzer keeps the sums precise on long takes") {
+    PitchStabilityAnalyzer analyzer;
+    analyzer.setNotesCount(1);
+    AddPitches(analyzer, 0, 0, 100000, [] (double time) {
+        return float(1000 + 25 * sin(2 * M_PI * 6 * time));
+    });
+    const PitchStabilityAnalyzer::Stability& stability = analyzer.getStability();
+    REQUIRE(stability.hasVibrato);
+    REQUIRE(stability.vibratoRate == Approx(6).epsilon(0.05));
+    REQUIRE(stability.vibratoExtent == Approx(25).epsilon(0.15));
+    REQUIRE(stability.meanCentsError == Approx(1000).margin(3));
+}
@@ -0,0 +1,79 @@
+#include "catch.hpp"
+#include "PitchValue.h"
+#include "Pitch.h"
+#include <cmath>
+
+static float ReferenceMidiNumber(float frequency) {
+    return float(69 + 12 * log2(double(frequency) / 440));
+}
+
+TEST_CASE("PitchValue fastLog2 accuracy") {
+    for (float value = 1e-3f; value < 1e5f; value *= 1.0013f) {
+        REQUIRE(fabs(PitchValue::fastLog2(value) - log2(double(value))) < 2e-6);
+    }
+    REQUIRE(PitchValue::fastLog2(1) == 0);
+    REQUIRE(PitchValue::fastLog2(1024) == 10);
+}
+
+TEST_CASE("PitchValue of the perfect frequencies") {
+    for (int index = 0; index < Pitch::FREQUENCIES_COUNT; ++index) {
+        Pitch pitch = Pitch::fromPerfectFrequencyIndex(index);
+        PitchValue value = PitchValue::fromFrequency(pitch.getFrequency());
+        REQUIRE(value.isValid());
+        REQUIRE(value.getPerfectFrequencyIndex() == index);
+        REQUIRE(value.getMidiIndex() == pitch.getMidiIndex());
+        // The table frequencies are rounded
+        REQUIRE(fabsf(value.getCents()) < 1);
+        REQUIRE(fabsf(value.getContinuousPerfectFrequencyIndex() - (index + 0.5f)) < 0.01f);
+        REQUIRE(fabsf(PitchValue(pitch).getMidiNumber() - value.getMidiNumber()) < 1e-5f);
+    }
+
+    PitchValue a4 = PitchValue::fromFrequency(440);
+    REQUIRE(fabsf(a4.getMidiNumber() - 69) < 1e-4f);
+    REQUIRE(fabsf(a4.getFrequency() - 440) < 0.01f);
+}
+
+TEST_CASE("PitchValue matches the reference mapping") {
+    for (float frequency = 31.8f; frequency < 4060; frequency *= 1.0007f) {
+        PitchValue value = PitchValue::fromFrequency(frequency);
+        float midiNumber = ReferenceMidiNumber(frequency);
+        REQUIRE(fabsf(value.getMidiNumber() - midiNumber) < 1e-4f);
+        // Away from the quarter tones the nearest note is the same
+        if (fabsf(midiNumber - floorf(midiNumber) - 0.5f) > 1e-3f) {
+            REQUIRE(value.getMidiIndex() == int(lroundf(midiNumber)));
+            REQUIRE(Pitch(frequency).getMidiIndex() == value.getMidiIndex());
+        }
+        REQUIRE(value.getCents() >= -50);
+        REQUIRE(value.getCents() < 50);
+    }
+}
+
+TEST_CASE("PitchValue invalid frequencies") {
+    for (float frequency : {-1.0f, 0.0f, 10.5f, 31.7f, 4068.0f, 123124.5f, NAN}) {
+        PitchValue value = PitchValue::fromFrequency(frequency);
+        REQUIRE(!value.isValid());
+        REQUIRE(value.getMidiIndex() == -1);
+        REQUIRE(value.getPerfectFrequencyIndex() == -1);
+        REQUIRE(value.getContinuousPerfectFrequencyIndex() < 0);
+        REQUIRE(!value.toPitch().isValid());
+        REQUIRE(Pitch::getContinuousPerfectFrequencyIndex(frequency) < 0);
+    }
+    REQUIRE(!PitchValue(Pitch()).isValid());
+}
+
+TEST_CASE("PitchValue converts to Pitch at the bounds") {
+    for (int index = 0; index < Pitch::FREQUENCIES_COUNT; ++index) {
+        for (float offset : {-0.4999f, 0.0f, 0.4999f}) {
+            PitchValue value = PitchValue::fromMidiNumber(24 + index + offset);
+            Pitch pitch = value.toPitch();
+            REQUIRE(pitch.getPerfectFrequencyIndex() == index);
+            REQUIRE(fabsf(pitch.getDistanceToPerfectFrequency() - offset * 2) < 1e-3f);
+        }
+    }
+}
+
+TEST_CASE("Pitch distance after shift") {
+    Pitch pitch(440);
+    pitch.shift(2);
+    REQUIRE(fabsf(pitch.getDistanceToPerfectFrequency() + 4) < 1e-3f);
+}
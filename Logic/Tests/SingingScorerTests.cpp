@@ -0,0 +1,204 @@
+#include "catch.hpp"
+#include "SingingScorer.h"
+#include "PitchValue.h"
+#include <cmath>
+
+static constexpr double TICKS_PER_SECOND = 10;
+static constexpr double PITCHES_INTERVAL = 0.01;
+
+// A4 [1s, 2s), C5 [2s, 3s), gap, A4 [4s, 5s)
+static VocalPart CreateVocalPart() {
+    std::vector<NoteInterval> notes = {
+            NoteInterval(Pitch(440.0f), 10, 10),
+            NoteInterval(Pitch(523.2511f), 20, 10),
+            NoteInterval(Pitch(440.0f), 40, 10)
+    };
+    return VocalPart(notes, 10, TICKS_PER_SECOND);
+}
+
+static float FrequencyWithCents(float frequency, float cents) {
+    return float(frequency * pow(2.0, cents / 1200.0));
+}
+
+// Sings the notes with the given cents error, NAN error means silence. Pitch times are in the middle of
+// the intervals, so they are never on the notes bounds.
+template<typename ErrorFunction>
+static void Sing(SingingScorer& scorer, const VocalPart& vocalPart, double begin, double end,
+        const ErrorFunction& centsError) {
+    for (int i = 0; begin + i * PITCHES_INTERVAL < end; ++i) {
+        double time = begin + (i + 0.5) * PITCHES_INTERVAL;
+        float frequency = -1;
+        for (const NoteInterval& note : vocalPart.getNotes()) {
+            if (time >= vocalPart.ticksToSeconds(note.startTickNumber) &&
+                    time < vocalPart.ticksToSeconds(note.endTickNumber())) {
+                float error = centsError(time);
+                frequency = std::isnan(error) ? -1 : FrequencyWithCents(note.pitch.getFrequency(), error);
+            }
+        }
+        scorer.addPitch(time, frequency);
+    }
+}
+
+TEST_CASE("SingingScorer perfect singing") {
+    VocalPart vocalPart = CreateVocalPart();
+    SingingScorer scorer;
+    scorer.setVocalPart(vocalPart);
+    Sing(scorer, vocalPart, 0, 6, [] (double) { return 0.0f; });
+
+    const SingingScore& score = scorer.getScore();
+    REQUIRE(score.getNotesCount() == 3);
+    REQUIRE(score.getSungNotesCount() == 3);
+    REQUIRE(score.getHitNotesCount() == 3);
+    REQUIRE(score.getAccuracy() == 1);
+    REQUIRE(score.getCoverage() == 1);
+    REQUIRE(score.getMeanAbsCentsError() < 0.1);
+    REQUIRE(score.getMeanOnsetDelay() < PITCHES_INTERVAL);
+    REQUIRE(score.getMeanCentsErrorStandardDeviation() < 0.1);
+    for (const NoteSingingScore& note : score.notes) {
+        REQUIRE(note.pitchesCount == 100);
+    }
+}
+
+TEST_CASE("SingingScorer cents error and stability") {
+    VocalPart vocalPart = CreateVocalPart();
+    SingingScorer scorer;
+    scorer.setVocalPart(vocalPart);
+    // 40 cents sharp with 20 cents vibrato at 5.5Hz
+    Sing(scorer, vocalPart, 0, 6, [] (double time) {
+        return float(40 + 20 * sin(2 * M_PI * 5.5 * time));
+    });
+
+    const SingingScore& score = scorer.getScore();
+    for (const NoteSingingScore& note : score.notes) {
+        REQUIRE(note.getMeanCentsError() == Approx(40).margin(2));
+        REQUIRE(note.getMeanAbsCentsError() == Approx(40).margin(2));
+        // Standard deviation of a sine is amplitude / sqrt(2)
+        REQUIRE(note.getCentsErrorStandardDeviation() == Approx(20 / sqrt(2)).margin(1));
+        REQUIRE(note.getCoverage() == 1);
+        // The pitch is further than 50 cents from the note for a third of the vibrato period
+        REQUIRE(note.getAccuracy() == Approx(2.0 / 3).margin(0.05));
+    }
+}
+
+TEST_CASE("SingingScorer octave errors") {
+    VocalPart vocalPart = CreateVocalPart();
+    SingingScorer scorer;
+    scorer.setVocalPart(vocalPart);
+    Sing(scorer, vocalPart, 0, 6, [] (double) { return -1200.0f; });
+    REQUIRE(scorer.getScore().getAccuracy() == 1);
+
+    SingingScorer::Settings settings;
+    settings.ignoreOctave = false;
+    SingingScorer strictScorer(settings);
+    strictScorer.setVocalPart(vocalPart);
+    Sing(strictScorer, vocalPart, 0, 6, [] (double) { return -1200.0f; });
+    REQUIRE(strictScorer.getScore().getAccuracy() == 0);
+    REQUIRE(strictScorer.getScore().getHitNotesCount() == 0);
+    REQUIRE(strictScorer.getScore().getMeanAbsCentsError() == Approx(1200).margin(0.5));
+}
+
+TEST_CASE("SingingScorer coverage and onset delay") {
+    VocalPart vocalPart = CreateVocalPart();
+    SingingScorer scorer;
+    scorer.setVocalPart(vocalPart);
+    // Every note starts 0.2s late, 0.1s of which is silence and 0.1s is a slide from 200 cents below
+    Sing(scorer, vocalPart, 0, 6, [] (double time) -> float {
+        double timeInNote = fmod(time, 1.0);
+        if (timeInNote < 0.1) {
+            return NAN;
+        }
+        if (timeInNote < 0.2) {
+            return float(-200 + (timeInNote - 0.1) * 1500);
+        }
+        return 0.0;
+    });
+
+    const SingingScore& score = scorer.getScore();
+    for (const NoteSingingScore& note : score.notes) {
+        REQUIRE(note.getCoverage() == Approx(0.9).margin(0.02));
+        REQUIRE(note.onsetDelay == Approx(0.2).margin(0.02));
+        REQUIRE(note.getAccuracy() == Approx(0.8).margin(0.02));
+    }
+    REQUIRE(score.getMeanOnsetDelay() == Approx(0.2).margin(0.02));
+}
+
+TEST_CASE("SingingScorer ignores pitches between notes") {
+    VocalPart vocalPart = CreateVocalPart();
+    SingingScorer scorer;
+    scorer.setVocalPart(vocalPart);
+    for (double time = 0; time < 6; time += PITCHES_INTERVAL) {
+        scorer.addPitch(time, 100);
+        bool inNote = (time >= 1 && time < 3) || (time >= 4 && time < 5);
+        REQUIRE((scorer.getCurrentNoteIndex() >= 0) == inNote);
+    }
+
+    int pitchesCount = 0;
+    for (const NoteSingingScore& note : scorer.getScore().notes) {
+        pitchesCount += note.pitchesCount;
+    }
+    REQUIRE(std::abs(pitchesCount - 300) <= 2);
+}
+
+TEST_CASE("SingingScorer seek back scores the notes again") {
+    VocalPart vocalPart = CreateVocalPart();
+    SingingScorer scorer;
+    scorer.setVocalPart(vocalPart);
+    Sing(scorer, vocalPart, 0, 3.5, [] (double) { return 100.0f; });
+    REQUIRE(scorer.getScore().getAccuracy() == 0);
+
+    // Seek back into the second note
+    Sing(scorer, vocalPart, 2.5, 6, [] (double) { return 0.0f; });
+    const SingingScore& score = scorer.getScore();
+    REQUIRE(score.notes[0].getAccuracy() == 0);
+    REQUIRE(score.notes[1].getAccuracy() == 1);
+    REQUIRE(score.notes[1].pitchesCount == Approx(50).margin(1));
+    REQUIRE(score.notes[2].getAccuracy() == 1);
+
+    // Forward seek skips the notes
+    scorer.reset();
+    Sing(scorer, vocalPart, 3.5, 6, [] (double) { return 0.0f; });
+    REQUIRE(scorer.getScore().getSungNotesCount() == 1);
+    REQUIRE(scorer.getScore().getAccuracy() == 1);
+}
+
+TEST_CASE("SingingScorer keeps the score on pitch shift") {
+    VocalPart vocalPart = CreateVocalPart();
+    SingingScorer scorer;
+    scorer.setVocalPart(vocalPart);
+    Sing(scorer, vocalPart, 0, 2.5, [] (double) { return 0.0f; });
+    SingingScore scoreBeforeShift = scorer.getScore();
+
+    VocalPart shifted = vocalPart.shifted(2);
+    scorer.setVocalPart(shifted);
+    REQUIRE(scorer.getScore() == scoreBeforeShift);
+    Sing(scorer, shifted, 2.5, 6, [] (double) { return 0.0f; });
+    REQUIRE(scorer.getScore().getAccuracy() == 1);
+    REQUIRE(scorer.getScore() != scoreBeforeShift);
+}
+
+TEST_CASE("SingingScorer analyzes the stability of the notes") {
+    VocalPart vocalPart = CreateVocalPart();
+    SingingScorer::Settings settings;
+    // 0.8s at 100 pitches per second
+    settings.stabilitySettings.windowSize = 80;
+    SingingScorer scorer(settings);
+    scorer.setVocalPart(vocalPart);
+    Sing(scorer, vocalPart, 0, 3.5, [] (double time) {
+        return float(40 * sin(2 * M_PI * 5.5 * time));
+    });
+
+    const PitchStabilityAnalyzer& analyzer = scorer.getStabilityAnalyzer();
+    REQUIRE(analyzer.getNotes().size() == 3);
+    for (int i = 0; i < 2; ++i) {
+        const PitchStabilityAnalyzer::NoteStability& note = analyzer.getNotes()[i];
+        REQUIRE(note.getVibratoShare() > 0.9);
+        REQUIRE(note.getMeanVibratoRate() == Approx(5.5).epsilon(0.05));
+    }
+    REQUIRE(analyzer.getNotes()[2].voicedPitchesCount == 0);
+
+    // Seek back into the second note
+    Sing(scorer, vocalPart, 2.5, 3, [] (double) { return 0.0f; });
+    REQUIRE(analyzer.getNotes()[0].vibratoPitchesCount > 0);
+    REQUIRE(analyzer.getNotes()[1].vibratoPitchesCount == 0);
+    REQUIRE(analyzer.getNotes()[1].voicedPitchesCount == 50);
+}
@@ -0,0 +1,28 @@
+#ifndef VOCALTRAINER_TESTTONES_H
+#define VOCALTRAINER_TESTTONES_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Sample of a tone of harmonicsCount harmonics, the harmonic n has the amplitude amplitude / n and the phase
+// phase * n. The phase of the frames continues across the pieces generated with the following firstFrameIndex.
+inline int16_t ToneSample(float frequency, int64_t frameIndex, float amplitude, int harmonicsCount = 1,
+        float phase = 0, int sampleRate = 44100) {
+    double value = 0;
+    for (int harmonic = 1; harmonic <= harmonicsCount; ++harmonic) {
+        value += sin(2 * M_PI * frequency * harmonic * frameIndex / sampleRate + phase * harmonic) / harmonic;
+    }
+    return static_cast<int16_t>(value * amplitude);
+}
+
+inline std::vector<int16_t> GenerateTone(float frequency, int size, float amplitude, int harmonicsCount = 1,
+        int64_t firstFrameIndex = 0, float phase = 0, int sampleRate = 44100) {
+    std::vector<int16_t> result(static_cast<size_t>(size));
+    for (int i = 0; i < size; ++i) {
+        result[i] = ToneSample(frequency, firstFrameIndex + i, amplitude, harmonicsCount, phase, sampleRate);
+    }
+    return result;
+}
+
+#endif //VOCALTRAINER_TESTTONES_H
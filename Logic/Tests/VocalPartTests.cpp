@@ -1,6 +1,10 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 #include "NoteInterval.h"
+#include "VocalPart.h"
+#include "Algorithms.h"
+
+using namespace CppUtils;
 
 TEST_CASE("VxPitch intersection test") {
     NoteInterval a;
@@ -50,5 +54,36 @@ TEST_CASE("VxPitch intersection test 2") {
 }
 
 TEST_CASE("iteratePitchesInTickRange test") {
+    std::vector<NoteInterval> notes;
+    Pitch pitch = Pitch::fromPerfectFrequencyIndex(40);
+    // Includes overlapping notes and a long note covering several short ones
+    notes.emplace_back(pitch, 0, 10);
+    notes.emplace_back(pitch, 5, 100);
+    notes.emplace_back(pitch, 12, 3);
+    notes.emplace_back(pitch, 20, 1);
+    notes.emplace_back(pitch, 150, 30);
+    notes.emplace_back(pitch, 160, 5);
+    VocalPart vocalPart(notes, 0, 100);
+
+    for (int startTick = -5; startTick < 200; ++startTick) {
+        for (int endTick = startTick - 2; endTick < startTick + 40; ++endTick) {
+            std::vector<int> expected;
+            for (int i = 0; i < vocalPart.getNotes().size(); ++i) {
+                if (vocalPart.getNotes()[i].intersectsWith(startTick, endTick)) {
+                    expected.push_back(i);
+                }
+            }
+
+            std::vector<int> actual;
+            vocalPart.iteratePitchesIndexesInTickRange(startTick, endTick, [&] (int index) {
+                actual.push_back(index);
+            });
+            REQUIRE(actual == expected);
+        }
 
+        REQUIRE(vocalPart.hasPitchesInMoment(vocalPart.ticksToSeconds(startTick)) ==
+                Contains(vocalPart.getNotes(), [=] (const NoteInterval& note) {
+                    return note.containsTick(startTick);
+                }));
+    }
 }
\ No newline at end of file
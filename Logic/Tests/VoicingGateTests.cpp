@@ -0,0 +1,203 @@
+#include "catch.hpp"
+#include "VoicingGate.h"
+#include "PitchInputReader.h"
+#include "TestTones.h"
+#include <random>
+#include <cmath>
+
+static constexpr int SAMPLE_RATE = 44100;
+static constexpr int PIECE_SIZE = 1024;
+
+// The fundamental and the second harmonic of half its amplitude
+static std::vector<int16_t> GenerateTonePiece(float frequency, float amplitude, int pieceIndex) {
+    return GenerateTone(frequency, PIECE_SIZE, amplitude, 2, int64_t(pieceIndex) * PIECE_SIZE);
+}
+
+// Amplitude of the tone generated by GenerateTonePiece with the given rms level
+static float GetToneAmplitude(float levelDb) {
+    return 32768 * powf(10, levelDb / 20) / sqrtf(0.625f);
+}
+
+static std::vector<int16_t> GenerateNoisePiece(float amplitude, std::mt19937& random) {
+    std::uniform_real_distribution<float> distribution(-amplitude, amplitude);
+    std::vector<int16_t> result(PIECE_SIZE);
+    for (int16_t& sample : result) {
+        sample = static_cast<int16_t>(distribution(random));
+    }
+    return result;
+}
+
+TEST_CASE("VoicingGate features") {
+    std::vector<int16_t> silence(PIECE_SIZE, 0);
+    VoicingGate::PieceFeatures features = VoicingGate::computeFeatures(silence.data(), PIECE_SIZE);
+    REQUIRE(features.levelDb <= -100);
+    REQUIRE(features.zeroCrossingRate == 0);
+
+    std::vector<int16_t> fullScale(PIECE_SIZE);
+    for (int i = 0; i < PIECE_SIZE; ++i) {
+        fullScale[i] = i % 2 ? 32767 : -32767;
+    }
+    features = VoicingGate::computeFeatures(fullScale.data(), PIECE_SIZE);
+    REQUIRE(fabsf(features.levelDb) < 0.01f);
+    REQUIRE(features.zeroCrossingRate > 0.99f);
+}
+
+TEST_CASE("VoicingGate skips silence and noise, passes a tone") {
+    std::mt19937 random(1);
+    VoicingGate gate;
+    gate.init(SAMPLE_RATE, 1);
+
+    int pieceIndex = 0;
+    for (int i = 0; i < 20; ++i, ++pieceIndex) {
+        std::vector<int16_t> piece = GenerateNoisePiece(30, random);
+        REQUIRE(!gate.process(piece.data(), PIECE_SIZE));
+    }
+
+    // Loud, but white noise
+    for (int i = 0; i < 5; ++i, ++pieceIndex) {
+        std::vector<int16_t> piece = GenerateNoisePiece(10000, random);
+        REQUIRE(!gate.process(piece.data(), PIECE_SIZE));
+    }
+
+    for (int i = 0; i < 20; ++i, ++pieceIndex) {
+        std::vector<int16_t> piece = GenerateTonePiece(220, 5000, pieceIndex);
+        REQUIRE(gate.process(piece.data(), PIECE_SIZE));
+    }
+}
+
+TEST_CASE("VoicingGate hysteresis and hold") {
+    std::mt19937 random(2);
+    VoicingGate gate;
+    int holdPiecesCount = 3;
+    gate.init(SAMPLE_RATE, holdPiecesCount);
+
+    int pieceIndex = 0;
+    for (int i = 0; i < 100; ++i, ++pieceIndex) {
+        std::vector<int16_t> piece = GenerateNoisePiece(100, random);
+        gate.process(piece.data(), PIECE_SIZE);
+    }
+    float noiseFloorDb = gate.getNoiseFloorDb();
+    // uniform noise of amplitude 100 has the rms of 100 / sqrt(3)
+    REQUIRE(fabsf(noiseFloorDb - 20 * log10f(100 / sqrtf(3) / 32768)) < 3);
+
+    // 6 dB above the floor: between the close and the open thresholds, so doesn't open the closed gate
+    for (int i = 0; i < 5; ++i, ++pieceIndex) {
+        float amplitude = GetToneAmplitude(gate.getNoiseFloorDb() + 6);
+        std::vector<int16_t> piece = GenerateTonePiece(220, amplitude, pieceIndex);
+        gate.process(piece.data(), PIECE_SIZE);
+        REQUIRE(!gate.isOpen());
+    }
+
+    std::vector<int16_t> loud = GenerateTonePiece(220, 5000, pieceIndex++);
+    gate.process(loud.data(), PIECE_SIZE);
+    REQUIRE(gate.isOpen());
+
+    // Keeps the open gate
+    for (int i = 0; i < 5; ++i, ++pieceIndex) {
+        float amplitude = GetToneAmplitude(gate.getNoiseFloorDb() + 6);
+        std::vector<int16_t> piece = GenerateTonePiece(220, amplitude, pieceIndex);
+        REQUIRE(gate.process(piece.data(), PIECE_SIZE));
+        REQUIRE(gate.isOpen());
+    }
+
+    // The window of holdPiecesCount pieces still contains a voiced piece
+    std::vector<int16_t> silence(PIECE_SIZE, 0);
+    for (int i = 0; i < holdPiecesCount - 1; ++i) {
+        REQUIRE(gate.process(silence.data(), PIECE_SIZE));
+        REQUIRE(!gate.isOpen());
+    }
+    REQUIRE(!gate.process(silence.data(), PIECE_SIZE));
+}
+
+TEST_CASE("VoicingGate adapts to the noise floor") {
+    std::mt19937 random(3);
+    VoicingGate gate;
+    gate.init(SAMPLE_RATE, 1);
+
+    // A quiet tone opens the gate in a silent room
+    int pieceIndex = 0;
+    std::vector<int16_t> silence(PIECE_SIZE, 0);
+    for (int i = 0; i < 10; ++i) {
+        gate.process(silence.data(), PIECE_SIZE);
+    }
+    std::vector<int16_t> quiet = GenerateTonePiece(220, 200, pieceIndex++);
+    REQUIRE(gate.process(quiet.data(), PIECE_SIZE));
+    gate.reset();
+
+    // A room with a constant hum, the floor rises to it and the gate closes
+    int piecesCount = 20 * SAMPLE_RATE / PIECE_SIZE;
+    for (int i = 0; i < piecesCount; ++i, ++pieceIndex) {
+        std::vector<int16_t> piece = GenerateTonePiece(100, 200, pieceIndex);
+        gate.process(piece.data(), PIECE_SIZE);
+    }
+    REQUIRE(!gate.isOpen());
+    std::vector<int16_t> hum = GenerateTonePiece(100, 200, pieceIndex++);
+    REQUIRE(!gate.process(hum.data(), PIECE_SIZE));
+
+    std::vector<int16_t> voice = GenerateTonePiece(220, 5000, pieceIndex++);
+    REQUIRE(gate.process(voice.data(), PIECE_SIZE));
+}
+
+// Counts the analyzed buffers and the resets, every buffer is voiced at 220 Hz
+class CountingPitchDetector : public PitchDetector {
+public:
+    int buffersCount = 0;
+    int resetsCount = 0;
+
+    void init(int maxBufferSize, int sampleRate) override {
+    }
+
+    float getFrequencyFromBuffer(const int16_t *buffer) override {
+        buffersCount++;
+        return 220;
+    }
+
+    void reset() override {
+        resetsCount++;
+    }
+};
+
+TEST_CASE("PitchInputReader resets the pitch detector when the voicing gate closes") {
+    CountingPitchDetector* detector = new CountingPitchDetector();
+    PitchInputReader reader(SAMPLE_RATE, PIECE_SIZE, detector, 1);
+    std::vector<int16_t> silence(PIECE_SIZE, 0);
+    int pieceIndex = 0;
+    auto sing = [&] (int piecesCount) {
+        for (int i = 0; i < piecesCount; ++i, ++pieceIndex) {
+            std::vector<int16_t> piece = GenerateTonePiece(220, 5000, pieceIndex);
+            reader(piece.data(), PIECE_SIZE);
+        }
+    };
+    auto pause = [&] (int piecesCount) {
+        for (int i = 0; i < piecesCount; ++i, ++pieceIndex) {
+            reader(silence.data(), PIECE_SIZE);
+        }
+    };
+
+    pause(5);
+    REQUIRE(detector->buffersCount == 0);
+    REQUIRE(detector->resetsCount == 1);
+    sing(10);
+    REQUIRE(detector->buffersCount == 10);
+    // Once per pause
+    pause(5);
+    REQUIRE(detector->resetsCount == 2);
+    sing(10);
+    pause(5);
+    REQUIRE(detector->resetsCount == 3);
+    REQUIRE(reader.getSkippedFramesCount() == 15);
+
+    // Without the gate every window is analyzed
+    reader.setVoicingGateEnabled(false);
+    REQUIRE(!reader.isVoicingGateEnabled());
+    pause(5);
+    REQUIRE(detector->buffersCount == 25);
+    REQUIRE(detector->resetsCount == 3);
+
+    // Enabled again, the gate is reset by the next piece and closes
+    reader.setVoicingGateEnabled(true);
+    pause(5);
+    REQUIRE(detector->buffersCount == 25);
+    REQUIRE(detector->resetsCount == 4);
+    REQUIRE(!reader.getVoicingGate().isOpen());
+}
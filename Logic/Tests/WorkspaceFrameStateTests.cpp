@@ -0,0 +1,91 @@
+#include "catch.hpp"
+#include "WorkspaceFrameState.h"
+#include "FrameScheduler.h"
+#include <thread>
+
+TEST_CASE("WorkspaceFrameStateBuffer reports the changes once") {
+    WorkspaceFrameStateBuffer buffer(FrameScheduler::ALL_CHANGES);
+    REQUIRE(buffer.acquire() == FrameScheduler::ALL_CHANGES);
+    REQUIRE(buffer.acquire() == 0);
+
+    buffer.modify(FrameScheduler::ZOOM, [] (WorkspaceFrameState& state) {
+        state.zoom = 2;
+    });
+    buffer.modify(FrameScheduler::SEEK, [] (WorkspaceFrameState& state) {
+        state.seek = 10;
+    });
+    // The front state is not changed until acquire
+    REQUIRE(buffer.getFront().zoom == 1);
+    REQUIRE(buffer.acquire() == (FrameScheduler::ZOOM | FrameScheduler::SEEK));
+    REQUIRE(buffer.getFront().zoom == 2);
+    REQUIRE(buffer.getFront().seek == 10);
+    REQUIRE(buffer.acquire() == 0);
+
+    // Modifications without changes are copied, but not reported
+    buffer.modify(0, [] (WorkspaceFrameState& state) {
+        state.verticalScrollPosition = 0.5f;
+    });
+    REQUIRE(buffer.acquire() == 0);
+    REQUIRE(buffer.getFront().verticalScrollPosition == 0.5f);
+}
+
+TEST_CASE("WorkspaceFrameStateBuffer front state is not affected by the pending modifications") {
+    WorkspaceFrameStateBuffer buffer(0);
+    buffer.modify(FrameScheduler::PITCHES, [] (WorkspaceFrameState& state) {
+        state.pitchesTimes = {1, 2, 3};
+        state.pitchValues = {PitchValue::fromMidiNumber(34), PitchValue(), PitchValue::fromMidiNumber(36)};
+    });
+    buffer.acquire();
+    const WorkspaceFrameState& front = buffer.getFront();
+
+    buffer.modify(FrameScheduler::PITCHES, [] (WorkspaceFrameState& state) {
+        state.pitchesTimes.push_back(4);
+        state.pitchValues.push_back(PitchValue::fromMidiNumber(37));
+    });
+    REQUIRE(front.pitchesTimes.size() == 3);
+
+    PitchValue pendingLastValue;
+    buffer.read([&] (const WorkspaceFrameState& state) {
+        pendingLastValue = state.pitchValues.back();
+    });
+    REQUIRE(pendingLastValue.getMidiIndex() == 37);
+}
+
+TEST_CASE("WorkspaceFrameStateBuffer tasks are taken in the posted order") {
+    WorkspaceFrameStateBuffer buffer(0);
+    std::vector<int> executed;
+    buffer.post([&] {
+        executed.push_back(1);
+    });
+    buffer.post([&] {
+        executed.push_back(2);
+    });
+
+    for (const auto& task : buffer.takeTasks()) {
+        task();
+    }
+    REQUIRE(executed == std::vector<int>({1, 2}));
+    REQUIRE(buffer.takeTasks().empty());
+}
+
+TEST_CASE("WorkspaceFrameStateBuffer frames see consistent states") {
+    WorkspaceFrameStateBuffer buffer(0);
+    std::thread controller([&] {
+        for (int i = 1; i <= 10000; ++i) {
+            buffer.modify(FrameScheduler::SEEK, [=] (WorkspaceFrameState& state) {
+                state.seek = i;
+                state.beatsInBar = i;
+            });
+        }
+    });
+
+    double lastSeek = 0;
+    while (lastSeek < 10000) {
+        buffer.acquire();
+        const WorkspaceFrameState& state = buffer.getFront();
+        REQUIRE(state.seek == state.beatsInBar);
+        REQUIRE(state.seek >= lastSeek);
+        lastSeek = state.seek;
+    }
+    controller.join();
+}
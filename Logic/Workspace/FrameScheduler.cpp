@@ -0,0 +1,142 @@
+#include "FrameScheduler.h"
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+#define LOCK std::lock_guard<std::mutex> _(transportMutex)
+
+FrameScheduler::FrameScheduler(const std::function<void()>& onFrameRequested) :
+        changes(ALL_CHANGES),
+        running(false),
+        onFrameRequested(onFrameRequested) {
+}
+
+void FrameScheduler::setOnFrameRequested(const std::function<void()>& onFrameRequested) {
+    this->onFrameRequested = onFrameRequested;
+}
+
+void FrameScheduler::invalidate(int changes) {
+    assert(changes != 0 && (changes & ~ALL_CHANGES) == 0);
+    int previousChanges = this->changes.fetch_or(changes);
+    if (previousChanges == 0 && onFrameRequested) {
+        onFrameRequested();
+    }
+}
+
+int FrameScheduler::getChanges() const {
+    return changes;
+}
+
+bool FrameScheduler::hasChanges() const {
+    return changes != 0;
+}
+
+bool FrameScheduler::isRunning() const {
+    return running;
+}
+
+void FrameScheduler::setRunning(bool running) {
+    this->running = running;
+    // The seek is snapped to the transport on the next frame and the idle interval is not counted as dropped frames
+    presentedTime = -1;
+    previousFrameBeginTime = -1;
+    invalidate(SEEK);
+}
+
+bool FrameScheduler::shouldRenderFrame() {
+    if (running || changes != 0) {
+        return true;
+    }
+
+    statistics.skippedFramesCount++;
+    return false;
+}
+
+void FrameScheduler::beginFrame(double time) {
+    changes = 0;
+    frameBeginTime = time;
+    if (!running) {
+        previousFrameBeginTime = -1;
+        return;
+    }
+
+    if (previousFrameBeginTime >= 0) {
+        double interval = time - previousFrameBeginTime;
+        if (interval > refreshInterval * 1.5) {
+            statistics.droppedFramesCount += static_cast<int>(std::round(interval / refreshInterval)) - 1;
+        }
+    }
+    previousFrameBeginTime = time;
+}
+
+void FrameScheduler::endFrame(double time) {
+    assert(frameBeginTime >= 0 && "call beginFrame before endFrame");
+    double frameTime = std::max(0.0, time - frameBeginTime);
+    frameBeginTime = -1;
+
+    statistics.framesCount++;
+    statistics.lastFrameTime = frameTime;
+    statistics.maxFrameTime = std::max(statistics.maxFrameTime, frameTime);
+    frameTimesSum += frameTime;
+    statistics.averageFrameTime = frameTimesSum / statistics.framesCount;
+}
+
+void FrameScheduler::syncPlaybackSeek(double seek, double time) {
+    {
+        LOCK;
+        transportSeek = seek;
+        transportTime = time;
+    }
+    invalidate(SEEK);
+}
+
+double FrameScheduler::getPlaybackSeek(double time) {
+    double targetSeek;
+    {
+        LOCK;
+        if (transportTime < 0) {
+            return presentedSeek;
+        }
+
+        targetSeek = transportSeek;
+        if (running) {
+            targetSeek += time - transportTime;
+        }
+    }
+
+    if (!running || presentedTime < 0) {
+        presentedSeek = targetSeek;
+    } else if (time > presentedTime) {
+        // Advance with the frame time and correct the drift from the transport gradually, so the irregular
+        // transport updates don't make the scroll jitter. Big differences are seeks made by the user.
+        double predictedSeek = presentedSeek + (time - presentedTime);
+        double drift = targetSeek - predictedSeek;
+        if (std::abs(drift) > MAX_PLAYBACK_SEEK_DRIFT) {
+            presentedSeek = targetSeek;
+        } else {
+            presentedSeek = predictedSeek + drift * PLAYBACK_SEEK_DRIFT_CORRECTION;
+        }
+    }
+
+    presentedTime = time;
+    return presentedSeek;
+}
+
+bool FrameScheduler::hasPlaybackSeek() const {
+    LOCK;
+    return transportTime >= 0;
+}
+
+void FrameScheduler::setRefreshInterval(double refreshInterval) {
+    assert(refreshInterval > 0);
+    this->refreshInterval = refreshInterval;
+}
+
+const FrameScheduler::Statistics& FrameScheduler::getStatistics() const {
+    return statistics;
+}
+
+void FrameScheduler::resetStatistics() {
+    statistics = Statistics();
+    frameTimesSum = 0;
+}
@@ -0,0 +1,107 @@
+#ifndef VOCALTRAINER_FRAMESCHEDULER_H
+#define VOCALTRAINER_FRAMESCHEDULER_H
+
+#include <atomic>
+#include <mutex>
+#include <functional>
+
+// Decides when a view should render a new frame. Changes are accumulated as dirty flags, the view is rendered
+// only when something is changed, or continuously while the playback is running.
+// While running the playback seek is derived from the transport clock, extrapolated to the frame time
+// and smoothed, so the scroll doesn't depend on the frame rate and doesn't jitter when the transport
+// reports its position with an irregular period.
+// invalidate and syncPlaybackSeek can be called from any thread, other methods from the rendering thread.
+class FrameScheduler {
+public:
+    enum Change {
+        SEEK = 1 << 0,
+        SCROLL = 1 << 1,
+        PITCHES = 1 << 2,
+        ZOOM = 1 << 3,
+        BOUNDS = 1 << 4,
+        COLORS = 1 << 5,
+        // Size, device pixel ratio and visible pitches range
+        LAYOUT = 1 << 6,
+        // Vocal part, tracks and other data displayed
+        CONTENT = 1 << 7,
+        // Mouse events, which are handled during the frame rendering
+        INPUT = 1 << 8,
+        // The frame shows an intermediate state, which is completed by the following frames
+        ANIMATION = 1 << 9,
+        ALL_CHANGES = (1 << 10) - 1
+    };
+
+    struct Statistics {
+        // Frames rendered since the last resetStatistics
+        int framesCount = 0;
+        // Frame requests ignored, because nothing was changed
+        int skippedFramesCount = 0;
+        // Frames presented later than expected while running, measured by the interval between the frames
+        int droppedFramesCount = 0;
+        // Rendering time of the frames in seconds
+        double lastFrameTime = 0;
+        double averageFrameTime = 0;
+        double maxFrameTime = 0;
+    };
+private:
+    std::atomic<int> changes;
+    std::atomic<bool> running;
+    std::function<void()> onFrameRequested;
+
+    mutable std::mutex transportMutex;
+    double transportSeek = 0;
+    double transportTime = -1;
+
+    // Last seek returned from getPlaybackSeek and the frame time it was calculated for
+    double presentedSeek = 0;
+    double presentedTime = -1;
+
+    double refreshInterval = 1.0 / 60.0;
+    double frameBeginTime = -1;
+    double previousFrameBeginTime = -1;
+    double frameTimesSum = 0;
+    Statistics statistics;
+public:
+    static constexpr double MAX_PLAYBACK_SEEK_DRIFT = 0.1;
+    static constexpr double PLAYBACK_SEEK_DRIFT_CORRECTION = 0.1;
+
+    // onFrameRequested is called when the first change is made after a frame is rendered,
+    // it's executed on the thread, which has made the change
+    explicit FrameScheduler(const std::function<void()>& onFrameRequested = nullptr);
+    FrameScheduler(const FrameScheduler&) = delete;
+    FrameScheduler& operator=(const FrameScheduler&) = delete;
+
+    void setOnFrameRequested(const std::function<void()>& onFrameRequested);
+
+    // changes is a combination of Change flags
+    void invalidate(int changes);
+    int getChanges() const;
+    bool hasChanges() const;
+
+    bool isRunning() const;
+    void setRunning(bool running);
+
+    // Returns true if a frame should be rendered, counts the frame as skipped otherwise.
+    // Should be called on every vsync, when the view is able to present a new frame.
+    bool shouldRenderFrame();
+
+    // Called around the frame rendering, time is in seconds of TimeUtils::NowInSecondsSinceStart.
+    // beginFrame clears the changes, the changes made during the rendering request the next frame.
+    void beginFrame(double time);
+    void endFrame(double time);
+
+    // Transport position reported by the playback at the given time
+    void syncPlaybackSeek(double seek, double time);
+    // Playback seek at the frame time, extrapolated from the last transport position while running
+    double getPlaybackSeek(double time);
+    bool hasPlaybackSeek() const;
+
+    // Expected interval between the frames while running, used to count the dropped frames
+    void setRefreshInterval(double refreshInterval);
+
+    const Statistics& getStatistics() const;
+    void resetStatistics();
+};
+
+
+#endif //VOCALTRAINER_FRAMESCHEDULER_H
@@ -5,6 +5,7 @@
 
 #include "PianoDrawer.h"
 #include "Drawer.h"
+#include "FrameProfiler.h"
 
 constexpr float bigPitchHeight = 25.5;
 constexpr float smallPitchHeight = 18.75;
@@ -42,145 +43,175 @@ void PianoDrawer::setIntervalHeight(float intervalHeight) {
 
 PianoDrawer::PianoDrawer(Drawer *drawer, const WorkspaceColorScheme* colors)
         : drawer(drawer), colors(colors) {
-    drawSharpPitchesFillColor.reserve(100);
-    drawSharpPitchesY.reserve(100);
+    keys.reserve(100);
     intervalHeight = 0;
     firstPitchIndex = -1;
     detectedPitchIndex = -1;
 }
 
-void PianoDrawer::draw(float width, float height, float devicePixelRation) {
-    assert(intervalHeight > 0);
-    assert(pitchSequence != nullptr);
-
-    drawer->setTextAlign(Drawer::LEFT);
-    drawer->setTextBaseline(Drawer::MIDDLE);
-    drawer->setTextFontSize(fontSize);
-    drawer->setTextStyle(fontStyle);
-
-    drawer->setStrokeColor(colors->pianoBorderColor);
-    drawer->setFillColor(colors->pianoSharpPitchColor);
+void PianoDrawer::layoutKeys(float height) {
+    keys.clear();
 
     int index = getFirstPitch().getWhiteIndex();
     int perfectFrequencyIndex = firstPitchIndex;
     float y = height;
 
-    drawSharpPitchesY.clear();
-    drawSharpPitchesFillColor.clear();
-    selectedPitchIndexes.clear();
-
     float intervalOctaveHeightToPianoOctaveHeightRelation = getIntervalOctaveHeightToPianoOctaveHeightRelation();
 
     while (y > -bigPitchHeight) {
-
-        bool fill = false;
-
-        auto getFillColor = [&] (int perfectFrequencyIndex) {
-            Pitch detectedPitch = Pitch::fromPerfectFrequencyIndex(detectedPitchIndex);
-            if (detectedPitchIndex == perfectFrequencyIndex) {
-                if (pitchSequence->hasPitchNow(detectedPitch)) {
-                    return colors->reachedPitchColor;
-                } else {
-                    return colors->pianoSelectedPitchColor;
-                }
-            } else {
-                if (pitchSequence->hasPitchNow(Pitch::fromPerfectFrequencyIndex(perfectFrequencyIndex)) &&
-                        !pitchSequence->hasPitchNow(detectedPitch)) {
-                    return colors->missedPitchColor;
-                } else {
-                    return colors->pianoSharpPitchColor;
-                }
-            }
-        };
-
-        Drawer::Color fillColor = getFillColor(perfectFrequencyIndex);
-        if (fillColor != colors->pianoSharpPitchColor) {
-            fill = true;
-            drawer->setFillColor(fillColor);
-            selectedPitchIndexes.insert(perfectFrequencyIndex);
-        }
-
         float pitchHeight = heightMap[index % heightMapLength] * intervalOctaveHeightToPianoOctaveHeightRelation;
-        drawer->roundedRectDifferentCorners(0, y - pitchHeight, pianoWidth - 1, pitchHeight, 0,
-                pitchRadius * intervalOctaveHeightToPianoOctaveHeightRelation,
-                pitchRadius * intervalOctaveHeightToPianoOctaveHeightRelation, 0);
-        if (fill) {
-            drawer->fill();
-        } else {
-            drawer->stroke();
-        }
-
+        keys.push_back({perfectFrequencyIndex, y - pitchHeight, pitchHeight, false, false,
+                colors->pianoSharpPitchColor});
         y -= pitchHeight;
 
-        // post draw sharp pitch command
         if (hasSharpMap[index % heightMapLength]) {
             perfectFrequencyIndex++;
-            fillColor = getFillColor(perfectFrequencyIndex);
-            drawSharpPitchesFillColor.push_back(fillColor);
-            drawSharpPitchesY.push_back(y);
+            float sharpHeight = sharpPitchHeight * intervalOctaveHeightToPianoOctaveHeightRelation;
+            float sharpY = y - sharpHeight / 2 - distanceBetweenPitches / 2 * intervalOctaveHeightToPianoOctaveHeightRelation;
+            keys.push_back({perfectFrequencyIndex, sharpY, sharpHeight, true, false, colors->pianoSharpPitchColor});
         }
 
         y -= distanceBetweenPitches * intervalOctaveHeightToPianoOctaveHeightRelation;
         index++;
         perfectFrequencyIndex++;
     }
-
-    drawSharpPitches();
-    drawPitchNames(height);
 }
 
-void PianoDrawer::drawSharpPitches() const {
+Drawer::RoundedRectShape PianoDrawer::getKeyShape(const Key& key) const {
     float intervalOctaveHeightToPianoOctaveHeightRelation = getIntervalOctaveHeightToPianoOctaveHeightRelation();
-
-    for (int i = 0; i < drawSharpPitchesY.size(); i++) {
-        float y = drawSharpPitchesY[i];
-        drawer->setFillColor(drawSharpPitchesFillColor[i]);
-        float pitchHeight = sharpPitchHeight * intervalOctaveHeightToPianoOctaveHeightRelation;
+    if (key.sharp) {
         float radius = sharpPitchRadius * intervalOctaveHeightToPianoOctaveHeightRelation;
-
-        drawer->roundedRectDifferentCorners(0,
-                y - pitchHeight / 2 - distanceBetweenPitches / 2 * intervalOctaveHeightToPianoOctaveHeightRelation,
-                sharpPitchWidth,
-                pitchHeight, 0, radius, radius, 0);
-        drawer->fill();
+        return {0, key.y, sharpPitchWidth, key.height, 0, radius, radius, 0};
+    } else {
+        float radius = pitchRadius * intervalOctaveHeightToPianoOctaveHeightRelation;
+        return {0, key.y, pianoWidth - 1, key.height, 0, radius, radius, 0};
     }
 }
 
-void PianoDrawer::drawPitchNames(float height) const {
-    float y = height;
-    Pitch pitch = getFirstPitch();
+void PianoDrawer::drawKey(const Key& key) const {
+    Drawer::RoundedRectShape shape = getKeyShape(key);
+    drawer->roundedRectDifferentCorners(shape.x, shape.y, shape.width, shape.height, shape.radiusLeftTop,
+            shape.radiusRightTop, shape.radiusBottomRight, shape.radiusBottomLeft);
+}
 
-    float intervalOctaveHeightToPianoOctaveHeightRelation = getIntervalOctaveHeightToPianoOctaveHeightRelation();
+void PianoDrawer::setupTextStyle() const {
+    drawer->setTextAlign(Drawer::LEFT);
+    drawer->setTextBaseline(Drawer::MIDDLE);
+    drawer->setTextFontSize(fontSize);
+    drawer->setTextStyle(fontStyle);
+}
 
-    while (y > -bigPitchHeight) {
-        int index = pitch.getWhiteIndex();
-        int indexInMap = index % heightMapLength;
-        float pitchHeight = heightMap[indexInMap] * intervalOctaveHeightToPianoOctaveHeightRelation;
+void PianoDrawer::drawPitchName(const Key& key) const {
+    Pitch pitch = Pitch::fromPerfectFrequencyIndex(key.perfectFrequencyIndex);
+    if (!pitch.isValid()) {
+        return;
+    }
+
+    std::string text;
+    if (pitch.getPerfectFrequencyIndex() == firstPitchIndex) {
+        text = pitch.getFullName();
+    } else if(pitch.getPitchInOctaveIndex() == Pitch::C_INDEX) {
+        text = pitch.getFullName();
+    } else {
+        text = pitch.getName();
+    }
 
-        float textY = y - pitchHeight / 2;
-        std::string text;
+    drawer->setFillColor(key.selected ? SELECTED_PITCH_TEXT_COLOR : PITCH_TEXT_COLOR);
+    float textX = pianoWidth - distanceBetweenTextLeftAndPitchRight;
+    drawer->fillText(text, textX, key.y + key.height / 2);
+}
 
-        if (pitch.getPerfectFrequencyIndex() == firstPitchIndex) {
-            text = pitch.getFullName();
-        } else if(pitch.getPitchInOctaveIndex() == Pitch::C_INDEX) {
-            text = pitch.getFullName();
+Drawer::Color PianoDrawer::getKeyFillColor(int perfectFrequencyIndex, bool detectedPitchIsPlaying) const {
+    if (detectedPitchIndex == perfectFrequencyIndex) {
+        if (detectedPitchIsPlaying) {
+            return colors->reachedPitchColor;
         } else {
-            text = pitch.getName();
+            return colors->pianoSelectedPitchColor;
         }
-
-        if (selectedPitchIndexes.count(pitch.getPerfectFrequencyIndex())) {
-            drawer->setFillColor(SELECTED_PITCH_TEXT_COLOR);
+    } else {
+        if (!detectedPitchIsPlaying &&
+                pitchSequence->hasPitchNow(Pitch::fromPerfectFrequencyIndex(perfectFrequencyIndex))) {
+            return colors->missedPitchColor;
         } else {
-            drawer->setFillColor(PITCH_TEXT_COLOR);
+            return colors->pianoSharpPitchColor;
         }
+    }
+}
 
-        float textX = pianoWidth - distanceBetweenTextLeftAndPitchRight;
-        drawer->fillText(text, textX, textY);
+void PianoDrawer::drawKeyboard(float height) {
+    PROFILE_FRAME_SECTION(drawer->getFrameProfiler(), "pianoKeyboard");
+    assert(intervalHeight > 0);
+    layoutKeys(height);
+
+    drawer->setStrokeColor(colors->pianoBorderColor);
+    for (const Key& key : keys) {
+        if (!key.sharp) {
+            drawKey(key);
+            drawer->stroke();
+        }
+    }
+
+    sharpKeysShapes.clear();
+    for (const Key& key : keys) {
+        if (key.sharp) {
+            sharpKeysShapes.push_back(getKeyShape(key));
+        }
+    }
+    drawer->fillRoundedRects(sharpKeysShapes.data(), int(sharpKeysShapes.size()), colors->pianoSharpPitchColor);
+
+    setupTextStyle();
+    for (const Key& key : keys) {
+        if (!key.sharp) {
+            drawPitchName(key);
+        }
+    }
+}
+
+void PianoDrawer::drawSelectedPitches(float height) {
+    PROFILE_FRAME_SECTION(drawer->getFrameProfiler(), "pianoSelectedPitches");
+    assert(intervalHeight > 0);
+    assert(pitchSequence != nullptr);
+    layoutKeys(height);
+
+    bool detectedPitchIsPlaying = pitchSequence->hasPitchNow(Pitch::fromPerfectFrequencyIndex(detectedPitchIndex));
+    bool hasSelectedKeys = false;
+    for (Key& key : keys) {
+        key.fillColor = getKeyFillColor(key.perfectFrequencyIndex, detectedPitchIsPlaying);
+        key.selected = key.fillColor != colors->pianoSharpPitchColor;
+        hasSelectedKeys |= key.selected;
+    }
+
+    if (!hasSelectedKeys) {
+        return;
+    }
+
+    for (const Key& key : keys) {
+        if (!key.sharp && key.selected) {
+            drawer->setFillColor(key.fillColor);
+            drawKey(key);
+            drawer->fill();
+        }
+    }
+
+    // Sharp keys overlap the white keys around them, so they are drawn again above the selected white keys
+    for (int i = 0; i < keys.size(); i++) {
+        const Key& key = keys[i];
+        if (!key.sharp) {
+            continue;
+        }
+
+        bool neighbourSelected = keys[i - 1].selected || (i + 1 < keys.size() && keys[i + 1].selected);
+        if (key.selected || neighbourSelected) {
+            drawer->setFillColor(key.fillColor);
+            drawKey(key);
+            drawer->fill();
+        }
+    }
 
-        y -= pitchHeight + distanceBetweenPitches * intervalOctaveHeightToPianoOctaveHeightRelation;
-        pitch = pitch.getNextWhitePitch();
-        if (!pitch.isValid()) {
-            break;
+    setupTextStyle();
+    for (const Key& key : keys) {
+        if (!key.sharp && key.selected) {
+            drawPitchName(key);
         }
     }
 }
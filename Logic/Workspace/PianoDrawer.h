@@ -11,19 +11,29 @@
 #include "Pitch.h"
 #include "PlayingPitchSequence.h"
 #include "WorkspaceColorScheme.h"
-#include <unordered_set>
+#include <vector>
 #include <atomic>
 
 class PianoDrawer {
+    // Rectangle of a piano key, keys go from the bottom to the top, every sharp key follows
+    // the white key below it
+    struct Key {
+        int perfectFrequencyIndex;
+        float y;
+        float height;
+        bool sharp;
+        bool selected;
+        Drawer::Color fillColor;
+    };
+
     float intervalHeight;
     Drawer* drawer;
     PlayingPitchSequence* pitchSequence = nullptr;
 
     int firstPitchIndex;
     int detectedPitchIndex;
-    std::vector<Drawer::Color> drawSharpPitchesFillColor;
-    std::vector<float> drawSharpPitchesY;
-    std::unordered_set<int> selectedPitchIndexes;
+    std::vector<Key> keys;
+    std::vector<Drawer::RoundedRectShape> sharpKeysShapes;
     int fontSize = 8;
     Drawer::FontStyle fontStyle;
     const WorkspaceColorScheme* colors;
@@ -31,6 +41,13 @@ class PianoDrawer {
     float getIntervalOctaveHeightToPianoOctaveHeightRelation() const;
 
     Pitch getFirstPitch() const;
+
+    void layoutKeys(float height);
+    Drawer::RoundedRectShape getKeyShape(const Key& key) const;
+    void drawKey(const Key& key) const;
+    void drawPitchName(const Key& key) const;
+    void setupTextStyle() const;
+    Drawer::Color getKeyFillColor(int perfectFrequencyIndex, bool detectedPitchIsPlaying) const;
 public:
     void setFontSize(int fontSize);
     void setFontStyle(Drawer::FontStyle fontStyle);
@@ -41,12 +58,14 @@ public:
     PianoDrawer(Drawer *drawer, const WorkspaceColorScheme* colors);
 
     void setPitchSequence(PlayingPitchSequence *pitchSequence);
-    void draw(float pianoWidth, float height, float devicePixelRation);
+    // Draws the piano without the detected and playing pitches. The result depends only on
+    // the interval height, the first pitch and the colors, so it can be cached.
+    void drawKeyboard(float height);
+    // Draws the detected and playing pitches above the keyboard
+    void drawSelectedPitches(float height);
     void setIntervalHeight(float intervalHeight);
     void setFirstPitch(const Pitch &firstPitch);
     void setDetectedPitch(const Pitch &detectedPitch);
-    void drawPitchNames(float height) const;
-    void drawSharpPitches() const;
     int getFontSize() const;
 };
 
@@ -0,0 +1,169 @@
+#include "WaveformTiles.h"
+#include "Executors.h"
+#include "AudioUtils.h"
+#include "MathUtils.h"
+#include <limits>
+#include <algorithm>
+#include <cstring>
+#include <cassert>
+
+using namespace CppUtils;
+
+WaveformTiles::WaveformTiles(Drawer* drawer, const std::function<void()>& onTilesReady) :
+        drawer(drawer), onTilesReady(onTilesReady) {
+}
+
+WaveformTiles::~WaveformTiles() {
+    cancelGeneration();
+}
+
+void WaveformTiles::cancelGeneration() {
+    if (!generation) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> _(generation->mutex);
+    generation->cancelled = true;
+    generation->onCompleted = nullptr;
+    generation.reset();
+}
+
+void WaveformTiles::deleteImages() {
+    for (Drawer::Image* image : images) {
+        drawer->deleteImage(image);
+    }
+    images.clear();
+    imagesWidth = 0;
+}
+
+void WaveformTiles::update(const std::vector<short>& samples, int width, int height, const Style& style) {
+    cancelGeneration();
+    if (samples.empty() || width <= 0 || height <= 0) {
+        deleteImages();
+        return;
+    }
+
+    auto newGeneration = std::make_shared<Generation>();
+    newGeneration->onCompleted = onTilesReady;
+    generation = newGeneration;
+    Executors::ExecuteOnBackgroundThread([=] {
+        std::vector<short> resizedSamples = AudioUtils::ResizePreviewSamples(samples.data(),
+                int(samples.size()), width);
+        std::vector<Bitmap> tiles;
+        tiles.reserve((width + TILE_WIDTH - 1) / TILE_WIDTH);
+        for (int begin = 0; begin < width; begin += TILE_WIDTH) {
+            if (newGeneration->cancelled) {
+                return;
+            }
+
+            tiles.push_back(rasterizeTile(resizedSamples, begin, std::min(begin + TILE_WIDTH, width), height, style));
+        }
+
+        std::lock_guard<std::mutex> _(newGeneration->mutex);
+        if (newGeneration->cancelled) {
+            return;
+        }
+
+        newGeneration->tiles = std::move(tiles);
+        newGeneration->completed = true;
+        if (newGeneration->onCompleted) {
+            newGeneration->onCompleted();
+        }
+    });
+}
+
+bool WaveformTiles::uploadReadyTiles() {
+    if (!generation) {
+        return false;
+    }
+
+    std::vector<Bitmap> tiles;
+    {
+        std::lock_guard<std::mutex> _(generation->mutex);
+        if (!generation->completed) {
+            return false;
+        }
+
+        tiles = std::move(generation->tiles);
+    }
+    generation.reset();
+
+    deleteImages();
+    for (const Bitmap& tile : tiles) {
+        images.push_back(drawer->createImage(tile));
+        imagesWidth += tile.getWidth();
+    }
+    return true;
+}
+
+bool WaveformTiles::hasImages() const {
+    return !images.empty();
+}
+
+void WaveformTiles::draw(float x, float y, float width, float height) const {
+    assert(hasImages());
+    float scaleX = width / imagesWidth;
+    for (Drawer::Image* image : images) {
+        float tileWidth = image->width() * scaleX;
+        drawer->drawImage(x, y, tileWidth, height, image);
+        x += tileWidth;
+    }
+}
+
+Bitmap WaveformTiles::rasterizeTile(const std::vector<short>& resizedSamples, int begin, int end, int height,
+        const Style& style) {
+    assert(begin >= 0 && begin < end && end <= resizedSamples.size());
+    assert(style.opaquePart >= 0 && style.opaquePart < 1);
+    int width = end - begin;
+    int middle = height / 2;
+
+    // Column half heights and their inverses, so a row is calculated without divisions
+    std::vector<float> halfHeights(width);
+    std::vector<float> inverseHalfHeights(width);
+    for (int x = 0; x < width; ++x) {
+        int value = Math::SelectValueFromRangeProjectedInRange<int>(resizedSamples[begin + x],
+                0, std::numeric_limits<short>::max(),
+                style.minimumHeight / 2, middle);
+        halfHeights[x] = static_cast<float>(value);
+        inverseHalfHeights[x] = value > 0 ? 1.0f / value : 0.0f;
+    }
+
+    const float red = style.color[0];
+    const float green = style.color[1];
+    const float blue = style.color[2];
+    const float alpha = style.color[3];
+    const float opaquePart = style.opaquePart;
+    const float fadeFactor = 1.0f / (1.0f - opaquePart);
+
+    // Rows at the same distance from the middle are equal, so every row is calculated once and copied.
+    // The loop over the columns has no branches and is vectorized by the compiler.
+    Bitmap bitmap(width, height);
+    unsigned char* data = bitmap.getData();
+    size_t rowSize = size_t(width) * 4;
+    std::vector<unsigned char> row(rowSize);
+    unsigned char* rowData = row.data();
+    for (int distance = 0; distance <= middle; ++distance) {
+        float d = static_cast<float>(distance);
+        for (int x = 0; x < width; ++x) {
+            float k = d * inverseHalfHeights[x];
+            float opacity = std::min(1.0f, 1.0f - (k - opaquePart) * fadeFactor);
+            float inside = d < halfHeights[x] ? 1.0f : 0.0f;
+            unsigned char* pixel = rowData + x * 4;
+            pixel[0] = static_cast<unsigned char>(red * inside);
+            pixel[1] = static_cast<unsigned char>(green * inside);
+            pixel[2] = static_cast<unsigned char>(blue * inside);
+            pixel[3] = static_cast<unsigned char>(std::max(0.0f, alpha * opacity * inside));
+        }
+
+        int bottom = middle + distance;
+        if (bottom < height) {
+            memcpy(data + bottom * rowSize, rowData, rowSize);
+        }
+        int top = middle - distance;
+        if (distance > 0 && top >= 0) {
+            memcpy(data + top * rowSize, rowData, rowSize);
+        }
+    }
+
+    return bitmap;
+}
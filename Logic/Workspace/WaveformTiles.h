@@ -0,0 +1,69 @@
+#ifndef VOCALTRAINER_WAVEFORMTILES_H
+#define VOCALTRAINER_WAVEFORMTILES_H
+
+#include "Drawer.h"
+#include "Bitmap.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <atomic>
+
+// Waveform preview of a track, rasterized into fixed width tiles on a background thread.
+// Images of the previous generation are drawn stretched to the new width, until all the new tiles are ready,
+// so resize doesn't stall the rendering thread. The images are owned by the drawer and released together with it.
+class WaveformTiles {
+public:
+    static constexpr int TILE_WIDTH = 256;
+
+    struct Style {
+        CppUtils::Color color;
+        // In pixels
+        int minimumHeight = 0;
+        // Part of a column from the middle, which has the color opacity, the rest fades out to the column edges
+        float opaquePart = 0.75f;
+    };
+
+private:
+    // Shared with the background thread, which may outlive WaveformTiles
+    struct Generation {
+        std::mutex mutex;
+        std::vector<CppUtils::Bitmap> tiles;
+        bool completed = false;
+        std::atomic<bool> cancelled {false};
+        std::function<void()> onCompleted;
+    };
+
+    Drawer* drawer;
+    std::function<void()> onTilesReady;
+    std::shared_ptr<Generation> generation;
+    std::vector<Drawer::Image*> images;
+    // Summarized width of the images in pixels
+    int imagesWidth = 0;
+
+    void deleteImages();
+    void cancelGeneration();
+public:
+    // onTilesReady is called on the background thread, when all the tiles of the last update are rasterized
+    WaveformTiles(Drawer* drawer, const std::function<void()>& onTilesReady);
+    WaveformTiles(const WaveformTiles&) = delete;
+    WaveformTiles& operator=(const WaveformTiles&) = delete;
+    ~WaveformTiles();
+
+    // Starts rasterization of the samples resized to width x height pixels. Empty samples remove the tiles.
+    void update(const std::vector<short>& samples, int width, int height, const Style& style);
+    // Replaces the images with the rasterized tiles, should be called on the rendering thread outside of
+    // beginFrame/endFrame. Returns true if the images are changed.
+    bool uploadReadyTiles();
+    bool hasImages() const;
+    // width and height are in points, the tiles are stretched if they are rasterized for another size
+    void draw(float x, float y, float width, float height) const;
+
+    // Rasterizes columns [begin, end) of the waveform. Every column is a vertical line, symmetric relative to
+    // the middle, which height is proportional to the sample value.
+    static CppUtils::Bitmap rasterizeTile(const std::vector<short>& resizedSamples, int begin, int end, int height,
+            const Style& style);
+};
+
+
+#endif //VOCALTRAINER_WAVEFORMTILES_H
@@ -26,6 +26,9 @@ public:
     virtual void setRunning(bool value) = 0;
     virtual double getBeatsPerSecond() const = 0;
     virtual void updateSeek(float seek) = 0;
+    // Position of the playback transport, can be called from any thread. While running the workspace scroll
+    // is derived from the last synced position and the time passed since it.
+    virtual void syncPlaybackSeek(double seek) = 0;
     virtual float getHorizontalOffset() const = 0;
     virtual float getVisibleGridWidth() const = 0;
     virtual float getVisibleGridHeight() const = 0;
@@ -18,6 +18,7 @@
 #include "AudioUtils.h"
 #include "MathUtils.h"
 #include "StringUtils.h"
+#include "Algorithms.h"
 
 #ifndef NDEBUG
 #define CHECK_IF_RENDER_THREAD assert(checkExecutedOnRenderingThread() && "WorkspaceDrawer draw, resize and constructor should be executed  in the same thread")
@@ -69,6 +70,26 @@ constexpr float DEFAULT_MAX_ZOOM = 4.0;
 constexpr int YARD_STICK_FONT_WEIGHT = 1;
 static const char* FONT_FAMILY = "Lato";
 
+// Copies the pitches, which the pitches graph may draw until the state is modified again: the graph of
+// the recording or the playback with a beat margin on both sides for the seek extrapolated by the frames.
+static void copyGraphPitches(WorkspaceFrameState& state) {
+    if (!state.pitchesCollection || state.beatsPerSecond <= 0) {
+        state.pitchesTimes.clear();
+        state.pitchValues.clear();
+        return;
+    }
+
+    double beatDuration = 1.0 / state.beatsPerSecond;
+    double graphDuration = beatDuration * PITCHES_GRAPH_WIDTH_IN_INTERVALS;
+    double durationBeforeSeek = std::max(graphDuration + beatDuration, beatDuration * (state.beatsInBar + 1));
+    double durationAfterSeek = state.recording ? state.visibleBeatsCount * beatDuration : 0;
+    state.pitchesCollection->getPitchValuesInTimeRange(
+            state.seek - durationBeforeSeek - beatDuration,
+            state.seek + durationAfterSeek + beatDuration,
+            &state.pitchesTimes,
+            &state.pitchValues);
+}
+
 #ifndef NDEBUG
 bool WorkspaceDrawer::checkExecutedOnRenderingThread() {
     if (threadId == std::thread::id()) {
@@ -90,86 +111,90 @@ void WorkspaceDrawer::resize(float width, float height, float devicePixelRatio)
         this->devicePixelRatio = devicePixelRatio;
         initImages();
     }
+    invalidateLayers();
 
     generateInstrumentalTrackSamplesImage(width - PIANO_WIDTH);
     updateZoom();
+    frameScheduler.invalidate(FrameScheduler::LAYOUT);
 }
 
 void WorkspaceDrawer::generateInstrumentalTrackSamplesImage(float width) {
-    drawer->deleteImage(instrumentalTrackImage);
-
-    if (instrumentalTrackSamples.empty()) {
-        return;
-    }
-
-    int bitmapWidth = int(round(width * devicePixelRatio));
-    int bitmapHeight = int(round(INSTRUMENTAL_TRACK_HEIGHT * devicePixelRatio));
-    Bitmap bitmap(bitmapWidth, bitmapHeight);
-    bitmap.fill(Color::transparent());
-
-    std::vector<short> resizedSamples = AudioUtils::ResizePreviewSamples(instrumentalTrackSamples.data(),
-            int(instrumentalTrackSamples.size()), bitmapWidth);
-
+    WaveformTiles::Style style;
+    style.color = colors.instrumentalTrackColor;
+    style.minimumHeight = MINIMUM_INSTRUMENTAL_TRACK_HEIGHT;
     // Minimum part of track line, where opacity should be applied.
-    double minimumK = 0.75;
-    for (int x = 0; x < bitmapWidth; ++x) {
-        int middle = bitmapHeight / 2;
-        int value = Math::SelectValueFromRangeProjectedInRange<int>(resizedSamples[x],
-                                                                    0, std::numeric_limits<short>::max(),
-                                                                    MINIMUM_INSTRUMENTAL_TRACK_HEIGHT / 2, middle);
-
-        for (int y = middle - value; y < middle + value; ++y) {
-            int offset = abs(y - middle);
-            double k = double(offset) / value;
-            Color color = colors.instrumentalTrackColor;
-            if (k >= minimumK) {
-                double factor = (k - minimumK) / (1.0 - minimumK);
-                double opacity = 1.0 - factor;
-                color = color.applyOpacity(opacity);
-            }
-
-            bitmap.setPixel(x, y, color);
-        }
-    }
-
-    instrumentalTrackImage = drawer->createImage(bitmap.getData(), bitmapWidth, bitmapHeight);
+    style.opaquePart = 0.75f;
+    static const std::vector<short> noSamples;
+    instrumentalTrackWaveform.update(instrumentalTrackSamples ? *instrumentalTrackSamples : noSamples,
+            int(round(width * devicePixelRatio)),
+            int(round(INSTRUMENTAL_TRACK_HEIGHT * devicePixelRatio)),
+            style);
 }
 
 void WorkspaceDrawer::draw() {
     CHECK_IF_RENDER_THREAD;
     assert(width >= 0 && height >= 0 && "call resize before draw");
 
+    FrameProfiler* profiler = drawer->getFrameProfiler();
+    if (profiler) {
+        profiler->beginFrame();
+    }
+
+    {
+        PROFILE_FRAME_SECTION(profiler, "state");
+        for (const auto& task : frameStates.takeTasks()) {
+            task();
+        }
+        // Bounds selection follows the mouse using the layout of the previous frame and publishes the bounds,
+        // so they are acquired by this frame
+        if (boundsSelectionController) {
+            boundsSelectionController->update();
+        }
+        applyFrameState(frameStates.acquire());
+    }
+
     assert(intervalWidth >= 0);
     assert(intervalHeight >= 0);
 
-    float frameDuration = drawer->getTimeBetweenFrames();
-    // old logic
-    if (running) {
-        horizontalOffset += beatsPerSecond * intervalWidth * frameDuration;
-        updateHorizontalScrollBarPagePosition();
+    double frameTime = TimeUtils::NowInSecondsSinceStart();
+    frameScheduler.beginFrame(frameTime);
+    if (running && frameScheduler.hasPlaybackSeek()) {
+        setHorizontalOffsetFromSeek(frameScheduler.getPlaybackSeek(frameTime));
+    }
+
+    {
+        PROFILE_FRAME_SECTION(profiler, "layers");
+        // Layers are rendered as separate frames, so it should be done before the workspace frame is started
+        updateLayers(frameTime);
+        instrumentalTrackWaveform.uploadReadyTiles();
     }
 
     drawer->clear();
     drawer->beginFrame(width, height, devicePixelRatio);
 
-    if (boundsSelectionController) {
-        boundsSelectionController->update();
-    }
-
     if (horizontalScrollBar.getPageSize() <= 0) {
         updateHorizontalScrollBarPageSize();
     }
 
     drawer->translate(PIANO_WIDTH, 0);
     drawer->translate(0, YARD_STICK_HEIGHT + 1);
-    drawer->translate(0, getGridYTranslation());
-    drawVerticalGrid();
-    drawHorizontalGrid();
-    drawer->translate(0, -getGridYTranslation());
-    drawPitches();
-    drawPitchesGraph();
+    {
+        PROFILE_FRAME_SECTION(profiler, "grid");
+        drawGridLayer();
+    }
+    {
+        PROFILE_FRAME_SECTION(profiler, "notes");
+        drawPitches();
+    }
+    {
+        PROFILE_FRAME_SECTION(profiler, "pitchGraph");
+        drawPitchesGraph();
+    }
     drawer->translate(0, -YARD_STICK_HEIGHT - 1);
-    drawYardStick();
+    {
+        PROFILE_FRAME_SECTION(profiler, "yardStick");
+        drawYardStick();
+    }
     drawer->translate(0, YARD_STICK_HEIGHT);
     drawer->translate(-PIANO_WIDTH, 0);
 
@@ -179,35 +204,97 @@ void WorkspaceDrawer::draw() {
 
     drawEnding();
     if (willDrawTracks) {
+        PROFILE_FRAME_SECTION(profiler, "tracks");
         drawTracks();
     }
-    drawFirstPlayHead();
-    drawSecondPlayHead();
-    drawScrollBars();
+    {
+        PROFILE_FRAME_SECTION(profiler, "playHeads");
+        drawFirstPlayHead();
+        drawSecondPlayHead();
+    }
+    {
+        PROFILE_FRAME_SECTION(profiler, "scrollBars");
+        drawScrollBars();
+    }
 
     drawer->translateTo(0, 0);
-    drawer->setFillColor(Color::white());
-    drawer->fillRect(0, 0, PIANO_WIDTH, height);
-    float pianoHeight = height -
-            (willDrawScrollbars ? ScrollBar::SCROLLBAR_WEIGHT : 0) +
-            getMaximumGridYTranslation() -
-            getGridYTranslation();
-    pianoDrawer->draw(PIANO_WIDTH, pianoHeight, devicePixelRatio);
-    drawer->setFillColor(Color::white());
-    drawer->fillRect(0, 0, PIANO_WIDTH, YARD_STICK_HEIGHT);
-    drawer->setStrokeColor(colors.borderLineColor);
-    // Draw border line above piano
-    drawer->drawLine(0, YARD_STICK_HEIGHT + 0.5f, PIANO_WIDTH, YARD_STICK_HEIGHT + 0.5f);
+    {
+        PROFILE_FRAME_SECTION(profiler, "piano");
+        drawer->setFillColor(Color::white());
+        drawer->fillRect(0, 0, PIANO_WIDTH, height);
+        drawPiano();
+        drawer->setFillColor(Color::white());
+        drawer->fillRect(0, 0, PIANO_WIDTH, YARD_STICK_HEIGHT);
+        drawer->setStrokeColor(colors.borderLineColor);
+        // Draw border line above piano
+        drawer->drawLine(0, YARD_STICK_HEIGHT + 0.5f, PIANO_WIDTH, YARD_STICK_HEIGHT + 0.5f);
+    }
 
     drawer->translate(0, PIANO_WORKSPACE_VERTICAL_LINE_TOP_MARGIN);
     drawVerticalLine(PIANO_WIDTH + 0.5f, colors.borderLineColor);
     drawer->translate(0, -PIANO_WORKSPACE_VERTICAL_LINE_TOP_MARGIN);
 
     drawer->translate(0, 0);
-    //drawFps(fps);
+    if (drawFrameProfilerOverlay) {
+        drawFrameProfiler();
+    }
     drawAboveQueue.process();
 
-    drawer->endFrame();
+    {
+        PROFILE_FRAME_SECTION(profiler, "endFrame");
+        drawer->endFrame();
+    }
+    frameScheduler.endFrame(TimeUtils::NowInSecondsSinceStart());
+    if (profiler) {
+        profiler->endFrame();
+    }
+}
+
+bool WorkspaceDrawer::drawIfNeeded() {
+    CHECK_IF_RENDER_THREAD;
+    if (!frameScheduler.shouldRenderFrame()) {
+        return false;
+    }
+
+    draw();
+    return true;
+}
+
+bool WorkspaceDrawer::needsFrame() const {
+    return frameScheduler.isRunning() || frameScheduler.hasChanges();
+}
+
+void WorkspaceDrawer::invalidate(int changes) {
+    frameScheduler.invalidate(changes);
+}
+
+const FrameScheduler::Statistics& WorkspaceDrawer::getFrameStatistics() const {
+    return frameScheduler.getStatistics();
+}
+
+void WorkspaceDrawer::resetFrameStatistics() {
+    frameScheduler.resetStatistics();
+}
+
+void WorkspaceDrawer::setFrameProfilingEnabled(bool enabled) {
+    CHECK_IF_RENDER_THREAD;
+    drawer->setFrameProfiler(enabled ? &frameProfiler : nullptr);
+    frameScheduler.invalidate(FrameScheduler::CONTENT);
+}
+
+bool WorkspaceDrawer::isFrameProfilingEnabled() const {
+    return drawer->getFrameProfiler() == &frameProfiler;
+}
+
+const FrameProfiler& WorkspaceDrawer::getFrameProfiler() const {
+    return frameProfiler;
+}
+
+void WorkspaceDrawer::setDrawFrameProfilerOverlay(bool drawFrameProfilerOverlay) {
+    CHECK_IF_RENDER_THREAD;
+    assert(!drawFrameProfilerOverlay || isFrameProfilingEnabled());
+    this->drawFrameProfilerOverlay = drawFrameProfilerOverlay;
+    frameScheduler.invalidate(FrameScheduler::CONTENT);
 }
 
 void WorkspaceDrawer::captureClickEventsInTracksArea(float pianoTrackHeight) {
@@ -239,14 +326,17 @@ void WorkspaceDrawer::drawScrollBars() {
         float position = horizontalScrollBar.getPosition();
         horizontalOffset = position * getSummarizedPlayableGridWidth();
         assert(position <= 1);
-        float seek = static_cast<float>(position * totalDurationInSeconds);
-        if (delegate) {
-            delegate->onSeekChangedByUserEvent(seek);
-        }
+        notifySeekChangedByUser(static_cast<float>(position * totalDurationInSeconds));
     }
 
     verticalScrollBar.draw(getVisibleGridWidth() - ScrollBar::SCROLLBAR_WEIGHT,
             YARD_STICK_HEIGHT + 1, getVisibleGridHeight());
+    if (verticalScrollBar.isPositionWasChangedFromUser()) {
+        float position = verticalScrollBar.getPosition();
+        publish(0, [=] (WorkspaceFrameState& state) {
+            state.verticalScrollPosition = position;
+        });
+    }
 }
 
 float WorkspaceDrawer::getGridYTranslation() const {
@@ -270,10 +360,17 @@ void WorkspaceDrawer::iterateHorizontalIntervals(const std::function<void(float
     }
 }
 
-void WorkspaceDrawer::drawVerticalGrid() const {
-    iterateHorizontalIntervals([=] (float x, bool isBeat) {
-        drawVerticalLine(x, isBeat ? colors.gridColor : colors.accentGridColor);
-    });
+void WorkspaceDrawer::drawVerticalGrid(float layerWidth, float layerHeight) const {
+    int index = 1;
+    for (float x = intervalWidth; x < layerWidth; x += intervalWidth, index++) {
+        bool isBeat = index % beatsInBar != 0;
+        drawer->beginPath();
+        drawer->moveTo(x * sizeMultiplier, 0);
+        drawer->lineTo(x * sizeMultiplier, layerHeight);
+        drawer->setStrokeWidth(sizeMultiplier);
+        drawer->setStrokeColor(isBeat ? colors.gridColor : colors.accentGridColor);
+        drawer->stroke();
+    }
 }
 
 void WorkspaceDrawer::drawHorizontalLine(float y, const Color& color) const {
@@ -297,22 +394,73 @@ void WorkspaceDrawer::drawVerticalLine(float x, const WorkspaceDrawer::Color &co
     drawer->stroke();
 }
 
-void WorkspaceDrawer::drawHorizontalGrid() const {
+// Lines go up from the bottom of the layer, which is aligned with the bottom of the grid
+void WorkspaceDrawer::drawHorizontalGrid(float layerWidth, float layerHeight) const {
     int index = 1;
-    float gridTranslation = getGridYTranslation();
-    float baseHeight = getMaximumGridYTranslation() - gridTranslation + getVisibleGridHeight();
-    for (float y = baseHeight - intervalHeight - gridTranslation;
-         y > - gridTranslation; y -= intervalHeight, index++) {
-
+    for (float y = layerHeight - intervalHeight; y > 0; y -= intervalHeight, index++) {
         bool isOctaveBegin = index % Pitch::PITCHES_IN_OCTAVE == 0;
-        drawHorizontalLine(y, isOctaveBegin ? colors.accentGridColor : colors.gridColor);
+        drawer->beginPath();
+        drawer->moveTo(0, y * sizeMultiplier);
+        drawer->lineTo(layerWidth * sizeMultiplier, y * sizeMultiplier);
+        drawer->setStrokeWidth(sizeMultiplier);
+        drawer->setStrokeColor(isOctaveBegin ? colors.accentGridColor : colors.gridColor);
+        drawer->stroke();
+    }
+}
+
+float WorkspaceDrawer::getGridLayerVerticalPeriod() const {
+    return intervalHeight * Pitch::PITCHES_IN_OCTAVE;
+}
+
+float WorkspaceDrawer::getGridLayerHeight() const {
+    // From the grid top to the bottom of the workspace with a spare period
+    return height - getGridBeginYPosition() + getGridLayerVerticalPeriod() + intervalHeight;
+}
+
+// The grid is periodic: one bar horizontally and one octave vertically. The layer contains a spare period
+// in both directions and is shifted by the current phase. The parts shifted beyond the grid top and
+// the piano are covered by the yard stick and the piano.
+// While the zoom is changing the layer is scaled, when zooming out it's repeated by whole periods to cover the grid.
+void WorkspaceDrawer::drawGridLayer() {
+    float scale = getLayersScale();
+    float layerWidth = gridLayer.getWidth() * scale;
+    float layerHeight = gridLayer.getHeight() * scale;
+    float horizontalPeriod = getZeroSeekGridOffset();
+    float x = -fmod(horizontalOffset, horizontalPeriod);
+    float period = getGridLayerVerticalPeriod();
+    float gridBottom = getMaximumGridYTranslation() + getVisibleGridHeight() - getGridYTranslation();
+    float y = gridBottom - layerHeight;
+    if (y > 0) {
+        y = fmod(y, period) - period;
+    }
+
+    if (Primitives::CompareFloats(scale, 1)) {
+        gridLayer.draw(x, y, devicePixelRatio);
+        return;
+    }
+
+    float horizontalStep = std::max(1.0f, std::floor(layerWidth / horizontalPeriod)) * horizontalPeriod;
+    float verticalStep = std::max(1.0f, std::floor(layerHeight / period)) * period;
+    float bottom = std::min(gridBottom, height - getGridBeginYPosition());
+    while (y > 0) {
+        y -= verticalStep;
+    }
+    for (float tileY = y; ; tileY += verticalStep) {
+        for (float tileX = x; ; tileX += horizontalStep) {
+            gridLayer.draw(tileX, tileY, layerWidth, layerHeight, devicePixelRatio);
+            if (tileX + layerWidth >= width) {
+                break;
+            }
+        }
+        if (tileY + layerHeight >= bottom) {
+            break;
+        }
     }
 }
 
-void WorkspaceDrawer::drawPitch(float x, float y, float width) {
+void WorkspaceDrawer::addPitchShape(float x, float y, float width) {
     float radius = pitchRadius * zoom;
-    drawer->roundedRect(x, y, width, intervalHeight, radius);
-    drawer->fill();
+    pitchesShapes.push_back({x, y, width, intervalHeight, radius, radius, radius, radius});
 }
 
 void WorkspaceDrawer::drawPitches() {
@@ -326,8 +474,7 @@ void WorkspaceDrawer::drawPitches() {
         return;
     }
 
-    drawer->setFillColor(colors.pitchColor);
-
+    pitchesShapes.clear();
     double workspaceDuration = getWorkspaceDuration();
     double workspaceSeek = getWorkspaceSeek();
     double timeBegin = workspaceSeek - getSingingPitchGraphDuration();
@@ -342,14 +489,15 @@ void WorkspaceDrawer::drawPitches() {
         double pitchWidth = pitchDuration / workspaceDuration * width;
         int distanceFromFirstPitch = getDistanceFromFirstPitch(vxPitch.pitch);
         float y = relativeHeight - (distanceFromFirstPitch + 1) * intervalHeight;
-        drawPitch((float)x, y, (float)pitchWidth);
+        addPitchShape((float)x, y, (float)pitchWidth);
     });
+    drawer->fillRoundedRects(pitchesShapes.data(), int(pitchesShapes.size()), colors.pitchColor);
 }
 
 void WorkspaceDrawer::drawInstrumentalTrack() {
-    if (instrumentalTrackImage) {
-        drawer->drawImage(0, height - INSTRUMENTAL_TRACK_BOTTOM_MARGIN - INSTRUMENTAL_TRACK_HEIGHT,
-                          instrumentalTrackImage);
+    if (instrumentalTrackWaveform.hasImages()) {
+        instrumentalTrackWaveform.draw(0, height - INSTRUMENTAL_TRACK_BOTTOM_MARGIN - INSTRUMENTAL_TRACK_HEIGHT,
+                width - PIANO_WIDTH, INSTRUMENTAL_TRACK_HEIGHT);
     } else {
         drawer->setStrokeColor(colors.instrumentalTrackColor);
         drawer->drawHorizontalLine(0, height - INSTRUMENTAL_TRACK_BOTTOM_MARGIN - INSTRUMENTAL_TRACK_HEIGHT / 2,
@@ -372,25 +520,38 @@ void WorkspaceDrawer::drawInstrumentalTrackButton() {
             instrumentalTrackButtonImage);
 }
 
-float WorkspaceDrawer::drawPianoTrackAndCalculateHeight() {
-    const VocalPart* vocalPart = this->vocalPart;
-    const Pitch &lowest = vocalPart->getLowestPitch();
-    const Pitch &highest = vocalPart->getHighestPitch();
-
-    int lowestIndex = lowest.getPerfectFrequencyIndex();
-    int highestIndex = highest.getPerfectFrequencyIndex();
+float WorkspaceDrawer::getPianoTrackHeight(float* verticalPadding) const {
+    int lowestIndex = vocalPart->getLowestPitch().getPerfectFrequencyIndex();
+    int highestIndex = vocalPart->getHighestPitch().getPerfectFrequencyIndex();
     float pianoTrackHeight = (highestIndex - lowestIndex + 1) * PIANO_TRACK_PITCH_HEIGHT +
             PIANO_TRACK_VERTICAL_PADDING * 2;
-    float verticalPadding = PIANO_TRACK_VERTICAL_PADDING;
+    *verticalPadding = PIANO_TRACK_VERTICAL_PADDING;
     if (pianoTrackHeight < MIN_PIANO_TRACK_HEIGHT) {
-        verticalPadding = (MIN_PIANO_TRACK_HEIGHT - pianoTrackHeight) / 2;
+        *verticalPadding = (MIN_PIANO_TRACK_HEIGHT - pianoTrackHeight) / 2;
         pianoTrackHeight = MIN_PIANO_TRACK_HEIGHT;
     }
 
-    // Draw rectangle and shadow
+    return pianoTrackHeight;
+}
+
+float WorkspaceDrawer::drawPianoTrackAndCalculateHeight() {
+    float verticalPadding;
+    float pianoTrackHeight = getPianoTrackHeight(&verticalPadding);
     float y = height - PIANO_TRACK_BOTTOM - pianoTrackHeight;
+    pianoTrackLayer.draw(0, y - PIANO_TRACK_SHADOW_RADIUS, devicePixelRatio);
+    drawPianoTrackButton(pianoTrackHeight);
+    return pianoTrackHeight;
+}
+
+// The layer has a margin for the shadow above and below the track
+void WorkspaceDrawer::drawPianoTrackLayer(float pianoTrackHeight, float verticalPadding) {
+    const VocalPart* vocalPart = this->vocalPart;
+    int lowestIndex = vocalPart->getLowestPitch().getPerfectFrequencyIndex();
+
+    // Draw rectangle and shadow
+    float y = PIANO_TRACK_SHADOW_RADIUS;
     float x = 1;
-    float width = this->width - drawer->getTranslateX();
+    float width = this->width - PIANO_WIDTH;
     float height = pianoTrackHeight;
     // make a width of shadow a bit bigger than rect width
     drawer->drawShadow(x - 200, y, width + 400, height, PIANO_TRACK_SHADOW_RADIUS,
@@ -402,21 +563,18 @@ float WorkspaceDrawer::drawPianoTrackAndCalculateHeight() {
     int durationInTicks = vocalPart->getDurationInTicks();
     float tickSize = width / durationInTicks;
 
-    drawer->setFillColor(colors.pianoTrackPitchesColor);
-
     const auto& pitches = vocalPart->getNotes();
+    pitchesShapes.clear();
     for (const NoteInterval& vxPitch : pitches) {
         float pitchX = vxPitch.startTickNumber * tickSize;
         float pitchWidth = vxPitch.ticksCount * tickSize;
 
         int pitchIndexInSongRange = vxPitch.pitch.getPerfectFrequencyIndex() - lowestIndex;
         float pitchY = pianoTrackHeight - verticalPadding - (pitchIndexInSongRange + 1) * PIANO_TRACK_PITCH_HEIGHT + y;
-        drawer->roundedRect(pitchX, pitchY, pitchWidth, PIANO_TRACK_PITCH_HEIGHT, PIANO_TRACK_PITCH_RADIUS);
-        drawer->fill();
+        pitchesShapes.push_back({pitchX, pitchY, pitchWidth, PIANO_TRACK_PITCH_HEIGHT,
+                PIANO_TRACK_PITCH_RADIUS, PIANO_TRACK_PITCH_RADIUS, PIANO_TRACK_PITCH_RADIUS, PIANO_TRACK_PITCH_RADIUS});
     }
-
-    drawPianoTrackButton(pianoTrackHeight);
-    return pianoTrackHeight;
+    drawer->fillRoundedRects(pitchesShapes.data(), int(pitchesShapes.size()), colors.pianoTrackPitchesColor);
 }
 
 void WorkspaceDrawer::drawPianoTrackButton(float pianoTrackHeight) {
@@ -459,14 +617,16 @@ float WorkspaceDrawer::getSummarizedPlayableGridWidth() const {
 }
 
 void WorkspaceDrawer::setVocalPart(const VocalPart *vocalPart, double beatsPerSecond, int beatsInBar) {
-    this->vocalPart = vocalPart;
-    this->beatsPerSecond = beatsPerSecond;
-    this->totalDurationInSeconds = vocalPart->getDurationInSeconds();
-    this->beatsInBar = beatsInBar;
-    updateHorizontalScrollBarPageSize();
+    assert(vocalPart);
+    publish(FrameScheduler::CONTENT, [=] (WorkspaceFrameState& state) {
+        state.vocalPart = vocalPart;
+        state.beatsPerSecond = beatsPerSecond;
+        state.beatsInBar = beatsInBar;
+        copyGraphPitches(state);
+    });
 }
 
-void WorkspaceDrawer::initGraphPitchesArrays(float workspaceSeek) {
+void WorkspaceDrawer::getGraphPitchesRange(float workspaceSeek, int* begin, int* end) const {
     double pitchesGraphDrawBeginTime;
     double pitchesGraphDrawEndTime;
     if (recording) {
@@ -481,25 +641,22 @@ void WorkspaceDrawer::initGraphPitchesArrays(float workspaceSeek) {
         pitchesGraphDrawEndTime = workspaceSeek + 0.001;
     }
 
-    pitchesCollection->getPitchesInTimeRange(pitchesGraphDrawBeginTime,
-                                             pitchesGraphDrawEndTime,
-                                             &pitchesTimes, &pitchesFrequencies);
+    const std::vector<double>& pitchesTimes = frameStates.getFront().pitchesTimes;
+    auto range = FindRangeInSortedCollection(pitchesTimes, pitchesGraphDrawBeginTime, pitchesGraphDrawEndTime);
+    *begin = static_cast<int>(range.first - pitchesTimes.begin());
+    *end = static_cast<int>(range.second - pitchesTimes.begin());
 }
 
 void WorkspaceDrawer::drawPitchesGraph() {
     assert(getFirstPitch().isValid());
-    assert(pitchesCollection);
     assert(colors.pitchGraphColor[3] > 0 && "pitchGraphColor not initialized or is completely transparent");
 
+    const WorkspaceFrameState& state = frameStates.getFront();
+    const std::vector<double>& pitchesTimes = state.pitchesTimes;
+    const std::vector<PitchValue>& pitchValues = state.pitchValues;
     float workspaceSeek = getWorkspaceSeek();
-    initGraphPitchesArrays(workspaceSeek);
-    int pitchesCount = static_cast<int>(pitchesTimes.size());
-
-    int i = 0;
-
-    while (i < pitchesCount && !Pitch(pitchesFrequencies[i]).isValid()) {
-        i++;
-    }
+    int pitchesBegin, pitchesEnd;
+    getGraphPitchesRange(workspaceSeek, &pitchesBegin, &pitchesEnd);
 
     drawer->beginPath();
     drawer->setStrokeWidth(sizeMultiplier);
@@ -507,50 +664,86 @@ void WorkspaceDrawer::drawPitchesGraph() {
 
     float pitchGraphWidth = intervalWidth * PITCHES_GRAPH_WIDTH_IN_INTERVALS;
     double duration = getSingingPitchGraphDuration();
-
-    double x;
-    double y;
-
     float relativeHeight = getMaximumGridYTranslation() - getGridYTranslation() + getVisibleGridHeight();
-    auto getXY = [&](double time, const Pitch& pitch) {
-        x = (time - workspaceSeek + duration) / duration * pitchGraphWidth;
-        float distanceFromFirstPitch = getDistanceFromFirstPitch(pitch);
-        y = relativeHeight - (distanceFromFirstPitch + pitch.getDistanceFromLowerBound() / 2.0) * intervalHeight;
-    };
 
-    while (i < pitchesCount) {
-        Pitch pitch(pitchesFrequencies[i]);
-        if (!pitch.isValid()) {
-            i++;
-            continue;
+    // Hundreds of pitches may fall into one device pixel column on long recordings or low zoom,
+    // so only the min and the max of every column are added to the path, in the order they were sung.
+    bool segmentStarted = false;
+    int segmentPointsCount = 0;
+    float lastX = 0, lastY = 0;
+    auto addPoint = [&](float x, float y) {
+        if (segmentStarted) {
+            drawer->lineTo(x, y);
+        } else {
+            drawer->moveTo(x, y);
+            segmentStarted = true;
         }
+        segmentPointsCount++;
+        lastX = x;
+        lastY = y;
+    };
 
-        double time = pitchesTimes[i];
-        getXY(time, pitch);
-        drawer->moveTo((float)x, (float)y);
+    bool hasColumn = false;
+    int column = 0;
+    float columnX = 0, minY = 0, maxY = 0;
+    bool minIsFirst = true;
+    auto flushColumn = [&] {
+        if (!hasColumn) {
+            return;
+        }
 
-        i++;
-        if (i >= pitchesCount) {
-            break;
+        if (minY == maxY) {
+            addPoint(columnX, minY);
+        } else if (minIsFirst) {
+            addPoint(columnX, minY);
+            addPoint(columnX, maxY);
+        } else {
+            addPoint(columnX, maxY);
+            addPoint(columnX, minY);
+        }
+        hasColumn = false;
+    };
+    auto finishSegment = [&] {
+        flushColumn();
+        if (segmentPointsCount == 1) {
+            // Single pitch is drawn as a dot
+            drawer->lineTo(lastX, lastY);
         }
+        segmentStarted = false;
+        segmentPointsCount = 0;
+    };
 
-        pitch = Pitch(pitchesFrequencies[i]);
-        if (!pitch.isValid()) {
-            drawer->lineTo((float)x, (float)y);
+    for (int i = pitchesBegin; i < pitchesEnd; i++) {
+        const PitchValue& pitchValue = pitchValues[i];
+        if (!pitchValue.isValid()) {
+            finishSegment();
             continue;
         }
 
-        for (; i < pitchesCount; i++) {
-            pitch = Pitch(pitchesFrequencies[i]);
-            if (!pitch.isValid()) {
-                break;
+        float x = static_cast<float>((pitchesTimes[i] - workspaceSeek + duration) / duration * pitchGraphWidth);
+        float y = relativeHeight - (pitchValue.getContinuousPerfectFrequencyIndex() - firstPitchIndex)
+                * intervalHeight;
+        int pointColumn = static_cast<int>(std::floor(x * devicePixelRatio));
+        if (hasColumn && pointColumn == column) {
+            if (y < minY) {
+                minY = y;
+                minIsFirst = false;
+            } else if (y > maxY) {
+                maxY = y;
+                minIsFirst = true;
             }
-
-            time = pitchesTimes[i];
-            getXY(time, pitch);
-            drawer->lineTo((float)x, (float)y);
+            continue;
         }
+
+        flushColumn();
+        hasColumn = true;
+        column = pointColumn;
+        columnX = x;
+        minY = maxY = y;
+        minIsFirst = true;
     }
+    finishSegment();
+
     drawer->stroke();
 }
 
@@ -695,6 +888,9 @@ WorkspaceDrawer::WorkspaceDrawer(Drawer *drawer,
         running(false),
         firstPitchIndex(-1),
         drawer(drawer),
+        gridLayer(drawer),
+        pianoLayer(drawer),
+        pianoTrackLayer(drawer),
         vocalPart(nullptr),
         firstPlayHeadPosition(0),
         secondPlayHeadPosition(0),
@@ -706,22 +902,36 @@ WorkspaceDrawer::WorkspaceDrawer(Drawer *drawer,
         horizontalScrollBar(drawer, mouseEventsReceiver, ScrollBar::HORIZONTAL),
         onUpdateRequested(onUpdateRequested),
         mouseClickChecker(mouseEventsReceiver),
-        resourcesProvider(resourcesProvider) {
+        resourcesProvider(resourcesProvider),
+        frameScheduler([this] {
+            this->onUpdateRequested();
+        }),
+        frameStates(FrameScheduler::ALL_CHANGES),
+        instrumentalTrackWaveform(drawer, [this] {
+            frameScheduler.invalidate(FrameScheduler::CONTENT);
+        }) {
     CHECK_IF_RENDER_THREAD;
     setPitchRadius(PITCH_RADIUS);
 
     pianoDrawer = new PianoDrawer(drawer, &colors);
     drawer->setTextFontFamily(FONT_FAMILY);
 
-    pitchesTimes.reserve(5000);
-    pitchesFrequencies.reserve(5000);
-
-    setFirstVisiblePitch(Pitch("C1"));
+    Pitch firstPitch("C1");
+    firstPitchIndex = firstPitch.getPerfectFrequencyIndex();
+    pianoDrawer->setFirstPitch(firstPitch);
     lastPitchIndex = Pitch("B6").getPerfectFrequencyIndex();
 
     minZoom = DEFAULT_MIN_ZOOM;
     maxZoom = DEFAULT_MAX_ZOOM;
     this->zoom = minZoom;
+    frameStates.modify(0, [this] (WorkspaceFrameState& state) {
+        state.firstPitchIndex = firstPitchIndex;
+        state.minZoom = minZoom;
+        state.maxZoom = maxZoom;
+        state.zoom = zoom;
+        state.pitchesTimes.reserve(5000);
+        state.pitchValues.reserve(5000);
+    });
 }
 
 WorkspaceDrawer::~WorkspaceDrawer() {
@@ -740,6 +950,8 @@ void WorkspaceDrawer::setSizeMultiplier(float sizeMultiplier) {
     CHECK_IF_RENDER_THREAD;
     assert(sizeMultiplier > 0);
     this->sizeMultiplier = sizeMultiplier;
+    invalidateLayers();
+    frameScheduler.invalidate(FrameScheduler::LAYOUT);
 }
 
 double WorkspaceDrawer::getBeatsPerSecond() const {
@@ -751,8 +963,10 @@ double WorkspaceDrawer::getTotalDurationInSeconds() const {
 }
 
 void WorkspaceDrawer::setPitchesCollection(const PitchesCollection *pitchesCollection) {
-    CHECK_IF_RENDER_THREAD;
-    this->pitchesCollection = pitchesCollection;
+    publish(FrameScheduler::PITCHES, [=] (WorkspaceFrameState& state) {
+        state.pitchesCollection = pitchesCollection;
+        copyGraphPitches(state);
+    });
 }
 
 float WorkspaceDrawer::getPitchRadius() const {
@@ -763,27 +977,35 @@ void WorkspaceDrawer::setPitchRadius(float pitchRadius) {
     CHECK_IF_RENDER_THREAD;
     assert(pitchRadius >= 0);
     this->pitchRadius = pitchRadius;
+    frameScheduler.invalidate(FrameScheduler::LAYOUT);
 }
 
 void WorkspaceDrawer::setFirstVisiblePitch(const Pitch &firstPitch) {
-    CHECK_IF_RENDER_THREAD;
     assert(firstPitch.isValid());
-    this->firstPitchIndex = firstPitch.getPerfectFrequencyIndex();
-    pianoDrawer->setFirstPitch(firstPitch);
+    int firstPitchIndex = firstPitch.getPerfectFrequencyIndex();
+    publish(FrameScheduler::LAYOUT, [=] (WorkspaceFrameState& state) {
+        state.firstPitchIndex = firstPitchIndex;
+    });
 }
 
 bool WorkspaceDrawer::isRunning() const {
+    bool running;
+    frameStates.read([&] (const WorkspaceFrameState& state) {
+        running = state.running;
+    });
     return running;
 }
 
 void WorkspaceDrawer::setRunning(bool value) {
-    CHECK_IF_RENDER_THREAD;
-    drawer->resetFrameTime();
-    running = value;
+    publish(FrameScheduler::SEEK, [=] (WorkspaceFrameState& state) {
+        state.running = value;
+    });
 }
 
 void WorkspaceDrawer::update() {
-    onUpdateRequested();
+    publish(FrameScheduler::CONTENT, [] (WorkspaceFrameState& state) {
+        copyGraphPitches(state);
+    });
 }
 
 void WorkspaceDrawer::setOnUpdateRequested(const std::function<void()> &onUpdateRequested) {
@@ -792,13 +1014,17 @@ void WorkspaceDrawer::setOnUpdateRequested(const std::function<void()> &onUpdate
 }
 
 void WorkspaceDrawer::setDetectedPitch(const Pitch &detectedPitch) {
-    CHECK_IF_RENDER_THREAD;
-    pianoDrawer->setDetectedPitch(detectedPitch);
+    // Pitches are detected together with the sung pitches recording, so the graph pitches are updated as well
+    publish(FrameScheduler::PITCHES, [&] (WorkspaceFrameState& state) {
+        state.detectedPitch = detectedPitch;
+        copyGraphPitches(state);
+    });
 }
 
 void WorkspaceDrawer::setPitchSequence(PlayingPitchSequence *pitchSequence) {
-    CHECK_IF_RENDER_THREAD;
-    pianoDrawer->setPitchSequence(pitchSequence);
+    publish(FrameScheduler::CONTENT, [=] (WorkspaceFrameState& state) {
+        state.pitchSequence = pitchSequence;
+    });
 }
 
 Pitch WorkspaceDrawer::getFirstPitch() const {
@@ -811,28 +1037,31 @@ float WorkspaceDrawer::getSummarizedGridHeight() const {
 }
 
 float WorkspaceDrawer::getVerticalScrollPosition() const {
-    return verticalScrollBar.getPosition();
+    float position;
+    frameStates.read([&] (const WorkspaceFrameState& state) {
+        position = state.verticalScrollPosition;
+    });
+    return position;
 }
 
 void WorkspaceDrawer::setVerticalScrollPosition(float verticalScrollPosition) {
-    CHECK_IF_RENDER_THREAD;
-    if (verticalScrollBar.getPageSize() <= 0) {
-        return;
-    }
-
-    verticalScrollBar.setPosition(verticalScrollPosition);
+    publish(FrameScheduler::SCROLL, [=] (WorkspaceFrameState& state) {
+        state.verticalScrollPosition = verticalScrollPosition;
+    });
 }
 
 void WorkspaceDrawer::scrollBy(float x, float y) {
-    float maxY = getMaximumGridYTranslation();
-    float newYTranslation = CutIfOutOfClosedRange(y + getGridYTranslation(), 0.0f, maxY);
-    setVerticalScrollPosition(newYTranslation / getMaximumGridYTranslation());
+    // The scroll depends on the layout, so it's made by the rendering thread
+    frameStates.post([=] {
+        float maxY = getMaximumGridYTranslation();
+        float newYTranslation = CutIfOutOfClosedRange(y + getGridYTranslation(), 0.0f, maxY);
+        setVerticalScrollPosition(newYTranslation / getMaximumGridYTranslation());
 
-    horizontalOffset = CutIfOutOfClosedRange(horizontalOffset + x, 0.0f, getSummarizedPlayableGridWidth());
-    updateHorizontalScrollBarPagePosition();
-    if (delegate) {
-        delegate->onSeekChangedByUserEvent(getWorkspaceSeek());
-    }
+        horizontalOffset = CutIfOutOfClosedRange(horizontalOffset + x, 0.0f, getSummarizedPlayableGridWidth());
+        updateHorizontalScrollBarPagePosition();
+        notifySeekChangedByUser(getWorkspaceSeek());
+    });
+    frameScheduler.invalidate(FrameScheduler::SCROLL);
 }
 
 const PlaybackBounds &WorkspaceDrawer::getPlaybackBounds() const {
@@ -840,8 +1069,9 @@ const PlaybackBounds &WorkspaceDrawer::getPlaybackBounds() const {
 }
 
 void WorkspaceDrawer::setPlaybackBounds(const PlaybackBounds &playbackBounds) {
-    CHECK_IF_RENDER_THREAD;
-    this->playbackBounds = playbackBounds;
+    publish(FrameScheduler::BOUNDS, [&] (WorkspaceFrameState& state) {
+        state.playbackBounds = playbackBounds;
+    });
 }
 
 float WorkspaceDrawer::durationToWidth(double duration) const {
@@ -892,36 +1122,41 @@ float WorkspaceDrawer::getPlayHeadXPosition(int playHeadIndex) {
 }
 
 void WorkspaceDrawer::setRecording(bool recording) {
-    CHECK_IF_RENDER_THREAD;
-    this->recording = recording;
+    publish(FrameScheduler::CONTENT, [=] (WorkspaceFrameState& state) {
+        state.recording = recording;
+        copyGraphPitches(state);
+    });
 }
 
 void WorkspaceDrawer::setInstrumentalTrackSamples(const std::vector<short> &instrumentalTrackSamples) {
-    CHECK_IF_RENDER_THREAD;
-    if (willDrawTracks) {
-        return;
-    }
-
-    this->instrumentalTrackSamples = instrumentalTrackSamples;
-    if (width > 0 && height > 0 && devicePixelRatio > 0) {
-        generateInstrumentalTrackSamplesImage(width - PIANO_WIDTH);
-    }
+    // Copied outside of the lock, the rendering thread keeps the previous samples until it acquires the new ones
+    auto samples = std::make_shared<const std::vector<short>>(instrumentalTrackSamples);
+    publish(FrameScheduler::CONTENT, [&] (WorkspaceFrameState& state) {
+        if (!state.drawTracks) {
+            state.instrumentalTrackSamples = samples;
+        }
+    });
 }
 
 void WorkspaceDrawer::setDrawTracks(bool value) {
-    CHECK_IF_RENDER_THREAD;
-    willDrawTracks = value;
+    publish(FrameScheduler::LAYOUT, [=] (WorkspaceFrameState& state) {
+        state.drawTracks = value;
+    });
 }
 
 float WorkspaceDrawer::getZoom() const {
+    float zoom;
+    frameStates.read([&] (const WorkspaceFrameState& state) {
+        zoom = state.zoom;
+    });
     return zoom;
 }
 
 void WorkspaceDrawer::setZoom(float zoom) {
-    CHECK_IF_RENDER_THREAD;
-    assert(zoom >= minZoom && zoom <= maxZoom);
-    this->zoom = zoom;
-    updateZoom();
+    publish(FrameScheduler::ZOOM, [=] (WorkspaceFrameState& state) {
+        assert(zoom >= state.minZoom && zoom <= state.maxZoom);
+        state.zoom = zoom;
+    });
 }
 
 void WorkspaceDrawer::updateZoom() {
@@ -929,11 +1164,17 @@ void WorkspaceDrawer::updateZoom() {
     // Calculate intervalWidth and intervalHeight
     int linesCount = (int)round(ZOOM_FACTOR / zoom);
     int baseIntervalsCount = linesCount + 1;
+    float previousIntervalWidth = intervalWidth;
     intervalWidth = ZOOM_BASE_WIDTH / baseIntervalsCount;
     intervalHeight = intervalWidth / HORIZONTAL_TO_VERTICAL_INTERVAL_WIDTH_RELATION;
     pianoDrawer->setIntervalHeight(intervalHeight);
+    // Zoom is changed in steps, the grid and the piano layers are rendered for the new step by updateLayers
+    // after the zoom settles
+    if (!Primitives::CompareFloats(previousIntervalWidth, intervalWidth)) {
+        zoomChangeTime = TimeUtils::NowInSecondsSinceStart();
+    }
     if (!isnan(workspaceSeek)) {
-        updateSeek(workspaceSeek);
+        setHorizontalOffsetFromSeek(workspaceSeek);
     }
     updateHorizontalScrollBarPageSize();
 
@@ -943,10 +1184,122 @@ void WorkspaceDrawer::updateZoom() {
         pageSize = 0;
     }
     verticalScrollBar.setPageSize(pageSize);
+
+    float visibleBeatsCount = width / intervalWidth;
+    frameStates.modify(0, [=] (WorkspaceFrameState& state) {
+        state.visibleBeatsCount = visibleBeatsCount;
+    });
 }
 
 void WorkspaceDrawer::updateSeek(float seek) {
-    CHECK_IF_RENDER_THREAD;
+    publish(FrameScheduler::SEEK, [=] (WorkspaceFrameState& state) {
+        state.seek = seek;
+        copyGraphPitches(state);
+    });
+    frameScheduler.syncPlaybackSeek(seek, TimeUtils::NowInSecondsSinceStart());
+}
+
+void WorkspaceDrawer::syncPlaybackSeek(double seek) {
+    frameStates.modify(0, [=] (WorkspaceFrameState& state) {
+        state.seek = seek;
+        copyGraphPitches(state);
+    });
+    frameScheduler.syncPlaybackSeek(seek, TimeUtils::NowInSecondsSinceStart());
+}
+
+void WorkspaceDrawer::publish(int changes, const std::function<void(WorkspaceFrameState& state)>& modifier) {
+    frameStates.modify(changes, modifier);
+    if (changes != 0) {
+        frameScheduler.invalidate(changes);
+    }
+}
+
+void WorkspaceDrawer::applyFrameState(int changes) {
+    if (changes == 0) {
+        return;
+    }
+
+    const WorkspaceFrameState& state = frameStates.getFront();
+    if (running != state.running) {
+        running = state.running;
+        frameScheduler.setRunning(running);
+    }
+    recording = state.recording;
+
+    bool instrumentalTrackChanged = false;
+    if (changes & FrameScheduler::CONTENT) {
+        // update() is also reported as CONTENT, the layers are re-rendered only for another vocal part
+        if (vocalPart != state.vocalPart || beatsPerSecond != state.beatsPerSecond ||
+                beatsInBar != state.beatsInBar) {
+            vocalPart = state.vocalPart;
+            beatsPerSecond = state.beatsPerSecond;
+            beatsInBar = state.beatsInBar;
+            totalDurationInSeconds = vocalPart ? vocalPart->getDurationInSeconds() : 0;
+            updateHorizontalScrollBarPageSize();
+            invalidateLayers();
+        }
+        pianoDrawer->setPitchSequence(state.pitchSequence);
+        if (instrumentalTrackSamples != state.instrumentalTrackSamples) {
+            instrumentalTrackSamples = state.instrumentalTrackSamples;
+            instrumentalTrackChanged = true;
+        }
+    }
+
+    if (changes & FrameScheduler::LAYOUT) {
+        if (firstPitchIndex != state.firstPitchIndex) {
+            firstPitchIndex = state.firstPitchIndex;
+            pianoDrawer->setFirstPitch(getFirstPitch());
+            invalidateLayers();
+        }
+        willDrawTracks = state.drawTracks;
+    }
+
+    if (changes & FrameScheduler::ZOOM) {
+        minZoom = state.minZoom;
+        maxZoom = state.maxZoom;
+        zoom = state.zoom;
+        updateZoom();
+    }
+
+    if (changes & FrameScheduler::COLORS) {
+        instrumentalTrackChanged |= colors.instrumentalTrackColor != state.colors.instrumentalTrackColor;
+        colors = state.colors;
+        invalidateLayers();
+    }
+
+    if (instrumentalTrackChanged && width > 0 && height > 0 && devicePixelRatio > 0) {
+        generateInstrumentalTrackSamplesImage(width - PIANO_WIDTH);
+    }
+
+    if (changes & FrameScheduler::BOUNDS) {
+        playbackBounds = state.playbackBounds;
+        if (boundsSelectionController &&
+                boundsSelectionController->isBoundsSelectionEnabled() != state.boundsSelectionEnabled) {
+            boundsSelectionController->setBoundsSelectionEnabled(state.boundsSelectionEnabled);
+        }
+    }
+
+    if (changes & FrameScheduler::PITCHES) {
+        pianoDrawer->setDetectedPitch(state.detectedPitch);
+    }
+
+    // While running the seek is replaced with the playback seek in draw
+    if (changes & FrameScheduler::SEEK) {
+        setHorizontalOffsetFromSeek(state.seek);
+    }
+
+    if ((changes & FrameScheduler::SCROLL) && verticalScrollBar.getPageSize() > 0) {
+        verticalScrollBar.setPosition(state.verticalScrollPosition);
+    }
+}
+
+void WorkspaceDrawer::notifySeekChangedByUser(float seek) {
+    if (delegate) {
+        delegate->onSeekChangedByUserEvent(seek);
+    }
+}
+
+void WorkspaceDrawer::setHorizontalOffsetFromSeek(double seek) {
     horizontalOffset = static_cast<float>(beatsPerSecond * seek * intervalWidth);
     updateHorizontalScrollBarPagePosition();
 }
@@ -967,17 +1320,78 @@ void WorkspaceDrawer::updateHorizontalScrollBarPagePosition() {
     horizontalScrollBar.setPosition(position);
 }
 
-void WorkspaceDrawer::drawFps(float fps) {
-    auto str = std::to_string(int(round(fps)));
+void WorkspaceDrawer::drawFrameProfiler() {
+    std::vector<FrameProfiler::FrameRecord> records = frameProfiler.getRecords();
+    if (records.empty()) {
+        return;
+    }
+
+    // A column per frame with the top level sections stacked in the order they are measured,
+    // the sections are distinguished by colors. The panel height is two frames of 60 fps.
+    static const Color SECTION_COLORS[] = {
+        Color::fromRgba(0x4E79A7FF), Color::fromRgba(0xF28E2BFF), Color::fromRgba(0xE15759FF),
+        Color::fromRgba(0x76B7B2FF), Color::fromRgba(0x59A14FFF), Color::fromRgba(0xEDC948FF),
+        Color::fromRgba(0xB07AA1FF), Color::fromRgba(0xFF9DA7FF), Color::fromRgba(0x9C755FFF)
+    };
+    constexpr int SECTION_COLORS_COUNT = sizeof(SECTION_COLORS) / sizeof(Color);
+    constexpr float COLUMN_WIDTH = 2;
+    constexpr float PANEL_HEIGHT = 60;
+    constexpr double PANEL_DURATION = 2.0 / 60.0;
+    float panelWidth = COLUMN_WIDTH * records.size();
+    float panelX = width - panelWidth - ScrollBar::SCROLLBAR_WEIGHT - 16;
+    float panelY = YARD_STICK_HEIGHT + 8;
+    float scale = float(PANEL_HEIGHT / PANEL_DURATION);
+
+    drawer->setFillColor(Color::fromRgba(0xFFFFFFD0));
+    drawer->fillRect(panelX, panelY, panelWidth, PANEL_HEIGHT);
+
+    std::array<std::vector<Drawer::RoundedRectShape>, SECTION_COLORS_COUNT> columns;
+    std::vector<Drawer::RoundedRectShape> gpuMarks;
+    float panelBottom = panelY + PANEL_HEIGHT;
+    for (int i = 0; i < records.size(); ++i) {
+        const FrameProfiler::FrameRecord& record = records[i];
+        float x = panelX + i * COLUMN_WIDTH;
+        float y = panelBottom;
+        int colorIndex = 0;
+        for (int sectionIndex = 0; sectionIndex < record.sectionsCount; ++sectionIndex) {
+            const FrameProfiler::Section& section = record.sections[sectionIndex];
+            if (section.depth != 0) {
+                continue;
+            }
+
+            float sectionHeight = std::min(float((section.end - section.begin) * scale), y - panelY);
+            y -= sectionHeight;
+            columns[colorIndex++ % SECTION_COLORS_COUNT].push_back({x, y, COLUMN_WIDTH, sectionHeight, 0, 0, 0, 0});
+        }
+
+        if (record.gpuTime >= 0) {
+            float gpuY = std::max(panelY, float(panelBottom - record.gpuTime * scale));
+            gpuMarks.push_back({x, gpuY - 0.5f, COLUMN_WIDTH, 1, 0, 0, 0, 0});
+        }
+    }
+
+    for (int i = 0; i < SECTION_COLORS_COUNT; ++i) {
+        drawer->fillRoundedRects(columns[i].data(), int(columns[i].size()), SECTION_COLORS[i]);
+    }
+    drawer->fillRoundedRects(gpuMarks.data(), int(gpuMarks.size()), Color(0, 0, 0, 255));
+
+    // 60 fps budget
+    drawer->setStrokeColor(colors.borderLineColor);
+    drawer->setStrokeWidth(1);
+    drawer->drawHorizontalLine(panelX, panelBottom - PANEL_HEIGHT / 2 + 0.5f, panelWidth);
+
+    // Frames per second the frames could be rendered, only digits are available in the pre-built text images
+    double framesTime = 0;
+    for (const FrameProfiler::FrameRecord& record : records) {
+        framesTime += record.getDuration();
+    }
+    int fps = framesTime > 0 ? int(round(records.size() / framesTime)) : 0;
     drawer->setTextFontSize(yardStickFontSize);
     drawer->setTextStyle(yardStickFontStyle);
+    drawer->setTextAlign(Drawer::RIGHT);
+    drawer->setTextBaseline(Drawer::TOP);
     drawer->setFillColor(YARD_STICK_DOT_AND_TEXT_COLOR);
-    drawer->fillText(str, 20, 20);
-    if (fps < 50) {
-        cerr << "fps=" << fps << endl;
-    } else {
-        cout << "fps=" << fps << endl;
-    }
+    drawer->fillText(std::to_string(fps), panelX + panelWidth - 2, panelY + 2);
 }
 
 void WorkspaceDrawer::drawTracks() {
@@ -996,20 +1410,28 @@ void WorkspaceDrawer::drawTracks() {
 }
 
 bool WorkspaceDrawer::shouldDrawTracks() {
-    return willDrawTracks;
+    bool drawTracks;
+    frameStates.read([&] (const WorkspaceFrameState& state) {
+        drawTracks = state.drawTracks;
+    });
+    return drawTracks;
 }
 
 void WorkspaceDrawer::setDelegate(WorkspaceControllerDelegate *delegate) {
-    CHECK_IF_RENDER_THREAD;
-    assert(!this->delegate && "setDelegate could not be called twice");
     assert(delegate && "delegate should not be null");
-    this->delegate = delegate;
-    this->boundsSelectionController = new BoundsSelectionController(delegate, mouseEventsReceiver, this);
+    // The delegate is used by the rendering thread
+    frameStates.post([=] {
+        assert(!this->delegate && "setDelegate could not be called twice");
+        this->delegate = delegate;
+        this->boundsSelectionController = new BoundsSelectionController(delegate, mouseEventsReceiver, this);
+    });
+    frameScheduler.invalidate(FrameScheduler::BOUNDS);
 }
 
 void WorkspaceDrawer::setBoundsSelectionEnabled(bool boundsSelectionEnabled) {
-    assert(boundsSelectionController && "Call setDelegate before setBoundsSelectionEnabled");
-    boundsSelectionController->setBoundsSelectionEnabled(boundsSelectionEnabled);
+    publish(FrameScheduler::BOUNDS, [=] (WorkspaceFrameState& state) {
+        state.boundsSelectionEnabled = boundsSelectionEnabled;
+    });
 }
 
 #define R(I) WorkspaceDrawerResourcesProvider::I
@@ -1027,13 +1449,7 @@ void WorkspaceDrawer::initImages() {
     DrawerTextImagesFactory* textImagesFactory = new DrawerTextImagesFactory();
     auto createImageForCharacter = [&] (char ch, int fontSize, const Color& color, Drawer::FontStyle style) {
         Bitmap bitmap = resourcesProvider->createImageForCharacter(ch, fontSize, color, style, devicePixelRatio);
-        DrawerTextImagesFactoryCharacterData data;
-        data.character = ch;
-        data.color = color;
-        data.fontSize = fontSize;
-        data.style = style;
-        data.image = drawer->createImage(bitmap);
-        textImagesFactory->addImage(data);
+        textImagesFactory->addGlyph(ch, fontSize, color, style, bitmap);
     };
 
     int pianoFontSize = 8;
@@ -1059,36 +1475,120 @@ void WorkspaceDrawer::initImages() {
 
     createImageForCharacter(':', clockFontSize, WorkspaceDrawer::YARD_STICK_DOT_AND_TEXT_COLOR, clockFontStyle);
 
+    textImagesFactory->createAtlasImage(drawer);
     drawer->setTextImagesFactory(textImagesFactory);
     drawer->setTextDrawStrategy(Drawer::DRAW_USING_PRE_BUILD_IMAGES);
 }
 
+void WorkspaceDrawer::updateLayers(double frameTime) {
+    // Rendering the grid and the piano on every zoom step takes longer than a frame, so while the zoom is
+    // changing the layers of the previous step are drawn scaled. The next frames are requested until the zoom
+    // settles. The piano layer is rendered at once if the scaled keyboard doesn't reach the top.
+    if (!Primitives::CompareFloats(layersIntervalWidth, intervalWidth)) {
+        bool zoomSettled = frameTime - zoomChangeTime >= LAYERS_ZOOM_SETTLE_DURATION;
+        bool pianoCovered = getPianoHeight() - pianoLayer.getHeight() * getLayersScale() <= 0;
+        if (zoomSettled || !gridLayer.isValid() || !pianoLayer.isValid() || !pianoCovered) {
+            gridLayer.invalidate();
+            pianoLayer.invalidate();
+            layersIntervalWidth = intervalWidth;
+        } else {
+            frameScheduler.invalidate(FrameScheduler::ANIMATION);
+        }
+    }
+
+    if (Primitives::CompareFloats(layersIntervalWidth, intervalWidth)) {
+        float gridLayerWidth = width + getZeroSeekGridOffset();
+        float gridLayerHeight = getGridLayerHeight();
+        gridLayer.update(gridLayerWidth, gridLayerHeight, devicePixelRatio, [=] {
+            drawVerticalGrid(gridLayerWidth, gridLayerHeight);
+            drawHorizontalGrid(gridLayerWidth, gridLayerHeight);
+        });
+
+        // The keyboard for the top scroll position, it's shifted up by the grid translation
+        float pianoLayerHeight = getPianoHeight() + getGridYTranslation();
+        pianoLayer.update(PIANO_WIDTH, pianoLayerHeight, devicePixelRatio, [=] {
+            pianoDrawer->drawKeyboard(pianoLayerHeight);
+        });
+    }
+
+    if (willDrawTracks && vocalPart) {
+        float verticalPadding;
+        float pianoTrackHeight = getPianoTrackHeight(&verticalPadding);
+        pianoTrackLayer.update(width - PIANO_WIDTH, pianoTrackHeight + PIANO_TRACK_SHADOW_RADIUS * 2,
+                devicePixelRatio, [=] {
+            drawPianoTrackLayer(pianoTrackHeight, verticalPadding);
+        });
+    }
+}
+
+// The grid and the piano are proportional to the interval width
+float WorkspaceDrawer::getLayersScale() const {
+    return layersIntervalWidth > 0 ? intervalWidth / layersIntervalWidth : 1;
+}
+
+void WorkspaceDrawer::invalidateLayers() {
+    gridLayer.invalidate();
+    pianoLayer.invalidate();
+    pianoTrackLayer.invalidate();
+}
+
+float WorkspaceDrawer::getPianoHeight() const {
+    return height -
+            (willDrawScrollbars ? ScrollBar::SCROLLBAR_WEIGHT : 0) +
+            getMaximumGridYTranslation() -
+            getGridYTranslation();
+}
+
+void WorkspaceDrawer::drawPiano() {
+    // The keyboard is aligned with the bottom of the piano, the layer is scaled while the zoom is changing.
+    // Selected pitches are aligned with the layer, which is snapped to device pixels.
+    float scale = getLayersScale();
+    float layerHeight = pianoLayer.getHeight() * scale;
+    float y = round((getPianoHeight() - layerHeight) * devicePixelRatio) / devicePixelRatio;
+    if (Primitives::CompareFloats(scale, 1)) {
+        pianoLayer.draw(0, y, devicePixelRatio);
+    } else {
+        pianoLayer.draw(0, y, PIANO_WIDTH, layerHeight, devicePixelRatio);
+    }
+    pianoDrawer->drawSelectedPitches(y + layerHeight);
+}
+
 bool WorkspaceDrawer::isBoundsSelectionEnabled() const {
-    return boundsSelectionController->isBoundsSelectionEnabled();
+    bool enabled;
+    frameStates.read([&] (const WorkspaceFrameState& state) {
+        enabled = state.boundsSelectionEnabled;
+    });
+    return enabled;
 }
 
 float WorkspaceDrawer::getMinZoom() const {
+    float minZoom;
+    frameStates.read([&] (const WorkspaceFrameState& state) {
+        minZoom = state.minZoom;
+    });
     return minZoom;
 }
 
 void WorkspaceDrawer::setMinZoom(float minZoom) {
-    if (zoom < minZoom) {
-        setZoom(zoom);
-    }
-
-    this->minZoom = minZoom;
+    publish(FrameScheduler::ZOOM, [=] (WorkspaceFrameState& state) {
+        state.minZoom = minZoom;
+        state.zoom = std::max(state.zoom, minZoom);
+    });
 }
 
 float WorkspaceDrawer::getMaxZoom() const {
+    float maxZoom;
+    frameStates.read([&] (const WorkspaceFrameState& state) {
+        maxZoom = state.maxZoom;
+    });
     return maxZoom;
 }
 
 void WorkspaceDrawer::setMaxZoom(float maxZoom) {
-    if (zoom > maxZoom) {
-        setZoom(maxZoom);
-    }
-
-    this->maxZoom = maxZoom;
+    publish(FrameScheduler::ZOOM, [=] (WorkspaceFrameState& state) {
+        state.maxZoom = maxZoom;
+        state.zoom = std::min(state.zoom, maxZoom);
+    });
 }
 
 float WorkspaceDrawer::getZeroSeekGridOffset() const {
@@ -1096,18 +1596,24 @@ float WorkspaceDrawer::getZeroSeekGridOffset() const {
 }
 
 void WorkspaceDrawer::setZoom(float zoom, const CppUtils::PointF& intoPoint) {
-    float currentZoom = this->zoom;
-    float y = std::max(0.0f, intoPoint.y - getGridBeginYPosition()) + getGridYTranslation();
-    float top = y / getMaximumGridYTranslation();
-    if (top > 1) {
-        top = 1;
-    }
+    // The point is kept in place using the layout, so the zoom is applied by the rendering thread
+    frameStates.post([=] {
+        float currentZoom = this->zoom;
+        float y = std::max(0.0f, intoPoint.y - getGridBeginYPosition()) + getGridYTranslation();
+        float top = y / getMaximumGridYTranslation();
+        if (top > 1) {
+            top = 1;
+        }
 
-    float zoomMultiplier = zoom / currentZoom;
-    float moveDistance = zoomMultiplier * getMaximumGridYTranslation() * (1.0f - top);
-    setZoom(zoom);
-    float scrollYPositionMoveDistance = moveDistance / getMaximumGridYTranslation();
-    setVerticalScrollPosition(scrollYPositionMoveDistance + getVerticalScrollPosition());
+        float zoomMultiplier = zoom / currentZoom;
+        float moveDistance = zoomMultiplier * getMaximumGridYTranslation() * (1.0f - top);
+        this->zoom = zoom;
+        updateZoom();
+        setZoom(zoom);
+        float scrollYPositionMoveDistance = moveDistance / getMaximumGridYTranslation();
+        setVerticalScrollPosition(scrollYPositionMoveDistance + verticalScrollBar.getPosition());
+    });
+    frameScheduler.invalidate(FrameScheduler::ZOOM);
 }
 
 CppUtils::PointF WorkspaceDrawer::getRelativeMousePosition() const {
@@ -1115,7 +1621,9 @@ CppUtils::PointF WorkspaceDrawer::getRelativeMousePosition() const {
 }
 
 void WorkspaceDrawer::setColors(const WorkspaceColorScheme &scheme) {
-    this->colors = scheme;
+    publish(FrameScheduler::COLORS, [&] (WorkspaceFrameState& state) {
+        state.colors = scheme;
+    });
 }
 
 int WorkspaceDrawer::getBeatsInBar() const {
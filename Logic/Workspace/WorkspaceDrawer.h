@@ -21,6 +21,11 @@
 #include "BoundsSelectionController.h"
 #include "MouseClickChecker.h"
 #include "CallbacksQueue.h"
+#include "DrawerLayer.h"
+#include "FrameScheduler.h"
+#include "WaveformTiles.h"
+#include "WorkspaceFrameState.h"
+#include "FrameProfiler.h"
 #include <thread>
 
 class BoundsSelectionController;
@@ -62,9 +67,18 @@ class WorkspaceDrawer : public WorkspaceController {
     float devicePixelRatio = -1;
 
     Drawer* drawer = nullptr;
+    // Parts of the workspace, which don't depend on the seek and the playback state. They are re-rendered
+    // only when the size, the zoom, the colors or the vocal part are changed and are composited with
+    // a translation otherwise.
+    DrawerLayer gridLayer;
+    DrawerLayer pianoLayer;
+    DrawerLayer pianoTrackLayer;
+    // Interval width the grid and the piano layers are rendered for. While the zoom is changing they are drawn
+    // scaled, they are rendered again when the zoom isn't changed for LAYERS_ZOOM_SETTLE_DURATION.
+    float layersIntervalWidth = 0;
+    double zoomChangeTime = 0;
     MouseEventsReceiver* mouseEventsReceiver;
     MouseClickChecker mouseClickChecker;
-    const PitchesCollection* pitchesCollection = nullptr;
     PianoDrawer* pianoDrawer = nullptr;
 
     Drawer::Image* playHeadTriangleImage = nullptr;
@@ -74,11 +88,10 @@ class WorkspaceDrawer : public WorkspaceController {
 
     float firstPlayHeadPosition, secondPlayHeadPosition;
 
-    std::vector<float> pitchesFrequencies;
-    std::vector<double> pitchesTimes;
+    // Notes of the vocal part or the piano track, filled in a single call
+    std::vector<Drawer::RoundedRectShape> pitchesShapes;
 
-    std::vector<short> instrumentalTrackSamples;
-    Drawer::Image* instrumentalTrackImage = nullptr;
+    std::shared_ptr<const std::vector<short>> instrumentalTrackSamples;
     Drawer::Image* instrumentalTrackButtonImage = nullptr;
     Drawer::Image* pianoTrackButtonImage = nullptr;
 
@@ -98,16 +111,27 @@ class WorkspaceDrawer : public WorkspaceController {
     BoundsSelectionController* boundsSelectionController = nullptr;
 
     CppUtils::CallbacksQueue drawAboveQueue;
+    FrameScheduler frameScheduler;
+    // Controllers modify the pending state from their threads, the fields above are updated from it
+    // at the beginning of every frame
+    WorkspaceFrameStateBuffer frameStates;
+    // Declared after frameScheduler, which is invalidated when the tiles are ready
+    WaveformTiles instrumentalTrackWaveform;
+    FrameProfiler frameProfiler;
+    bool drawFrameProfilerOverlay = false;
 
     void iterateHorizontalIntervals(const std::function<void(float x, bool isBeat)>& func) const;
 
     void drawHorizontalLine(float y, const Color& color) const;
     void drawVerticalLine(float x, const Color& color) const;
-    void drawVerticalGrid() const;
-    void drawHorizontalGrid() const;
-    void drawPitch(float x, float y, float width);
+    void drawVerticalGrid(float layerWidth, float layerHeight) const;
+    void drawHorizontalGrid(float layerWidth, float layerHeight) const;
+    float getGridLayerVerticalPeriod() const;
+    float getGridLayerHeight() const;
+    void drawGridLayer();
+    void addPitchShape(float x, float y, float width);
     void drawPitches();
-    void initGraphPitchesArrays(float workspaceSeek);
+    void getGraphPitchesRange(float workspaceSeek, int* begin, int* end) const;
     void drawPitchesGraph();
     void drawBoundsIfNeed() const;
     void drawYardStick() const;
@@ -118,12 +142,16 @@ class WorkspaceDrawer : public WorkspaceController {
     void drawInstrumentalTrack();
     void drawInstrumentalTrackButton();
 
+    float getPianoTrackHeight(float* verticalPadding) const;
+    void drawPianoTrackLayer(float pianoTrackHeight, float verticalPadding);
     float drawPianoTrackAndCalculateHeight();
+    float getPianoHeight() const;
+    void drawPiano();
     void drawPianoTrackButton(float pianoTrackHeight);
     void drawScrollBars();
     void drawEnding();
     void drawTracks();
-    void drawFps(float fps);
+    void drawFrameProfiler();
 
     double getSingingPitchGraphDuration() const;
 
@@ -141,8 +169,16 @@ class WorkspaceDrawer : public WorkspaceController {
     void updateHorizontalScrollBarPageSize();
     void updateHorizontalScrollBarPagePosition();
     void updateZoom();
+    void setHorizontalOffsetFromSeek(double seek);
+
+    void publish(int changes, const std::function<void(WorkspaceFrameState& state)>& modifier);
+    void applyFrameState(int changes);
+    void notifySeekChangedByUser(float seek);
 
     void initImages();
+    void updateLayers(double frameTime);
+    float getLayersScale() const;
+    void invalidateLayers();
     void captureClickEventsInTracksArea(float pianoTrackHeight);
 
     CppUtils::PointF getRelativeMousePosition() const;
@@ -154,8 +190,13 @@ public:
     static constexpr float CLOCK_WIDTH = 42.f;
     static constexpr float CLOCK_HEIGHT = 22.f;
     static constexpr float YARD_STICK_HEIGHT = CLOCK_HEIGHT  + PLAYHEAD_TRIANGLE_HEIGHT / 2;
+    static constexpr double LAYERS_ZOOM_SETTLE_DURATION = 0.15;
     static const Color YARD_STICK_DOT_AND_TEXT_COLOR;
 
+    // The constructor, resize, draw and the drawer configuration setters should be called on the rendering thread.
+    // WorkspaceController setters and the getters of the published state can be called from any thread,
+    // the layout getters are for the rendering thread.
+    // onUpdateRequested is called on the first change after a frame, on the thread which has made the change.
     WorkspaceDrawer(Drawer *drawer,
             MouseEventsReceiver *mouseEventsReceiver,
             WorkspaceDrawerResourcesProvider *resourcesProvider,
@@ -168,6 +209,25 @@ public:
 
     void resize(float width, float height, float devicePixelRatio);
     void draw();
+    // Draws the frame only if something is changed since the last frame or the playback is running,
+    // should be called on every vsync. Returns false if the frame is skipped.
+    bool drawIfNeeded();
+    // True if drawIfNeeded would draw a frame, can be called from any thread. Views, which stop their
+    // update loop while nothing is changed, restart it from onUpdateRequested.
+    bool needsFrame() const;
+    // Requests a new frame, changes is a combination of FrameScheduler::Change flags.
+    // Platform views call it with FrameScheduler::INPUT on mouse events.
+    void invalidate(int changes);
+    const FrameScheduler::Statistics& getFrameStatistics() const;
+    void resetFrameStatistics();
+
+    // Measures the sections of every frame: the workspace parts, the piano and the backend endFrame.
+    // Disabled by default. The records of the profiler can be read from any thread.
+    void setFrameProfilingEnabled(bool enabled);
+    bool isFrameProfilingEnabled() const;
+    const FrameProfiler& getFrameProfiler() const;
+    // Draws the frame times of the recorded frames over the workspace, the profiling should be enabled
+    void setDrawFrameProfilerOverlay(bool drawFrameProfilerOverlay);
 
     float getHorizontalOffset() const override;
 
@@ -241,6 +301,7 @@ public:
     void setMaxZoom(float maxZoom);
 
     void updateSeek(float seek) override;
+    void syncPlaybackSeek(double seek) override;
 
     void setDelegate(WorkspaceControllerDelegate *delegate) override;
     void setBoundsSelectionEnabled(bool boundsSelectionEnabled) override;
@@ -0,0 +1,48 @@
+#include "WorkspaceFrameState.h"
+
+#define LOCK std::lock_guard<std::mutex> _(mutex)
+
+WorkspaceFrameStateBuffer::WorkspaceFrameStateBuffer(int initialChanges) : pendingChanges(initialChanges) {
+}
+
+void WorkspaceFrameStateBuffer::modify(int changes, const std::function<void(WorkspaceFrameState& state)>& modifier) {
+    LOCK;
+    modifier(pending);
+    pendingChanges |= changes;
+    modified = true;
+}
+
+void WorkspaceFrameStateBuffer::read(const std::function<void(const WorkspaceFrameState& state)>& reader) const {
+    LOCK;
+    reader(pending);
+}
+
+void WorkspaceFrameStateBuffer::post(const std::function<void()>& task) {
+    LOCK;
+    tasks.push_back(task);
+}
+
+std::vector<std::function<void()>> WorkspaceFrameStateBuffer::takeTasks() {
+    std::vector<std::function<void()>> result;
+    LOCK;
+    result.swap(tasks);
+    return result;
+}
+
+int WorkspaceFrameStateBuffer::acquire() {
+    LOCK;
+    if (!modified) {
+        return 0;
+    }
+
+    // Assignment reuses the capacity of the front pitches arrays
+    front = pending;
+    modified = false;
+    int changes = pendingChanges;
+    pendingChanges = 0;
+    return changes;
+}
+
+const WorkspaceFrameState& WorkspaceFrameStateBuffer::getFront() const {
+    return front;
+}
@@ -0,0 +1,87 @@
+#ifndef VOCALTRAINER_WORKSPACEFRAMESTATE_H
+#define VOCALTRAINER_WORKSPACEFRAMESTATE_H
+
+#include "VocalPart.h"
+#include "PlaybackBounds.h"
+#include "PlayingPitchSequence.h"
+#include "PitchesCollection.h"
+#include "WorkspaceColorScheme.h"
+#include "Pitch.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <functional>
+
+// Everything the controllers tell the workspace. A frame is rendered from a copy of the state, taken when the frame
+// begins, so the frame never sees a half applied change and the controllers never read the data the frame is
+// being rendered from.
+struct WorkspaceFrameState {
+    // Seek set by the controllers, while running the frame seek is extrapolated by FrameScheduler
+    double seek = 0;
+    bool running = false;
+    bool recording = false;
+
+    // VocalPart is immutable, it's replaced by setVocalPart as a whole
+    const VocalPart* vocalPart = nullptr;
+    double beatsPerSecond = 0;
+    int beatsInBar = 4;
+    PlayingPitchSequence* pitchSequence = nullptr;
+    std::shared_ptr<const std::vector<short>> instrumentalTrackSamples;
+
+    PlaybackBounds playbackBounds;
+    bool boundsSelectionEnabled = false;
+
+    float zoom = 1;
+    float minZoom = 1;
+    float maxZoom = 1;
+    float verticalScrollPosition = 0;
+    int firstPitchIndex = -1;
+    bool drawTracks = true;
+    WorkspaceColorScheme colors;
+
+    // Width of the workspace in beats, written back by the rendering thread after resize and zoom
+    float visibleBeatsCount = 0;
+
+    Pitch detectedPitch;
+    const PitchesCollection* pitchesCollection = nullptr;
+    // Sung pitches around the seek, copied from pitchesCollection when the state is modified.
+    // Pitch values are invalid for the silence.
+    std::vector<double> pitchesTimes;
+    std::vector<PitchValue> pitchValues;
+};
+
+// Double buffer of WorkspaceFrameState: controllers modify the pending state from any thread, the rendering thread
+// copies it to the front state at the beginning of a frame and reads the front state without locks.
+// The rendering thread is the main thread of every platform view, the player and the recorder callbacks
+// publish their state from their own threads without waiting for the frame.
+class WorkspaceFrameStateBuffer {
+    mutable std::mutex mutex;
+    WorkspaceFrameState pending;
+    WorkspaceFrameState front;
+    int pendingChanges;
+    bool modified = true;
+    std::vector<std::function<void()>> tasks;
+public:
+    // The first acquire reports all the changes
+    explicit WorkspaceFrameStateBuffer(int initialChanges);
+    WorkspaceFrameStateBuffer(const WorkspaceFrameStateBuffer&) = delete;
+    WorkspaceFrameStateBuffer& operator=(const WorkspaceFrameStateBuffer&) = delete;
+
+    // changes is a combination of FrameScheduler::Change flags, which are reported by the next acquire.
+    // modifier should not call other methods of the buffer.
+    void modify(int changes, const std::function<void(WorkspaceFrameState& state)>& modifier);
+    void read(const std::function<void(const WorkspaceFrameState& state)>& reader) const;
+
+    // Posts a task, which needs the layout of the rendered frames, it's executed on the rendering thread
+    // before the next frame
+    void post(const std::function<void()>& task);
+    std::vector<std::function<void()>> takeTasks();
+
+    // Rendering thread. Copies the pending state to the front state, returns the changes made since
+    // the previous acquire.
+    int acquire();
+    const WorkspaceFrameState& getFront() const;
+};
+
+
+#endif //VOCALTRAINER_WORKSPACEFRAMESTATE_H
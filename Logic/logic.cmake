@@ -2,6 +2,10 @@ set(Drawers
         Drawers/Drawer.cpp
         ../CppUtils/Color.cpp
         Drawers/NvgDrawer.cpp
+        Drawers/SoftwareDrawer.cpp
+        Drawers/DrawerLayer.cpp
+        Drawers/CommandBufferDrawer.cpp
+        Drawers/FrameProfiler.cpp
         nanovg/nanovg.cpp
         )
 
@@ -25,11 +29,23 @@ set(Manager
 set(Workspace
         Workspace/PianoDrawer.cpp
         Workspace/ScrollBar.cpp
-        Workspace/WorkspaceDrawer.cpp)
+        Workspace/WorkspaceDrawer.cpp
+        Workspace/FrameScheduler.cpp
+        Workspace/WaveformTiles.cpp
+        Workspace/WorkspaceFrameState.cpp)
+
+set(Pitch
+        Pitch/Pitch.cpp
+        Pitch/PitchValue.cpp
+        Pitch/PitchStabilityAnalyzer.cpp
+        Pitch/PitchesMutableList.cpp
+        Pitch/SeekablePitchesList.cpp
+        Pitch/Tonality.cpp)
 
 set(logicSources
         ${Drawers}
         ${Manager}
+        ${Pitch}
         ApplicationModel.cpp
         Events/MouseEventsReceiver.h
         Events/BaseSynchronizedMouseEventsReceiver.cpp
@@ -44,6 +44,13 @@
 #define NVG_INIT_VERTS_SIZE 256
 #define NVG_MAX_STATES 32
 
+// Paths shorter than this number of command values are tessellated faster than looked up in the geometry cache
+#define NVG_GEOMETRY_CACHE_MIN_COMMANDS 32
+// Geometry not used for this number of frames is evicted
+#define NVG_GEOMETRY_CACHE_MAX_AGE 4
+#define NVG_GEOMETRY_CACHE_MAX_VERTS (1 << 20)
+#define NVG_GEOMETRY_KEY_SIZE 8
+
 #define NVG_KAPPA90 0.5522847493f	// Length proportional to radius of a cubic bezier handle for 90deg arcs.
 
 #define NVG_COUNTOF(arr) (sizeof(arr) / sizeof(0[arr]))
@@ -109,6 +116,39 @@ struct NVGpathCache {
 };
 typedef struct NVGpathCache NVGpathCache;
 
+// Tessellated paths of a fill or a stroke. The key is the fill or stroke parameters followed by the transformed
+// path commands. A path seen for the first time has only its hash stored, the key and the geometry are stored
+// when the path is drawn again, so the paths changing every frame cost only the hashing.
+// The tessellation itself stays scalar: nanovg takes 0.02-0.3 ms of a WorkspaceBenchmark frame and SSE2 versions
+// of the segment, join and extrusion loops didn't change it measurably.
+struct NVGgeometry {
+	unsigned int hash;
+	int next;
+	int lastFrame;
+	float* key;
+	int nkey;
+	NVGpath* paths;
+	int npaths;
+	NVGvertex* verts;
+	int nverts;
+	float bounds[4];
+};
+typedef struct NVGgeometry NVGgeometry;
+
+// Geometry of the recent frames, looked up by the hash chained in buckets
+struct NVGgeometryCache {
+	NVGgeometry* entries;
+	int nentries;
+	int centries;
+	int* buckets;
+	int nbuckets;
+	int nverts;
+	int frame;
+	int enabled;
+	int nhits;
+};
+typedef struct NVGgeometryCache NVGgeometryCache;
+
 struct NVGcontext {
 	NVGparams params;
 	float* commands;
@@ -118,6 +158,7 @@ struct NVGcontext {
 	NVGstate states[NVG_MAX_STATES];
 	int nstates;
 	NVGpathCache* cache;
+	NVGgeometryCache geometryCache;
 	float tessTol;
 	float distTol;
 	float fringeWidth;
@@ -160,6 +201,29 @@ static float nvg__normalize(float *x, float* y)
 	return d;
 }
 
+// FNV-1a of 4 interleaved lanes, so the multiplications of the lanes are independent
+static unsigned int nvg__hashFloats(const float* values, int nvalues)
+{
+	unsigned int h[4] = {2166136261u, 2166136261u, 2166136261u, 2166136261u};
+	unsigned int bits[4];
+	int i;
+	for (i = 0; i + 4 <= nvalues; i += 4) {
+		memcpy(bits, &values[i], sizeof(bits));
+		h[0] = (h[0] ^ bits[0]) * 16777619u;
+		h[1] = (h[1] ^ bits[1]) * 16777619u;
+		h[2] = (h[2] ^ bits[2]) * 16777619u;
+		h[3] = (h[3] ^ bits[3]) * 16777619u;
+	}
+	for (; i < nvalues; i++) {
+		memcpy(bits, &values[i], sizeof(bits[0]));
+		h[0] = (h[0] ^ bits[0]) * 16777619u;
+	}
+	h[0] = (h[0] ^ h[1]) * 16777619u;
+	h[0] = (h[0] ^ h[2]) * 16777619u;
+	h[0] = (h[0] ^ h[3]) * 16777619u;
+	return (h[0] ^ (unsigned int)nvalues) * 16777619u;
+}
+
 
 static void nvg__deletePathCache(NVGpathCache* c)
 {
@@ -197,6 +261,173 @@ static NVGpathCache* nvg__allocPathCache(void)
 	return NULL;
 }
 
+static void nvg__deleteGeometry(NVGgeometry* g)
+{
+	free(g->key);
+	free(g->paths);
+	free(g->verts);
+}
+
+static void nvg__rehashGeometryCache(NVGgeometryCache* gc)
+{
+	int i;
+	for (i = 0; i < gc->nbuckets; i++)
+		gc->buckets[i] = -1;
+	for (i = 0; i < gc->nentries; i++) {
+		int bucket = (int)(gc->entries[i].hash & (gc->nbuckets-1));
+		gc->entries[i].next = gc->buckets[bucket];
+		gc->buckets[bucket] = i;
+	}
+}
+
+static void nvg__clearGeometryCache(NVGgeometryCache* gc)
+{
+	int i;
+	for (i = 0; i < gc->nentries; i++)
+		nvg__deleteGeometry(&gc->entries[i]);
+	gc->nentries = 0;
+	gc->nverts = 0;
+	nvg__rehashGeometryCache(gc);
+}
+
+static void nvg__deleteGeometryCache(NVGgeometryCache* gc)
+{
+	nvg__clearGeometryCache(gc);
+	free(gc->entries);
+	free(gc->buckets);
+	gc->entries = NULL;
+	gc->centries = 0;
+	gc->buckets = NULL;
+	gc->nbuckets = 0;
+}
+
+// Returns the index of the geometry of the current path drawn with the parameters, its paths are NULL if it is
+// not stored yet. Returns -1 if the path is seen the first time or it is not worth caching.
+static int nvg__findGeometry(NVGcontext* ctx, const float* params)
+{
+	NVGgeometryCache* gc = &ctx->geometryCache;
+	NVGgeometry* g;
+	unsigned int hash;
+	int i, nkey = NVG_GEOMETRY_KEY_SIZE + ctx->ncommands;
+
+	if (!gc->enabled || ctx->ncommands < NVG_GEOMETRY_CACHE_MIN_COMMANDS)
+		return -1;
+
+	hash = nvg__hashFloats(ctx->commands, ctx->ncommands);
+	hash = (hash ^ nvg__hashFloats(params, NVG_GEOMETRY_KEY_SIZE)) * 16777619u;
+	for (i = gc->nbuckets > 0 ? gc->buckets[hash & (gc->nbuckets-1)] : -1; i >= 0; i = g->next) {
+		g = &gc->entries[i];
+		if (g->hash != hash)
+			continue;
+		// The key is not stored yet, the path is drawn the second time
+		if (g->key == NULL || (g->nkey == nkey &&
+				memcmp(g->key, params, sizeof(float)*NVG_GEOMETRY_KEY_SIZE) == 0 &&
+				memcmp(g->key + NVG_GEOMETRY_KEY_SIZE, ctx->commands, sizeof(float)*ctx->ncommands) == 0)) {
+			g->lastFrame = gc->frame;
+			return i;
+		}
+	}
+
+	// Keep the hash only, the path is stored if it is drawn again
+	if (gc->nentries+1 > gc->centries) {
+		NVGgeometry* entries;
+		int centries = gc->nentries+1 + gc->centries/2;
+		entries = (NVGgeometry*)realloc(gc->entries, sizeof(NVGgeometry)*centries);
+		if (entries == NULL) return -1;
+		gc->entries = entries;
+		gc->centries = centries;
+	}
+	if ((gc->nentries+1)*2 > gc->nbuckets) {
+		int nbuckets = nvg__maxi(64, gc->nbuckets*2);
+		int* buckets = (int*)realloc(gc->buckets, sizeof(int)*nbuckets);
+		if (buckets == NULL) return -1;
+		gc->buckets = buckets;
+		gc->nbuckets = nbuckets;
+		nvg__rehashGeometryCache(gc);
+	}
+
+	g = &gc->entries[gc->nentries];
+	memset(g, 0, sizeof(*g));
+	g->hash = hash;
+	g->lastFrame = gc->frame;
+	g->next = gc->buckets[hash & (gc->nbuckets-1)];
+	gc->buckets[hash & (gc->nbuckets-1)] = gc->nentries;
+	gc->nentries++;
+	return -1;
+}
+
+// Copies the key, the paths and the vertices of the path cache into the geometry
+static void nvg__storeGeometry(NVGcontext* ctx, int index, const float* params)
+{
+	NVGgeometryCache* gc = &ctx->geometryCache;
+	NVGgeometry* g = &gc->entries[index];
+	NVGpathCache* cache = ctx->cache;
+	NVGvertex* verts = cache->verts;
+	int i, nverts = 0, nkey = NVG_GEOMETRY_KEY_SIZE + ctx->ncommands;
+
+	for (i = 0; i < cache->npaths; i++) {
+		const NVGpath* path = &cache->paths[i];
+		if (path->fill != NULL)
+			nverts = nvg__maxi(nverts, (int)(path->fill - verts) + path->nfill);
+		if (path->stroke != NULL)
+			nverts = nvg__maxi(nverts, (int)(path->stroke - verts) + path->nstroke);
+	}
+	if (gc->nverts + nverts > NVG_GEOMETRY_CACHE_MAX_VERTS)
+		return;
+
+	g->key = (float*)malloc(sizeof(float)*nkey);
+	g->paths = (NVGpath*)malloc(sizeof(NVGpath)*nvg__maxi(cache->npaths, 1));
+	g->verts = (NVGvertex*)malloc(sizeof(NVGvertex)*nvg__maxi(nverts, 1));
+	if (g->key == NULL || g->paths == NULL || g->verts == NULL) {
+		nvg__deleteGeometry(g);
+		g->key = NULL;
+		g->paths = NULL;
+		g->verts = NULL;
+		return;
+	}
+
+	memcpy(g->key, params, sizeof(float)*NVG_GEOMETRY_KEY_SIZE);
+	memcpy(g->key + NVG_GEOMETRY_KEY_SIZE, ctx->commands, sizeof(float)*ctx->ncommands);
+	g->nkey = nkey;
+
+	memcpy(g->verts, verts, sizeof(NVGvertex)*nverts);
+	for (i = 0; i < cache->npaths; i++) {
+		NVGpath* path = &g->paths[i];
+		*path = cache->paths[i];
+		if (path->fill != NULL)
+			path->fill = g->verts + (path->fill - verts);
+		if (path->stroke != NULL)
+			path->stroke = g->verts + (path->stroke - verts);
+	}
+	g->npaths = cache->npaths;
+	g->nverts = nverts;
+	memcpy(g->bounds, cache->bounds, sizeof(g->bounds));
+	gc->nverts += nverts;
+}
+
+// Removes the geometry not drawn in the last frames
+static void nvg__evictGeometry(NVGcontext* ctx)
+{
+	NVGgeometryCache* gc = &ctx->geometryCache;
+	int i, n = 0;
+
+	gc->frame++;
+	for (i = 0; i < gc->nentries; i++) {
+		NVGgeometry* g = &gc->entries[i];
+		if (gc->frame - g->lastFrame > NVG_GEOMETRY_CACHE_MAX_AGE) {
+			gc->nverts -= g->nverts;
+			nvg__deleteGeometry(g);
+		} else {
+			gc->entries[n++] = *g;
+		}
+	}
+
+	if (n != gc->nentries) {
+		gc->nentries = n;
+		nvg__rehashGeometryCache(gc);
+	}
+}
+
 static void nvg__setDevicePixelRatio(NVGcontext* ctx, float ratio)
 {
 	ctx->tessTol = 0.25f / ratio;
@@ -302,6 +533,7 @@ NVGcontext* nvgCreateInternal(NVGparams* params)
 
 	ctx->cache = nvg__allocPathCache();
 	if (ctx->cache == NULL) goto error;
+	ctx->geometryCache.enabled = 1;
 
 	nvgSave(ctx);
 	nvgReset(ctx);
@@ -346,6 +578,7 @@ void nvgDeleteInternal(NVGcontext* ctx)
 	if (ctx == NULL) return;
 	if (ctx->commands != NULL) free(ctx->commands);
 	if (ctx->cache != NULL) nvg__deletePathCache(ctx->cache);
+	nvg__deleteGeometryCache(&ctx->geometryCache);
 
 	if (ctx->fs)
 		fonsDeleteInternal(ctx->fs);
@@ -391,6 +624,7 @@ void nvgCancelFrame(NVGcontext* ctx)
 void nvgEndFrame(NVGcontext* ctx)
 {
 	ctx->params.renderFlush(ctx->params.userPtr);
+	nvg__evictGeometry(ctx);
 	if (ctx->fontImageIdx != 0) {
 		int fontImage = ctx->fontImages[ctx->fontImageIdx];
 		int i, j, iw, ih;
@@ -672,6 +906,26 @@ void nvgShapeAntiAlias(NVGcontext* ctx, int enabled)
 	state->shapeAntiAlias = enabled;
 }
 
+void nvgGeometryCaching(NVGcontext* ctx, int enabled)
+{
+	ctx->geometryCache.enabled = enabled;
+	if (!enabled)
+		nvg__clearGeometryCache(&ctx->geometryCache);
+}
+
+void nvgGeometryCacheStats(NVGcontext* ctx, int* nentries, int* nstored, int* nhits)
+{
+	NVGgeometryCache* gc = &ctx->geometryCache;
+	int i;
+	*nentries = gc->nentries;
+	*nstored = 0;
+	for (i = 0; i < gc->nentries; i++) {
+		if (gc->entries[i].paths != NULL)
+			(*nstored)++;
+	}
+	*nhits = gc->nhits;
+}
+
 void nvgStrokeWidth(NVGcontext* ctx, float width)
 {
 	NVGstate* state = nvg__getState(ctx);
@@ -2220,25 +2474,40 @@ void nvgFill(NVGcontext* ctx)
 {
 	NVGstate* state = nvg__getState(ctx);
 	const NVGpath* path;
+	const NVGpath* paths;
+	const float* bounds;
 	NVGpaint fillPaint = state->fill;
-	int i;
-
-	nvg__flattenPaths(ctx);
-	if (ctx->params.edgeAntiAlias && state->shapeAntiAlias)
-		nvg__expandFill(ctx, ctx->fringeWidth, NVG_MITER, 2.4f);
-	else
-		nvg__expandFill(ctx, 0.0f, NVG_MITER, 2.4f);
+	float w = ctx->params.edgeAntiAlias && state->shapeAntiAlias ? ctx->fringeWidth : 0.0f;
+	float params[NVG_GEOMETRY_KEY_SIZE] = {0.0f, w, ctx->fringeWidth, ctx->tessTol, ctx->distTol, 0.0f, 0.0f, 0.0f};
+	int i, npaths, geometry;
+
+	geometry = nvg__findGeometry(ctx, params);
+	if (geometry >= 0 && ctx->geometryCache.entries[geometry].paths != NULL) {
+		const NVGgeometry* g = &ctx->geometryCache.entries[geometry];
+		ctx->geometryCache.nhits++;
+		paths = g->paths;
+		npaths = g->npaths;
+		bounds = g->bounds;
+	} else {
+		nvg__flattenPaths(ctx);
+		nvg__expandFill(ctx, w, NVG_MITER, 2.4f);
+		if (geometry >= 0)
+			nvg__storeGeometry(ctx, geometry, params);
+		paths = ctx->cache->paths;
+		npaths = ctx->cache->npaths;
+		bounds = ctx->cache->bounds;
+	}
 
 	// Apply global alpha
 	fillPaint.innerColor.a *= state->alpha;
 	fillPaint.outerColor.a *= state->alpha;
 
 	ctx->params.renderFill(ctx->params.userPtr, &fillPaint, state->compositeOperation, &state->scissor, ctx->fringeWidth,
-			ctx->cache->bounds, ctx->cache->paths, ctx->cache->npaths);
+			bounds, paths, npaths);
 
 	// Count triangles
-	for (i = 0; i < ctx->cache->npaths; i++) {
-		path = &ctx->cache->paths[i];
+	for (i = 0; i < npaths; i++) {
+		path = &paths[i];
 		ctx->fillTriCount += path->nfill-2;
 		ctx->fillTriCount += path->nstroke-2;
 		ctx->drawCallCount += 2;
@@ -2252,7 +2521,10 @@ void nvgStroke(NVGcontext* ctx)
 	float strokeWidth = nvg__clampf(state->strokeWidth * scale, 0.0f, 200.0f);
 	NVGpaint strokePaint = state->stroke;
 	const NVGpath* path;
-	int i;
+	const NVGpath* paths;
+	float fringe = ctx->params.edgeAntiAlias && state->shapeAntiAlias ? ctx->fringeWidth : 0.0f;
+	float params[NVG_GEOMETRY_KEY_SIZE];
+	int i, npaths, geometry;
 
 
 	if (strokeWidth < ctx->fringeWidth) {
@@ -2268,24 +2540,134 @@ void nvgStroke(NVGcontext* ctx)
 	strokePaint.innerColor.a *= state->alpha;
 	strokePaint.outerColor.a *= state->alpha;
 
-	nvg__flattenPaths(ctx);
-
-	if (ctx->params.edgeAntiAlias && state->shapeAntiAlias)
-		nvg__expandStroke(ctx, strokeWidth*0.5f, ctx->fringeWidth, state->lineCap, state->lineJoin, state->miterLimit);
-	else
-		nvg__expandStroke(ctx, strokeWidth*0.5f, 0.0f, state->lineCap, state->lineJoin, state->miterLimit);
+	params[0] = 1.0f;
+	params[1] = strokeWidth;
+	params[2] = fringe;
+	params[3] = (float)state->lineCap;
+	params[4] = (float)state->lineJoin;
+	params[5] = state->miterLimit;
+	params[6] = ctx->tessTol;
+	params[7] = ctx->distTol;
+	geometry = nvg__findGeometry(ctx, params);
+	if (geometry >= 0 && ctx->geometryCache.entries[geometry].paths != NULL) {
+		const NVGgeometry* g = &ctx->geometryCache.entries[geometry];
+		ctx->geometryCache.nhits++;
+		paths = g->paths;
+		npaths = g->npaths;
+	} else {
+		nvg__flattenPaths(ctx);
+		nvg__expandStroke(ctx, strokeWidth*0.5f, fringe, state->lineCap, state->lineJoin, state->miterLimit);
+		if (geometry >= 0)
+			nvg__storeGeometry(ctx, geometry, params);
+		paths = ctx->cache->paths;
+		npaths = ctx->cache->npaths;
+	}
 
 	ctx->params.renderStroke(ctx->params.userPtr, &strokePaint, state->compositeOperation, &state->scissor, ctx->fringeWidth,
-			strokeWidth, ctx->cache->paths, ctx->cache->npaths);
+			strokeWidth, paths, npaths);
 
 	// Count triangles
-	for (i = 0; i < ctx->cache->npaths; i++) {
-		path = &ctx->cache->paths[i];
+	for (i = 0; i < npaths; i++) {
+		path = &paths[i];
 		ctx->strokeTriCount += path->nstroke-2;
 		ctx->drawCallCount++;
 	}
 }
 
+// Adds two triangles covering a quarter of the rounded rectangle from its center (cx,cy) towards the corner
+// in the direction (sx,sy), extended by the fringe. u,v is the offset from the corner circle center in radii.
+static NVGvertex* nvg__roundedRectQuarter(NVGvertex* dst, float* xform, float cx, float cy, float hw, float hh,
+										  float sx, float sy, float r, float fringe)
+{
+	float x1 = cx + sx*(hw + fringe), y1 = cy + sy*(hh + fringe);
+	float minx = nvg__minf(cx, x1), maxx = nvg__maxf(cx, x1);
+	float miny = nvg__minf(cy, y1), maxy = nvg__maxf(cy, y1);
+	float px[4] = {minx, maxx, maxx, minx};
+	float py[4] = {miny, miny, maxy, maxy};
+	float c[4*2], uv[4*2];
+	float invr = 1.0f / r;
+	int i;
+
+	for (i = 0; i < 4; i++) {
+		nvgTransformPoint(&c[i*2], &c[i*2+1], xform, px[i], py[i]);
+		uv[i*2] = (sx*(px[i] - cx) - (hw - r)) * invr;
+		uv[i*2+1] = (sy*(py[i] - cy) - (hh - r)) * invr;
+	}
+
+	// The same winding as nvgImageQuads
+	nvg__vset(dst++, c[0], c[1], uv[0], uv[1]);
+	nvg__vset(dst++, c[4], c[5], uv[4], uv[5]);
+	nvg__vset(dst++, c[2], c[3], uv[2], uv[3]);
+	nvg__vset(dst++, c[0], c[1], uv[0], uv[1]);
+	nvg__vset(dst++, c[6], c[7], uv[6], uv[7]);
+	nvg__vset(dst++, c[4], c[5], uv[4], uv[5]);
+	return dst;
+}
+
+void nvgFillRoundedRects(NVGcontext* ctx, const float* rects, int nrects)
+{
+	NVGstate* state = nvg__getState(ctx);
+	NVGpaint paint;
+	NVGvertex* verts;
+	NVGvertex* dst;
+	float fringe;
+	int i, nverts;
+
+	nvgBeginPath(ctx);
+	if (nrects <= 0) return;
+
+	if (ctx->params.renderRoundedRects == NULL) {
+		// All the rectangles are sub-paths of a single fill
+		for (i = 0; i < nrects; i++) {
+			const float* r = &rects[i*8];
+			nvgRoundedRectVarying(ctx, r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7]);
+		}
+		nvgFill(ctx);
+		nvgBeginPath(ctx);
+		return;
+	}
+
+	verts = nvg__allocTempVerts(ctx, nrects * 24);
+	if (verts == NULL) return;
+
+	// The shape is anti-aliased in the fragment shader, the fringe gives it the pixels around the edges
+	fringe = ctx->fringeWidth / nvg__maxf(nvg__getAverageScale(state->xform), 1e-6f);
+	dst = verts;
+	for (i = 0; i < nrects; i++) {
+		const float* r = &rects[i*8];
+		float x = r[2] < 0 ? r[0] + r[2] : r[0];
+		float y = r[3] < 0 ? r[1] + r[3] : r[1];
+		float hw = nvg__absf(r[2])*0.5f, hh = nvg__absf(r[3])*0.5f;
+		float cx = x + hw, cy = y + hh;
+		float maxr = nvg__minf(hw, hh);
+		float rtl, rtr, rbr, rbl;
+		if (maxr < 0.01f) continue;
+		// Zero radius is replaced by a tiny one to keep u,v finite, the corner is still sharp
+		rtl = nvg__clampf(r[4], 0.01f, maxr);
+		rtr = nvg__clampf(r[5], 0.01f, maxr);
+		rbr = nvg__clampf(r[6], 0.01f, maxr);
+		rbl = nvg__clampf(r[7], 0.01f, maxr);
+
+		dst = nvg__roundedRectQuarter(dst, state->xform, cx, cy, hw, hh, -1, -1, rtl, fringe);
+		dst = nvg__roundedRectQuarter(dst, state->xform, cx, cy, hw, hh, 1, -1, rtr, fringe);
+		dst = nvg__roundedRectQuarter(dst, state->xform, cx, cy, hw, hh, 1, 1, rbr, fringe);
+		dst = nvg__roundedRectQuarter(dst, state->xform, cx, cy, hw, hh, -1, 1, rbl, fringe);
+	}
+	nverts = (int)(dst - verts);
+	if (nverts == 0) return;
+
+	// Solid color of the current fill style
+	paint = state->fill;
+	paint.image = 0;
+	paint.innerColor.a *= state->alpha;
+	paint.outerColor = paint.innerColor;
+
+	ctx->params.renderRoundedRects(ctx->params.userPtr, &paint, state->compositeOperation, &state->scissor, verts, nverts);
+
+	ctx->drawCallCount++;
+	ctx->fillTriCount += nverts/3;
+}
+
 // Add fonts
 int nvgCreateFont(NVGcontext* ctx, const char* name, const char* path)
 {
@@ -2496,6 +2878,53 @@ float nvgText(NVGcontext* ctx, float x, float y, const char* string, const char*
 	return iter.nextx / scale;
 }
 
+void nvgImageQuads(NVGcontext* ctx, int image, const float* quads, int nquads)
+{
+	NVGstate* state = nvg__getState(ctx);
+	NVGpaint paint;
+	NVGvertex* verts;
+	int i, iw, ih, nverts = 0;
+	float invw, invh;
+
+	if (nquads <= 0) return;
+
+	nvgImageSize(ctx, image, &iw, &ih);
+	if (iw <= 0 || ih <= 0) return;
+	invw = 1.0f / iw;
+	invh = 1.0f / ih;
+
+	verts = nvg__allocTempVerts(ctx, nquads * 6);
+	if (verts == NULL) return;
+
+	for (i = 0; i < nquads; i++) {
+		const float* q = &quads[i*8];
+		float c[4*2];
+		float s0 = q[4] * invw, t0 = q[5] * invh, s1 = q[6] * invw, t1 = q[7] * invh;
+		// Transform corners.
+		nvgTransformPoint(&c[0],&c[1], state->xform, q[0], q[1]);
+		nvgTransformPoint(&c[2],&c[3], state->xform, q[2], q[1]);
+		nvgTransformPoint(&c[4],&c[5], state->xform, q[2], q[3]);
+		nvgTransformPoint(&c[6],&c[7], state->xform, q[0], q[3]);
+		nvg__vset(&verts[nverts], c[0], c[1], s0, t0); nverts++;
+		nvg__vset(&verts[nverts], c[4], c[5], s1, t1); nverts++;
+		nvg__vset(&verts[nverts], c[2], c[3], s1, t0); nverts++;
+		nvg__vset(&verts[nverts], c[0], c[1], s0, t0); nverts++;
+		nvg__vset(&verts[nverts], c[6], c[7], s0, t1); nverts++;
+		nvg__vset(&verts[nverts], c[4], c[5], s1, t1); nverts++;
+	}
+
+	// The same path as text rendering, but the image colors are used as is
+	memset(&paint, 0, sizeof(paint));
+	nvgTransformIdentity(paint.xform);
+	paint.image = image;
+	paint.innerColor = paint.outerColor = nvgRGBAf(1, 1, 1, state->alpha);
+
+	ctx->params.renderTriangles(ctx->params.userPtr, &paint, state->compositeOperation, &state->scissor, verts, nverts);
+
+	ctx->drawCallCount++;
+	ctx->textTriCount += nverts/3;
+}
+
 void nvgTextBox(NVGcontext* ctx, float x, float y, float breakRowWidth, const char* string, const char* end)
 {
 	NVGstate* state = nvg__getState(ctx);
@@ -0,0 +1,286 @@
+#include "BatchMvxGenerator.h"
+#include <Logic/StringUtils.h>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <cstdio>
+
+using namespace CppUtils;
+namespace fs = std::filesystem;
+
+static const char* MIDI_EXTENSIONS[] = {".mid", ".midi"};
+static const char* INSTRUMENTAL_EXTENSIONS[] = {".mp3", ".m4a", ".aac", ".wav", ".ogg", ".flac"};
+static constexpr const char* LYRICS_FILE_NAME = "lyrics.txt";
+static constexpr const char* ARTIST_TITLE_SEPARATOR = " - ";
+static constexpr const char* MVX_EXTENSION = ".mvx";
+
+// Splits a manifest line into arguments, arguments containing spaces should be quoted
+static std::vector<std::string> splitArguments(const std::string& line) {
+    std::vector<std::string> result;
+    std::string current;
+    bool inQuotes = false;
+    bool hasArgument = false;
+    for (char ch : line) {
+        if (ch == '"') {
+            inQuotes = !inQuotes;
+            hasArgument = true;
+        } else if (!inQuotes && isspace(static_cast<unsigned char>(ch))) {
+            if (hasArgument) {
+                result.push_back(current);
+                current.clear();
+                hasArgument = false;
+            }
+        } else {
+            current.push_back(ch);
+            hasArgument = true;
+        }
+    }
+
+    if (hasArgument) {
+        result.push_back(current);
+    }
+
+    return result;
+}
+
+template <size_t N>
+static std::string findFileWithExtension(const fs::path& directory, const char* (&extensions)[N]) {
+    std::vector<std::string> found;
+    for (const auto& entry : fs::directory_iterator(directory)) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+
+        std::string extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (std::find(std::begin(extensions), std::end(extensions), extension) != std::end(extensions)) {
+            found.push_back(entry.path().string());
+        }
+    }
+
+    if (found.empty()) {
+        return std::string();
+    }
+
+    // Make the choice independent of the directory iteration order
+    return *std::min_element(found.begin(), found.end());
+}
+
+static void writeJsonString(std::ostream& os, const std::string& str) {
+    os << '"';
+    for (char ch : str) {
+        switch (ch) {
+            case '"':
+                os << "\\\"";
+                break;
+            case '\\':
+                os << "\\\\";
+                break;
+            case '\n':
+                os << "\\n";
+                break;
+            case '\r':
+                os << "\\r";
+                break;
+            case '\t':
+                os << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20) {
+                    char buffer[8];
+                    snprintf(buffer, sizeof(buffer), "\\u%04x", ch);
+                    os << buffer;
+                } else {
+                    os << ch;
+                }
+        }
+    }
+    os << '"';
+}
+
+BatchMvxGenerator::BatchMvxGenerator(int threadsCount) : threadsCount(threadsCount) {
+    if (this->threadsCount <= 0) {
+        this->threadsCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+}
+
+bool BatchMvxGenerator::loadManifest(const std::string& manifestFilePath, std::string* outError) {
+    std::ifstream is(manifestFilePath);
+    if (!is.is_open()) {
+        *outError = "Unable to open manifest " + manifestFilePath;
+        return false;
+    }
+
+    std::string baseDirectory = fs::absolute(manifestFilePath).parent_path().string();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(is, line)) {
+        lineNumber++;
+        std::vector<std::string> args = splitArguments(line);
+        if (args.empty() || args[0][0] == '#') {
+            continue;
+        }
+
+        MvxGenerationJob job;
+        std::string error;
+        if (!job.parseArguments(args, baseDirectory, &error)) {
+            *outError = manifestFilePath + ":" + std::to_string(lineNumber) + ": " + error;
+            return false;
+        }
+
+        jobs.push_back(job);
+    }
+
+    return true;
+}
+
+bool BatchMvxGenerator::loadSongsDirectory(const std::string& songsDirectory, const std::string& outputDirectory,
+        std::string* outError) {
+    std::error_code errorCode;
+    if (!fs::is_directory(songsDirectory, errorCode)) {
+        *outError = songsDirectory + " is not a directory";
+        return false;
+    }
+
+    fs::create_directories(outputDirectory, errorCode);
+    if (errorCode) {
+        *outError = "Unable to create " + outputDirectory + ": " + errorCode.message();
+        return false;
+    }
+
+    std::vector<fs::path> songDirectories;
+    for (const auto& entry : fs::directory_iterator(songsDirectory)) {
+        if (entry.is_directory()) {
+            songDirectories.push_back(entry.path());
+        }
+    }
+    std::sort(songDirectories.begin(), songDirectories.end());
+
+    for (const fs::path& songDirectory : songDirectories) {
+        std::string name = songDirectory.filename().string();
+        MvxGenerationJob job;
+        job.midiFilePath = findFileWithExtension(songDirectory, MIDI_EXTENSIONS);
+        job.instrumentalFilePath = findFileWithExtension(songDirectory, INSTRUMENTAL_EXTENSIONS);
+        if (job.midiFilePath.empty() || job.instrumentalFilePath.empty()) {
+            *outError = songDirectory.string() + " should contain a midi file and an instrumental";
+            return false;
+        }
+
+        fs::path lyricsPath = songDirectory / LYRICS_FILE_NAME;
+        if (fs::exists(lyricsPath)) {
+            job.lyricsFilePath = lyricsPath.string();
+        }
+
+        size_t separatorIndex = name.find(ARTIST_TITLE_SEPARATOR);
+        if (separatorIndex != std::string::npos) {
+            job.artistName = name.substr(0, separatorIndex);
+            job.title = name.substr(separatorIndex + strlen(ARTIST_TITLE_SEPARATOR));
+        } else {
+            job.title = name;
+        }
+
+        job.outputFilePath = (fs::path(outputDirectory) / (name + MVX_EXTENSION)).string();
+        jobs.push_back(job);
+    }
+
+    return true;
+}
+
+void BatchMvxGenerator::setSkipUnchanged(bool skipUnchanged) {
+    this->skipUnchanged = skipUnchanged;
+}
+
+void BatchMvxGenerator::run(std::ostream& progressStream) {
+    results.assign(jobs.size(), MvxGenerationResult());
+    std::atomic_int nextJobIndex(0);
+    std::mutex progressMutex;
+    int finishedCount = 0;
+    int jobsCount = static_cast<int>(jobs.size());
+
+    auto worker = [&] {
+        while (true) {
+            int index = nextJobIndex++;
+            if (index >= jobsCount) {
+                return;
+            }
+
+            MvxGenerationResult result = jobs[index].run(skipUnchanged, true);
+            std::lock_guard<std::mutex> _(progressMutex);
+            results[index] = result;
+            finishedCount++;
+            progressStream << "[" << finishedCount << "/" << jobsCount << "] "
+                    << MvxGenerationResult::statusToString(result.status) << " "
+                    << jobs[index].outputFilePath;
+            if (!result.error.empty()) {
+                progressStream << ": " << result.error;
+            }
+            progressStream << std::endl;
+        }
+    };
+
+    int workersCount = std::min(threadsCount, jobsCount);
+    std::vector<std::thread> threads;
+    for (int i = 1; i < workersCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    // The calling thread is used as one of the workers
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+const std::vector<MvxGenerationJob>& BatchMvxGenerator::getJobs() const {
+    return jobs;
+}
+
+const std::vector<MvxGenerationResult>& BatchMvxGenerator::getResults() const {
+    return results;
+}
+
+bool BatchMvxGenerator::hasFailures() const {
+    return std::any_of(results.begin(), results.end(), [] (const MvxGenerationResult& result) {
+        return result.status == MvxGenerationResult::FAILED;
+    });
+}
+
+void BatchMvxGenerator::writeReport(std::ostream& os) const {
+    int counts[MvxGenerationResult::FAILED + 1] = {0};
+    for (const auto& result : results) {
+        counts[result.status]++;
+    }
+
+    os << "{\n";
+    os << "  \"generated\": " << counts[MvxGenerationResult::GENERATED] << ",\n";
+    os << "  \"skipped\": " << counts[MvxGenerationResult::SKIPPED] << ",\n";
+    os << "  \"failed\": " << counts[MvxGenerationResult::FAILED] << ",\n";
+    os << "  \"jobs\": [";
+    for (int i = 0; i < results.size(); ++i) {
+        const MvxGenerationJob& job = jobs[i];
+        const MvxGenerationResult& result = results[i];
+        os << (i == 0 ? "\n" : ",\n") << "    {";
+        os << "\"output\": ";
+        writeJsonString(os, job.outputFilePath);
+        os << ", \"status\": \"" << MvxGenerationResult::statusToString(result.status) << "\"";
+        os << ", \"inputsHash\": ";
+        writeJsonString(os, result.inputsHash);
+        if (result.status == MvxGenerationResult::GENERATED) {
+            os << ", \"vocalPartDuration\": " << result.vocalPartDuration;
+            os << ", \"instrumentalDuration\": " << result.instrumentalDuration;
+            os << ", \"vocalPartDurationAdjusted\": " << (result.vocalPartDurationAdjusted ? "true" : "false");
+        }
+        os << ", \"elapsedSeconds\": " << result.elapsedSeconds;
+        if (!result.error.empty()) {
+            os << ", \"error\": ";
+            writeJsonString(os, result.error);
+        }
+        os << "}";
+    }
+    os << (results.empty() ? "]\n" : "\n  ]\n");
+    os << "}\n";
+}
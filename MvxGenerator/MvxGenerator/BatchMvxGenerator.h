@@ -0,0 +1,41 @@
+#ifndef MVXGENERATOR_BATCHMVXGENERATOR_H
+#define MVXGENERATOR_BATCHMVXGENERATOR_H
+
+#include "MvxGenerationJob.h"
+#include <string>
+#include <vector>
+#include <ostream>
+
+// Generates mvx files for a whole catalogue on a pool of worker threads.
+// Jobs can be loaded either from a manifest file, where every non-empty line contains the arguments
+// of a single file generation command, or from a directory of song folders.
+class BatchMvxGenerator {
+    std::vector<MvxGenerationJob> jobs;
+    std::vector<MvxGenerationResult> results;
+    int threadsCount;
+    bool skipUnchanged = true;
+public:
+    explicit BatchMvxGenerator(int threadsCount = 0);
+
+    // Lines starting with # are ignored. Relative paths are resolved against the manifest directory.
+    // Returns false and sets outError if the manifest is invalid.
+    bool loadManifest(const std::string& manifestFilePath, std::string* outError);
+    // Every subdirectory is a song folder with a .mid file, an instrumental audio file and an optional lyrics.txt.
+    // Folder name is used as the output file name and is parsed as "Artist - Title".
+    bool loadSongsDirectory(const std::string& songsDirectory, const std::string& outputDirectory, std::string* outError);
+
+    void setSkipUnchanged(bool skipUnchanged);
+
+    // Runs all the jobs, progress is printed to progressStream
+    void run(std::ostream& progressStream);
+
+    const std::vector<MvxGenerationJob>& getJobs() const;
+    const std::vector<MvxGenerationResult>& getResults() const;
+    bool hasFailures() const;
+
+    // Writes results as JSON
+    void writeReport(std::ostream& os) const;
+};
+
+
+#endif //MVXGENERATOR_BATCHMVXGENERATOR_H
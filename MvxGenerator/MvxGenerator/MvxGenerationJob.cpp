@@ -0,0 +1,235 @@
+#include "MvxGenerationJob.h"
+#include <Logic/MvxFile.h>
+#include <Logic/StringUtils.h>
+#include <Logic/MidiFileReader.h>
+#include <Logic/MidiFileReaderException.h>
+#include <Logic/audiodecoder.h>
+#include <Logic/StlContainerAudioDataBuffer.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <set>
+
+using namespace CppUtils;
+
+// The same tolerance is used by VocalTrainerFilePlayer::prepare
+static constexpr double MAX_DURATIONS_DIFFERENCE = 0.005;
+static constexpr const char* INPUTS_HASH_FILE_EXTENSION = ".inputshash";
+
+static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+static void appendToHash(uint64_t& hash, const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= FNV_PRIME;
+    }
+}
+
+static void appendToHash(uint64_t& hash, const std::string& value) {
+    uint64_t size = value.size();
+    // Prefix with size, so the concatenation of different fields can't produce the same hash
+    appendToHash(hash, reinterpret_cast<const char*>(&size), sizeof(size));
+    appendToHash(hash, value.data(), value.size());
+}
+
+static std::string readFile(const std::string& filePath) {
+    std::ifstream is(filePath, std::ios::binary | std::ios::in);
+    if (!is.is_open()) {
+        throw std::runtime_error("Unable to open " + filePath);
+    }
+
+    return Strings::StreamToString(is);
+}
+
+static std::string readTextFile(const std::string& filePath) {
+    std::ifstream is(filePath, std::ios::binary | std::ios::in);
+    if (!is.is_open()) {
+        return std::string();
+    }
+
+    return Strings::StreamToString(is);
+}
+
+const char* MvxGenerationResult::statusToString(Status status) {
+    switch (status) {
+        case GENERATED:
+            return "generated";
+        case SKIPPED:
+            return "skipped";
+        case FAILED:
+            return "failed";
+    }
+
+    return "unknown";
+}
+
+const char* MvxGenerationJob::getArgumentsTemplate() {
+    return "-o example.mvx "
+           "-midi midiExample.mid "
+           "-trackid midiTrackId(default 1) "
+           "-instrumental instrumental.mp3 "
+           "-lyrics lyrics.txt "
+           "-artistname artistName "
+           "-title title";
+}
+
+bool MvxGenerationJob::parseArguments(const std::vector<std::string>& args,
+        const std::string& baseDirectory, std::string* outError) {
+    std::set<std::string> argDefinitions {"-o", "-midi", "-trackid", "-instrumental", "-artistname", "-title", "-lyrics"};
+
+    auto resolvePath = [&] (const std::string& path) {
+        if (baseDirectory.empty() || path.empty() || std::filesystem::path(path).is_absolute()) {
+            return path;
+        }
+
+        return (std::filesystem::path(baseDirectory) / path).string();
+    };
+
+    for (int i = 0; i < args.size(); ++i) {
+        const std::string& argDefinition = args[i];
+        if (argDefinition.empty() || argDefinition[0] != '-' || !argDefinitions.count(argDefinition)) {
+            continue;
+        }
+
+        auto getDescription = [&] () -> std::string {
+            if (argDefinition[1] == 'o') {
+                return "output file path";
+            } else {
+                return Strings::RemovePrefix(argDefinition, 1);
+            }
+        };
+
+        if (i == args.size() - 1 || argDefinitions.count(args[i + 1])) {
+            *outError = "Please specify " + getDescription();
+            return false;
+        }
+
+        std::string arg = Strings::Unquote(args[++i]);
+
+        if (argDefinition == "-o") {
+            outputFilePath = resolvePath(arg);
+        } else if (argDefinition == "-midi") {
+            midiFilePath = resolvePath(arg);
+        } else if (argDefinition == "-trackid") {
+            midiTrackId = Strings::TryParseInt(arg, 1);
+        } else if (argDefinition == "-instrumental") {
+            instrumentalFilePath = resolvePath(arg);
+        } else if (argDefinition == "-artistname") {
+            artistName = arg;
+        } else if (argDefinition == "-title") {
+            title = arg;
+        } else if (argDefinition == "-lyrics") {
+            lyricsFilePath = resolvePath(arg);
+        }
+    }
+
+    if (outputFilePath.empty()) {
+        *outError = "Please specify output file path using -o command";
+        return false;
+    }
+
+    if (instrumentalFilePath.empty()) {
+        *outError = "instrumental is missing";
+        return false;
+    }
+
+    return true;
+}
+
+std::string MvxGenerationJob::getInputsHashFilePath() const {
+    return outputFilePath + INPUTS_HASH_FILE_EXTENSION;
+}
+
+MvxGenerationResult MvxGenerationJob::run(bool skipUnchanged, bool writeInputsHash) const {
+    auto startTime = std::chrono::steady_clock::now();
+    MvxGenerationResult result;
+    auto finish = [&] (MvxGenerationResult::Status status) {
+        result.status = status;
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+        result.elapsedSeconds = elapsed.count();
+        return result;
+    };
+
+    try {
+        // Every input is read only once, the same data is used both for hashing and generation
+        std::string midiData = readFile(midiFilePath);
+        std::string instrumentalData = readFile(instrumentalFilePath);
+        std::string lyricsData = lyricsFilePath.empty() ? std::string() : readFile(lyricsFilePath);
+
+        uint64_t hash = FNV_OFFSET_BASIS;
+        // Outputs should be regenerated after format changes
+        appendToHash(hash, std::to_string(MvxFile::VERSION));
+        appendToHash(hash, midiData);
+        appendToHash(hash, instrumentalData);
+        appendToHash(hash, lyricsData);
+        appendToHash(hash, std::to_string(midiTrackId));
+        appendToHash(hash, title);
+        appendToHash(hash, artistName);
+        std::stringstream hashStream;
+        hashStream << std::hex << std::setw(16) << std::setfill('0') << hash;
+        result.inputsHash = hashStream.str();
+
+        if (skipUnchanged && std::filesystem::exists(outputFilePath) &&
+                readTextFile(getInputsHashFilePath()) == result.inputsHash) {
+            return finish(MvxGenerationResult::SKIPPED);
+        }
+
+        MidiFileReader reader;
+        std::stringstream midiStream(midiData);
+        if (!reader.read(midiStream)) {
+            result.error = "Broken or missing midi file, generating .mvx file failed";
+            return finish(MvxGenerationResult::FAILED);
+        }
+
+        VocalPart vocalPart;
+        try {
+            vocalPart = reader.tryGetVocalPartFromMidiTrackWithId(midiTrackId);
+        } catch (MidiFileReaderException& e) {
+            result.error = std::string("Failed to parse midi file: ") + e.what();
+            return finish(MvxGenerationResult::FAILED);
+        }
+
+        MvxFile mvxFile;
+        mvxFile.setArtistNameUtf8(artistName);
+        mvxFile.setSongTitleUtf8(title);
+        mvxFile.setInstrumental(AudioDataBufferConstPtr(new StdStringAudioDataBuffer(std::move(instrumentalData))));
+        mvxFile.setBeatsPerMinute(reader.getBeatsPerMinute());
+        mvxFile.setOriginalTonality(reader.getTonality());
+        mvxFile.setTimeSignature(reader.getTimeSignature());
+
+        // Validate durations using the decoder metadata, no need to prepare the players
+        {
+            std::unique_ptr<AudioDecoder> decoder(AudioDecoder::create());
+            decoder->open(mvxFile.getInstrumental());
+            result.instrumentalDuration = decoder->duration();
+        }
+        result.vocalPartDuration = vocalPart.getDurationInSeconds();
+        if (fabs(result.instrumentalDuration - result.vocalPartDuration) > MAX_DURATIONS_DIFFERENCE) {
+            vocalPart = vocalPart.cutOrExpand(0, result.instrumentalDuration);
+            result.vocalPartDurationAdjusted = true;
+        }
+        mvxFile.setVocalPart(vocalPart);
+
+        if (!lyricsFilePath.empty()) {
+            mvxFile.setLyrics(Lyrics(lyricsData, &vocalPart));
+        }
+
+        mvxFile.generateInstrumentalPreviewSamplesFromInstrumental();
+        mvxFile.writeToFile(outputFilePath.data());
+
+        if (writeInputsHash) {
+            std::ofstream hashFile(getInputsHashFilePath(), std::ios::out | std::ios::trunc);
+            hashFile << result.inputsHash;
+        }
+
+        return finish(MvxGenerationResult::GENERATED);
+    } catch (std::exception& e) {
+        result.error = e.what();
+        return finish(MvxGenerationResult::FAILED);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef MVXGENERATOR_MVXGENERATIONJOB_H
+#define MVXGENERATOR_MVXGENERATIONJOB_H
+
+#include <string>
+#include <vector>
+
+struct MvxGenerationResult {
+    enum Status {
+        GENERATED,
+        // Output exists and its inputs haven't changed since it was generated
+        SKIPPED,
+        FAILED
+    };
+
+    Status status = FAILED;
+    std::string error;
+    std::string inputsHash;
+    double vocalPartDuration = 0;
+    double instrumentalDuration = 0;
+    // Vocal part has been cut/expanded to match instrumental duration
+    bool vocalPartDurationAdjusted = false;
+    double elapsedSeconds = 0;
+
+    static const char* statusToString(Status status);
+};
+
+struct MvxGenerationJob {
+    std::string outputFilePath;
+    std::string midiFilePath;
+    std::string instrumentalFilePath;
+    std::string lyricsFilePath;
+    std::string title;
+    std::string artistName;
+    int midiTrackId = 1;
+
+    // Parses the arguments in the format of a single file generation command,
+    // relative paths are resolved against baseDirectory if it's not empty.
+    // Returns false and sets outError if the arguments are invalid.
+    bool parseArguments(const std::vector<std::string>& args, const std::string& baseDirectory, std::string* outError);
+
+    // Generates the mvx file. When skipUnchanged is true and the output has been generated from the inputs
+    // with the same content hash, the generation is skipped. The inputs hash file is written next to the output
+    // only when writeInputsHash is true. Never throws, errors are returned in the result.
+    MvxGenerationResult run(bool skipUnchanged, bool writeInputsHash) const;
+
+    static const char* getArgumentsTemplate();
+    // Path of the file with the inputs hash, stored next to the output
+    std::string getInputsHashFilePath() const;
+};
+
+
+#endif //MVXGENERATOR_MVXGENERATIONJOB_H
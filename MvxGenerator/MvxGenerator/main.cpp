@@ -1,163 +1,125 @@
 #include <iostream>
+#include <fstream>
 #include <Logic/MvxFile.h>
 #include <Logic/StringUtils.h>
-#include <Logic/MidiFileReader.h>
-#include <Logic/Maps.h>
-#include <map>
-#include <set>
-#include <Logic/MidiFileReaderException.h>
-#include <Logic/MvxFile.h>
-#include <Logic/VocalTrainerFilePlayer.h>
-#include <Logic/VocalTrainerPlayerPrepareException.h>
-#include <Logic/ApplicationModel.h>
+#include <vector>
+#include "MvxGenerationJob.h"
+#include "BatchMvxGenerator.h"
 
 using std::cout;
 using std::cerr;
 using std::endl;
 using namespace CppUtils;
 
-int main(int argc, char *argv[]) {
-    const char * templateString = "The command arguments should be in the following format: "
-                                  "-o example.mvx "
-                                  "-midi midiExample.mid "
-                                  "-trackid midiTrackId(default 1) "
-                                  "-instrumental instrumental.mp3 "
-                                  "-lyrics lyrics.txt "
-                                  "-artistname artistName "
-                                  "-title title\n";
-    if (argc == 0) {
-        cout << templateString;
-        return -1;
-    }
-
-    if (argc == 2 && std::string(argv[1]) == "--help") {
-        cout << templateString << endl;
-        return 0;
+static int runBatch(const std::vector<std::string>& args) {
+    std::string manifestFilePath, songsDirectory, outputDirectory, reportFilePath;
+    int threadsCount = 0;
+    bool force = false;
+    for (int i = 0; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        bool hasValue = i < args.size() - 1;
+        if (arg == "-force") {
+            force = true;
+        } else if (!hasValue) {
+            cerr << "Please specify value for " << arg << endl;
+            return -1;
+        } else if (arg == "-manifest") {
+            manifestFilePath = Strings::Unquote(args[++i]);
+        } else if (arg == "-songs") {
+            songsDirectory = Strings::Unquote(args[++i]);
+        } else if (arg == "-outdir") {
+            outputDirectory = Strings::Unquote(args[++i]);
+        } else if (arg == "-report") {
+            reportFilePath = Strings::Unquote(args[++i]);
+        } else if (arg == "-j") {
+            threadsCount = Strings::TryParseInt(args[++i], 0);
+        }
     }
 
-    std::string outputFilepath, midiFilepath, instrumentalFilePath, lyricsFilePath;
-    std::string title, artistName;
-    int midiTrackId;
-
-    std::set<std::string> argDefinitions {"-o", "-midi", "-trackid", "-instrumental", "-artistname", "-title", "-lyrics"};
-
-    for (int i = 1; i < argc; ++i) {
-        std::string argDefinition(argv[i]);
-        if (argDefinition[0] != '-' || !argDefinitions.count(argDefinition)) {
-            continue;
+    BatchMvxGenerator generator(threadsCount);
+    generator.setSkipUnchanged(!force);
+    std::string error;
+    if (!manifestFilePath.empty()) {
+        if (!generator.loadManifest(manifestFilePath, &error)) {
+            cerr << error << endl;
+            return -1;
         }
-
-        auto getDescription = [&] () -> std::string {
-            if (argDefinition[1] == 'o') {
-                return "output file path";
-            } else {
-                return Strings::RemovePrefix(argDefinition, 1);
-            }
-        };
-
-        if (i == argc - 1) {
-            cerr << "Please specify " << getDescription();
+    } else if (!songsDirectory.empty()) {
+        if (outputDirectory.empty()) {
+            cerr << "Please specify output directory using -outdir command\n";
             return -1;
         }
 
-        std::string arg = argv[++i];
-
-        if (argDefinitions.count(arg)) {
-            cerr << "Please specify " << getDescription();
+        if (!generator.loadSongsDirectory(songsDirectory, outputDirectory, &error)) {
+            cerr << error << endl;
             return -1;
         }
+    } else {
+        cerr << "Please specify either -manifest or -songs for batch mode\n";
+        return -1;
+    }
 
-        if (argDefinition == "-o") {
-            outputFilepath = Strings::Unquote(arg);
-        } else if (argDefinition == "-midi") {
-            midiFilepath = Strings::Unquote(arg);
-        } else if (argDefinition == "-trackid") {
-            midiTrackId = Strings::TryParseInt(argDefinition, 1);
-        } else if (argDefinition == "-instrumental") {
-            instrumentalFilePath = Strings::Unquote(arg);
-        } else if (argDefinition == "-artistname") {
-            artistName = Strings::Unquote(arg);
-        } else if (argDefinition == "-title") {
-            title = Strings::Unquote(arg);
-        } else if (argDefinition == "-lyrics") {
-            lyricsFilePath = Strings::Unquote(arg);
-        }
+    // Keep stdout clean for the report, when it is not written to a file
+    generator.run(reportFilePath.empty() ? cerr : cout);
+
+    if (reportFilePath.empty()) {
+        generator.writeReport(cout);
+    } else {
+        std::ofstream report(reportFilePath, std::ios::out | std::ios::trunc);
+        generator.writeReport(report);
     }
 
-    if (outputFilepath.empty()) {
-        cerr << "Please specify output file path using -o command\n";
+    return generator.hasFailures() ? -1 : 0;
+}
+
+int main(int argc, char *argv[]) {
+    std::string templateString = std::string("The command arguments should be in the following format: ") +
+            MvxGenerationJob::getArgumentsTemplate() + "\n"
+            "Batch mode: -batch (-manifest manifest.txt | -songs songsDirectory -outdir outputDirectory) "
+            "[-j threadsCount] [-report report.json] [-force]\n"
+            "Every manifest line contains the arguments in the single file format. "
+            "Outputs, whose inputs haven't changed, are skipped unless -force is specified\n";
+    if (argc <= 1) {
+        cout << templateString;
         return -1;
     }
 
-    MidiFileReader reader;
-    if (!reader.read(midiFilepath)) {
-        cerr << "Broken or missing midi file, generating .mvx file failed\n";
-        return -1;
+    if (argc == 2 && std::string(argv[1]) == "--help") {
+        cout << templateString << endl;
+        return 0;
     }
-    double beatsPerMinute = reader.getBeatsPerMinute();
 
-    VocalPart vocalPart;
-    try {
-        vocalPart = reader.tryGetVocalPartFromMidiTrackWithId(midiTrackId);
-    } catch (MidiFileReaderException& e) {
-        cerr << "Failed to parse midi file: " << e.what() << endl;
-        return -1;
+    std::vector<std::string> args(argv + 1, argv + argc);
+    if (args[0] == "-batch") {
+        return runBatch(std::vector<std::string>(args.begin() + 1, args.end()));
     }
 
-    if (instrumentalFilePath.empty()) {
-        cerr << "instrumental is missing\n";
+    MvxGenerationJob job;
+    std::string error;
+    if (!job.parseArguments(args, std::string(), &error)) {
+        cerr << error << endl;
         return -1;
     }
 
-    MvxFile mvxFile;
-    mvxFile.setVocalPart(vocalPart);
-    mvxFile.setArtistNameUtf8(artistName);
-    mvxFile.setSongTitleUtf8(title);
-    mvxFile.loadInstrumentalFromFile(instrumentalFilePath.data());
-    mvxFile.setBeatsPerMinute(beatsPerMinute);
-    mvxFile.generateInstrumentalPreviewSamplesFromInstrumental();
-
-    Tonality tonality = reader.getTonality();
-    mvxFile.setOriginalTonality(tonality);
-    TimeSignature timeSignature = reader.getTimeSignature();
-    mvxFile.setTimeSignature(timeSignature);
-
-    if (!lyricsFilePath.empty()) {
-        mvxFile.loadLyricsFromFile(lyricsFilePath.data());
+    // The inputs hash is used by the batch mode only, no sidecar file is left next to a single output
+    MvxGenerationResult result = job.run(false, false);
+    if (result.status == MvxGenerationResult::FAILED) {
+        cerr << result.error << endl;
+        return -1;
     }
 
-    ApplicationModel::init();
-    VocalTrainerFilePlayer* player = ApplicationModel::instance()->createPlayer();
-    player->setSource(
-            &mvxFile,
-            false //destroyFileOnDestructor
-    );
-
-    try {
-        player->prepare();
-    } catch (VocalTrainerPlayerPrepareException& e) {
-        if (e.getReason() == VocalTrainerPlayerPrepareException::DIFFERENT_DURATIONS) {
-            double vocalPartDuration = vocalPart.getDurationInSeconds();
-            double instrumentalDuration = player->getInstrumentalPlayer().getOriginalTrackDurationInSeconds();
-            vocalPart = vocalPart.cutOrExpand(0, instrumentalDuration);
-            mvxFile.setVocalPart(vocalPart);
-            cout << "Vocal part has duration "
-                << vocalPartDuration
-                <<". Instrumental has duration "
-                << instrumentalDuration
-                << ". Vocal part has been cut/modified to match instrumental duration\n";
-        } else {
-            cout << e.what() << endl;
-            return -1;
-        }
+    if (result.vocalPartDurationAdjusted) {
+        cout << "Vocal part has duration "
+            << result.vocalPartDuration
+            <<". Instrumental has duration "
+            << result.instrumentalDuration
+            << ". Vocal part has been cut/modified to match instrumental duration\n";
     }
 
-    mvxFile.writeToFile(outputFilepath.data());
-
-    std::fstream f = Streams::OpenFile(outputFilepath.data(), std::ios::in | std::ios::binary);
+    std::fstream f = Streams::OpenFile(job.outputFilePath.data(), std::ios::in | std::ios::binary);
     VocalTrainerFile::read(f);
 
-    cout << "mvx file has been created: " << outputFilepath << endl;
+    cout << "mvx file has been created: " << job.outputFilePath << endl;
 
     return 0;
 }
@@ -0,0 +1,638 @@
+#define _USE_MATH_DEFINES
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <chrono>
+#include <random>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <iomanip>
+#include "PitchDetectorFactory.h"
+#include "PitchDetectionSmoothingAudioBuffer.h"
+#include "VoicingGate.h"
+#include "Decimator.h"
+#include "StringUtils.h"
+
+// Runs the pitch detectors on a synthesized labelled corpus the way PitchInputReader does: the audio comes in
+// pieces of the buffer size, optionally decimated, the last smooth level pieces are analyzed together. Reports per
+// engine, buffer size, smooth level and decimation factor:
+//  GPE - gross pitch error, share of the voiced frames detected as voiced with an error above 50 cents
+//  fine - mean error of the other voiced frames, in cents
+//  voicing - share of the frames with the voicing detected correctly
+//  onset - time from a note start to the first correct detection, the missed onsets are reported separately
+//  ns/frame - time of a detector call
+//  skipped - share of the frames skipped by the voicing gate, with -gate 1
+// Frames analyzing the end of one note and the beginning of another are not counted in GPE, fine and voicing.
+// Usage: PitchDetectorBenchmark [-engines yin,mpm,pyin] [-bufferSizes 512,1024,2048] [-smoothLevels 1,2,4]
+//         [-decimations 1,2,4] [-sampleRate 44100] [-settings name=value,...] [-repeats 3] [-details 1] [-gate 1]
+//         [-csv path] [-baseline path]
+// -settings are given to every engine, so they should be used with a single engine.
+// Every signal is detected -repeats times by a new detector, the fastest run is reported.
+// -gate 1 runs VoicingGate before the detector as PitchInputReader does, ns/frame includes the gate time then.
+// -csv saves the results of every signal and of the whole corpus as "all". -baseline compares the results with
+// the csv saved before, e.g. by the previous commit, and fails if the accuracy got worse. Its speed column is
+// the baseline time divided by the current one.
+
+using std::cout;
+using std::cerr;
+using std::endl;
+using namespace CppUtils;
+
+static constexpr float GROSS_ERROR_CENTS = 50;
+static constexpr float AMPLITUDE = 8000;
+// Accuracy changes the baseline comparison tolerates
+static constexpr double GPE_TOLERANCE = 0.005;
+static constexpr double FINE_ERROR_TOLERANCE_CENTS = 1;
+static constexpr double VOICING_TOLERANCE = 0.005;
+
+struct Signal {
+    std::string name;
+    std::vector<int16_t> samples;
+    // Hz of every sample, 0 if unvoiced
+    std::vector<float> frequencies;
+    // Sample indexes where the notes begin, frames covering one of them are analyzing two notes
+    std::vector<int> boundaries;
+};
+
+enum class Timbre {
+    PURE,
+    // Decaying harmonics shaped by two formants
+    VOICE
+};
+
+class SignalBuilder {
+    Signal signal;
+    int sampleRate;
+    double phase = 0;
+
+    float getHarmonicAmplitude(Timbre timbre, int harmonic, float frequency) const {
+        if (timbre == Timbre::PURE) {
+            return harmonic == 1 ? 1.0f : 0.0f;
+        }
+
+        float harmonicFrequency = harmonic * frequency;
+        if (harmonicFrequency > sampleRate * 0.45f) {
+            return 0;
+        }
+
+        auto formant = [=] (float center, float width) {
+            float distance = (harmonicFrequency - center) / width;
+            return expf(-0.5f * distance * distance);
+        };
+        return 0.3f / harmonic + formant(600, 300) + 0.5f * formant(1500, 400);
+    }
+
+public:
+    SignalBuilder(const std::string& name, int sampleRate) : sampleRate(sampleRate) {
+        signal.name = name;
+    }
+
+    // frequency is the function of the time since the note start
+    void addNote(double seconds, const std::function<float(double)>& frequency, Timbre timbre = Timbre::VOICE) {
+        signal.boundaries.push_back(int(signal.samples.size()));
+        int count = int(seconds * sampleRate);
+        // Short fades, so the notes don't click
+        int fadeCount = sampleRate / 200;
+        for (int i = 0; i < count; ++i) {
+            float noteFrequency = frequency(double(i) / sampleRate);
+            phase += 2 * M_PI * noteFrequency / sampleRate;
+            double value = 0;
+            double normalization = 0;
+            for (int harmonic = 1; harmonic <= 16; ++harmonic) {
+                float amplitude = getHarmonicAmplitude(timbre, harmonic, noteFrequency);
+                value += amplitude * sin(harmonic * phase);
+                normalization += amplitude;
+            }
+
+            double fade = std::min(1.0, std::min(i, count - 1 - i) / double(fadeCount));
+            signal.samples.push_back(static_cast<int16_t>(value / normalization * AMPLITUDE * fade));
+            signal.frequencies.push_back(noteFrequency);
+        }
+    }
+
+    void addNote(double seconds, float frequency, Timbre timbre = Timbre::VOICE) {
+        addNote(seconds, [=] (double) {
+            return frequency;
+        }, timbre);
+    }
+
+    void addSilence(double seconds, float noiseAmplitude = 0) {
+        signal.boundaries.push_back(int(signal.samples.size()));
+        std::mt19937 random(int(signal.samples.size()));
+        std::normal_distribution<float> distribution(0, noiseAmplitude);
+        int count = int(seconds * sampleRate);
+        for (int i = 0; i < count; ++i) {
+            signal.samples.push_back(static_cast<int16_t>(noiseAmplitude > 0 ? distribution(random) : 0));
+            signal.frequencies.push_back(0);
+        }
+        phase = 0;
+    }
+
+    // White noise relative to the power of the voiced samples
+    void addNoise(float snrInDb) {
+        double power = 0;
+        int voicedCount = 0;
+        for (int i = 0; i < signal.samples.size(); ++i) {
+            if (signal.frequencies[i] > 0) {
+                power += double(signal.samples[i]) * signal.samples[i];
+                voicedCount++;
+            }
+        }
+
+        double noiseDeviation = sqrt(power / std::max(1, voicedCount) / pow(10.0, snrInDb / 10));
+        std::mt19937 random(int(snrInDb * 100));
+        std::normal_distribution<double> distribution(0, noiseDeviation);
+        for (int16_t& sample : signal.samples) {
+            double value = sample + distribution(random);
+            sample = static_cast<int16_t>(std::max(-32768.0, std::min(32767.0, value)));
+        }
+    }
+
+    Signal build() {
+        std::sort(signal.boundaries.begin(), signal.boundaries.end());
+        signal.boundaries.erase(std::unique(signal.boundaries.begin(), signal.boundaries.end()),
+                signal.boundaries.end());
+        return signal;
+    }
+};
+
+static std::vector<Signal> createCorpus(int sampleRate) {
+    std::vector<Signal> corpus;
+    const std::vector<float> notes = {98.0f, 146.8f, 196.0f, 261.6f, 392.0f, 523.3f, 784.0f};
+
+    SignalBuilder pure("pure", sampleRate);
+    for (float frequency : notes) {
+        pure.addNote(0.5, frequency, Timbre::PURE);
+    }
+    corpus.push_back(pure.build());
+
+    auto addVoiceNotes = [&] (SignalBuilder& builder) {
+        for (float frequency : notes) {
+            builder.addNote(0.5, frequency);
+        }
+    };
+    SignalBuilder voice("voice", sampleRate);
+    addVoiceNotes(voice);
+    corpus.push_back(voice.build());
+
+    SignalBuilder vibrato("vibrato", sampleRate);
+    for (float frequency : {196.0f, 440.0f}) {
+        // 5.5 Hz, +-40 cents
+        vibrato.addNote(1.5, [=] (double time) {
+            return frequency * powf(2.0f, 40.0f / 1200 * float(sin(2 * M_PI * 5.5 * time)));
+        });
+    }
+    corpus.push_back(vibrato.build());
+
+    SignalBuilder glide("glide", sampleRate);
+    // Three octaves up in 3 seconds
+    glide.addNote(3, [] (double time) {
+        return 110.0f * powf(2.0f, float(time));
+    });
+    corpus.push_back(glide.build());
+
+    SignalBuilder octaveJumps("octaveJumps", sampleRate);
+    for (int i = 0; i < 8; ++i) {
+        octaveJumps.addNote(0.4, i % 2 ? 300.0f : 150.0f);
+    }
+    corpus.push_back(octaveJumps.build());
+
+    SignalBuilder gaps("gaps", sampleRate);
+    for (float frequency : notes) {
+        gaps.addNote(0.4, frequency);
+        gaps.addSilence(0.2);
+    }
+    corpus.push_back(gaps.build());
+
+    for (float snr : {20.0f, 10.0f, 5.0f, 0.0f}) {
+        SignalBuilder noisy("noise" + std::to_string(int(snr)) + "dB", sampleRate);
+        addVoiceNotes(noisy);
+        noisy.addNoise(snr);
+        corpus.push_back(noisy.build());
+    }
+
+    SignalBuilder silence("silence", sampleRate);
+    silence.addSilence(1);
+    // -50 dBFS noise floor
+    silence.addSilence(1, 32768 * 0.00316f);
+    corpus.push_back(silence.build());
+
+    return corpus;
+}
+
+struct Result {
+    int framesCount = 0;
+    int evaluatedFramesCount = 0;
+    int correctVoicingCount = 0;
+    int bothVoicedCount = 0;
+    int grossErrorsCount = 0;
+    double fineErrorSum = 0;
+    int onsetsCount = 0;
+    int missedOnsetsCount = 0;
+    double onsetLatencySum = 0;
+    int skippedFramesCount = 0;
+    double detectionNanoseconds = 0;
+
+    void add(const Result& other) {
+        framesCount += other.framesCount;
+        evaluatedFramesCount += other.evaluatedFramesCount;
+        correctVoicingCount += other.correctVoicingCount;
+        bothVoicedCount += other.bothVoicedCount;
+        grossErrorsCount += other.grossErrorsCount;
+        fineErrorSum += other.fineErrorSum;
+        onsetsCount += other.onsetsCount;
+        missedOnsetsCount += other.missedOnsetsCount;
+        onsetLatencySum += other.onsetLatencySum;
+        skippedFramesCount += other.skippedFramesCount;
+        detectionNanoseconds += other.detectionNanoseconds;
+    }
+
+    double getGrossPitchError() const {
+        return bothVoicedCount > 0 ? double(grossErrorsCount) / bothVoicedCount : 0;
+    }
+
+    double getFineErrorInCents() const {
+        int count = bothVoicedCount - grossErrorsCount;
+        return count > 0 ? fineErrorSum / count : 0;
+    }
+
+    double getVoicingAccuracy() const {
+        return evaluatedFramesCount > 0 ? double(correctVoicingCount) / evaluatedFramesCount : 0;
+    }
+
+    double getOnsetLatencyInMilliseconds() const {
+        int count = onsetsCount - missedOnsetsCount;
+        return count > 0 ? onsetLatencySum / count * 1000 : 0;
+    }
+
+    double getSkippedFramesShare() const {
+        return framesCount > 0 ? double(skippedFramesCount) / framesCount : 0;
+    }
+
+    double getNanosecondsPerFrame() const {
+        return framesCount > 0 ? detectionNanoseconds / framesCount : 0;
+    }
+};
+
+struct Configuration {
+    std::string engine;
+    int bufferSize;
+    int smoothLevel;
+    int decimationFactor;
+    bool gate;
+};
+
+static float getCents(float frequency, float expected) {
+    return fabsf(1200 * log2f(frequency / expected));
+}
+
+static Result runSignal(PitchDetector* detector, const Configuration& configuration, const Signal& signal,
+        int sampleRate) {
+    Result result;
+    Decimator decimator(configuration.decimationFactor);
+    std::vector<int16_t> decimatedPiece(size_t(decimator.getMaxOutputSize(configuration.bufferSize)));
+    PitchDetectionSmoothingAudioBuffer smoothingAudioBuffer(size_t(configuration.smoothLevel),
+            decimatedPiece.size());
+    // In the input samples
+    int windowSize = configuration.bufferSize * configuration.smoothLevel;
+    VoicingGate gate;
+    gate.init(sampleRate, configuration.smoothLevel);
+
+    // Onsets of the voiced notes, waiting for the first correct detection
+    std::vector<int> onsets;
+    for (int boundary : signal.boundaries) {
+        if (signal.frequencies[boundary] > 0) {
+            onsets.push_back(boundary);
+        }
+    }
+    result.onsetsCount = int(onsets.size());
+    std::vector<bool> onsetDetected(onsets.size(), false);
+
+    int samplesCount = int(signal.samples.size());
+    for (int end = configuration.bufferSize; end <= samplesCount; end += configuration.bufferSize) {
+        const int16_t* piece = signal.samples.data() + end - configuration.bufferSize;
+        auto begin = std::chrono::steady_clock::now();
+        bool voiceMayBePresent = !configuration.gate || gate.process(piece, configuration.bufferSize);
+        int pieceSize = decimator.process(piece, configuration.bufferSize, decimatedPiece.data());
+        double frontEndNanoseconds = std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now() - begin).count();
+        const int16_t* buffer = smoothingAudioBuffer.getRunPitchDetectionBufferIfReady(
+                decimatedPiece.data(), size_t(pieceSize));
+        if (!buffer) {
+            continue;
+        }
+
+        begin = std::chrono::steady_clock::now();
+        float frequency = -1;
+        if (voiceMayBePresent) {
+            frequency = detector->getFrequencyFromBuffer(buffer);
+        } else {
+            result.skippedFramesCount++;
+        }
+        result.detectionNanoseconds += frontEndNanoseconds + std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now() - begin).count();
+        result.framesCount++;
+        bool voiced = frequency > 0;
+
+        // The latest note, the window may still contain the previous one. The note frequency is taken at the window
+        // center, or at the note start if the note began after it, so a glide is expected where it is analyzed.
+        int windowBegin = end - windowSize;
+        auto onset = std::upper_bound(onsets.begin(), onsets.end(), end - 1);
+        if (onset != onsets.begin()) {
+            size_t onsetIndex = onset - onsets.begin() - 1;
+            float expected = signal.frequencies[std::max(onsets[onsetIndex], windowBegin + windowSize / 2)];
+            if (!onsetDetected[onsetIndex] && expected > 0 && voiced &&
+                    getCents(frequency, expected) <= GROSS_ERROR_CENTS) {
+                onsetDetected[onsetIndex] = true;
+                result.onsetLatencySum += double(end - onsets[onsetIndex]) / sampleRate;
+            }
+        }
+
+        auto boundary = std::upper_bound(signal.boundaries.begin(), signal.boundaries.end(), windowBegin);
+        if (boundary != signal.boundaries.end() && *boundary < end) {
+            continue;
+        }
+
+        result.evaluatedFramesCount++;
+        float expected = signal.frequencies[windowBegin + windowSize / 2];
+        bool expectedVoiced = expected > 0;
+        if (voiced == expectedVoiced) {
+            result.correctVoicingCount++;
+        }
+        if (voiced && expectedVoiced) {
+            result.bothVoicedCount++;
+            float cents = getCents(frequency, expected);
+            if (cents > GROSS_ERROR_CENTS) {
+                result.grossErrorsCount++;
+            } else {
+                result.fineErrorSum += cents;
+            }
+        }
+    }
+
+    for (bool detected : onsetDetected) {
+        if (!detected) {
+            result.missedOnsetsCount++;
+        }
+    }
+
+    return result;
+}
+
+static std::vector<int> parseIntList(const std::string& string) {
+    std::vector<int> result;
+    std::stringstream stream(string);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        int value = Strings::TryParseInt(item, 0);
+        if (value > 0) {
+            result.push_back(value);
+        }
+    }
+    return result;
+}
+
+static std::vector<std::string> parseStringList(const std::string& string) {
+    std::vector<std::string> result;
+    std::stringstream stream(string);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            result.push_back(item);
+        }
+    }
+    return result;
+}
+
+static const char* CSV_HEADER = "engine,bufferSize,smoothLevel,decimation,signal,frames,evaluatedFrames,grossPitchError,"
+        "fineErrorCents,voicingAccuracy,onsetLatencyMs,missedOnsets,nsPerFrame";
+
+static void writeCsvRow(std::ostream& os, const Configuration& configuration, const std::string& signalName,
+        const Result& result) {
+    os << configuration.engine << "," << configuration.bufferSize << "," << configuration.smoothLevel << ","
+            << configuration.decimationFactor << "," << signalName << "," << result.framesCount << "," << result.evaluatedFramesCount << ","
+            << result.getGrossPitchError() << "," << result.getFineErrorInCents() << ","
+            << result.getVoicingAccuracy() << "," << result.getOnsetLatencyInMilliseconds() << ","
+            << result.missedOnsetsCount << "," << result.getNanosecondsPerFrame() << "\n";
+}
+
+struct BaselineRow {
+    double grossPitchError;
+    double fineErrorInCents;
+    double voicingAccuracy;
+    double nanosecondsPerFrame;
+};
+
+// Rows of the whole corpus, keyed by "engine,bufferSize,smoothLevel,decimation". The csv saved before the
+// decimation column was added is read as not decimated.
+static std::map<std::string, BaselineRow> readBaseline(std::istream& is) {
+    std::map<std::string, BaselineRow> result;
+    std::string line;
+    std::getline(is, line);
+    while (std::getline(is, line)) {
+        std::vector<std::string> columns;
+        std::stringstream stream(line);
+        std::string column;
+        while (std::getline(stream, column, ',')) {
+            columns.push_back(column);
+        }
+        if (columns.size() == 12) {
+            columns.insert(columns.begin() + 3, "1");
+        }
+        if (columns.size() != 13 || columns[4] != "all") {
+            continue;
+        }
+
+        BaselineRow row;
+        row.grossPitchError = atof(columns[7].c_str());
+        row.fineErrorInCents = atof(columns[8].c_str());
+        row.voicingAccuracy = atof(columns[9].c_str());
+        row.nanosecondsPerFrame = atof(columns[12].c_str());
+        result[columns[0] + "," + columns[1] + "," + columns[2] + "," + columns[3]] = row;
+    }
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    std::vector<std::string> engines = PitchDetectorFactory::getEngineNames();
+    std::vector<int> bufferSizes = {512, 1024, 2048};
+    std::vector<int> smoothLevels = {1, 2, 4};
+    std::vector<int> decimationFactors = {1};
+    int sampleRate = 44100;
+    int repeatsCount = 3;
+    std::string settingsString;
+    bool details = false;
+    bool gate = false;
+    std::string csvPath;
+    std::string baselinePath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i == argc - 1) {
+            cerr << "Please specify value for " << arg << endl;
+            return -1;
+        }
+
+        std::string value = argv[++i];
+        if (arg == "-engines") {
+            engines = parseStringList(value);
+        } else if (arg == "-bufferSizes") {
+            bufferSizes = parseIntList(value);
+        } else if (arg == "-smoothLevels") {
+            smoothLevels = parseIntList(value);
+        } else if (arg == "-decimations") {
+            decimationFactors = parseIntList(value);
+        } else if (arg == "-sampleRate") {
+            sampleRate = Strings::TryParseInt(value, sampleRate);
+        } else if (arg == "-repeats") {
+            repeatsCount = std::max(1, Strings::TryParseInt(value, repeatsCount));
+        } else if (arg == "-settings") {
+            settingsString = value;
+        } else if (arg == "-details") {
+            details = value == "1";
+        } else if (arg == "-gate") {
+            gate = value == "1";
+        } else if (arg == "-csv") {
+            csvPath = value;
+        } else if (arg == "-baseline") {
+            baselinePath = value;
+        } else {
+            cerr << "Unknown argument " << arg << endl;
+            return -1;
+        }
+    }
+
+    PitchDetectorSettings settings;
+    try {
+        settings = PitchDetectorFactory::parseSettings(settingsString);
+    } catch (const std::invalid_argument& e) {
+        cerr << e.what() << endl;
+        return -1;
+    }
+
+    std::map<std::string, BaselineRow> baseline;
+    if (!baselinePath.empty()) {
+        std::ifstream baselineStream(baselinePath);
+        if (!baselineStream) {
+            cerr << "Can't read " << baselinePath << endl;
+            return -1;
+        }
+        baseline = readBaseline(baselineStream);
+    }
+
+    std::vector<Signal> corpus = createCorpus(sampleRate);
+    double corpusDuration = 0;
+    for (const Signal& signal : corpus) {
+        corpusDuration += double(signal.samples.size()) / sampleRate;
+    }
+
+    std::ofstream csv;
+    if (!csvPath.empty()) {
+        csv.open(csvPath);
+        csv << CSV_HEADER << "\n";
+    }
+
+    cout << corpus.size() << " signals, " << std::fixed << std::setprecision(1) << corpusDuration
+            << " seconds at " << sampleRate << " Hz\n";
+    cout << std::left << std::setw(12) << "engine" << std::right << std::setw(7) << "buffer" << std::setw(7)
+            << "smooth" << std::setw(5) << "dec" << std::setw(9) << "GPE %" << std::setw(9) << "fine c" << std::setw(10) << "voicing %"
+            << std::setw(10) << "onset ms" << std::setw(8) << "missed" << std::setw(11) << "ns/frame";
+    if (gate) {
+        cout << std::setw(11) << "skipped %";
+    }
+    if (!baseline.empty()) {
+        cout << std::setw(10) << "dGPE %" << std::setw(9) << "dfine c" << std::setw(11) << "dvoicing %"
+                << std::setw(9) << "speed";
+    }
+    cout << endl;
+
+    bool regressed = false;
+    for (const std::string& engine : engines) {
+        for (int bufferSize : bufferSizes) {
+            for (int smoothLevel : smoothLevels) {
+                for (int decimationFactor : decimationFactors) {
+                    Configuration configuration = {engine, bufferSize, smoothLevel, decimationFactor, gate};
+                    // Validates the engine and the settings
+                    std::unique_ptr<PitchDetector> detector;
+                    try {
+                        detector.reset(PitchDetectorFactory::create(engine, settings));
+                    } catch (const std::invalid_argument& e) {
+                        cerr << e.what() << endl;
+                        return -1;
+                    }
+
+                    Result total;
+                    std::vector<Result> signalResults;
+                    for (const Signal& signal : corpus) {
+                        Result result;
+                        for (int repeat = 0; repeat < repeatsCount; ++repeat) {
+                            // A new detector for every run, so the tracking engines don't carry the state over
+                            detector.reset(PitchDetectorFactory::create(engine, settings));
+                            int decimatedBufferSize = Decimator(decimationFactor).getMaxOutputSize(bufferSize);
+                            detector->init(decimatedBufferSize * smoothLevel, sampleRate / decimationFactor);
+                            Result repeatResult = runSignal(detector.get(), configuration, signal, sampleRate);
+                            if (repeat == 0 || repeatResult.detectionNanoseconds < result.detectionNanoseconds) {
+                                result = repeatResult;
+                            }
+                        }
+                        total.add(result);
+                        signalResults.push_back(result);
+                        if (csv.is_open()) {
+                            writeCsvRow(csv, configuration, signal.name, result);
+                        }
+                    }
+                    if (csv.is_open()) {
+                        writeCsvRow(csv, configuration, "all", total);
+                    }
+
+                    auto printRow = [&] (const std::string& name, const Result& result) {
+                        cout << std::left << std::setw(12) << name << std::right << std::setw(7) << bufferSize
+                                << std::setw(7) << smoothLevel << std::setw(5) << decimationFactor
+                                << std::setprecision(2)
+                                << std::setw(9) << result.getGrossPitchError() * 100
+                                << std::setw(9) << result.getFineErrorInCents()
+                                << std::setw(10) << result.getVoicingAccuracy() * 100
+                                << std::setprecision(1) << std::setw(10) << result.getOnsetLatencyInMilliseconds()
+                                << std::setw(8) << result.missedOnsetsCount
+                                << std::setprecision(0) << std::setw(11) << result.getNanosecondsPerFrame();
+                        if (gate) {
+                            cout << std::setprecision(1) << std::setw(11) << result.getSkippedFramesShare() * 100;
+                        }
+                    };
+
+                    printRow(engine, total);
+                    auto baselineRow = baseline.find(engine + "," + std::to_string(bufferSize) + ","
+                            + std::to_string(smoothLevel) + "," + std::to_string(decimationFactor));
+                    if (baselineRow != baseline.end()) {
+                        const BaselineRow& row = baselineRow->second;
+                        double grossPitchErrorChange = total.getGrossPitchError() - row.grossPitchError;
+                        double fineErrorChange = total.getFineErrorInCents() - row.fineErrorInCents;
+                        double voicingChange = total.getVoicingAccuracy() - row.voicingAccuracy;
+                        bool rowRegressed = grossPitchErrorChange > GPE_TOLERANCE ||
+                                fineErrorChange > FINE_ERROR_TOLERANCE_CENTS || voicingChange < -VOICING_TOLERANCE;
+                        regressed = regressed || rowRegressed;
+                        cout << std::showpos << std::setprecision(2) << std::setw(10) << grossPitchErrorChange * 100
+                                << std::setw(9) << fineErrorChange << std::setw(11) << voicingChange * 100
+                                << std::noshowpos << std::setw(8)
+                                << row.nanosecondsPerFrame / std::max(1.0, total.getNanosecondsPerFrame()) << "x"
+                                << (rowRegressed ? "  REGRESSED" : "");
+                    }
+                    cout << endl;
+
+                    if (details) {
+                        for (int i = 0; i < corpus.size(); ++i) {
+                            printRow("  " + corpus[i].name, signalResults[i]);
+                            cout << endl;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return regressed ? 1 : 0;
+}
@@ -12,4 +12,6 @@
 - (instancetype)initWithFrame:(CGRect)frameRect callback:(MetalViewCallback*)callback
           andDevicePixelRatio:(CGFloat)devicePixelRatio;
 - (CAMetalLayer*)metalLayer;
+// While paused the view is drawn only on setNeedsDisplay, e.g. when it's resized
+- (void)setRenderingPaused:(BOOL)paused;
 @end
\ No newline at end of file
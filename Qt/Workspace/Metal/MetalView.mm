@@ -62,7 +62,14 @@
 
 - (void)drawInMTKView:(nonnull MTKView *)view {
     [self initMetalIfNeed];
-    _callback->renderMetal(int(_size.width), int(_size.height));
+    if (!_callback->renderMetal(int(_size.width), int(_size.height))) {
+        [self setRenderingPaused:YES];
+    }
+}
+
+- (void)setRenderingPaused:(BOOL)paused {
+    self.paused = paused;
+    self.enableSetNeedsDisplay = paused;
 }
 
 - (void)resize:(CGSize)size {
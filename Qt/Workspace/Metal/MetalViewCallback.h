@@ -9,7 +9,8 @@
 class MetalViewCallback {
 public:
     virtual void initMetal() = 0;
-    virtual void renderMetal(int width, int height) = 0;
+    // Returns false if nothing is drawn, the view stops its update loop until QMetalWidget::resumeRendering
+    virtual bool renderMetal(int width, int height) = 0;
     virtual void metalResize(int width, int height) = 0;
     virtual ~MetalViewCallback() = default;
 };
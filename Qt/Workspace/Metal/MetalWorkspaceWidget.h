@@ -12,7 +12,7 @@ public:
 
 protected:
     void initMetal() override;
-    void renderMetal(int width, int height) override;
+    bool renderMetal(int width, int height) override;
     void metalResize(int width, int height) override;
     void onRequestUpdate(QWidget *widget) override;
 
@@ -12,8 +12,8 @@ MetalWorkspaceWidget::MetalWorkspaceWidget(QWidget *parent) : QMetalWidget(paren
 
 }
 
-void MetalWorkspaceWidget::renderMetal(int width, int height) {
-    workspaceDrawer->draw();
+bool MetalWorkspaceWidget::renderMetal(int width, int height) {
+    return workspaceDrawer->drawIfNeeded();
 }
 
 void MetalWorkspaceWidget::metalResize(int width, int height) {
@@ -26,7 +26,7 @@ void MetalWorkspaceWidget::initMetal() {
 }
 
 void MetalWorkspaceWidget::onRequestUpdate(QWidget *widget) {
-    // do nothing, metal is updated automatically
+    resumeRendering();
 }
 
 void MetalWorkspaceWidget::mousePressEvent(QMouseEvent *event) {
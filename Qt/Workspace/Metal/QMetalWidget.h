@@ -14,6 +14,8 @@ class QMetalWidget : public QWidget, protected MetalViewCallback
 public:
     explicit QMetalWidget(QWidget *parent = nullptr);
     QMacNativeWidget* addSubWidget(QWidget* widget);
+    // Restarts the update loop of the view, stopped when renderMetal returns false. Can be called from any thread.
+    void resumeRendering();
 protected:
 #ifdef __OBJC__
     void addSubview(NSView* view);
@@ -18,6 +18,13 @@ void QMetalWidget::resizeEvent(QResizeEvent *event) {
     [metalView resize:event->size().toCGSize()];
 }
 
+void QMetalWidget::resumeRendering() {
+    MetalView* view = metalView;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [view setRenderingPaused:NO];
+    });
+}
+
 CAMetalLayer *QMetalWidget::getLayer() const {
     return metalView.metalLayer;
 }
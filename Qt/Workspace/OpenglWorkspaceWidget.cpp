@@ -11,6 +11,8 @@
 
 OpenGLWorkspaceWidget::OpenGLWorkspaceWidget(QWidget* parent) : QOpenGLWidget(parent)
 {
+    // Skipped frames keep the content of the framebuffer
+    setUpdateBehavior(QOpenGLWidget::PartialUpdate);
 }
 
 QOpenGLTexture* texture;
@@ -26,7 +28,7 @@ void OpenGLWorkspaceWidget::resizeGL(int w, int h) {
 
 void OpenGLWorkspaceWidget::paintGL() {
     assert(QApplication::instance()->thread() == QThread::currentThread());
-    workspaceDrawer->draw();
+    workspaceDrawer->drawIfNeeded();
     const GLenum error = glGetError();
     if (error != GL_NO_ERROR) {
         qDebug() << "GL error: "<<error<<"\n";
@@ -3,10 +3,10 @@
 //
 
 #include "QtDrawerTextImagesFactory.h"
-#include "WorkspaceDrawer.h"
-#include "PianoDrawer.h"
 #include <QString>
 #include <QImage>
+#include <QFile>
+#include <sstream>
 #include <iostream>
 
 constexpr int MAX_SUPPORTED_DEVICE_PIXEL_RATIO = 2;
@@ -15,31 +15,6 @@ constexpr const char* path = ":qml/sharedimages/text/";
 using std::cerr;
 using namespace CppUtils;
 
-void QtDrawerTextImagesFactory::addImage(Drawer *drawer, int devicePixelRatio, int fontSize, char character,
-                                         const CppUtils::Color &color, bool useCharacterCode) {
-    QString fileName = path + QString::number(fontSize * devicePixelRatio) + "_";
-    if (!useCharacterCode) {
-        fileName += QString(character);
-    } else {
-        fileName += "code" + QString::number(int(character));
-    }
-    fileName += "_" + QString::fromStdString(color.toHexString());
-    fileName += ".png";
-
-    std::string fileNameStd = fileName.toStdString();
-    QImage image(fileName);
-    assert(!image.isNull());
-
-    Drawer::Image* imageHolder = drawer->createImage(image.bits(), image.width(), image.height());
-
-    DrawerTextImagesFactoryCharacterData data;
-    data.image = imageHolder;
-    data.character = character;
-    data.fontSize = fontSize;
-    data.color = color;
-    DrawerTextImagesFactory::addImage(data);
-}
-
 void QtDrawerTextImagesFactory::load(Drawer* drawer, int devicePixelRatio) {
     if (devicePixelRatio < 1) {
         devicePixelRatio = 1;
@@ -49,21 +24,17 @@ void QtDrawerTextImagesFactory::load(Drawer* drawer, int devicePixelRatio) {
         cerr<<"Unsupported device pixel ratio passed "<<devicePixelRatio;
     }
 
-    // digits
-    for (int textInt = 0; textInt <= 9; ++textInt) {
-        char ch = (char)textInt + '0';
-        addImage(drawer, devicePixelRatio, WorkspaceDrawer::YARD_STICK_FONT_SIZE, ch,
-                WorkspaceDrawer::YARD_STICK_DOT_AND_TEXT_COLOR, false);
-        addImage(drawer, devicePixelRatio, PianoDrawer::FONT_SIZE, ch, PianoDrawer::PITCH_TEXT_COLOR, false);
-        addImage(drawer, devicePixelRatio, PianoDrawer::FONT_SIZE, ch, PianoDrawer::SELECTED_PITCH_TEXT_COLOR, false);
-    }
+    QString atlasPath = path + QString("atlas_") + QString::number(devicePixelRatio) + "x";
 
-    // pitch names
-    for (char ch = 'A'; ch <= 'G'; ch++) {
-        addImage(drawer, devicePixelRatio, PianoDrawer::FONT_SIZE, ch, PianoDrawer::PITCH_TEXT_COLOR, false);
-        addImage(drawer, devicePixelRatio, PianoDrawer::FONT_SIZE, ch, PianoDrawer::SELECTED_PITCH_TEXT_COLOR, false);
-    }
+    QFile metricsFile(atlasPath + ".txt");
+    bool opened = metricsFile.open(QIODevice::ReadOnly);
+    assert(opened);
+    std::istringstream metrics(metricsFile.readAll().toStdString());
+    bool metricsLoaded = readMetrics(metrics);
+    assert(metricsLoaded);
 
-    addImage(drawer, devicePixelRatio, WorkspaceDrawer::CLOCK_FONT_SIZE, ':',
-            WorkspaceDrawer::YARD_STICK_DOT_AND_TEXT_COLOR, true);
-}
\ No newline at end of file
+    QImage image(atlasPath + ".png");
+    assert(!image.isNull());
+    image = image.convertToFormat(QImage::Format_RGBA8888);
+    setAtlasImage(drawer->createImage(image.bits(), image.width(), image.height()));
+}
@@ -7,9 +7,8 @@
 
 #include "Drawer.h"
 
+// Loads the glyphs atlas and its metrics generated by TextImagesGenerator
 class QtDrawerTextImagesFactory : public DrawerTextImagesFactory {
-    void addImage(Drawer *drawer, int devicePixelRatio, int fontSize, char character,
-                      const CppUtils::Color &color, bool useCharacterCode = false);
 public:
     void load(Drawer* drawer, int devicePixelRatio);
 };
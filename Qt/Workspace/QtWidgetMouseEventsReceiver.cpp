@@ -8,7 +8,9 @@
 
 using namespace CppUtils;
 
-QtWidgetMouseEventsReceiver::QtWidgetMouseEventsReceiver(QWidget *widget) : QObject(widget), widget(widget) {
+QtWidgetMouseEventsReceiver::QtWidgetMouseEventsReceiver(QWidget *widget,
+        const std::function<void()>& onMouseStateChanged) :
+        QObject(widget), widget(widget), onMouseStateChanged(onMouseStateChanged) {
     assert(widget);
     widget->installEventFilter(this);
 }
@@ -20,6 +22,9 @@ bool QtWidgetMouseEventsReceiver::eventFilter(QObject *watched, QEvent *event) {
         bool rightMouseDown = mouseEvent->buttons().testFlag(Qt::RightButton);
         PointF positionF(float(position.x()), float(position.y()));
         onMouseEvent(positionF, leftMouseDown, rightMouseDown);
+        if (onMouseStateChanged) {
+            onMouseStateChanged();
+        }
     }
 
     return false;
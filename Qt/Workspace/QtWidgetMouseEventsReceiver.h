@@ -7,11 +7,15 @@
 
 #include "BaseSynchronizedMouseEventsReceiver.h"
 #include <QWidget>
+#include <functional>
 
 class QtWidgetMouseEventsReceiver : public BaseSynchronizedMouseEventsReceiver, public QObject {
     QWidget* widget;
+    std::function<void()> onMouseStateChanged;
 public:
-    explicit QtWidgetMouseEventsReceiver(QWidget *widget);
+    // onMouseStateChanged is called on the main thread after every mouse event of the widget
+    explicit QtWidgetMouseEventsReceiver(QWidget *widget,
+            const std::function<void()>& onMouseStateChanged = nullptr);
     bool eventFilter(QObject *watched, QEvent *event) override;
 };
 
@@ -66,7 +66,13 @@ void WorkspaceDrawerWidgetSetup::setupWorkspaceDrawer(QWidget* widget, Drawer* d
     drawer->setTextImagesFactory(factory);
     drawer->setTextDrawStrategy(Drawer::DRAW_USING_PRE_BUILD_IMAGES);
 
-    workspaceDrawer = new WorkspaceDrawer(drawer, new QtWidgetMouseEventsReceiver(widget), [=] {
+    auto* mouseEventsReceiver = new QtWidgetMouseEventsReceiver(widget, [=] {
+        // Hover and drag are handled during the frame rendering
+        if (workspaceDrawer) {
+            workspaceDrawer->invalidate(FrameScheduler::INPUT);
+        }
+    });
+    workspaceDrawer = new WorkspaceDrawer(drawer, mouseEventsReceiver, [=] {
         onRequestUpdate(widget);
     });
     initImages(drawer, widget);
@@ -75,12 +81,15 @@ void WorkspaceDrawerWidgetSetup::setupWorkspaceDrawer(QWidget* widget, Drawer* d
     if (useUpdateLoop) {
         // Fix strange bug, when grid is drawing with wrong alpha
         QtUtils::StartRepeatedTimer(widget, [=] {
+            workspaceDrawer->invalidate(FrameScheduler::ALL_CHANGES);
             widget->repaint();
             return false;
         }, 1000 / 150); // 150fps
 
+        // The widget draws with drawIfNeeded, it's repainted only while the playback is running or
+        // something is changed and keeps the last frame otherwise
         QtUtils::StartRepeatedTimer(widget, [=] {
-            if (workspaceDrawer->isRunning()) {
+            if (workspaceDrawer->needsFrame()) {
                 widget->repaint();
             }
             return true;
@@ -112,5 +121,8 @@ void WorkspaceDrawerWidgetSetup::onMouseClick(float x) {
 }
 
 void WorkspaceDrawerWidgetSetup::onRequestUpdate(QWidget* widget) {
-    widget->repaint();
+    // Called on the thread, which has changed the workspace
+    Executors::ExecuteOnMainThread([=] {
+        widget->update();
+    });
 }
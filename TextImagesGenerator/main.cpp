@@ -1,14 +1,17 @@
 #include <QApplication>
 #include <QFontMetrics>
 #include <QPainter>
-#include <QPixmap>
+#include <QImage>
 #include <cmath>
 #include <QDir>
 #include <iostream>
 #include <WorkspaceDrawer.h>
 #include "Color.h"
+#include "Drawer.h"
+#include "Bitmap.h"
 #include "PianoDrawer.h"
-#include <iostream>
+#include <fstream>
+#include <cstring>
 #include "StringUtils.h"
 #include "Algorithms.h"
 
@@ -21,31 +24,64 @@ const char* qrcPath = "/Users/semyontikhonenko/Projects/VocalTrainer/Qt/qml.qrc"
 
 std::vector<std::string> generatedLines;
 
-static void drawText(int textSize, QString text, QString fileNameIdPart, const Color& color) {
+static void addGlyph(DrawerTextImagesFactory* atlas, int devicePixelRatio, int fontSize, char character,
+        const Color& color) {
+    QString text = QChar(character);
     QFont font;
-    font.setPixelSize(textSize);
+    font.setPixelSize(fontSize * devicePixelRatio);
     QFontMetrics metrics(font);
     int width = metrics.width(text);
     int height = metrics.height();
 
-    QPixmap pix = QPixmap(width, height);
-    pix.fill(Qt::transparent);
-    QPainter painter(&pix);
+    QImage image(width, height, QImage::Format_RGBA8888);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
     painter.setPen(QPen(color.toQColor()));
     painter.setBrush(QBrush(color.toQColor()));
     painter.setFont(font);
     painter.drawText(0, 0, width, height, Qt::AlignTop | Qt::AlignLeft, text);
+    painter.end();
 
-    QString fileName = QString::number(textSize) + "_" + fileNameIdPart + "_" +
-            QString::fromStdString(color.toHexString()) + ".png";
-    QString filePath = path + fileName;
-    assert(pix.save(filePath));
+    Bitmap bitmap(width, height);
+    for (int y = 0; y < height; ++y) {
+        memcpy(bitmap.getData() + y * width * 4, image.constScanLine(y), width * 4);
+    }
+    atlas->addGlyph(character, fontSize, color, Drawer::NORMAL, bitmap);
+}
 
+static void addFileToQrc(const QString& fileName) {
     QByteArray line = "        <file>qml/sharedimages/text/" + fileName.toLocal8Bit() + "</file>";
     generatedLines.push_back(line.data());
     std::cout << line.data() << "\n";
 }
 
+// Writes atlas_<devicePixelRatio>x.png with all the glyphs and atlas_<devicePixelRatio>x.txt with their metrics
+static void generateAtlas(int devicePixelRatio) {
+    DrawerTextImagesFactory atlas;
+    for (char ch = '0'; ch <= '9'; ++ch) {
+        addGlyph(&atlas, devicePixelRatio, WorkspaceDrawer::YARD_STICK_FONT_SIZE, ch, WorkspaceDrawer::YARD_STICK_DOT_AND_TEXT_COLOR);
+        addGlyph(&atlas, devicePixelRatio, PianoDrawer::FONT_SIZE, ch, PianoDrawer::PITCH_TEXT_COLOR);
+        addGlyph(&atlas, devicePixelRatio, PianoDrawer::FONT_SIZE, ch, PianoDrawer::SELECTED_PITCH_TEXT_COLOR);
+    }
+
+    for (char ch = 'A'; ch <= 'G'; ch++) {
+        addGlyph(&atlas, devicePixelRatio, PianoDrawer::FONT_SIZE, ch, PianoDrawer::PITCH_TEXT_COLOR);
+        addGlyph(&atlas, devicePixelRatio, PianoDrawer::FONT_SIZE, ch, PianoDrawer::SELECTED_PITCH_TEXT_COLOR);
+    }
+
+    addGlyph(&atlas, devicePixelRatio, WorkspaceDrawer::YARD_STICK_FONT_SIZE, ':', WorkspaceDrawer::YARD_STICK_DOT_AND_TEXT_COLOR);
+
+    Bitmap bitmap = atlas.packAtlas();
+    QImage image(bitmap.getData(), bitmap.getWidth(), bitmap.getHeight(), QImage::Format_RGBA8888);
+    QString baseName = "atlas_" + QString::number(devicePixelRatio) + "x";
+    assert(image.save(path + baseName + ".png"));
+    addFileToQrc(baseName + ".png");
+
+    std::ofstream metrics((path + baseName + ".txt").toStdString());
+    atlas.writeMetrics(metrics);
+    addFileToQrc(baseName + ".txt");
+}
+
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
@@ -54,22 +90,7 @@ int main(int argc, char *argv[])
     QDir(path).mkpath(".");
 
     for (int devicePixelRatio = 1; devicePixelRatio <= 2; ++devicePixelRatio) {
-        for (int textInt = 0; textInt <= 9; ++textInt) {
-            QString text = QString::number(textInt);
-            drawText(WorkspaceDrawer::YARD_STICK_FONT_SIZE * devicePixelRatio, text, text, WorkspaceDrawer::YARD_STICK_DOT_AND_TEXT_COLOR);
-            drawText(PianoDrawer::FONT_SIZE * devicePixelRatio, text, text, PianoDrawer::PITCH_TEXT_COLOR);
-            drawText(PianoDrawer::FONT_SIZE * devicePixelRatio, text, text, PianoDrawer::SELECTED_PITCH_TEXT_COLOR);
-        }
-
-        for (char ch = 'A'; ch <= 'G'; ch++) {
-            QChar text = QChar(ch);
-            drawText(PianoDrawer::FONT_SIZE * devicePixelRatio, text, text, PianoDrawer::PITCH_TEXT_COLOR);
-            drawText(PianoDrawer::FONT_SIZE * devicePixelRatio, text, text, PianoDrawer::SELECTED_PITCH_TEXT_COLOR);
-        }
-
-        drawText(WorkspaceDrawer::YARD_STICK_FONT_SIZE * devicePixelRatio,
-                QChar(':'), "code" + QString::number(int(':')),
-                WorkspaceDrawer::YARD_STICK_DOT_AND_TEXT_COLOR);
+        generateAtlas(devicePixelRatio);
     }
 
     auto lines = Strings::ReadAllIntoLines(qrcPath);
@@ -65,6 +65,7 @@ using namespace CppUtils;
     NSPoint mouseLocation = [self convertPoint:[event locationInWindow] fromView:nil];
     mouseLocation.y = self.frame.size.height - mouseLocation.y;
     self.mouseEventsReceiver->setCurrentMousePosition(PointF(float(mouseLocation.x), float(mouseLocation.y)));
+    [self mouseEventsReceiverDidChange];
 }
 
 - (WorkspaceDrawerResourcesProvider *)createResourcesProvider {
@@ -23,4 +23,6 @@
 - (WorkspaceDrawerResourcesProvider*)createResourcesProvider;
 - (BaseMouseEventsReceiver*)mouseEventsReceiver;
 #endif
+// Requests a frame after the state of mouseEventsReceiver is changed
+- (void)mouseEventsReceiverDidChange;
 @end
@@ -56,9 +56,13 @@ using namespace CppUtils;
 
         WorkspaceDrawerResourcesProvider* resourcesProvider = [self createResourcesProvider];
         assert(resourcesProvider && "Override createResourcesProvider");
+        __weak BaseWorkspaceDrawerView* weakSelf = self;
         _workspaceDrawer = new WorkspaceDrawer(
-                drawer, _mouseEventsReceiver, resourcesProvider, self.drawScrollbars, [] {
-            // update workspace drawer automatically, nothing to do here
+                drawer, _mouseEventsReceiver, resourcesProvider, self.drawScrollbars, [weakSelf] {
+            // Called on the thread, which has changed the workspace
+            dispatch_async(dispatch_get_main_queue(), ^{
+                [weakSelf setRenderingPaused:NO];
+            });
         });
         self.onWorkspaceControllerChanged();
         [self workspaceDrawerDidInitialize:_workspaceDrawer];
@@ -85,8 +89,21 @@ using namespace CppUtils;
         [self resizeWorkspaceDrawer:self.frame.size];
     }
 
+    // The view is paused while nothing is changed, it's drawn on setNeedsDisplay, e.g. on resize,
+    // until the workspace requests a frame
+    if (_workspaceDrawer && !_workspaceDrawer->drawIfNeeded()) {
+        [self setRenderingPaused:YES];
+    }
+}
+
+- (void)setRenderingPaused:(BOOL)paused {
+    self.paused = paused;
+    self.enableSetNeedsDisplay = paused;
+}
+
+- (void)mouseEventsReceiverDidChange {
     if (_workspaceDrawer) {
-        _workspaceDrawer->draw();
+        _workspaceDrawer->invalidate(FrameScheduler::INPUT);
     }
 }
 
@@ -0,0 +1,520 @@
+#define _USE_MATH_DEFINES
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <iomanip>
+#include <cstring>
+#include "WorkspaceDrawer.h"
+#include "SoftwareDrawer.h"
+#include "CommandBufferDrawer.h"
+#include "NvgDrawer.h"
+#include "PitchesMutableList.h"
+#include "MouseEventsReceiver.h"
+#include "StringUtils.h"
+
+// Renders WorkspaceDrawer frames with SoftwareDrawer through scripted scenarios and reports per-frame time.
+// Usage: WorkspaceBenchmark [-frames 300] [-width 1280] [-height 720] [-scale 1] [-snapshot prefix]
+//         [-commands prefix] [-golden prefix] [-profile prefix] [-nanovg 1]
+// With -snapshot the last frame of every scenario is saved to <prefix><scenario>.ppm
+// With -commands or -golden the frames are recorded by CommandBufferDrawer, frames identical to the previous one
+// are not replayed. -commands saves the command dump of the last frame of every scenario to <prefix><scenario>.txt,
+// -golden compares it with the dump saved before and fails if the frame is drawn differently.
+// With -profile the sections of the last frames of every scenario are printed and saved as Chrome trace JSON
+// to <prefix><scenario>.json
+// With -nanovg 1 every scenario is also recorded by CommandBufferDrawer and replayed on NvgDrawer with a no-op
+// renderer, with and without the nanovg geometry cache. The CPU time of the replay is reported: path flattening,
+// fill and stroke expansion, including the layers.
+
+using std::cout;
+using std::cerr;
+using std::endl;
+using namespace CppUtils;
+
+static constexpr double BEATS_PER_MINUTE = 120;
+static constexpr int TICKS_PER_BEAT = 480;
+static constexpr int NOTES_COUNT = 400;
+static constexpr double PITCHES_PER_SECOND = 100;
+
+class NoMouseEventsReceiver : public MouseEventsReceiver {
+public:
+    bool isLeftMouseDown() override {
+        return false;
+    }
+
+    bool isRightMouseDown() override {
+        return false;
+    }
+
+    PointF getMousePosition() override {
+        return PointF(-1, -1);
+    }
+};
+
+// Placeholder images with the same sizes the platform providers produce, so the pre-built text images path
+// and the images blits are benchmarked without a font rasterizer.
+class PlaceholderResourcesProvider : public WorkspaceDrawerResourcesProvider {
+public:
+    Bitmap createImageForCharacter(char ch, int fontSize, Color color, Drawer::FontStyle fontStyle,
+            float scaleFactor) const override {
+        int width = std::max(1, int(round(fontSize * 0.6f * scaleFactor)));
+        int height = std::max(1, int(round(fontSize * 1.2f * scaleFactor)));
+        Bitmap bitmap(width, height);
+        bitmap.fill(Color::transparent());
+        for (int y = height / 4; y < height * 3 / 4; ++y) {
+            for (int x = width / 6; x < width * 5 / 6; ++x) {
+                bitmap.setPixel(x, y, color);
+            }
+        }
+        return bitmap;
+    }
+
+    Bitmap createImageForName(Image image, int widthInPoints, int heightInPoints, float scaleFactor) const override {
+        Bitmap bitmap(std::max(1, int(round(widthInPoints * scaleFactor))),
+                std::max(1, int(round(heightInPoints * scaleFactor))));
+        bitmap.fill(Color::fromRgba(0x24232D80));
+        return bitmap;
+    }
+};
+
+// Notes of the vocal part under the workspace seek, the way the playback reports them
+class VocalPartPitchSequence : public PlayingPitchSequence {
+    const VocalPart* vocalPart;
+    const WorkspaceDrawer* workspaceDrawer;
+public:
+    VocalPartPitchSequence(const VocalPart* vocalPart, const WorkspaceDrawer* workspaceDrawer)
+            : vocalPart(vocalPart), workspaceDrawer(workspaceDrawer) {
+    }
+
+    bool hasPitchNow(const Pitch& pitch) const override {
+        bool result = false;
+        double seek = workspaceDrawer->getWorkspaceSeek();
+        vocalPart->iteratePitchesInTimeRange(seek, seek + 0.001, [&] (const NoteInterval& note) {
+            result |= note.pitch.getPerfectFrequencyIndex() == pitch.getPerfectFrequencyIndex();
+        });
+        return result;
+    }
+
+    bool hasAnyPitchNow() const override {
+        bool result = false;
+        double seek = workspaceDrawer->getWorkspaceSeek();
+        vocalPart->iteratePitchesInTimeRange(seek, seek + 0.001, [&] (const NoteInterval& note) {
+            result = true;
+        });
+        return result;
+    }
+};
+
+// Owns the nanovg context of NullNvgDrawer, so it outlives Drawer, which deletes the remaining images
+class NullNvgContext {
+protected:
+    NVGcontext* context = nullptr;
+    std::vector<std::pair<int, int>> textureSizes;
+
+    ~NullNvgContext() {
+        nvgDeleteInternal(context);
+    }
+};
+
+// NvgDrawer on a nanovg context with the render callbacks doing nothing, textures are just sizes.
+// Measures the CPU time spent in its frames and layers.
+class NullNvgDrawer : private NullNvgContext, public NvgDrawer {
+    std::chrono::steady_clock::time_point frameStart;
+    double cpuTime = 0;
+
+    static int renderCreateTexture(void* userPtr, int type, int w, int h, int imageFlags,
+            const unsigned char* data) {
+        NullNvgDrawer* drawer = static_cast<NullNvgDrawer*>(userPtr);
+        drawer->textureSizes.emplace_back(w, h);
+        return int(drawer->textureSizes.size());
+    }
+
+    static int renderGetTextureSize(void* userPtr, int image, int* w, int* h) {
+        const std::pair<int, int>& size = static_cast<NullNvgDrawer*>(userPtr)->textureSizes.at(image - 1);
+        *w = size.first;
+        *h = size.second;
+        return 1;
+    }
+
+protected:
+    int getImageHandleFromFrameBuffer(void* frameBuffer) override {
+        return int(reinterpret_cast<intptr_t>(frameBuffer));
+    }
+
+    void* createFrameBuffer(int w, int h) override {
+        return reinterpret_cast<void*>(intptr_t(nvgCreateImageRGBA(ctx, w, h, 0, nullptr)));
+    }
+
+    void bindFrameBuffer(void* frameBuffer) override {
+    }
+
+    void deleteFrameBuffer(void* frameBuffer) override {
+        nvgDeleteImage(ctx, getImageHandleFromFrameBuffer(frameBuffer));
+    }
+
+    Image* renderIntoImageNative(const std::function<void()>& renderingFunction, int w, int h) override {
+        auto start = std::chrono::steady_clock::now();
+        Image* image = NvgDrawer::renderIntoImageNative(renderingFunction, w, h);
+        cpuTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return image;
+    }
+
+public:
+    explicit NullNvgDrawer(bool geometryCacheEnabled) {
+        NVGparams params;
+        memset(&params, 0, sizeof(params));
+        params.userPtr = this;
+        params.edgeAntiAlias = 1;
+        params.renderCreate = [] (void*) { return 1; };
+        params.renderCreateTexture = renderCreateTexture;
+        params.renderDeleteTexture = [] (void*, int) { return 1; };
+        params.renderUpdateTexture = [] (void*, int, int, int, int, int, const unsigned char*) { return 1; };
+        params.renderGetTextureSize = renderGetTextureSize;
+        params.renderViewport = [] (void*, float, float, float) {};
+        params.renderCancel = [] (void*) {};
+        params.renderFlush = [] (void*) {};
+        params.renderFill = [] (void*, NVGpaint*, NVGcompositeOperationState, NVGscissor*, float, const float*,
+                const NVGpath*, int) {};
+        params.renderStroke = [] (void*, NVGpaint*, NVGcompositeOperationState, NVGscissor*, float, float,
+                const NVGpath*, int) {};
+        params.renderTriangles = [] (void*, NVGpaint*, NVGcompositeOperationState, NVGscissor*,
+                const NVGvertex*, int) {};
+        params.renderRoundedRects = [] (void*, NVGpaint*, NVGcompositeOperationState, NVGscissor*,
+                const NVGvertex*, int) {};
+        context = ctx = nvgCreateInternal(&params);
+        nvgGeometryCaching(ctx, geometryCacheEnabled);
+        setupBase();
+    }
+
+    void beginFrame(float width, float height, float devicePixelRatio) override {
+        frameStart = std::chrono::steady_clock::now();
+        NvgDrawer::beginFrame(width, height, devicePixelRatio);
+    }
+
+    void endFrame() override {
+        NvgDrawer::endFrame();
+        cpuTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+    }
+
+    // Returns the time in ms spent since the last call
+    double takeCpuTime() {
+        double result = cpuTime;
+        cpuTime = 0;
+        return result;
+    }
+};
+
+struct FrameStatistics {
+    double min = 0;
+    double average = 0;
+    double median = 0;
+    double p95 = 0;
+    double max = 0;
+
+    explicit FrameStatistics(std::vector<double> frameTimes) {
+        if (frameTimes.empty()) {
+            return;
+        }
+
+        std::sort(frameTimes.begin(), frameTimes.end());
+        min = frameTimes.front();
+        max = frameTimes.back();
+        median = frameTimes[frameTimes.size() / 2];
+        p95 = frameTimes[std::min(frameTimes.size() - 1, size_t(frameTimes.size() * 0.95))];
+        double sum = 0;
+        for (double time : frameTimes) {
+            sum += time;
+        }
+        average = sum / frameTimes.size();
+    }
+};
+
+struct Scenario {
+    std::string name;
+    std::function<void(WorkspaceDrawer* workspaceDrawer, int frameIndex, int framesCount)> prepareFrame;
+};
+
+// Deterministic melody in the comfortable singing range with a few jumps
+static VocalPart createVocalPart() {
+    std::vector<NoteInterval> notes;
+    int tick = TICKS_PER_BEAT * 4;
+    int basePitchIndex = Pitch("C3").getPerfectFrequencyIndex();
+    for (int i = 0; i < NOTES_COUNT; ++i) {
+        int pitchIndex = basePitchIndex + (i * 7) % 17;
+        int ticksCount = TICKS_PER_BEAT / 2 * (1 + i % 3);
+        notes.emplace_back(Pitch::fromPerfectFrequencyIndex(pitchIndex), tick, ticksCount);
+        tick += ticksCount + (i % 5 == 0 ? TICKS_PER_BEAT / 2 : 0);
+    }
+
+    return VocalPart(std::move(notes), TICKS_PER_BEAT * 4, TICKS_PER_BEAT * BEATS_PER_MINUTE / 60.0);
+}
+
+// Sung pitches following the melody with vibrato, the way PitchInputReader reports them
+static void appendSungPitches(const VocalPart& vocalPart, double begin, double end, PitchesMutableList* pitches) {
+    for (double time = begin; time < end; time += 1.0 / PITCHES_PER_SECOND) {
+        float frequency = -1;
+        vocalPart.iteratePitchesInTimeRange(time, time + 0.001, [&] (const NoteInterval& note) {
+            frequency = note.pitch.getFrequency() * powf(2.0f, 0.3f * sinf(time * 2 * M_PI * 5.5f) / 12.0f);
+        });
+        pitches->appendPitch(time, frequency);
+    }
+}
+
+static void writePpm(const Bitmap& bitmap, const std::string& filePath) {
+    std::ofstream os(filePath, std::ios::binary);
+    os << "P6\n" << bitmap.getWidth() << " " << bitmap.getHeight() << "\n255\n";
+    const unsigned char* data = bitmap.getData();
+    for (int i = 0; i < bitmap.getWidth() * bitmap.getHeight(); ++i) {
+        const unsigned char* pixel = data + i * 4;
+        // Composite over white
+        for (int channel = 0; channel < 3; ++channel) {
+            os.put(static_cast<char>((pixel[channel] * pixel[3] + 255 * (255 - pixel[3])) / 255));
+        }
+    }
+}
+
+static std::vector<std::string> readLines(std::istream& is) {
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(is, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+// Returns false and prints the first different line if the frame is drawn differently from the golden dump
+static bool compareWithGolden(const DrawerCommandBuffer& frame, const std::string& filePath) {
+    std::ifstream goldenStream(filePath);
+    if (!goldenStream) {
+        cerr << "Unable to open " << filePath << endl;
+        return false;
+    }
+
+    std::stringstream frameStream;
+    frame.writeText(frameStream);
+    std::vector<std::string> golden = readLines(goldenStream);
+    std::vector<std::string> lines = readLines(frameStream);
+    auto difference = std::mismatch(golden.begin(), golden.end(), lines.begin(), lines.end());
+    if (difference.first == golden.end() && difference.second == lines.end()) {
+        return true;
+    }
+
+    cerr << filePath << ":" << (difference.first - golden.begin() + 1) << " differs\n"
+            << "  expected: " << (difference.first != golden.end() ? *difference.first : "<end>") << "\n"
+            << "  actual:   " << (difference.second != lines.end() ? *difference.second : "<end>") << endl;
+    return false;
+}
+
+int main(int argc, char *argv[]) {
+    int framesCount = 300;
+    float width = 1280;
+    float height = 720;
+    float devicePixelRatio = 1;
+    std::string snapshotPrefix;
+    std::string commandsPrefix;
+    std::string goldenPrefix;
+    std::string profilePrefix;
+    bool replayOnNanovg = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i == argc - 1) {
+            cerr << "Please specify value for " << arg << endl;
+            return -1;
+        }
+
+        std::string value = argv[++i];
+        if (arg == "-frames") {
+            framesCount = Strings::TryParseInt(value, framesCount);
+        } else if (arg == "-width") {
+            width = Strings::TryParseInt(value, int(width));
+        } else if (arg == "-height") {
+            height = Strings::TryParseInt(value, int(height));
+        } else if (arg == "-scale") {
+            devicePixelRatio = Strings::TryParseInt(value, int(devicePixelRatio));
+        } else if (arg == "-snapshot") {
+            snapshotPrefix = value;
+        } else if (arg == "-commands") {
+            commandsPrefix = value;
+        } else if (arg == "-golden") {
+            goldenPrefix = value;
+        } else if (arg == "-profile") {
+            profilePrefix = value;
+        } else if (arg == "-nanovg") {
+            replayOnNanovg = value == "1";
+        } else {
+            cerr << "Unknown argument " << arg << endl;
+            return -1;
+        }
+    }
+
+    VocalPart vocalPart = createVocalPart();
+    double duration = vocalPart.getDurationInSeconds();
+    PitchesMutableList pitches;
+    std::vector<short> instrumentalSamples(4096);
+    for (int i = 0; i < instrumentalSamples.size(); ++i) {
+        instrumentalSamples[i] = static_cast<short>(16000 + 12000 * sin(i * 0.05) * sin(i * 0.0031));
+    }
+
+    std::vector<Scenario> scenarios = {
+        {"static", [] (WorkspaceDrawer* workspaceDrawer, int frameIndex, int framesCount) {}},
+        {"seek", [&] (WorkspaceDrawer* workspaceDrawer, int frameIndex, int framesCount) {
+            workspaceDrawer->updateSeek(static_cast<float>(duration * frameIndex / framesCount));
+        }},
+        {"zoom", [&] (WorkspaceDrawer* workspaceDrawer, int frameIndex, int framesCount) {
+            // From min zoom to max zoom and back
+            float phase = float(frameIndex) / framesCount * 2;
+            float k = phase <= 1 ? phase : 2 - phase;
+            float minZoom = workspaceDrawer->getMinZoom();
+            float maxZoom = workspaceDrawer->getMaxZoom();
+            workspaceDrawer->setZoom(minZoom + (maxZoom - minZoom) * k, PointF(width / 2, height / 2));
+        }},
+        {"zoomAndHold", [&] (WorkspaceDrawer* workspaceDrawer, int frameIndex, int framesCount) {
+            // Pinches of half a second at 60 fps with pauses of the same duration, zooming in and out by turns
+            int pinchIndex = frameIndex / 60;
+            int pinchFrameIndex = std::min(frameIndex % 60, 30);
+            float phase = pinchFrameIndex / 30.0f;
+            float k = pinchIndex % 2 == 0 ? phase : 1 - phase;
+            float minZoom = workspaceDrawer->getMinZoom();
+            float maxZoom = workspaceDrawer->getMaxZoom();
+            workspaceDrawer->setZoom(minZoom + (maxZoom - minZoom) * k, PointF(width / 2, height / 2));
+        }},
+        {"resize", [&] (WorkspaceDrawer* workspaceDrawer, int frameIndex, int framesCount) {
+            // Window resize by dragging its corner, every frame has a new width
+            float k = 1.0f - 0.2f * (frameIndex % 20) / 20;
+            workspaceDrawer->resize(std::round(width * k), height, devicePixelRatio);
+        }},
+        {"recording", [&] (WorkspaceDrawer* workspaceDrawer, int frameIndex, int framesCount) {
+            // 60 fps playback with the pitches arriving from the input
+            double seek = frameIndex / 60.0;
+            double previousSeek = frameIndex > 0 ? (frameIndex - 1) / 60.0 : 0;
+            appendSungPitches(vocalPart, previousSeek, seek, &pitches);
+            workspaceDrawer->updateSeek(static_cast<float>(seek));
+            workspaceDrawer->setDetectedPitch(pitches.getNearestPitch(seek));
+        }},
+        {"longRecording", [&] (WorkspaceDrawer* workspaceDrawer, int frameIndex, int framesCount) {
+            // Whole song is already sung, the graph of the min zoom covers thousands of pitches
+            if (frameIndex == 0) {
+                appendSungPitches(vocalPart, 0, duration, &pitches);
+                workspaceDrawer->setZoom(workspaceDrawer->getMinZoom(), PointF(0, 0));
+            }
+            double seek = duration / 2 + frameIndex / 60.0;
+            workspaceDrawer->updateSeek(static_cast<float>(seek));
+            workspaceDrawer->setDetectedPitch(pitches.getNearestPitch(seek));
+        }},
+    };
+
+    cout << std::fixed << std::setprecision(3);
+    cout << "Frame size " << width << "x" << height << "@" << devicePixelRatio << ", " << framesCount
+            << " frames per scenario, times in ms\n";
+    cout << std::left << std::setw(12) << "scenario" << std::right
+            << std::setw(10) << "min" << std::setw(10) << "avg" << std::setw(10) << "median"
+            << std::setw(10) << "p95" << std::setw(10) << "max" << endl;
+
+    enum Backend {
+        SOFTWARE,
+        NANOVG,
+        CACHING_NANOVG
+    };
+    std::vector<Backend> backends = {SOFTWARE};
+    if (replayOnNanovg) {
+        backends.push_back(NANOVG);
+        backends.push_back(CACHING_NANOVG);
+    }
+
+    bool goldenMatches = true;
+    for (const Scenario& scenario : scenarios) {
+        for (Backend backend : backends) {
+            pitches.clearPitches();
+            SoftwareDrawer* softwareDrawer = nullptr;
+            NullNvgDrawer* nvgDrawer = nullptr;
+            Drawer* drawer;
+            if (backend == SOFTWARE) {
+                drawer = softwareDrawer = new SoftwareDrawer();
+            } else {
+                drawer = nvgDrawer = new NullNvgDrawer(backend == CACHING_NANOVG);
+            }
+
+            CommandBufferDrawer* commandBufferDrawer = nullptr;
+            if (nvgDrawer || !commandsPrefix.empty() || !goldenPrefix.empty()) {
+                commandBufferDrawer = new CommandBufferDrawer(drawer);
+                commandBufferDrawer->setSkipIdenticalFrames(true);
+                drawer = commandBufferDrawer;
+            }
+            WorkspaceDrawer workspaceDrawer(drawer, new NoMouseEventsReceiver(), new PlaceholderResourcesProvider(),
+                    true, [] {});
+            // Samples are accepted only while the tracks are hidden
+            workspaceDrawer.setDrawTracks(false);
+            workspaceDrawer.setInstrumentalTrackSamples(instrumentalSamples);
+            workspaceDrawer.setDrawTracks(true);
+            workspaceDrawer.resize(width, height, devicePixelRatio);
+            workspaceDrawer.setVocalPart(&vocalPart, BEATS_PER_MINUTE / 60.0, 4);
+            workspaceDrawer.setPitchesCollection(&pitches);
+            VocalPartPitchSequence pitchSequence(&vocalPart, &workspaceDrawer);
+            workspaceDrawer.setPitchSequence(&pitchSequence);
+            workspaceDrawer.setFirstVisiblePitch(Pitch("C2"));
+            workspaceDrawer.setRecording(scenario.name == "recording" || scenario.name == "longRecording");
+            workspaceDrawer.setFrameProfilingEnabled(softwareDrawer && !profilePrefix.empty());
+
+            std::vector<double> frameTimes;
+            frameTimes.reserve(framesCount);
+            int skippedFramesCount = 0;
+            for (int frameIndex = 0; frameIndex < framesCount; ++frameIndex) {
+                auto start = std::chrono::steady_clock::now();
+                scenario.prepareFrame(&workspaceDrawer, frameIndex, framesCount);
+                workspaceDrawer.draw();
+                std::chrono::duration<double, std::milli> frameTime = std::chrono::steady_clock::now() - start;
+                frameTimes.push_back(nvgDrawer ? nvgDrawer->takeCpuTime() : frameTime.count());
+                if (commandBufferDrawer && commandBufferDrawer->isLastFrameSkipped()) {
+                    skippedFramesCount++;
+                }
+            }
+
+            FrameStatistics statistics(frameTimes);
+            std::string name = backend == SOFTWARE ? scenario.name : backend == NANOVG ? "  nanovg" : "  cached";
+            cout << std::left << std::setw(12) << name << std::right
+                    << std::setw(10) << statistics.min << std::setw(10) << statistics.average
+                    << std::setw(10) << statistics.median << std::setw(10) << statistics.p95
+                    << std::setw(10) << statistics.max << endl;
+            if (nvgDrawer) {
+                continue;
+            }
+
+            if (commandBufferDrawer) {
+                const DrawerCommandBuffer& frame = commandBufferDrawer->getLastFrame();
+                cout << std::setw(12) << "" << frame.getCommandsCount() << " commands, " << frame.getPathsCount()
+                        << " paths, " << frame.getSizeInBytes() << " bytes, " << skippedFramesCount
+                        << " frames skipped" << endl;
+                if (!commandsPrefix.empty()) {
+                    std::ofstream os(commandsPrefix + scenario.name + ".txt");
+                    frame.writeText(os);
+                }
+                if (!goldenPrefix.empty()) {
+                    goldenMatches &= compareWithGolden(frame, goldenPrefix + scenario.name + ".txt");
+                }
+            }
+
+            if (!profilePrefix.empty()) {
+                const FrameProfiler& frameProfiler = workspaceDrawer.getFrameProfiler();
+                for (const FrameProfiler::SectionSummary& section : frameProfiler.getSummary()) {
+                    cout << std::setw(12) << "" << std::left << std::setw(24)
+                            << (std::string(section.depth * 2, ' ') + section.name) << std::right
+                            << std::setw(10) << section.averageTime * 1000 << std::setw(10) << section.maxTime * 1000
+                            << endl;
+                }
+                std::ofstream os(profilePrefix + scenario.name + ".json");
+                frameProfiler.writeChromeTrace(os);
+            }
+
+            if (!snapshotPrefix.empty()) {
+                writePpm(softwareDrawer->getBitmap(), snapshotPrefix + scenario.name + ".ppm");
+            }
+        }
+    }
+
+    return goldenMatches ? 0 : 1;
+}
@@ -241,6 +241,14 @@ void nvgReset(NVGcontext* ctx);
 // Sets whether to draw antialias for nvgStroke() and nvgFill(). It's enabled by default.
 void nvgShapeAntiAlias(NVGcontext* ctx, int enabled);
 
+// Sets whether to keep the tessellated fills and strokes of the recent frames, so a path drawn again with the same
+// transform and style is not flattened and expanded again. It's enabled by default.
+void nvgGeometryCaching(NVGcontext* ctx, int enabled);
+
+// Returns the number of the cached paths, of those with the stored geometry, the others have only their hash,
+// and of the fills and strokes drawn from the stored geometry since the context was created.
+void nvgGeometryCacheStats(NVGcontext* ctx, int* nentries, int* nstored, int* nhits);
+
 // Sets current stroke style to a solid color.
 void nvgStrokeColor(NVGcontext* ctx, NVGcolor color);
 
@@ -388,6 +396,11 @@ void nvgImageSize(NVGcontext* ctx, int image, int* w, int* h);
 // Deletes created image.
 void nvgDeleteImage(NVGcontext* ctx, int image);
 
+// Draws parts of the image as textured quads in a single draw call, e.g. glyphs from an atlas.
+// Every quad is 8 floats: x0,y0,x1,y1 of the destination rectangle in local coordinates
+// followed by s0,t0,s1,t1 of the source rectangle in image pixels. The current transform and global alpha are applied.
+void nvgImageQuads(NVGcontext* ctx, int image, const float* quads, int nquads);
+
 //
 // Paints
 //
@@ -508,6 +521,12 @@ void nvgFill(NVGcontext* ctx);
 // Fills the current path with current stroke style.
 void nvgStroke(NVGcontext* ctx);
 
+// Fills rounded rectangles with the color of the current fill style in a single draw call,
+// if the back-end supports it, or as a single path otherwise. Every rectangle is 8 floats: x,y,w,h
+// followed by the radii of the top left, top right, bottom right and bottom left corners.
+// The current transform, scissor and global alpha are applied. The current path is reset.
+void nvgFillRoundedRects(NVGcontext* ctx, const float* rects, int nrects);
+
 
 //
 // Text
@@ -659,6 +678,9 @@ struct NVGparams {
 	void (*renderFill)(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, float fringe, const float* bounds, const NVGpath* paths, int npaths);
 	void (*renderStroke)(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, float fringe, float strokeWidth, const NVGpath* paths, int npaths);
 	void (*renderTriangles)(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, const NVGvertex* verts, int nverts);
+	// Optional. Triangles covering rounded rectangles, u,v of a vertex is its offset from the nearest
+	// corner circle center divided by the corner radius, the shape is found by the signed distance.
+	void (*renderRoundedRects)(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, const NVGvertex* verts, int nverts);
 	void (*renderDelete)(void* uptr);
 };
 typedef struct NVGparams NVGparams;
@@ -114,7 +114,8 @@ enum GLNVGshaderType {
 	NSVG_SHADER_FILLGRAD,
 	NSVG_SHADER_FILLIMG,
 	NSVG_SHADER_SIMPLE,
-	NSVG_SHADER_IMG
+	NSVG_SHADER_IMG,
+	NSVG_SHADER_ROUNDED_RECTS
 };
 
 #if NANOVG_GL_USE_UNIFORMBUFFER
@@ -505,6 +506,7 @@ static int glnvg__renderCreate(void* uptr)
 		"#define NANOVG_GL3 1\n"
 #elif defined NANOVG_GLES2
 		"#version 100\n"
+		"#extension GL_OES_standard_derivatives : enable\n"
 		"#define NANOVG_GL2 1\n"
 #elif defined NANOVG_GLES3
 		"#version 300 es\n"
@@ -616,7 +618,8 @@ static int glnvg__renderCreate(void* uptr)
 			"	float scissor = scissorMask(fpos);\n"
 			"#ifdef EDGE_AA\n"
 			"	float strokeAlpha = strokeMask();\n"
-			"	if (strokeAlpha < strokeThr) discard;\n"
+			"	// ftcoord of rounded rects is not a stroke coordinate\n"
+			"	if (type != 4 && strokeAlpha < strokeThr) discard;\n"
 			"#else\n"
 			"	float strokeAlpha = 1.0;\n"
 			"#endif\n"
@@ -655,6 +658,11 @@ static int glnvg__renderCreate(void* uptr)
 			"		if (texType == 2) color = vec4(color.x);"
 			"		color *= scissor;\n"
 			"		result = color * innerCol;\n"
+			"	} else if (type == 4) {		// Rounded rects\n"
+			"		// ftcoord is the offset from the corner circle center in radii, the edge is anti-aliased by the distance gradient\n"
+			"		float d = min(max(ftcoord.x,ftcoord.y),0.0) + length(max(ftcoord,0.0)) - 1.0;\n"
+			"		float coverage = clamp(0.5 - d / max(fwidth(d), 1e-6), 0.0, 1.0);\n"
+			"		result = innerCol * (coverage * scissor);\n"
 			"	}\n"
 			"#ifdef NANOVG_GL3\n"
 			"	outColor = result;\n"
@@ -1470,8 +1478,8 @@ static void glnvg__renderStroke(void* uptr, NVGpaint* paint, NVGcompositeOperati
 	if (gl->ncalls > 0) gl->ncalls--;
 }
 
-static void glnvg__renderTriangles(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor,
-		const NVGvertex* verts, int nverts)
+static void glnvg__renderTrianglesWithShader(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor,
+		const NVGvertex* verts, int nverts, int shaderType)
 {
 	GLNVGcontext* gl = (GLNVGcontext*)uptr;
 	GLNVGcall* call = glnvg__allocCall(gl);
@@ -1495,7 +1503,7 @@ static void glnvg__renderTriangles(void* uptr, NVGpaint* paint, NVGcompositeOper
 	if (call->uniformOffset == -1) goto error;
 	frag = nvg__fragUniformPtr(gl, call->uniformOffset);
 	glnvg__convertPaint(gl, frag, paint, scissor, 1.0f, 1.0f, -1.0f);
-	frag->type = NSVG_SHADER_IMG;
+	frag->type = shaderType;
 
 	return;
 
@@ -1505,6 +1513,18 @@ static void glnvg__renderTriangles(void* uptr, NVGpaint* paint, NVGcompositeOper
 	if (gl->ncalls > 0) gl->ncalls--;
 }
 
+static void glnvg__renderTriangles(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor,
+		const NVGvertex* verts, int nverts)
+{
+	glnvg__renderTrianglesWithShader(uptr, paint, compositeOperation, scissor, verts, nverts, NSVG_SHADER_IMG);
+}
+
+static void glnvg__renderRoundedRects(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor,
+		const NVGvertex* verts, int nverts)
+{
+	glnvg__renderTrianglesWithShader(uptr, paint, compositeOperation, scissor, verts, nverts, NSVG_SHADER_ROUNDED_RECTS);
+}
+
 static void glnvg__renderDelete(void* uptr)
 {
 	GLNVGcontext* gl = (GLNVGcontext*)uptr;
@@ -1567,6 +1587,7 @@ NVGcontext* nvgCreateGLES3(int flags)
 	params.renderFill = glnvg__renderFill;
 	params.renderStroke = glnvg__renderStroke;
 	params.renderTriangles = glnvg__renderTriangles;
+	params.renderRoundedRects = glnvg__renderRoundedRects;
 	params.renderDelete = glnvg__renderDelete;
 	params.userPtr = gl;
 	params.edgeAntiAlias = flags & NVG_ANTIALIAS ? 1 : 0;